@@ -0,0 +1,87 @@
+#include "allocator.h"
+
+////////////////////////////////////////////////////
+/*       Private functions of the allocator       */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Allocate function of allocator_default.
+ *
+ * @param ctx Not used.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ */
+static dptr
+__allocator_malloc (dptr ctx, size_t size)
+{
+  (void)ctx;
+  return malloc (size);
+}
+
+/**
+ * @brief Reallocate function of allocator_default.
+ *
+ * @param ctx Not used.
+ * @param ptr Memory to resize.
+ * @param old_size Not used.
+ * @param new_size New number of bytes.
+ * @return dptr Pointer to resized memory.
+ */
+static dptr
+__allocator_realloc (dptr ctx, dptr ptr, size_t old_size, size_t new_size)
+{
+  (void)ctx;
+  (void)old_size;
+  return realloc (ptr, new_size);
+}
+
+/**
+ * @brief Deallocate function of allocator_default.
+ *
+ * @param ctx Not used.
+ * @param ptr Memory to free.
+ * @param size Not used.
+ */
+static void
+__allocator_free (dptr ctx, dptr ptr, size_t size)
+{
+  (void)ctx;
+  (void)size;
+  free (ptr);
+}
+
+const allocator allocator_default
+    = { __allocator_malloc, __allocator_realloc, __allocator_free, NULL };
+
+////////////////////////////////////////////////////
+/*      Public API functions of the allocator     */
+////////////////////////////////////////////////////
+
+inline allocator
+allocator_or_default (const allocator *alloc)
+{
+  if (alloc)
+    return *alloc;
+  return allocator_default;
+}
+
+inline dptr
+allocator_allocate (const allocator *alloc, size_t size)
+{
+  return alloc->allocate (alloc->ctx, size);
+}
+
+inline dptr
+allocator_reallocate (const allocator *alloc, dptr ptr, size_t old_size,
+                      size_t new_size)
+{
+  return alloc->reallocate (alloc->ctx, ptr, old_size, new_size);
+}
+
+inline void
+allocator_deallocate (const allocator *alloc, dptr ptr, size_t size)
+{
+  // Allocators are not required to accept NULL.
+  if (ptr)
+    alloc->deallocate (alloc->ctx, ptr, size);
+}
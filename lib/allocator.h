@@ -0,0 +1,99 @@
+/**
+ * @file allocator.h Interface of the allocator,
+ * that containers take their memory from.
+ */
+
+#ifndef _EXTENDED_C_LIB_ALLOCATOR_H
+#define _EXTENDED_C_LIB_ALLOCATOR_H
+
+#include <stddef.h> // size_t
+#include <stdlib.h> // malloc, realloc, free
+
+#include "types.h"
+
+/**
+ * @struct allocator
+ * @brief Table of functions, that gives and takes back
+ * memory, and context, that is passed to them. Containers
+ * created with *_create_with_allocator() keep copy of the
+ * table and take all their memory (instance, buffers, nodes)
+ * through it. Sizes are passed back on reallocate and
+ * deallocate, so allocators without headers can be used.
+ */
+typedef struct allocator
+{
+  /**
+   * @brief Function to allocate <size> bytes.
+   * Memory should be aligned for any type.
+   */
+  dptr (*allocate) (dptr ctx, size_t size);
+
+  /**
+   * @brief Function to resize memory from <old_size>
+   * to <new_size> bytes. Content is kept.
+   */
+  dptr (*reallocate) (dptr ctx, dptr ptr, size_t old_size, size_t new_size);
+
+  /**
+   * @brief Function to free <size> bytes of memory.
+   * Could do nothing (e.g. for arena).
+   */
+  void (*deallocate) (dptr ctx, dptr ptr, size_t size);
+
+  /**
+   * @brief Context, that is passed to functions,
+   * usually allocator instance.
+   */
+  dptr ctx;
+} allocator;
+
+/**
+ * @brief Allocator, that uses malloc, realloc and free.
+ * Containers created without allocator use it.
+ */
+extern const allocator allocator_default;
+
+////////////////////////////////////////////////////
+/*      Public API functions of the allocator     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to get allocator for container.
+ *
+ * @param alloc Pointer to allocator, could be NULL.
+ * @return allocator Copy of <alloc>, allocator_default
+ * if <alloc> is NULL.
+ */
+allocator allocator_or_default (const allocator *alloc);
+
+/**
+ * @brief Function to allocate memory through allocator.
+ *
+ * @param alloc Pointer to allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ */
+dptr allocator_allocate (const allocator *alloc, size_t size);
+
+/**
+ * @brief Function to resize memory through allocator.
+ *
+ * @param alloc Pointer to allocator.
+ * @param ptr Memory to resize, could be NULL.
+ * @param old_size Number of bytes in <ptr>.
+ * @param new_size New number of bytes.
+ * @return dptr Pointer to resized memory.
+ */
+dptr allocator_reallocate (const allocator *alloc, dptr ptr, size_t old_size,
+                           size_t new_size);
+
+/**
+ * @brief Function to free memory through allocator.
+ *
+ * @param alloc Pointer to allocator.
+ * @param ptr Memory to free, could be NULL.
+ * @param size Number of bytes in <ptr>.
+ */
+void allocator_deallocate (const allocator *alloc, dptr ptr, size_t size);
+
+#endif
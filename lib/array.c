@@ -14,7 +14,10 @@
 static void
 __array_increase_capacity (array *arr, size_t capacity)
 {
-  dptr *ptr = realloc (arr->vec, sizeof (dptr) * capacity);
+  dptr *ptr
+      = allocator_reallocate (&arr->alloc, arr->vec,
+                              sizeof (dptr) * arr->capacity,
+                              sizeof (dptr) * capacity);
 
   arr->capacity = capacity;
   arr->vec = ptr;
@@ -63,6 +66,529 @@ __array_is_iterator_from_range (array *arr, array_iterator where)
   return arr->vec <= where && where < arr->vec + arr->size;
 }
 
+/**
+ * @brief Function to swap two elements.
+ *
+ * @param first Pointer to the first element.
+ * @param second Pointer to the second element.
+ */
+inline static void
+__array_swap (dptr *first, dptr *second)
+{
+  dptr tmp = *first;
+  *first = *second;
+  *second = tmp;
+}
+
+/**
+ * @brief Function to sort two elements.
+ *
+ * @param a Pointer to the first element.
+ * @param b Pointer to the second element.
+ * @param cmp Function of comparing.
+ */
+inline static void
+__array_sort2 (dptr *a, dptr *b,
+               int (*cmp) (constdptr first, constdptr second))
+{
+  if (cmp (*b, *a) < 0)
+    __array_swap (a, b);
+}
+
+/**
+ * @brief Function to sort three elements.
+ *
+ * @param a Pointer to the first element.
+ * @param b Pointer to the second element.
+ * @param c Pointer to the third element.
+ * @param cmp Function of comparing.
+ */
+inline static void
+__array_sort3 (dptr *a, dptr *b, dptr *c,
+               int (*cmp) (constdptr first, constdptr second))
+{
+  __array_sort2 (a, b, cmp);
+  __array_sort2 (b, c, cmp);
+  __array_sort2 (a, b, cmp);
+}
+
+/**
+ * @brief Function to sort range by insertion sort.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_insertion_sort (dptr *begin, dptr *end,
+                        int (*cmp) (constdptr first, constdptr second))
+{
+  if (begin == end)
+    return;
+
+  for (dptr *cur = begin + 1; cur != end; cur++)
+    {
+      dptr tmp = *cur;
+      dptr *sift = cur;
+
+      // Moving greater elements one position right.
+      while (sift != begin && cmp (tmp, *(sift - 1)) < 0)
+        {
+          *sift = *(sift - 1);
+          sift--;
+        }
+
+      *sift = tmp;
+    }
+}
+
+/**
+ * @brief Function to try insertion sort of the range.
+ * Gives up, if too many elements have to be moved.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ * @return true If range is sorted.
+ * @return false If sorting was given up.
+ */
+static bool
+__array_partial_insertion_sort (dptr *begin, dptr *end,
+                                int (*cmp) (constdptr first,
+                                            constdptr second))
+{
+  size_t moved = 0;
+
+  if (begin == end)
+    return true;
+
+  for (dptr *cur = begin + 1; cur != end; cur++)
+    {
+      dptr tmp = *cur;
+      dptr *sift = cur;
+
+      while (sift != begin && cmp (tmp, *(sift - 1)) < 0)
+        {
+          *sift = *(sift - 1);
+          sift--;
+        }
+
+      *sift = tmp;
+      moved += (size_t)(cur - sift);
+
+      if (moved > ARRAY_SORT_PARTIAL_INSERTION_LIMIT)
+        return false;
+    }
+
+  return true;
+}
+
+/**
+ * @brief Function to move element down the max heap.
+ *
+ * @param heap Pointer to the first element of heap.
+ * @param pos Position of element.
+ * @param size Size of heap.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_sift_down (dptr *heap, size_t pos, size_t size,
+                   int (*cmp) (constdptr first, constdptr second))
+{
+  dptr tmp = heap[pos];
+
+  while (2 * pos + 1 < size)
+    {
+      size_t child = 2 * pos + 1;
+
+      if (child + 1 < size && cmp (heap[child], heap[child + 1]) < 0)
+        child++;
+      if (cmp (tmp, heap[child]) >= 0)
+        break;
+
+      heap[pos] = heap[child];
+      pos = child;
+    }
+
+  heap[pos] = tmp;
+}
+
+/**
+ * @brief Function to sort range by heapsort.
+ * Used, when quicksort meets too many bad pivots.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_heap_sort (dptr *begin, dptr *end,
+                   int (*cmp) (constdptr first, constdptr second))
+{
+  size_t size = (size_t)(end - begin);
+
+  for (size_t i = size / 2; i > 0; i--)
+    __array_sift_down (begin, i - 1, size, cmp);
+
+  for (size_t i = size - 1; i > 0; i--)
+    {
+      __array_swap (begin, begin + i);
+      __array_sift_down (begin, 0, i, cmp);
+    }
+}
+
+/**
+ * @brief Function to partition range around <*begin>.
+ * Elements equal to pivot go to the right part.
+ * Median of three guarantees, that there are elements
+ * not less than pivot, so inner loops are unguarded.
+ *
+ * @param begin Pointer to the pivot, the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ * @param already_partitioned Set to true, if nothing was swapped.
+ * @return dptr* Final position of pivot.
+ */
+static dptr *
+__array_partition_right (dptr *begin, dptr *end,
+                         int (*cmp) (constdptr first, constdptr second),
+                         bool *already_partitioned)
+{
+  dptr pivot = *begin;
+  dptr *first = begin;
+  dptr *last = end;
+
+  // Finding the first element not less than pivot.
+  while (cmp (*++first, pivot) < 0)
+    ;
+
+  // Finding the last element less than pivot. Guarded
+  // only if there is no such element before <first>.
+  if (first - 1 == begin)
+    while (first < last && cmp (*--last, pivot) >= 0)
+      ;
+  else
+    while (cmp (*--last, pivot) >= 0)
+      ;
+
+  *already_partitioned = first >= last;
+
+  while (first < last)
+    {
+      __array_swap (first, last);
+      while (cmp (*++first, pivot) < 0)
+        ;
+      while (cmp (*--last, pivot) >= 0)
+        ;
+    }
+
+  // Putting pivot on its final place.
+  dptr *pivot_pos = first - 1;
+  *begin = *pivot_pos;
+  *pivot_pos = pivot;
+
+  return pivot_pos;
+}
+
+/**
+ * @brief Function to partition range around <*begin>,
+ * when element before range is equal to pivot.
+ * Elements equal to pivot go to the left part, so
+ * they are never processed again.
+ *
+ * @param begin Pointer to the pivot, the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ * @return dptr* Final position of pivot.
+ */
+static dptr *
+__array_partition_left (dptr *begin, dptr *end,
+                        int (*cmp) (constdptr first, constdptr second))
+{
+  dptr pivot = *begin;
+  dptr *first = begin;
+  dptr *last = end;
+
+  while (cmp (pivot, *--last) < 0)
+    ;
+
+  if (last + 1 == end)
+    while (first < last && cmp (pivot, *++first) >= 0)
+      ;
+  else
+    while (cmp (pivot, *++first) >= 0)
+      ;
+
+  while (first < last)
+    {
+      __array_swap (first, last);
+      while (cmp (pivot, *--last) < 0)
+        ;
+      while (cmp (pivot, *++first) >= 0)
+        ;
+    }
+
+  *begin = *last;
+  *last = pivot;
+
+  return last;
+}
+
+/**
+ * @brief Function to shuffle some elements of the part,
+ * that was too small after partition, to break patterns,
+ * which make pivot bad.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ */
+static void
+__array_break_patterns (dptr *begin, dptr *end)
+{
+  size_t size = (size_t)(end - begin);
+
+  if (size < ARRAY_SORT_INSERTION_THRESHOLD)
+    return;
+
+  __array_swap (begin, begin + size / 4);
+  __array_swap (end - 1, end - size / 4);
+
+  if (size > ARRAY_SORT_NINTHER_THRESHOLD)
+    {
+      __array_swap (begin + 1, begin + (size / 4 + 1));
+      __array_swap (begin + 2, begin + (size / 4 + 2));
+      __array_swap (end - 2, end - (size / 4 + 1));
+      __array_swap (end - 3, end - (size / 4 + 2));
+    }
+}
+
+/**
+ * @brief Pattern-defeating quicksort of the range.
+ * Recursion goes to the left part, the right part
+ * is sorted by the loop.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ * @param bad_allowed Number of bad partitions before
+ * switching to heapsort.
+ * @param leftmost True if there is no elements before range.
+ */
+static void
+__array_pdqsort (dptr *begin, dptr *end,
+                 int (*cmp) (constdptr first, constdptr second),
+                 int bad_allowed, bool leftmost)
+{
+  for (;;)
+    {
+      size_t size = (size_t)(end - begin);
+
+      if (size < ARRAY_SORT_INSERTION_THRESHOLD)
+        {
+          __array_insertion_sort (begin, end, cmp);
+          return;
+        }
+
+      // Choosing pivot as median of 3 or pseudomedian of 9
+      // and moving it to the <begin>.
+      size_t half = size / 2;
+      if (size > ARRAY_SORT_NINTHER_THRESHOLD)
+        {
+          __array_sort3 (begin, begin + half, end - 1, cmp);
+          __array_sort3 (begin + 1, begin + (half - 1), end - 2, cmp);
+          __array_sort3 (begin + 2, begin + (half + 1), end - 3, cmp);
+          __array_sort3 (begin + (half - 1), begin + half,
+                         begin + (half + 1), cmp);
+          __array_swap (begin, begin + half);
+        }
+      else
+        __array_sort3 (begin + half, begin, end - 1, cmp);
+
+      // If element before range is equal to pivot, all elements
+      // equal to pivot are put left and skipped at once.
+      if (!leftmost && cmp (*(begin - 1), *begin) >= 0)
+        {
+          begin = __array_partition_left (begin, end, cmp) + 1;
+          continue;
+        }
+
+      bool already_partitioned;
+      dptr *pivot_pos
+          = __array_partition_right (begin, end, cmp, &already_partitioned);
+
+      size_t l_size = (size_t)(pivot_pos - begin);
+      size_t r_size = (size_t)(end - (pivot_pos + 1));
+
+      if (l_size < size / 8 || r_size < size / 8)
+        {
+          // Too many bad pivots, quicksort goes quadratic.
+          if (--bad_allowed == 0)
+            {
+              __array_heap_sort (begin, end, cmp);
+              return;
+            }
+
+          __array_break_patterns (begin, pivot_pos);
+          __array_break_patterns (pivot_pos + 1, end);
+        }
+      else if (already_partitioned
+               && __array_partial_insertion_sort (begin, pivot_pos, cmp)
+               && __array_partial_insertion_sort (pivot_pos + 1, end, cmp))
+        return;
+
+      __array_pdqsort (begin, pivot_pos, cmp, bad_allowed, leftmost);
+      begin = pivot_pos + 1;
+      leftmost = false;
+    }
+}
+
+/**
+ * @brief Function to sort range by pdqsort.
+ *
+ * @param begin Pointer to the first element.
+ * @param end Pointer after the last element.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_sort_range (dptr *begin, dptr *end,
+                    int (*cmp) (constdptr first, constdptr second))
+{
+  int bad_allowed = 1;
+
+  // Allowing log2(size) bad partitions.
+  for (size_t size = (size_t)(end - begin); size > 1; size >>= 1)
+    bad_allowed++;
+
+  __array_pdqsort (begin, end, cmp, bad_allowed, true);
+}
+
+/**
+ * @brief Function to merge two sorted ranges into <out>.
+ * Elements of the first range go first, if equal.
+ *
+ * @param first Pointer to the first range.
+ * @param middle Pointer after the first, to the second range.
+ * @param last Pointer after the second range.
+ * @param out Pointer to memory for last - first elements.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_merge (dptr *first, dptr *middle, dptr *last, dptr *out,
+               int (*cmp) (constdptr first, constdptr second))
+{
+  dptr *left = first;
+  dptr *right = middle;
+
+  while (left < middle && right < last)
+    *out++ = (cmp (*right, *left) < 0) ? *right++ : *left++;
+
+  memcpy (out, left, sizeof (dptr) * (size_t)(middle - left));
+  out += middle - left;
+  memcpy (out, right, sizeof (dptr) * (size_t)(last - right));
+}
+
+/**
+ * @brief Function to do one bottom-up merge pass: merges
+ * pairs of sorted runs of <run> elements from <src> to <dst>.
+ *
+ * @param src Pointer to runs.
+ * @param dst Pointer to memory for result.
+ * @param size Number of elements.
+ * @param run Size of run.
+ * @param cmp Function of comparing.
+ */
+static void
+__array_merge_pass (dptr *src, dptr *dst, size_t size, size_t run,
+                    int (*cmp) (constdptr first, constdptr second))
+{
+  for (size_t i = 0; i < size; i += 2 * run)
+    {
+      size_t middle = (i + run < size) ? i + run : size;
+      size_t last = (i + 2 * run < size) ? i + 2 * run : size;
+
+      // Runs, that are already in order, are just copied.
+      if (middle == last || cmp (src[middle], src[middle - 1]) >= 0)
+        memcpy (dst + i, src + i, sizeof (dptr) * (last - i));
+      else
+        __array_merge (src + i, src + middle, src + last, dst + i, cmp);
+    }
+}
+
+/**
+ * @struct __array_sort_job
+ * @brief Part of the array, sorted by one thread.
+ */
+struct __array_sort_job
+{
+  dptr *begin;
+  dptr *end;
+  dptr *out;
+  dptr *middle;
+  int (*cmp) (constdptr first, constdptr second);
+};
+
+/**
+ * @brief Thread routine to sort part of the array.
+ *
+ * @param arg Pointer to struct __array_sort_job.
+ * @return void* NULL.
+ */
+static void *
+__array_sort_job_run (void *arg)
+{
+  struct __array_sort_job *job = (struct __array_sort_job *)arg;
+
+  __array_sort_range (job->begin, job->end, job->cmp);
+
+  return NULL;
+}
+
+/**
+ * @brief Thread routine to merge two sorted parts of the array.
+ *
+ * @param arg Pointer to struct __array_sort_job.
+ * @return void* NULL.
+ */
+static void *
+__array_merge_job_run (void *arg)
+{
+  struct __array_sort_job *job = (struct __array_sort_job *)arg;
+
+  __array_merge (job->begin, job->middle, job->end, job->out, job->cmp);
+
+  return NULL;
+}
+
+/**
+ * @brief Function to run jobs in threads and wait for them.
+ * If thread can't be created, job is run by the caller.
+ *
+ * @param jobs Array of jobs.
+ * @param count Number of jobs.
+ * @param routine Thread routine.
+ */
+static void
+__array_run_jobs (struct __array_sort_job *jobs, size_t count,
+                  void *(*routine) (void *))
+{
+  pthread_t threads[ARRAY_SORT_THREADS_MAX];
+  bool started[ARRAY_SORT_THREADS_MAX];
+
+  // The first job is done by the calling thread.
+  for (size_t i = 1; i < count; i++)
+    started[i] = pthread_create (threads + i, NULL, routine, jobs + i) == 0;
+
+  routine (jobs);
+
+  for (size_t i = 1; i < count; i++)
+    {
+      if (started[i])
+        pthread_join (threads[i], NULL);
+      else
+        routine (jobs + i);
+    }
+}
+
 ////////////////////////////////////////////////////
 /*       Public API functions of the array        */
 ////////////////////////////////////////////////////
@@ -70,15 +596,25 @@ __array_is_iterator_from_range (array *arr, array_iterator where)
 array *
 array_create (size_t capacity)
 {
+  return array_create_with_allocator (capacity, NULL);
+}
+
+array *
+array_create_with_allocator (size_t capacity, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+
   // Allocating memory for array instance..
-  array *arr = (array *)malloc (sizeof (array));
+  array *arr = (array *)allocator_allocate (&al, sizeof (array));
 
   // Setting starting values.
   arr->size = 0;
   arr->capacity = (capacity == 0) ? ARRAY_CAPACITY_DEFAULT : capacity;
+  arr->alloc = al;
 
   // Allocating memory for array.
-  arr->vec = (dptr *)malloc (sizeof (dptr) * arr->capacity);
+  arr->vec
+      = (dptr *)allocator_allocate (&al, sizeof (dptr) * arr->capacity);
 
   return arr;
 }
@@ -155,10 +691,12 @@ array_copy (const array *arr, dptr (*cpy) (constdptr data))
     return NULL;
 
   // Allocating memory for copy array.
-  array *other = (array *)malloc (sizeof (array));
+  array *other = (array *)allocator_allocate (&arr->alloc, sizeof (array));
 
-  other->vec = malloc (sizeof (dptr) * arr->capacity);
+  other->vec
+      = allocator_allocate (&arr->alloc, sizeof (dptr) * arr->capacity);
   other->capacity = arr->capacity;
+  other->alloc = arr->alloc;
   other->size = arr->size;
 
   // Coping all from arr array to other array.
@@ -226,8 +764,9 @@ array_destroy (array *arr, void (*destr) (dptr data))
     return;
 
   array_clear (arr, destr);
-  free (arr->vec);
-  free (arr);
+  allocator_deallocate (&arr->alloc, arr->vec,
+                        sizeof (dptr) * arr->capacity);
+  allocator_deallocate (&arr->alloc, arr, sizeof (array));
 }
 
 inline array_iterator
@@ -484,7 +1023,141 @@ void array_remove_if (array *arr, bool (*predicate) (constdptr data),
 
 void array_reverse (array *arr);
 
-void array_sort (array *arr, int (*cmp) (constdptr first, constdptr second));
+void
+array_sort (array *arr, int (*cmp) (constdptr first, constdptr second))
+{
+  // Checking if arr is not NULL
+  if (!arr || arr->size < 2)
+    return;
+
+  __array_sort_range (arr->vec, arr->vec + arr->size, cmp);
+}
+
+void
+array_sort_parallel (array *arr,
+                     int (*cmp) (constdptr first, constdptr second),
+                     size_t threads)
+{
+  // Checking if arr is not NULL
+  if (!arr || arr->size < 2)
+    return;
+
+  size_t size = arr->size;
+
+  if (threads == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+      threads = (cpus > 0) ? (size_t)cpus : 1;
+    }
+  if (threads > ARRAY_SORT_THREADS_MAX)
+    threads = ARRAY_SORT_THREADS_MAX;
+
+  // Parts should be big enough to pay for threads.
+  while (threads > 1 && size / threads < ARRAY_SORT_PARALLEL_THRESHOLD)
+    threads--;
+
+  if (threads < 2)
+    {
+      array_sort (arr, cmp);
+      return;
+    }
+
+  struct __array_sort_job jobs[ARRAY_SORT_THREADS_MAX];
+  size_t bounds[ARRAY_SORT_THREADS_MAX + 1];
+
+  // Sorting equal parts in parallel.
+  for (size_t i = 0; i <= threads; i++)
+    bounds[i] = size * i / threads;
+
+  for (size_t i = 0; i < threads; i++)
+    {
+      jobs[i].begin = arr->vec + bounds[i];
+      jobs[i].end = arr->vec + bounds[i + 1];
+      jobs[i].cmp = cmp;
+    }
+
+  __array_run_jobs (jobs, threads, __array_sort_job_run);
+
+  // Merging parts pairwise, every round halves number of parts.
+  dptr *buf = allocator_allocate (&arr->alloc, sizeof (dptr) * size);
+  dptr *src = arr->vec;
+  dptr *dst = buf;
+  size_t parts = threads;
+
+  while (parts > 1)
+    {
+      size_t count = 0;
+
+      for (size_t i = 0; i < parts; i += 2)
+        {
+          // Odd part has nothing to merge with, so it is copied.
+          size_t last = (i + 1 < parts) ? bounds[i + 2] : bounds[i + 1];
+
+          jobs[count].begin = src + bounds[i];
+          jobs[count].middle = src + bounds[i + 1];
+          jobs[count].end = src + last;
+          jobs[count].out = dst + bounds[i];
+          jobs[count].cmp = cmp;
+
+          bounds[count++] = bounds[i];
+        }
+      bounds[count] = size;
+
+      __array_run_jobs (jobs, count, __array_merge_job_run);
+
+      parts = count;
+      dptr *tmp = src;
+      src = dst;
+      dst = tmp;
+    }
+
+  if (src != arr->vec)
+    memcpy (arr->vec, src, sizeof (dptr) * size);
+
+  allocator_deallocate (&arr->alloc, buf, sizeof (dptr) * size);
+}
+
+void
+array_stable_sort (array *arr,
+                   int (*cmp) (constdptr first, constdptr second))
+{
+  // Checking if arr is not NULL
+  if (!arr || arr->size < 2)
+    return;
+
+  size_t size = arr->size;
+
+  // Sorting small runs by insertion sort, that is stable.
+  for (size_t i = 0; i < size; i += ARRAY_SORT_RUN)
+    __array_insertion_sort (arr->vec + i,
+                            arr->vec
+                                + ((i + ARRAY_SORT_RUN < size)
+                                       ? i + ARRAY_SORT_RUN
+                                       : size),
+                            cmp);
+
+  if (size <= ARRAY_SORT_RUN)
+    return;
+
+  // Merging runs bottom-up between array and buffer.
+  dptr *buf = allocator_allocate (&arr->alloc, sizeof (dptr) * size);
+  dptr *src = arr->vec;
+  dptr *dst = buf;
+
+  for (size_t run = ARRAY_SORT_RUN; run < size; run *= 2)
+    {
+      __array_merge_pass (src, dst, size, run, cmp);
+
+      dptr *tmp = src;
+      src = dst;
+      dst = tmp;
+    }
+
+  if (src != arr->vec)
+    memcpy (arr->vec, src, sizeof (dptr) * size);
+
+  allocator_deallocate (&arr->alloc, buf, sizeof (dptr) * size);
+}
 
 void array_unique (array *arr,
                    bool (*predicate) (constdptr first, constdptr second));
@@ -5,16 +5,27 @@
 #ifndef _EXTENDED_C_LIB_LIB_ARRAY_H
 #define _EXTENDED_C_LIB_LIB_ARRAY_H
 
+#include <pthread.h> // pthread_create, pthread_join
 #include <stdarg.h>
 #include <stdbool.h> // bool
 #include <stddef.h>  // size_t
 #include <stdlib.h>  // malloc, realloc, free
+#include <string.h>  // memcpy
+#include <unistd.h>  // sysconf
 
+#include "allocator.h"
 #include "types.h"
 
 #define ARRAY_CAPACITY_INCREASE_FACTOR 2
 #define ARRAY_CAPACITY_DEFAULT 10
 
+#define ARRAY_SORT_INSERTION_THRESHOLD 24
+#define ARRAY_SORT_NINTHER_THRESHOLD 128
+#define ARRAY_SORT_PARTIAL_INSERTION_LIMIT 8
+#define ARRAY_SORT_RUN 32
+#define ARRAY_SORT_PARALLEL_THRESHOLD 65536
+#define ARRAY_SORT_THREADS_MAX 64
+
 /**
  * @struct array
  * @brief Implementation of array.
@@ -36,6 +47,11 @@ typedef struct array
    * @brief Current capacity of array.
    */
   size_t capacity;
+
+  /**
+   * @brief Allocator of the array instance and <vec>.
+   */
+  allocator alloc;
 } array;
 
 /**
@@ -57,6 +73,17 @@ typedef dptr *array_iterator;
  */
 array *array_create (size_t capacity);
 
+/**
+ * @brief Function to create new Array, that
+ * takes memory for itself and its items from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param capacity Starting capacity for the array.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return array* Pointer to new array.
+ */
+array *array_create_with_allocator (size_t capacity, const allocator *alloc);
+
 /**
  * @brief Returns element at the <pos>
  * position, or NULL if out of range.
@@ -393,7 +420,10 @@ void array_remove_if (array *arr, bool (*predicate) (constdptr data),
 void array_reverse (array *arr);
 
 /**
- * @brief Function to sort the array.
+ * @brief Function to sort the array by pattern-defeating
+ * quicksort. Not stable. Sorted, reversed and
+ * many-equal inputs take linear time, worst case
+ * is O(n log n) due to heapsort fallback.
  *
  * @param arr Pointer to array instance.
  * @param cmp Function of comparing
@@ -404,6 +434,37 @@ void array_reverse (array *arr);
  */
 void array_sort (array *arr, int (*cmp) (constdptr first, constdptr second));
 
+/**
+ * @brief Function to sort the array in several threads.
+ * Parts of the array are sorted by array_sort in parallel,
+ * then merged pairwise in parallel. Not stable.
+ * Takes additional memory for <size> pointers
+ * from allocator of the array.
+ *
+ * @param arr Pointer to array instance.
+ * @param cmp Function of comparing, the same as
+ * in array_sort. Is called from several threads.
+ * @param threads Maximal number of threads, 0 means
+ * number of online CPUs. Less threads are used, if parts
+ * would be less than ARRAY_SORT_PARALLEL_THRESHOLD.
+ */
+void array_sort_parallel (array *arr,
+                          int (*cmp) (constdptr first, constdptr second),
+                          size_t threads);
+
+/**
+ * @brief Function to sort the array, keeping order of
+ * equal elements. Bottom-up merge sort with insertion
+ * sorted runs. Takes additional memory for <size>
+ * pointers from allocator of the array.
+ *
+ * @param arr Pointer to array instance.
+ * @param cmp Function of comparing, the same as
+ * in array_sort.
+ */
+void array_stable_sort (array *arr,
+                        int (*cmp) (constdptr first, constdptr second));
+
 /**
  * @brief Reduce capacity to <size> size.
  *
@@ -71,13 +71,22 @@ __bitset_count_set_extra_bits (char byte, char nbits)
 bitset *
 bitset_create (size_t n)
 {
-  bitset *b = (bitset *)malloc (sizeof (bitset));
+  return bitset_create_with_allocator (n, NULL);
+}
+
+bitset *
+bitset_create_with_allocator (size_t n, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  bitset *b = (bitset *)allocator_allocate (&al, sizeof (bitset));
+  size_t bytes = __bitset_total_bytes_from_bits (n);
 
   b->n = n;
+  b->alloc = al;
   // allocating n / 8 (from bits in bytes) + extra 1 byte,
   // if some extra bits doesn't fit.
-  b->bits = (unsigned char *)calloc (n / 8 + ((n % 8) & 1),
-                                     sizeof (unsigned char));
+  b->bits = (unsigned char *)allocator_allocate (&al, bytes);
+  memset (b->bits, 0, bytes);
 
   return b;
 }
@@ -89,6 +98,7 @@ bitset_create_from_data (dptr data, size_t size)
 
   // Converting bytes to bits.
   b->n = size * 8;
+  b->alloc = allocator_default;
   b->bits = (unsigned char *)malloc (sizeof (unsigned char) * size);
 
   // copying bits from data to <bits>
@@ -286,6 +296,7 @@ bitset_to_data (bitset *b, dptr data, size_t size)
 void
 bitset_destroy (bitset *b)
 {
-  free (b->bits);
-  free (b);
+  allocator_deallocate (&b->alloc, b->bits,
+                        __bitset_total_bytes_from_bits (b->n));
+  allocator_deallocate (&b->alloc, b, sizeof (bitset));
 }
\ No newline at end of file
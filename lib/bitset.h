@@ -11,6 +11,7 @@
 #include <stdlib.h>  // calloc, malloc, free.
 #include <string.h>  // mem funcs.
 
+#include "allocator.h"
 #include "types.h"
 
 /**
@@ -29,6 +30,11 @@ typedef struct bitset
    * @brief Number of bits.
    */
   size_t n;
+
+  /**
+   * @brief Allocator of the bitset instance and <bits>.
+   */
+  allocator alloc;
 } bitset;
 
 /**
@@ -54,6 +60,19 @@ bitset *bitset_create (size_t n);
  */
 bitset *bitset_create_from_data (dptr data, size_t size);
 
+/**
+ * @brief Creates bitset with n
+ * bits, all equals zero after
+ * initialization. Memory is taken
+ * from <alloc>.
+ *
+ * @param n Number of bits.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return bitset* Created instance
+ * of bitset.
+ */
+bitset *bitset_create_with_allocator (size_t n, const allocator *alloc);
+
 /**
  * @brief Checking that all bits
  * are set.
@@ -0,0 +1,391 @@
+#include "chunked_pool_allocator.h"
+
+#include <string.h> // memcpy
+
+////////////////////////////////////////////////////////
+/*  Private functions of the chunked_pool_allocator   */
+////////////////////////////////////////////////////////
+
+/**
+ * @brief Size of the chunk header with padding, so
+ * first block is aligned.
+ */
+#define __CHUNKED_POOL_HEADER_SIZE                                            \
+  ((sizeof (struct __chunked_pool_chunk) + CHUNKED_POOL_ALLOCATOR_ALIGNMENT   \
+    - 1)                                                                      \
+   & ~(size_t)(CHUNKED_POOL_ALLOCATOR_ALIGNMENT - 1))
+
+/**
+ * @brief Function to read link to the next free
+ * block, stored in the first bytes of <block>.
+ *
+ * @param block Free block.
+ * @return dptr Next free block.
+ */
+inline static dptr
+__chunked_pool_allocator_next (constdptr block)
+{
+  dptr next;
+  memcpy (&next, block, sizeof (dptr));
+  return next;
+}
+
+/**
+ * @brief Function to store link to the next free
+ * block into the first bytes of <block>.
+ *
+ * @param block Free block.
+ * @param next Next free block.
+ */
+inline static void
+__chunked_pool_allocator_set_next (dptr block, dptr next)
+{
+  memcpy (block, &next, sizeof (dptr));
+}
+
+/**
+ * @brief Function to find chunk of the block
+ * by masking its address.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param ptr Block.
+ * @return struct __chunked_pool_chunk* Chunk of the block.
+ */
+inline static struct __chunked_pool_chunk *
+__chunked_pool_allocator_chunk_of (const chunked_pool_allocator *al,
+                                   constdptr ptr)
+{
+  return (struct __chunked_pool_chunk *)((uintptr_t)ptr
+                                         & ~(uintptr_t)(al->chunk_size - 1));
+}
+
+/**
+ * @brief Function to make chunk empty.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param chunk Chunk to reset.
+ */
+inline static void
+__chunked_pool_allocator_chunk_reset (chunked_pool_allocator *al,
+                                      struct __chunked_pool_chunk *chunk)
+{
+  chunk->used = 0;
+  chunk->free_list = NULL;
+  chunk->untouched = chunk->begin + al->block_size * al->blocks_per_chunk;
+}
+
+/**
+ * @brief Function to push chunk to the head of the
+ * list of chunks with free blocks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param chunk Chunk to push.
+ */
+inline static void
+__chunked_pool_allocator_avail_push (chunked_pool_allocator *al,
+                                     struct __chunked_pool_chunk *chunk)
+{
+  chunk->prev_avail = NULL;
+  chunk->next_avail = al->avail;
+
+  if (al->avail)
+    al->avail->prev_avail = chunk;
+
+  al->avail = chunk;
+}
+
+/**
+ * @brief Function to remove chunk from the list
+ * of chunks with free blocks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param chunk Chunk to remove.
+ */
+inline static void
+__chunked_pool_allocator_avail_remove (chunked_pool_allocator *al,
+                                       struct __chunked_pool_chunk *chunk)
+{
+  if (chunk->prev_avail)
+    chunk->prev_avail->next_avail = chunk->next_avail;
+  else
+    al->avail = chunk->next_avail;
+
+  if (chunk->next_avail)
+    chunk->next_avail->prev_avail = chunk->prev_avail;
+
+  chunk->prev_avail = chunk->next_avail = NULL;
+}
+
+/**
+ * @brief Function to map new chunk aligned to its size.
+ * Chunk is added to the list of all chunks and to the
+ * list of chunks with free blocks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @return struct __chunked_pool_chunk* New chunk,
+ * or NULL if mapping failed.
+ */
+static struct __chunked_pool_chunk *
+__chunked_pool_allocator_chunk_map (chunked_pool_allocator *al)
+{
+  size_t size = al->chunk_size;
+
+  // mmap aligns only to page, so twice more is
+  // mapped and extra parts are unmapped.
+  uint8_t *raw = (uint8_t *)mmap (NULL, size * 2, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (raw == MAP_FAILED)
+    return NULL;
+
+  uint8_t *aligned
+      = (uint8_t *)(((uintptr_t)raw + size - 1) & ~(uintptr_t)(size - 1));
+
+  if (aligned != raw)
+    munmap (raw, (size_t)(aligned - raw));
+
+  if (aligned + size != raw + size * 2)
+    munmap (aligned + size, (size_t)(raw + size - aligned));
+
+  struct __chunked_pool_chunk *chunk = (struct __chunked_pool_chunk *)aligned;
+
+  chunk->owner = al;
+  chunk->begin = aligned + __CHUNKED_POOL_HEADER_SIZE;
+  __chunked_pool_allocator_chunk_reset (al, chunk);
+
+  // Linking chunk to the list of all chunks.
+  chunk->prev = NULL;
+  chunk->next = al->chunks;
+  if (al->chunks)
+    al->chunks->prev = chunk;
+  al->chunks = chunk;
+
+  __chunked_pool_allocator_avail_push (al, chunk);
+  al->chunks_number++;
+
+  return chunk;
+}
+
+/**
+ * @brief Function to unmap chunk. Chunk is removed from
+ * the list of all chunks, but not from the list of chunks
+ * with free blocks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param chunk Chunk to unmap.
+ */
+static void
+__chunked_pool_allocator_chunk_unmap (chunked_pool_allocator *al,
+                                      struct __chunked_pool_chunk *chunk)
+{
+  if (chunk->prev)
+    chunk->prev->next = chunk->next;
+  else
+    al->chunks = chunk->next;
+
+  if (chunk->next)
+    chunk->next->prev = chunk->prev;
+
+  munmap (chunk, al->chunk_size);
+  al->chunks_number--;
+}
+
+////////////////////////////////////////////////////////
+/* Public API functions of the chunked_pool_allocator */
+////////////////////////////////////////////////////////
+
+chunked_pool_allocator *
+chunked_pool_allocator_create (size_t block_size, size_t blocks_per_chunk,
+                               bool release_empty)
+{
+  // Free block should fit link to the next one.
+  if (block_size < sizeof (dptr))
+    block_size = sizeof (dptr);
+
+  if (blocks_per_chunk == 0)
+    blocks_per_chunk = 1;
+
+  return chunked_pool_allocator_create_with_chunk_size (
+      block_size,
+      __CHUNKED_POOL_HEADER_SIZE + block_size * blocks_per_chunk,
+      release_empty);
+}
+
+chunked_pool_allocator *
+chunked_pool_allocator_create_with_chunk_size (size_t block_size,
+                                               size_t chunk_size,
+                                               bool release_empty)
+{
+  chunked_pool_allocator *al
+      = (chunked_pool_allocator *)malloc (sizeof (chunked_pool_allocator));
+
+  // Free block should fit link to the next one.
+  if (block_size < sizeof (dptr))
+    block_size = sizeof (dptr);
+
+  // Rounding chunk up to power of 2, so chunk of the
+  // block could be found by mask.
+  size_t need = __CHUNKED_POOL_HEADER_SIZE + block_size;
+  if (chunk_size < need)
+    chunk_size = need;
+
+  al->chunk_size = (size_t)sysconf (_SC_PAGESIZE);
+  while (al->chunk_size < chunk_size)
+    al->chunk_size <<= 1;
+
+  // Using the whole chunk.
+  al->block_size = block_size;
+  al->blocks_per_chunk
+      = (al->chunk_size - __CHUNKED_POOL_HEADER_SIZE) / block_size;
+
+  al->chunks_number = 0;
+  al->used = 0;
+  al->chunks = NULL;
+  al->avail = NULL;
+  al->spare = NULL;
+  al->release_empty = release_empty;
+
+  return al;
+}
+
+dptr
+chunked_pool_allocator_allocate (chunked_pool_allocator *al)
+{
+  struct __chunked_pool_chunk *chunk = al->avail;
+  dptr ptr;
+
+  // All chunks are full, mapping new one.
+  if (!chunk)
+    {
+      chunk = __chunked_pool_allocator_chunk_map (al);
+      if (!chunk)
+        return NULL;
+    }
+
+  if (chunk == al->spare)
+    al->spare = NULL;
+
+  // Reusing last freed block, otherwise carving new one.
+  if (chunk->free_list)
+    {
+      ptr = chunk->free_list;
+      chunk->free_list = __chunked_pool_allocator_next (ptr);
+    }
+  else
+    {
+      chunk->untouched -= al->block_size;
+      ptr = chunk->untouched;
+    }
+
+  chunk->used++;
+  al->used++;
+
+  if (chunk->used == al->blocks_per_chunk)
+    __chunked_pool_allocator_avail_remove (al, chunk);
+
+  return ptr;
+}
+
+void
+chunked_pool_allocator_deallocate (chunked_pool_allocator *al, dptr ptr)
+{
+  if (!ptr)
+    return;
+
+  struct __chunked_pool_chunk *chunk
+      = __chunked_pool_allocator_chunk_of (al, ptr);
+
+  // Checking that block is from this allocator
+  // and that address is correct (points to starting
+  // byte of some block).
+  if (chunk->owner != al || ptr < chunk->begin
+      || ptr >= chunk->begin + al->block_size * al->blocks_per_chunk)
+    return;
+
+  if ((size_t)(ptr - chunk->begin) % al->block_size != 0)
+    return;
+
+  // Checking if all blocks of chunk are already freed.
+  if (chunk->used == 0)
+    return;
+
+  // Full chunk gets free block.
+  if (chunk->used == al->blocks_per_chunk)
+    __chunked_pool_allocator_avail_push (al, chunk);
+
+  __chunked_pool_allocator_set_next (ptr, chunk->free_list);
+  chunk->free_list = ptr;
+  chunk->used--;
+  al->used--;
+
+  if (chunk->used != 0 || !al->release_empty)
+    return;
+
+  // Keeping one free chunk, others are returned
+  // to the system.
+  if (!al->spare)
+    al->spare = chunk;
+  else
+    {
+      __chunked_pool_allocator_avail_remove (al, chunk);
+      __chunked_pool_allocator_chunk_unmap (al, chunk);
+    }
+}
+
+void
+chunked_pool_allocator_reset (chunked_pool_allocator *al)
+{
+  struct __chunked_pool_chunk *chunk = al->chunks, *next;
+
+  // List of chunks with free blocks is built again.
+  al->avail = NULL;
+  al->spare = NULL;
+  al->used = 0;
+
+  while (chunk)
+    {
+      next = chunk->next;
+
+      if (al->release_empty && chunk != al->chunks)
+        __chunked_pool_allocator_chunk_unmap (al, chunk);
+      else
+        {
+          __chunked_pool_allocator_chunk_reset (al, chunk);
+          __chunked_pool_allocator_avail_push (al, chunk);
+        }
+
+      chunk = next;
+    }
+
+  if (al->release_empty)
+    al->spare = al->chunks;
+}
+
+inline size_t
+chunked_pool_allocator_used (const chunked_pool_allocator *al)
+{
+  return al->used;
+}
+
+inline size_t
+chunked_pool_allocator_chunks (const chunked_pool_allocator *al)
+{
+  return al->chunks_number;
+}
+
+void
+chunked_pool_allocator_destroy (chunked_pool_allocator *al)
+{
+  struct __chunked_pool_chunk *chunk = al->chunks, *next;
+
+  // Unmapping all chunks.
+  while (chunk)
+    {
+      next = chunk->next;
+      munmap (chunk, al->chunk_size);
+      chunk = next;
+    }
+
+  // freeing allocator.
+  free (al);
+}
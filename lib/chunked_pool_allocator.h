@@ -0,0 +1,229 @@
+/**
+ * @file chunked_pool_allocator.h Implementation of growable
+ * Pool Allocator. Memory is mapped by chunks on demand, so
+ * allocation fails only if system is out of memory.
+ */
+
+#ifndef _EXTENDED_C_LIB_CHUNKED_POOL_ALLOCATOR_H
+#define _EXTENDED_C_LIB_CHUNKED_POOL_ALLOCATOR_H
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uintptr_t
+#include <stdlib.h>   // malloc, free
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h>   // sysconf
+
+#include "types.h"
+
+/**
+ * @brief Alignment of the first block in the chunk.
+ */
+#define CHUNKED_POOL_ALLOCATOR_ALIGNMENT 16
+
+/**
+ * @struct __chunked_pool_chunk
+ * @brief Header of the chunk. Lies in the first bytes of
+ * the chunk, and chunk is aligned to its size, so
+ * header of any block is found by masking its address.
+ */
+struct __chunked_pool_chunk
+{
+  /**
+   * @brief Allocator, that owns the chunk.
+   */
+  struct chunked_pool_allocator *owner;
+
+  /**
+   * @brief Neighbours in the list of all chunks.
+   */
+  struct __chunked_pool_chunk *prev, *next;
+
+  /**
+   * @brief Neighbours in the list of chunks with free
+   * blocks. Both are NULL, if chunk is full.
+   */
+  struct __chunked_pool_chunk *prev_avail, *next_avail;
+
+  /**
+   * @brief Head of the list of freed blocks of the chunk.
+   */
+  dptr free_list;
+
+  /**
+   * @brief Blocks in [begin, untouched) have never
+   * been allocated.
+   */
+  dptr untouched;
+
+  /**
+   * @brief First block of the chunk.
+   */
+  dptr begin;
+
+  /**
+   * @brief Number of allocated blocks of the chunk.
+   */
+  size_t used;
+};
+
+/**
+ * @struct chunked_pool_allocator
+ * @brief Implementation of growable pool allocator.
+ * Allocator holds list of chunks. When all of them are
+ * full, new chunk is mapped. If <release_empty> is set,
+ * chunk, that became free, is unmapped, but one free
+ * chunk is always kept to avoid mapping and unmapping
+ * on the border of the chunk.
+ */
+typedef struct chunked_pool_allocator
+{
+  /**
+   * @brief Size of one block (in bytes).
+   * At least sizeof (dptr).
+   */
+  size_t block_size;
+
+  /**
+   * @brief Number of blocks in one chunk.
+   */
+  size_t blocks_per_chunk;
+
+  /**
+   * @brief Size of the chunk (in bytes).
+   * Power of 2, at least size of the page.
+   */
+  size_t chunk_size;
+
+  /**
+   * @brief Number of mapped chunks.
+   */
+  size_t chunks_number;
+
+  /**
+   * @brief Number of allocated blocks.
+   */
+  size_t used;
+
+  /**
+   * @brief List of all chunks.
+   */
+  struct __chunked_pool_chunk *chunks;
+
+  /**
+   * @brief List of chunks with free blocks.
+   * Blocks are allocated from the head.
+   */
+  struct __chunked_pool_chunk *avail;
+
+  /**
+   * @brief Free chunk, that is kept mapped, or NULL.
+   * Used only if <release_empty> is set.
+   */
+  struct __chunked_pool_chunk *spare;
+
+  /**
+   * @brief Whether free chunks are unmapped.
+   */
+  bool release_empty;
+} chunked_pool_allocator;
+
+////////////////////////////////////////////////////////
+/* Public API functions of the chunked_pool_allocator */
+////////////////////////////////////////////////////////
+
+/**
+ * @brief Contructor for the chunked pool allocator.
+ * Does not map any chunk.
+ *
+ * @param block_size Number of bytes for one block.
+ * @param blocks_per_chunk Minimal number of blocks in
+ * one chunk. Chunk is rounded up to power of 2 bytes,
+ * so actual number may be greater.
+ * @param release_empty Whether free chunks should be
+ * returned to the system.
+ * @return chunked_pool_allocator* Pointer to
+ * chunked_pool_allocator instance.
+ */
+chunked_pool_allocator *chunked_pool_allocator_create (size_t block_size,
+                                                       size_t blocks_per_chunk,
+                                                       bool release_empty);
+
+/**
+ * @brief Contructor for the chunked pool allocator with
+ * chunks of given size. Allocators with the same chunk
+ * size find chunk of the block by the same mask.
+ * Does not map any chunk.
+ *
+ * @param block_size Number of bytes for one block.
+ * @param chunk_size Size of one chunk. Rounded up to power
+ * of 2, at least size of the page, that fits one block.
+ * @param release_empty Whether free chunks should be
+ * returned to the system.
+ * @return chunked_pool_allocator* Pointer to
+ * chunked_pool_allocator instance.
+ */
+chunked_pool_allocator *
+chunked_pool_allocator_create_with_chunk_size (size_t block_size,
+                                               size_t chunk_size,
+                                               bool release_empty);
+
+/**
+ * @brief Function to allocate new block of memory
+ * from allocator. Maps new chunk, if all are full.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @return dptr Pointer to allocated memory.
+ * NULL only if new chunk can not be mapped.
+ */
+dptr chunked_pool_allocator_allocate (chunked_pool_allocator *al);
+
+/**
+ * @brief Function to return block of memory to
+ * allocator, O(1). Pointer must be NULL or lie in a
+ * chunk of some chunked pool allocator, because chunk
+ * header is read by masking the address. NULL, blocks
+ * of other chunked pool allocators and pointers not to
+ * the start of the block are ignored. Pointers from any
+ * other memory must not be passed.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @param ptr Pointer to block to deallocate.
+ */
+void chunked_pool_allocator_deallocate (chunked_pool_allocator *al,
+                                        dptr ptr);
+
+/**
+ * @brief Function to make all blocks free at once.
+ * Blocks, that were allocated, should not be used after.
+ * If <release_empty> is set, all chunks except of one
+ * are unmapped.
+ *
+ * @param al Pointer to chunked pool allocator.
+ */
+void chunked_pool_allocator_reset (chunked_pool_allocator *al);
+
+/**
+ * @brief Function to get number of allocated blocks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @return size_t Number of blocks in use.
+ */
+size_t chunked_pool_allocator_used (const chunked_pool_allocator *al);
+
+/**
+ * @brief Function to get number of mapped chunks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ * @return size_t Number of chunks.
+ */
+size_t chunked_pool_allocator_chunks (const chunked_pool_allocator *al);
+
+/**
+ * @brief Destructor for chunked pool allocator.
+ * Unmaps all chunks.
+ *
+ * @param al Pointer to chunked pool allocator.
+ */
+void chunked_pool_allocator_destroy (chunked_pool_allocator *al);
+
+#endif
@@ -0,0 +1,235 @@
+#include "concurrent_hashmap.h"
+
+////////////////////////////////////////////////////
+/*  Private functions of the concurrent_hashmap   */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to hash the key once per operation.
+ * Hash is used to choose shard and is passed to *_hashed
+ * functions of the shard's hashmap, so it must be
+ * computed by the same hash function and seed.
+ *
+ * @param chm Pointer to concurrent_hashmap instance.
+ * @param key Key to hash.
+ * @return hash64 Hash of the key.
+ */
+inline static hash64
+__concurrent_hashmap_hash (const concurrent_hashmap *chm, constdptr key)
+{
+  return hash_wy (key, chm->size_func (key), chm->seed);
+}
+
+/**
+ * @brief Function to get shard of the hash.
+ * Shard is chosen by high bits of the hash, while
+ * buckets inside shard depend mostly on low ones.
+ *
+ * @param chm Pointer to concurrent_hashmap instance.
+ * @param h Hash of the key.
+ * @return struct __concurrent_hashmap_shard* Shard of the key.
+ */
+inline static struct __concurrent_hashmap_shard *
+__concurrent_hashmap_shard (const concurrent_hashmap *chm, hash64 h)
+{
+  return chm->shards + ((size_t)(h >> 32) & (chm->nshards - 1));
+}
+
+////////////////////////////////////////////////////
+/* Public API functions of the concurrent_hashmap */
+////////////////////////////////////////////////////
+
+concurrent_hashmap *
+concurrent_hashmap_create (bool (*cmp) (constdptr pair1, constdptr pair2),
+                           size_t (*size_func) (constdptr key),
+                           void (*destr) (dptr pair))
+{
+  return concurrent_hashmap_create_with_shards (
+      cmp, size_func, destr, CONCURRENT_HASHMAP_DEFAULT_NUMBER_OF_SHARDS);
+}
+
+concurrent_hashmap *
+concurrent_hashmap_create_with_shards (bool (*cmp) (constdptr pair1,
+                                                    constdptr pair2),
+                                       size_t (*size_func) (constdptr key),
+                                       void (*destr) (dptr pair),
+                                       size_t nshards)
+{
+  // Allocation memory for the concurrent_hashmap instance.
+  concurrent_hashmap *chm
+      = (concurrent_hashmap *)malloc (sizeof (concurrent_hashmap));
+
+  // Rounding number of shards up to power of 2.
+  chm->nshards = 1;
+  while (chm->nshards < nshards)
+    chm->nshards <<= 1;
+
+  chm->size_func = size_func;
+  chm->seed = hash_random_seed ();
+
+  // Shards are aligned to cache line.
+  chm->shards = (struct __concurrent_hashmap_shard *)aligned_alloc (
+      CONCURRENT_HASHMAP_CACHE_LINE,
+      sizeof (struct __concurrent_hashmap_shard) * chm->nshards);
+
+  for (size_t i = 0; i < chm->nshards; i++)
+    {
+      pthread_rwlock_init (&chm->shards[i].lock, NULL);
+      chm->shards[i].map = hashmap_create_with_hash (cmp, size_func, destr,
+                                                     hash_wy, chm->seed);
+    }
+
+  return chm;
+}
+
+dptr
+concurrent_hashmap_at (concurrent_hashmap *chm, constdptr key)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+
+  pthread_rwlock_rdlock (&shard->lock);
+  struct pair *pair = hashmap_find_hashed (shard->map, key, h);
+  dptr val = pair ? pair->value : NULL;
+  pthread_rwlock_unlock (&shard->lock);
+
+  return val;
+}
+
+void
+concurrent_hashmap_clear (concurrent_hashmap *chm)
+{
+  for (size_t i = 0; i < chm->nshards; i++)
+    {
+      pthread_rwlock_wrlock (&chm->shards[i].lock);
+      hashmap_clear (chm->shards[i].map);
+      pthread_rwlock_unlock (&chm->shards[i].lock);
+    }
+}
+
+dptr
+concurrent_hashmap_compute_if_absent (concurrent_hashmap *chm, constdptr key,
+                                      dptr (*func) (constdptr key, dptr arg),
+                                      dptr arg)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+  dptr val;
+  bool inserted;
+
+  // Fast path: key exists, readers do not block each other.
+  pthread_rwlock_rdlock (&shard->lock);
+  struct pair *pair = hashmap_find_hashed (shard->map, key, h);
+  val = pair ? pair->value : NULL;
+  pthread_rwlock_unlock (&shard->lock);
+
+  if (pair)
+    return val;
+
+  // Checking again by the same lookup, that inserts,
+  // key could be inserted between locks.
+  pthread_rwlock_wrlock (&shard->lock);
+  pair = hashmap_emplace_hashed (shard->map, key, h, &inserted);
+  if (inserted)
+    pair->value = func (key, arg);
+  val = pair->value;
+  pthread_rwlock_unlock (&shard->lock);
+
+  return val;
+}
+
+bool
+concurrent_hashmap_contains (concurrent_hashmap *chm, constdptr key)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+
+  pthread_rwlock_rdlock (&shard->lock);
+  bool found = hashmap_find_hashed (shard->map, key, h) != NULL;
+  pthread_rwlock_unlock (&shard->lock);
+
+  return found;
+}
+
+bool
+concurrent_hashmap_empty (concurrent_hashmap *chm)
+{
+  return concurrent_hashmap_size (chm) == 0;
+}
+
+void
+concurrent_hashmap_erase (concurrent_hashmap *chm, constdptr key)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+
+  pthread_rwlock_wrlock (&shard->lock);
+  hashmap_erase_hashed (shard->map, key, h);
+  pthread_rwlock_unlock (&shard->lock);
+}
+
+bool
+concurrent_hashmap_insert (concurrent_hashmap *chm, constdptr key,
+                           constdptr val)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+  bool inserted;
+
+  pthread_rwlock_wrlock (&shard->lock);
+  struct pair *pair = hashmap_emplace_hashed (shard->map, key, h, &inserted);
+  if (inserted)
+    pair->value = (dptr)val;
+  pthread_rwlock_unlock (&shard->lock);
+
+  return inserted;
+}
+
+bool
+concurrent_hashmap_insert_or_assign (concurrent_hashmap *chm, constdptr key,
+                                     constdptr val)
+{
+  hash64 h = __concurrent_hashmap_hash (chm, key);
+  struct __concurrent_hashmap_shard *shard
+      = __concurrent_hashmap_shard (chm, h);
+  bool inserted;
+
+  pthread_rwlock_wrlock (&shard->lock);
+  hashmap_emplace_hashed (shard->map, key, h, &inserted)->value = (dptr)val;
+  pthread_rwlock_unlock (&shard->lock);
+
+  return inserted;
+}
+
+size_t
+concurrent_hashmap_size (concurrent_hashmap *chm)
+{
+  size_t size = 0;
+
+  for (size_t i = 0; i < chm->nshards; i++)
+    {
+      pthread_rwlock_rdlock (&chm->shards[i].lock);
+      size += hashmap_size (chm->shards[i].map);
+      pthread_rwlock_unlock (&chm->shards[i].lock);
+    }
+
+  return size;
+}
+
+void
+concurrent_hashmap_destroy (concurrent_hashmap *chm)
+{
+  for (size_t i = 0; i < chm->nshards; i++)
+    {
+      hashmap_destroy (chm->shards[i].map);
+      pthread_rwlock_destroy (&chm->shards[i].lock);
+    }
+
+  free (chm->shards);
+  free (chm);
+}
@@ -0,0 +1,236 @@
+/**
+ * @file concurrent_hashmap.h Implementation of thread safe
+ * Hashmap. Keys are split into shards, every shard is
+ * hashmap guarded by its own read-write lock.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_CONCURRENT_HASHMAP_H
+#define _EXTENDED_C_LIB_LIB_CONCURRENT_HASHMAP_H
+
+#include <pthread.h> // pthread_rwlock_t
+#include <stdbool.h> // bool
+#include <stdlib.h>  // malloc, free
+
+#include "hash.h"
+#include "hashmap.h"
+#include "types.h"
+
+#define CONCURRENT_HASHMAP_DEFAULT_NUMBER_OF_SHARDS 64
+
+/**
+ * @brief Size of the cache line. Shards are aligned
+ * to it, so locks of neighbour shards do not share
+ * one line.
+ */
+#define CONCURRENT_HASHMAP_CACHE_LINE 64
+
+/**
+ * @struct __concurrent_hashmap_shard
+ * @brief One shard of the concurrent_hashmap.
+ */
+struct __concurrent_hashmap_shard
+{
+  /**
+   * @brief Lock of the shard. Readers take it
+   * shared, writers exclusive.
+   */
+  pthread_rwlock_t lock;
+
+  /**
+   * @brief Entries of the shard.
+   */
+  hashmap *map;
+} __attribute__ ((aligned (CONCURRENT_HASHMAP_CACHE_LINE)));
+
+/**
+ * @struct concurrent_hashmap
+ * @brief Implementation of thread safe Hashmap.
+ * Operations on keys of different shards do not
+ * block each other.
+ */
+typedef struct concurrent_hashmap
+{
+  /**
+   * @brief Number of shards. Always power of 2.
+   */
+  size_t nshards;
+
+  /**
+   * @brief Array of shards.
+   */
+  struct __concurrent_hashmap_shard *shards;
+
+  /**
+   * @brief Function to get to know size
+   * of the key. Needs for hash alg.
+   */
+  size_t (*size_func) (constdptr);
+
+  /**
+   * @brief Seed of the hash. Shards use the same
+   * hash function and seed.
+   */
+  uint64_t seed;
+} concurrent_hashmap;
+
+////////////////////////////////////////////////////
+/* Public API functions of the concurrent_hashmap */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new concurrent_hashmap with
+ * CONCURRENT_HASHMAP_DEFAULT_NUMBER_OF_SHARDS shards.
+ * Allocates the memory. Should be destroyed at the end.
+ *
+ * @param pair_keys_cmp Function to compare keys of
+ * the pair.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param destr Destructor for pairs, like in hashmap.
+ * @return Pointer to new concurrent_hashmap.
+ */
+concurrent_hashmap *
+concurrent_hashmap_create (bool (*pair_keys_cmp) (constdptr pair1,
+                                                  constdptr pair2),
+                           size_t (*size_func) (constdptr key),
+                           void (*destr) (dptr pair));
+
+/**
+ * @brief Function to create new concurrent_hashmap
+ * with <nshards> shards. Allocates the memory.
+ * Should be destroyed at the end.
+ *
+ * @param pair_keys_cmp Function to compare keys of
+ * the pair.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param destr Destructor for pairs, like in hashmap.
+ * @param nshards Number of shards. Rounded up to power of 2.
+ * @return Pointer to new concurrent_hashmap.
+ */
+concurrent_hashmap *concurrent_hashmap_create_with_shards (
+    bool (*pair_keys_cmp) (constdptr pair1, constdptr pair2),
+    size_t (*size_func) (constdptr key), void (*destr) (dptr pair),
+    size_t nshards);
+
+/**
+ * @brief Function to get value by key from the
+ * concurrent_hashmap. Takes shard lock shared.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key for searching.
+ * @return dptr Value that associated this key,
+ * or NULL if key is not in concurrent_hashmap.
+ */
+dptr concurrent_hashmap_at (concurrent_hashmap *chm, constdptr key);
+
+/**
+ * @brief Function to clear concurrent_hashmap.
+ * Shards are cleared one by one, so entries
+ * inserted concurrently may survive.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ */
+void concurrent_hashmap_clear (concurrent_hashmap *chm);
+
+/**
+ * @brief Function to get value of <key> key or insert
+ * value computed by <func>, if key is absent. Check and
+ * insert are atomic, so <func> is called at most once per
+ * key, even if many threads ask for it at the same time.
+ * <func> is called under shard lock, so it should not
+ * access the same concurrent_hashmap.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key of the entry.
+ * @param func Function to compute value from key and <arg>.
+ * @param arg Argument to pass to <func>.
+ * @return dptr Existing or inserted value.
+ */
+dptr concurrent_hashmap_compute_if_absent (concurrent_hashmap *chm,
+                                           constdptr key,
+                                           dptr (*func) (constdptr key,
+                                                         dptr arg),
+                                           dptr arg);
+
+/**
+ * @brief Function to check if key is in
+ * the concurrent_hashmap.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key to check on existense.
+ * @return true If key is in concurrent_hashmap,
+ *  false If key is not in concurrent_hashmap.
+ */
+bool concurrent_hashmap_contains (concurrent_hashmap *chm, constdptr key);
+
+/**
+ * @brief Function to check if concurrent_hashmap is empty.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @return true If concurrent_hashmap is empty.
+ * @return false If concurrent_hashmap is not empty.
+ */
+bool concurrent_hashmap_empty (concurrent_hashmap *chm);
+
+/**
+ * @brief Function to erase pair by key
+ * from the concurrent_hashmap.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key to find pair to erase.
+ */
+void concurrent_hashmap_erase (concurrent_hashmap *chm, constdptr key);
+
+/**
+ * @brief Function to insert new pair of key, val into
+ * the concurrent_hashmap, if key is absent.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key of the pair to insert.
+ * @param val Val of the pair to insert.
+ * @return true If pair was inserted.
+ * @return false If key already exists. Nothing is changed.
+ */
+bool concurrent_hashmap_insert (concurrent_hashmap *chm, constdptr key,
+                                constdptr val);
+
+/**
+ * @brief Function to insert new pair of key, val into
+ * the concurrent_hashmap or update value of existing key,
+ * like hashmap_insert(). Former key is kept.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @param key Key of the pair to insert.
+ * @param val Val of the pair to insert.
+ * @return true If pair was inserted.
+ * @return false If value of existing key was updated.
+ */
+bool concurrent_hashmap_insert_or_assign (concurrent_hashmap *chm,
+                                          constdptr key, constdptr val);
+
+/**
+ * @brief Function to get number of pairs in
+ * concurrent_hashmap. Shards are counted one by
+ * one, so result is approximate, if there are
+ * concurrent writers.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ * @return size_t Number of pairs.
+ */
+size_t concurrent_hashmap_size (concurrent_hashmap *chm);
+
+/**
+ * @brief Destructor for concurrent_hashmap.
+ * Should not be called concurrently with other
+ * functions.
+ *
+ * @param chm Pointer to the instance of concurrent_hashmap.
+ */
+void concurrent_hashmap_destroy (concurrent_hashmap *chm);
+
+#endif
@@ -0,0 +1,386 @@
+#include "concurrent_pool_allocator.h"
+
+////////////////////////////////////////////////////////////
+/*  Private functions of the concurrent_pool_allocator    */
+////////////////////////////////////////////////////////////
+
+/**
+ * @brief Number of bits of the pointer in the top of
+ * the stack. User space addresses fit 48 bits, higher
+ * bits store ABA counter.
+ */
+#define __CONCURRENT_POOL_POINTER_BITS 48
+
+/**
+ * @brief Mask of the pointer in the top of the stack.
+ */
+#define __CONCURRENT_POOL_POINTER_MASK                                        \
+  (((uint64_t)1 << __CONCURRENT_POOL_POINTER_BITS) - 1)
+
+/**
+ * @brief Function to push magazine to the lock-free stack.
+ * Counter is incremented, so popping thread, that saw the
+ * same top before, fails its CAS.
+ *
+ * @param top Top of the stack.
+ * @param mag Magazine to push.
+ */
+static void
+__concurrent_pool_allocator_push (atomic_uint_fast64_t *top,
+                                  struct __concurrent_pool_magazine *mag)
+{
+  uint64_t old = atomic_load_explicit (top, memory_order_relaxed), new;
+
+  do
+    {
+      atomic_store_explicit (&mag->next,
+                             (struct __concurrent_pool_magazine *)(uintptr_t)(
+                                 old & __CONCURRENT_POOL_POINTER_MASK),
+                             memory_order_relaxed);
+      new = (uint64_t)(uintptr_t)mag
+            | ((old >> __CONCURRENT_POOL_POINTER_BITS) + 1)
+                  << __CONCURRENT_POOL_POINTER_BITS;
+    }
+  while (!atomic_compare_exchange_weak_explicit (
+      top, &old, new, memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * @brief Function to pop magazine from the lock-free stack.
+ * Magazines are freed only by destructor, so reading next
+ * of the magazine, that is already popped by other thread,
+ * is safe.
+ *
+ * @param top Top of the stack.
+ * @return struct __concurrent_pool_magazine* Popped magazine,
+ * or NULL if stack is empty.
+ */
+static struct __concurrent_pool_magazine *
+__concurrent_pool_allocator_pop (atomic_uint_fast64_t *top)
+{
+  uint64_t old = atomic_load_explicit (top, memory_order_acquire), new;
+  struct __concurrent_pool_magazine *mag;
+
+  do
+    {
+      mag = (struct __concurrent_pool_magazine *)(uintptr_t)(
+          old & __CONCURRENT_POOL_POINTER_MASK);
+
+      if (!mag)
+        return NULL;
+
+      new = (uint64_t)(uintptr_t)atomic_load_explicit (&mag->next,
+                                                       memory_order_relaxed)
+            | ((old >> __CONCURRENT_POOL_POINTER_BITS) + 1)
+                  << __CONCURRENT_POOL_POINTER_BITS;
+    }
+  while (!atomic_compare_exchange_weak_explicit (
+      top, &old, new, memory_order_acquire, memory_order_acquire));
+
+  return mag;
+}
+
+/**
+ * @brief Function to get empty magazine from the depot
+ * or to allocate new one.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @return struct __concurrent_pool_magazine* Empty magazine.
+ */
+static struct __concurrent_pool_magazine *
+__concurrent_pool_allocator_empty_magazine (concurrent_pool_allocator *al)
+{
+  struct __concurrent_pool_magazine *mag
+      = __concurrent_pool_allocator_pop (&al->empty);
+
+  if (!mag)
+    {
+      mag = (struct __concurrent_pool_magazine *)malloc (
+          sizeof (struct __concurrent_pool_magazine));
+      mag->count = 0;
+    }
+
+  return mag;
+}
+
+/**
+ * @brief Function to return magazine with blocks to the
+ * depot. If depot is full, blocks are flushed to the
+ * backing pool and magazine becomes empty.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @param mag Magazine with blocks.
+ * @return bool true if magazine is taken by depot,
+ * false if it was flushed and stays with caller.
+ */
+static bool
+__concurrent_pool_allocator_return_magazine (
+    concurrent_pool_allocator *al, struct __concurrent_pool_magazine *mag)
+{
+  if (atomic_fetch_add_explicit (&al->full_count, 1, memory_order_relaxed)
+      < CONCURRENT_POOL_ALLOCATOR_DEPOT_LIMIT)
+    {
+      __concurrent_pool_allocator_push (&al->full, mag);
+      return true;
+    }
+
+  atomic_fetch_sub_explicit (&al->full_count, 1, memory_order_relaxed);
+
+  // Flushing the whole magazine under one lock.
+  pthread_mutex_lock (&al->lock);
+  for (size_t i = 0; i < mag->count; i++)
+    chunked_pool_allocator_deallocate (al->pool, mag->blocks[i]);
+  pthread_mutex_unlock (&al->lock);
+
+  mag->count = 0;
+
+  return false;
+}
+
+/**
+ * @brief Function to fill empty magazine from the depot
+ * or from the backing pool.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @param cache Cache of the thread, both magazines are empty.
+ */
+static void
+__concurrent_pool_allocator_refill (concurrent_pool_allocator *al,
+                                    struct __concurrent_pool_cache *cache)
+{
+  struct __concurrent_pool_magazine *mag
+      = __concurrent_pool_allocator_pop (&al->full);
+
+  if (mag)
+    {
+      atomic_fetch_sub_explicit (&al->full_count, 1, memory_order_relaxed);
+
+      // Returning empty magazine to the depot.
+      __concurrent_pool_allocator_push (&al->empty, cache->previous);
+      cache->previous = cache->loaded;
+      cache->loaded = mag;
+      return;
+    }
+
+  // Filling the whole magazine under one lock.
+  mag = cache->loaded;
+  pthread_mutex_lock (&al->lock);
+  while (mag->count < CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE)
+    {
+      dptr ptr = chunked_pool_allocator_allocate (al->pool);
+
+      if (!ptr)
+        break;
+
+      mag->blocks[mag->count++] = ptr;
+    }
+  pthread_mutex_unlock (&al->lock);
+}
+
+/**
+ * @brief Destructor of the cache, called at exit of the
+ * thread. Magazines are returned to the depot.
+ *
+ * @param ptr Cache of the thread.
+ */
+static void
+__concurrent_pool_allocator_cache_destroy (dptr ptr)
+{
+  struct __concurrent_pool_cache *cache
+      = (struct __concurrent_pool_cache *)ptr;
+  concurrent_pool_allocator *al = cache->owner;
+  struct __concurrent_pool_magazine *mags[2]
+      = { cache->loaded, cache->previous };
+
+  for (size_t i = 0; i < 2; i++)
+    {
+      if (mags[i]->count == 0
+          || !__concurrent_pool_allocator_return_magazine (al, mags[i]))
+        __concurrent_pool_allocator_push (&al->empty, mags[i]);
+    }
+
+  // Unlinking cache from the list of caches.
+  pthread_mutex_lock (&al->lock);
+  if (cache->prev)
+    cache->prev->next = cache->next;
+  else
+    al->caches = cache->next;
+
+  if (cache->next)
+    cache->next->prev = cache->prev;
+  pthread_mutex_unlock (&al->lock);
+
+  free (cache);
+}
+
+/**
+ * @brief Function to get cache of the current thread.
+ * Cache is created at first call.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @return struct __concurrent_pool_cache* Cache of the thread.
+ */
+inline static struct __concurrent_pool_cache *
+__concurrent_pool_allocator_cache (concurrent_pool_allocator *al)
+{
+  struct __concurrent_pool_cache *cache
+      = (struct __concurrent_pool_cache *)pthread_getspecific (al->key);
+
+  if (cache)
+    return cache;
+
+  cache = (struct __concurrent_pool_cache *)malloc (
+      sizeof (struct __concurrent_pool_cache));
+  cache->owner = al;
+  cache->loaded = __concurrent_pool_allocator_empty_magazine (al);
+  cache->previous = __concurrent_pool_allocator_empty_magazine (al);
+  cache->prev = NULL;
+
+  // Linking cache, so destructor of allocator can free it.
+  pthread_mutex_lock (&al->lock);
+  cache->next = al->caches;
+  if (al->caches)
+    al->caches->prev = cache;
+  al->caches = cache;
+  pthread_mutex_unlock (&al->lock);
+
+  pthread_setspecific (al->key, cache);
+
+  return cache;
+}
+
+/**
+ * @brief Function to free all magazines of the stack.
+ *
+ * @param top Top of the stack.
+ */
+static void
+__concurrent_pool_allocator_free_stack (atomic_uint_fast64_t *top)
+{
+  struct __concurrent_pool_magazine *mag;
+
+  while ((mag = __concurrent_pool_allocator_pop (top)))
+    free (mag);
+}
+
+////////////////////////////////////////////////////////////
+/* Public API functions of the concurrent_pool_allocator  */
+////////////////////////////////////////////////////////////
+
+concurrent_pool_allocator *
+concurrent_pool_allocator_create (size_t block_size, size_t blocks_per_chunk)
+{
+  concurrent_pool_allocator *al = (concurrent_pool_allocator *)malloc (
+      sizeof (concurrent_pool_allocator));
+
+  atomic_init (&al->full, 0);
+  atomic_init (&al->empty, 0);
+  atomic_init (&al->full_count, 0);
+
+  pthread_key_create (&al->key, __concurrent_pool_allocator_cache_destroy);
+  pthread_mutex_init (&al->lock, NULL);
+
+  // Blocks stay in magazines, so chunks never become free.
+  al->pool = chunked_pool_allocator_create (block_size, blocks_per_chunk,
+                                            false);
+  al->caches = NULL;
+
+  return al;
+}
+
+dptr
+concurrent_pool_allocator_allocate (concurrent_pool_allocator *al)
+{
+  struct __concurrent_pool_cache *cache
+      = __concurrent_pool_allocator_cache (al);
+  struct __concurrent_pool_magazine *tmp;
+
+  // Fast path, no synchronization at all.
+  if (cache->loaded->count > 0)
+    return cache->loaded->blocks[--cache->loaded->count];
+
+  // Previous magazine has blocks, swapping.
+  if (cache->previous->count > 0)
+    {
+      tmp = cache->loaded;
+      cache->loaded = cache->previous;
+      cache->previous = tmp;
+
+      return cache->loaded->blocks[--cache->loaded->count];
+    }
+
+  __concurrent_pool_allocator_refill (al, cache);
+
+  // Backing pool is out of memory.
+  if (cache->loaded->count == 0)
+    return NULL;
+
+  return cache->loaded->blocks[--cache->loaded->count];
+}
+
+void
+concurrent_pool_allocator_deallocate (concurrent_pool_allocator *al,
+                                      dptr ptr)
+{
+  if (!ptr)
+    return;
+
+  struct __concurrent_pool_cache *cache
+      = __concurrent_pool_allocator_cache (al);
+  struct __concurrent_pool_magazine *tmp;
+
+  // Fast path, no synchronization at all.
+  if (cache->loaded->count < CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE)
+    {
+      cache->loaded->blocks[cache->loaded->count++] = ptr;
+      return;
+    }
+
+  // Previous magazine has space, swapping.
+  if (cache->previous->count < CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE)
+    {
+      tmp = cache->loaded;
+      cache->loaded = cache->previous;
+      cache->previous = tmp;
+    }
+  // Both are full, previous one goes to the depot.
+  else
+    {
+      tmp = cache->previous;
+      cache->previous = cache->loaded;
+
+      if (__concurrent_pool_allocator_return_magazine (al, tmp))
+        tmp = __concurrent_pool_allocator_empty_magazine (al);
+
+      cache->loaded = tmp;
+    }
+
+  cache->loaded->blocks[cache->loaded->count++] = ptr;
+}
+
+void
+concurrent_pool_allocator_destroy (concurrent_pool_allocator *al)
+{
+  struct __concurrent_pool_cache *cache = al->caches, *next;
+
+  // Destructors of caches are not called after that.
+  pthread_key_delete (al->key);
+
+  while (cache)
+    {
+      next = cache->next;
+      free (cache->loaded);
+      free (cache->previous);
+      free (cache);
+      cache = next;
+    }
+
+  __concurrent_pool_allocator_free_stack (&al->full);
+  __concurrent_pool_allocator_free_stack (&al->empty);
+
+  // Blocks are freed all at once with the pool.
+  chunked_pool_allocator_destroy (al->pool);
+  pthread_mutex_destroy (&al->lock);
+
+  free (al);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file concurrent_pool_allocator.h Implementation of thread
+ * safe Pool Allocator. Every thread caches free blocks in
+ * magazines, so most of allocations take no locks.
+ */
+
+#ifndef _EXTENDED_C_LIB_CONCURRENT_POOL_ALLOCATOR_H
+#define _EXTENDED_C_LIB_CONCURRENT_POOL_ALLOCATOR_H
+
+#include <pthread.h>   // pthread_key_t, pthread_mutex_t
+#include <stdatomic.h> // atomic_uint_fast64_t, atomic_size_t
+#include <stdlib.h>    // malloc, free
+
+#include "chunked_pool_allocator.h"
+#include "types.h"
+
+/**
+ * @brief Number of blocks in one magazine. Threads
+ * take and return blocks to the shared memory by
+ * whole magazines.
+ */
+#define CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE 64
+
+/**
+ * @brief Maximal number of full magazines in depot.
+ * Extra magazines are flushed to the backing pool.
+ */
+#define CONCURRENT_POOL_ALLOCATOR_DEPOT_LIMIT 64
+
+/**
+ * @struct __concurrent_pool_magazine
+ * @brief Stack of free blocks.
+ */
+struct __concurrent_pool_magazine
+{
+  /**
+   * @brief Next magazine in the depot. Atomic, because
+   * popping thread may read it, while magazine is
+   * pushed by other one.
+   */
+  struct __concurrent_pool_magazine *_Atomic next;
+
+  /**
+   * @brief Number of blocks in the magazine.
+   */
+  size_t count;
+
+  /**
+   * @brief Free blocks.
+   */
+  dptr blocks[CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE];
+};
+
+/**
+ * @struct __concurrent_pool_cache
+ * @brief Cache of one thread. Thread allocates from
+ * <loaded> magazine and falls back to <previous> one,
+ * so it does not go to the depot on every border of
+ * the magazine.
+ */
+struct __concurrent_pool_cache
+{
+  /**
+   * @brief Allocator of the cache.
+   */
+  struct concurrent_pool_allocator *owner;
+
+  /**
+   * @brief Current magazine.
+   */
+  struct __concurrent_pool_magazine *loaded;
+
+  /**
+   * @brief Previous magazine.
+   */
+  struct __concurrent_pool_magazine *previous;
+
+  /**
+   * @brief Neighbours in the list of caches.
+   */
+  struct __concurrent_pool_cache *prev, *next;
+};
+
+/**
+ * @struct concurrent_pool_allocator
+ * @brief Implementation of thread safe pool allocator.
+ * Magazines, that are not used by threads, are kept in
+ * lock-free stacks. Only refilling magazine from the
+ * backing pool and flushing to it take the lock.
+ * Block can be freed by any thread, not only by the
+ * one that allocated it.
+ */
+typedef struct concurrent_pool_allocator
+{
+  /**
+   * @brief Stack of magazines with blocks. Pointer
+   * to the top is packed with ABA counter.
+   */
+  atomic_uint_fast64_t full;
+
+  /**
+   * @brief Stack of empty magazines. Pointer
+   * to the top is packed with ABA counter.
+   */
+  atomic_uint_fast64_t empty;
+
+  /**
+   * @brief Number of magazines in <full> stack.
+   */
+  atomic_size_t full_count;
+
+  /**
+   * @brief Key of the cache of the thread.
+   */
+  pthread_key_t key;
+
+  /**
+   * @brief Lock of the <pool> and of the <caches>.
+   */
+  pthread_mutex_t lock;
+
+  /**
+   * @brief Pool, that owns memory of blocks.
+   */
+  chunked_pool_allocator *pool;
+
+  /**
+   * @brief List of caches of all threads.
+   */
+  struct __concurrent_pool_cache *caches;
+} concurrent_pool_allocator;
+
+////////////////////////////////////////////////////////////
+/* Public API functions of the concurrent_pool_allocator  */
+////////////////////////////////////////////////////////////
+
+/**
+ * @brief Contructor for the concurrent pool allocator.
+ * Every allocator takes one pthread key.
+ *
+ * @param block_size Number of bytes for one block.
+ * @param blocks_per_chunk Minimal number of blocks in
+ * one chunk of the backing pool.
+ * @return concurrent_pool_allocator* Pointer to
+ * concurrent_pool_allocator instance.
+ */
+concurrent_pool_allocator *
+concurrent_pool_allocator_create (size_t block_size, size_t blocks_per_chunk);
+
+/**
+ * @brief Function to allocate new block of memory
+ * from allocator. Thread safe.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @return dptr Pointer to allocated memory.
+ * NULL only if system is out of memory.
+ */
+dptr concurrent_pool_allocator_allocate (concurrent_pool_allocator *al);
+
+/**
+ * @brief Function to return block of memory
+ * to allocator. Thread safe. Block may be
+ * allocated by another thread. NULL is ignored.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ * @param ptr Pointer to block to deallocate.
+ */
+void concurrent_pool_allocator_deallocate (concurrent_pool_allocator *al,
+                                           dptr ptr);
+
+/**
+ * @brief Destructor for concurrent pool allocator.
+ * Should not be called concurrently with other
+ * functions. Caches of all threads are freed.
+ *
+ * @param al Pointer to concurrent pool allocator.
+ */
+void concurrent_pool_allocator_destroy (concurrent_pool_allocator *al);
+
+#endif
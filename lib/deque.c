@@ -0,0 +1,228 @@
+#include "deque.h"
+
+////////////////////////////////////////////////////
+/*         Private functions of the deque         */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to round capacity up to power of two.
+ *
+ * @param capacity Requested capacity.
+ * @return size_t Power of two, not less than <capacity>.
+ */
+inline static size_t
+__deque_round_capacity (size_t capacity)
+{
+  size_t res = 1;
+
+  while (res < capacity)
+    res <<= 1;
+
+  return res;
+}
+
+/**
+ * @brief Function to get index in <vec> by position.
+ *
+ * @param d Pointer to deque instance.
+ * @param pos Position from the front.
+ * @return size_t Index, wrapped by mask.
+ */
+inline static size_t
+__deque_index (const deque *d, size_t pos)
+{
+  return (d->head + pos) & (d->capacity - 1);
+}
+
+/**
+ * @brief Function to set bigger capacity. Part of
+ * elements, that wrapped to the start of buffer,
+ * is copied right after the old end, so elements
+ * stay contiguous modulo new capacity.
+ *
+ * @param d Pointer to deque instance.
+ * @param capacity New capacity, power of two.
+ */
+static void
+__deque_grow (deque *d, size_t capacity)
+{
+  size_t old_capacity = d->capacity;
+
+  d->vec = allocator_reallocate (&d->alloc, d->vec,
+                                 sizeof (dptr) * old_capacity,
+                                 sizeof (dptr) * capacity);
+  d->capacity = capacity;
+
+  if (d->head + d->size > old_capacity)
+    memcpy (d->vec + old_capacity, d->vec,
+            sizeof (dptr) * (d->head + d->size - old_capacity));
+}
+
+/**
+ * @brief Function to double capacity, if deque is full.
+ *
+ * @param d Pointer to deque instance.
+ */
+inline static void
+__deque_grow_if_need (deque *d)
+{
+  if (d->size == d->capacity)
+    __deque_grow (d, d->capacity * 2);
+}
+
+////////////////////////////////////////////////////
+/*       Public API functions of the deque        */
+////////////////////////////////////////////////////
+
+deque *
+deque_create (size_t capacity)
+{
+  return deque_create_with_allocator (capacity, NULL);
+}
+
+deque *
+deque_create_with_allocator (size_t capacity, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  deque *d = (deque *)allocator_allocate (&al, sizeof (deque));
+
+  d->head = 0;
+  d->size = 0;
+  d->capacity = __deque_round_capacity (
+      (capacity == 0) ? DEQUE_CAPACITY_DEFAULT : capacity);
+  d->alloc = al;
+  d->vec = allocator_allocate (&al, sizeof (dptr) * d->capacity);
+
+  return d;
+}
+
+inline dptr
+deque_at (const deque *d, size_t pos)
+{
+  if (!d || pos >= d->size)
+    return NULL;
+  return d->vec[__deque_index (d, pos)];
+}
+
+inline dptr
+deque_back (const deque *d)
+{
+  if (!d || d->size == 0)
+    return NULL;
+  return d->vec[__deque_index (d, d->size - 1)];
+}
+
+inline size_t
+deque_capacity (const deque *d)
+{
+  if (!d)
+    return 0;
+  return d->capacity;
+}
+
+void
+deque_clear (deque *d, void (*destr) (dptr data))
+{
+  if (!d)
+    return;
+
+  if (destr)
+    for (size_t i = 0; i < d->size; i++)
+      destr (d->vec[__deque_index (d, i)]);
+
+  d->head = 0;
+  d->size = 0;
+}
+
+void
+deque_destroy (deque *d, void (*destr) (dptr data))
+{
+  if (!d)
+    return;
+
+  deque_clear (d, destr);
+  allocator_deallocate (&d->alloc, d->vec, sizeof (dptr) * d->capacity);
+  allocator_deallocate (&d->alloc, d, sizeof (deque));
+}
+
+inline bool
+deque_empty (const deque *d)
+{
+  if (!d)
+    return true;
+  return d->size == 0;
+}
+
+inline dptr
+deque_front (const deque *d)
+{
+  if (!d || d->size == 0)
+    return NULL;
+  return d->vec[d->head];
+}
+
+inline void
+deque_pop_back (deque *d, void (*destr) (dptr data))
+{
+  if (!d || d->size == 0)
+    return;
+
+  d->size--;
+  if (destr)
+    destr (d->vec[__deque_index (d, d->size)]);
+}
+
+inline void
+deque_pop_front (deque *d, void (*destr) (dptr data))
+{
+  if (!d || d->size == 0)
+    return;
+
+  if (destr)
+    destr (d->vec[d->head]);
+  d->head = __deque_index (d, 1);
+  d->size--;
+}
+
+inline void
+deque_push_back (deque *d, constdptr data)
+{
+  if (!d)
+    return;
+
+  __deque_grow_if_need (d);
+
+  d->vec[__deque_index (d, d->size)] = (dptr)data;
+  d->size++;
+}
+
+inline void
+deque_push_front (deque *d, constdptr data)
+{
+  if (!d)
+    return;
+
+  __deque_grow_if_need (d);
+
+  // Index wraps to the end of buffer, when head is 0.
+  d->head = __deque_index (d, d->capacity - 1);
+  d->vec[d->head] = (dptr)data;
+  d->size++;
+}
+
+void
+deque_reserve (deque *d, size_t count)
+{
+  if (!d || count <= d->capacity)
+    return;
+
+  __deque_grow (d, __deque_round_capacity (count));
+}
+
+inline size_t
+deque_size (const deque *d)
+{
+  if (!d)
+    return 0;
+  return d->size;
+}
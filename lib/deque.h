@@ -0,0 +1,190 @@
+/**
+ * @file deque.h Implementation of Deque on top of
+ * ring buffer with power of two capacity.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_DEQUE_H
+#define _EXTENDED_C_LIB_LIB_DEQUE_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <string.h>  // memcpy
+
+#include "allocator.h"
+#include "types.h"
+
+#define DEQUE_CAPACITY_DEFAULT 16
+
+/**
+ * @struct deque
+ * @brief Implementation of deque. Elements are
+ * stored in ring buffer, index wraps by mask,
+ * so push and pop never allocate until buffer is full.
+ */
+typedef struct deque
+{
+  /**
+   * @brief Ring buffer of elements.
+   */
+  dptr *vec;
+
+  /**
+   * @brief Index of the first element in <vec>.
+   */
+  size_t head;
+
+  /**
+   * @brief Current number of elements.
+   */
+  size_t size;
+
+  /**
+   * @brief Capacity of <vec>, power of two.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Allocator of the deque instance and <vec>.
+   */
+  allocator alloc;
+} deque;
+
+////////////////////////////////////////////////////
+/*       Public API functions of the deque        */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new deque.
+ * Allocates the memory. Should be
+ * destroyed at the end.
+ *
+ * @param capacity Starting capacity, rounded up to
+ * power of two. 0 means DEQUE_CAPACITY_DEFAULT.
+ * @return deque* Pointer to new deque.
+ */
+deque *deque_create (size_t capacity);
+
+/**
+ * @brief Function to create new deque, that takes
+ * memory for itself and elements from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param capacity Starting capacity, the same as
+ * in deque_create.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return deque* Pointer to new deque.
+ */
+deque *deque_create_with_allocator (size_t capacity, const allocator *alloc);
+
+/**
+ * @brief Function to get element by position from the front.
+ *
+ * @param d Pointer to deque instance.
+ * @param pos Position of element.
+ * @return dptr Element, NULL if <pos> is out of range.
+ */
+dptr deque_at (const deque *d, size_t pos);
+
+/**
+ * @brief Function to get last element.
+ *
+ * @param d Pointer to deque instance.
+ * @return dptr Element, NULL if deque is empty.
+ */
+dptr deque_back (const deque *d);
+
+/**
+ * @brief Function to get capacity.
+ *
+ * @param d Pointer to deque instance.
+ * @return size_t Capacity in elements.
+ */
+size_t deque_capacity (const deque *d);
+
+/**
+ * @brief Function to remove all elements.
+ * Capacity is kept.
+ *
+ * @param d Pointer to deque instance.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void deque_clear (deque *d, void (*destr) (dptr data));
+
+/**
+ * @brief Destructor of the deque.
+ *
+ * @param d Pointer to deque instance.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void deque_destroy (deque *d, void (*destr) (dptr data));
+
+/**
+ * @brief Function to check if deque is empty.
+ *
+ * @param d Pointer to deque instance.
+ * @return true If deque is empty.
+ * @return false If deque isn't empty.
+ */
+bool deque_empty (const deque *d);
+
+/**
+ * @brief Function to get first element.
+ *
+ * @param d Pointer to deque instance.
+ * @return dptr Element, NULL if deque is empty.
+ */
+dptr deque_front (const deque *d);
+
+/**
+ * @brief Function to remove last element.
+ *
+ * @param d Pointer to deque instance.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void deque_pop_back (deque *d, void (*destr) (dptr data));
+
+/**
+ * @brief Function to remove first element.
+ *
+ * @param d Pointer to deque instance.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void deque_pop_front (deque *d, void (*destr) (dptr data));
+
+/**
+ * @brief Function to add element to the end.
+ * Capacity is doubled, if deque is full.
+ *
+ * @param d Pointer to deque instance.
+ * @param data New element.
+ */
+void deque_push_back (deque *d, constdptr data);
+
+/**
+ * @brief Function to add element to the front.
+ * Capacity is doubled, if deque is full.
+ *
+ * @param d Pointer to deque instance.
+ * @param data New element.
+ */
+void deque_push_front (deque *d, constdptr data);
+
+/**
+ * @brief Function to reserve capacity.
+ *
+ * @param d Pointer to deque instance.
+ * @param count Number of elements. Capacity is rounded
+ * up to power of two, ignored if it is not greater
+ * than current capacity.
+ */
+void deque_reserve (deque *d, size_t count);
+
+/**
+ * @brief Function to get size.
+ *
+ * @param d Pointer to deque instance.
+ * @return size_t Number of elements.
+ */
+size_t deque_size (const deque *d);
+
+#endif
@@ -0,0 +1,663 @@
+#include "flat_hashmap.h"
+
+#include <string.h> // memset
+
+#ifdef __SSE2__
+#include <emmintrin.h> // SSE2 intrinsics
+#endif // __SSE2__
+
+////////////////////////////////////////////////////
+/*     Private functions of the flat_hashmap      */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to calculate hash of the key.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param key Key to hash.
+ * @return hash64 Hash of the key.
+ */
+inline static hash64
+__flat_hashmap_hash (const flat_hashmap *hm, constdptr key)
+{
+  return hm->hash (key, hm->size_func (key), hm->seed);
+}
+
+/**
+ * @brief Function to get position part of the hash.
+ *
+ * @param hash Full hash of the key.
+ * @return size_t Starting position for probing.
+ */
+inline static size_t
+__flat_hashmap_h1 (hash64 hash)
+{
+  return (size_t)(hash >> 7);
+}
+
+/**
+ * @brief Function to get 7 bits of the hash,
+ * stored into the control byte.
+ *
+ * @param hash Full hash of the key.
+ * @return int8_t Control byte for full slot.
+ */
+inline static int8_t
+__flat_hashmap_h2 (hash64 hash)
+{
+  return (int8_t)(hash & 0x7F);
+}
+
+/**
+ * @brief Function to check if control byte
+ * marks full slot.
+ *
+ * @param ctrl Control byte.
+ * @return true If slot is full.
+ * @return false If slot is empty or deleted.
+ */
+inline static bool
+__flat_hashmap_is_full (int8_t ctrl)
+{
+  return ctrl >= 0;
+}
+
+/**
+ * @brief Function to compute number of entries,
+ * that table with <capacity> slots can hold.
+ *
+ * @param capacity Number of slots.
+ * @return size_t Max number of entries.
+ */
+inline static size_t
+__flat_hashmap_max_size (size_t capacity)
+{
+  return capacity / FLAT_HASHMAP_MAX_LOAD_DENOMINATOR
+         * FLAT_HASHMAP_MAX_LOAD_NUMERATOR;
+}
+
+/**
+ * @brief Group of FLAT_HASHMAP_GROUP_WIDTH control bytes.
+ * Every match function returns bitmask, where bit i
+ * is set if i-th control byte of the group matches.
+ */
+#ifdef __SSE2__
+
+/**
+ * @brief Function to get bitmask of bytes equal to <h2>.
+ *
+ * @param group Pointer to the first control byte of group.
+ * @param h2 Control byte to match.
+ * @return uint32_t Bitmask of matching bytes.
+ */
+inline static uint32_t
+__flat_hashmap_group_match (const int8_t *group, int8_t h2)
+{
+  __m128i ctrl = _mm_loadu_si128 ((const __m128i *)group);
+  return (uint32_t)_mm_movemask_epi8 (
+      _mm_cmpeq_epi8 (ctrl, _mm_set1_epi8 (h2)));
+}
+
+/**
+ * @brief Function to get bitmask of empty slots.
+ *
+ * @param group Pointer to the first control byte of group.
+ * @return uint32_t Bitmask of empty slots.
+ */
+inline static uint32_t
+__flat_hashmap_group_match_empty (const int8_t *group)
+{
+  return __flat_hashmap_group_match (group, FLAT_HASHMAP_CTRL_EMPTY);
+}
+
+/**
+ * @brief Function to get bitmask of empty or deleted slots.
+ * Both have the sign bit set, so movemask is enough.
+ *
+ * @param group Pointer to the first control byte of group.
+ * @return uint32_t Bitmask of not full slots.
+ */
+inline static uint32_t
+__flat_hashmap_group_match_free (const int8_t *group)
+{
+  return (uint32_t)_mm_movemask_epi8 (
+      _mm_loadu_si128 ((const __m128i *)group));
+}
+
+#else // __SSE2__
+
+inline static uint32_t
+__flat_hashmap_group_match (const int8_t *group, int8_t h2)
+{
+  uint32_t mask = 0;
+
+  for (uint32_t i = 0; i < FLAT_HASHMAP_GROUP_WIDTH; i++)
+    mask |= (uint32_t)(group[i] == h2) << i;
+
+  return mask;
+}
+
+inline static uint32_t
+__flat_hashmap_group_match_empty (const int8_t *group)
+{
+  return __flat_hashmap_group_match (group, FLAT_HASHMAP_CTRL_EMPTY);
+}
+
+inline static uint32_t
+__flat_hashmap_group_match_free (const int8_t *group)
+{
+  uint32_t mask = 0;
+
+  for (uint32_t i = 0; i < FLAT_HASHMAP_GROUP_WIDTH; i++)
+    mask |= (uint32_t)(group[i] < 0) << i;
+
+  return mask;
+}
+
+#endif // __SSE2__
+
+/**
+ * @brief Function to set control byte of the slot.
+ * First FLAT_HASHMAP_GROUP_WIDTH bytes are mirrored
+ * after the end of the control bytes.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param index Index of the slot.
+ * @param ctrl New control byte.
+ */
+inline static void
+__flat_hashmap_set_ctrl (flat_hashmap *hm, size_t index, int8_t ctrl)
+{
+  hm->ctrl[index] = ctrl;
+  hm->ctrl[((index - FLAT_HASHMAP_GROUP_WIDTH) & (hm->capacity - 1))
+           + FLAT_HASHMAP_GROUP_WIDTH]
+      = ctrl;
+}
+
+/**
+ * @brief Function to get number of bytes of the table.
+ *
+ * @param capacity Number of slots.
+ * @return size_t Size of slots and control bytes.
+ */
+inline static size_t
+__flat_hashmap_table_size (size_t capacity)
+{
+  return sizeof (struct __flat_hashmap_slot) * capacity + capacity
+         + FLAT_HASHMAP_GROUP_WIDTH;
+}
+
+/**
+ * @brief Function to allocate slots and control
+ * bytes in one chunk of memory. All slots are empty.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param capacity Number of slots. Power of 2,
+ * not less than FLAT_HASHMAP_GROUP_WIDTH.
+ */
+static void
+__flat_hashmap_allocate_table (flat_hashmap *hm, size_t capacity)
+{
+  // Slots go first to keep them aligned, control bytes follow.
+  hm->slots = (struct __flat_hashmap_slot *)allocator_allocate (
+      &hm->alloc, __flat_hashmap_table_size (capacity));
+  hm->ctrl = (int8_t *)(hm->slots + capacity);
+  memset (hm->ctrl, FLAT_HASHMAP_CTRL_EMPTY,
+          capacity + FLAT_HASHMAP_GROUP_WIDTH);
+
+  hm->capacity = capacity;
+  hm->growth_left = __flat_hashmap_max_size (capacity) - hm->size;
+}
+
+/**
+ * @brief Function to find slot of entry by key.
+ * Probing goes by groups in triangular sequence,
+ * which visits every group of the table.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param key Key to find.
+ * @param hash Hash of the key.
+ * @return size_t Index of slot or hm->capacity
+ * if key is not in table.
+ */
+static size_t
+__flat_hashmap_find (const flat_hashmap *hm, constdptr key, hash64 hash)
+{
+  size_t mask = hm->capacity - 1;
+  size_t pos = __flat_hashmap_h1 (hash) & mask;
+  int8_t h2 = __flat_hashmap_h2 (hash);
+
+  for (size_t step = FLAT_HASHMAP_GROUP_WIDTH;;
+       step += FLAT_HASHMAP_GROUP_WIDTH)
+    {
+      const int8_t *group = hm->ctrl + pos;
+
+      // Comparator is called only on matching 7 bits
+      // and matching full hash.
+      for (uint32_t match = __flat_hashmap_group_match (group, h2); match;
+           match &= match - 1)
+        {
+          size_t index = (pos + __builtin_ctz (match)) & mask;
+          if (hm->slots[index].hash == hash
+              && hm->cmp (key, hm->slots[index].key))
+            return index;
+        }
+
+      // Empty slot in group means, that key has never
+      // been probed further. Table always has one,
+      // because of max load factor.
+      if (__flat_hashmap_group_match_empty (group))
+        return hm->capacity;
+
+      pos = (pos + step) & mask;
+    }
+}
+
+/**
+ * @brief Function to find first not full slot
+ * in probe sequence of <hash>.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param hash Hash of the key.
+ * @return size_t Index of empty or deleted slot.
+ */
+static size_t
+__flat_hashmap_find_free (const flat_hashmap *hm, hash64 hash)
+{
+  size_t mask = hm->capacity - 1;
+  size_t pos = __flat_hashmap_h1 (hash) & mask;
+
+  for (size_t step = FLAT_HASHMAP_GROUP_WIDTH;;
+       step += FLAT_HASHMAP_GROUP_WIDTH)
+    {
+      uint32_t match = __flat_hashmap_group_match_free (hm->ctrl + pos);
+
+      if (match)
+        return (pos + __builtin_ctz (match)) & mask;
+
+      pos = (pos + step) & mask;
+    }
+}
+
+/**
+ * @brief Function to resize the table. Entries are moved
+ * by cached hash, so there is no hashing and no comparing.
+ * Also drops all tombstones.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param capacity New number of slots. Power of 2.
+ */
+static void
+__flat_hashmap_resize (flat_hashmap *hm, size_t capacity)
+{
+  struct __flat_hashmap_slot *old_slots = hm->slots;
+  int8_t *old_ctrl = hm->ctrl;
+  size_t old_capacity = hm->capacity;
+
+  __flat_hashmap_allocate_table (hm, capacity);
+
+  for (size_t i = 0; i < old_capacity; i++)
+    {
+      if (!__flat_hashmap_is_full (old_ctrl[i]))
+        continue;
+
+      size_t index = __flat_hashmap_find_free (hm, old_slots[i].hash);
+      __flat_hashmap_set_ctrl (hm, index, old_ctrl[i]);
+      hm->slots[index] = old_slots[i];
+    }
+
+  allocator_deallocate (&hm->alloc, old_slots,
+                        __flat_hashmap_table_size (old_capacity));
+}
+
+/**
+ * @brief Function to make room for one more entry.
+ * If table is full of tombstones, it is rehashed
+ * with the same capacity, otherwise it grows.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ */
+static void
+__flat_hashmap_grow_if_need (flat_hashmap *hm)
+{
+  if (hm->growth_left > 0)
+    return;
+
+  if (hm->size + 1 > __flat_hashmap_max_size (hm->capacity) / 2)
+    __flat_hashmap_resize (hm, hm->capacity
+                                   * FLAT_HASHMAP_INCREASE_CAPACITY_FACTOR);
+  else
+    __flat_hashmap_resize (hm, hm->capacity);
+}
+
+/**
+ * @brief Function to destroy keys and values
+ * of all entries.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ */
+static void
+__flat_hashmap_destroy_entries (flat_hashmap *hm)
+{
+  if (!hm->key_destr && !hm->value_destr)
+    return;
+
+  for (size_t i = 0; i < hm->capacity; i++)
+    {
+      if (!__flat_hashmap_is_full (hm->ctrl[i]))
+        continue;
+
+      if (hm->key_destr)
+        hm->key_destr (hm->slots[i].key);
+      if (hm->value_destr)
+        hm->value_destr (hm->slots[i].value);
+    }
+}
+
+/**
+ * @brief Function to insert entry with already computed
+ * hash of the key, or update value of existing entry.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param key Key of the entry.
+ * @param val Value of the entry.
+ * @param h Hash of the key.
+ */
+static void
+__flat_hashmap_insert_hashed (flat_hashmap *hm, constdptr key, constdptr val,
+                              hash64 h)
+{
+  // Checking for existance.
+  size_t index = __flat_hashmap_find (hm, key, h);
+
+  // If exist => updating value.
+  if (index != hm->capacity)
+    {
+      if (hm->value_destr && hm->slots[index].value != val)
+        hm->value_destr (hm->slots[index].value);
+      hm->slots[index].value = (dptr)val;
+      return;
+    }
+
+  __flat_hashmap_grow_if_need (hm);
+
+  index = __flat_hashmap_find_free (hm, h);
+
+  // Reusing tombstone does not consume growth.
+  if (hm->ctrl[index] == FLAT_HASHMAP_CTRL_EMPTY)
+    hm->growth_left--;
+
+  __flat_hashmap_set_ctrl (hm, index, __flat_hashmap_h2 (h));
+  hm->slots[index].hash = h;
+  hm->slots[index].key = (dptr)key;
+  hm->slots[index].value = (dptr)val;
+  hm->size++;
+}
+
+/**
+ * @brief Function to grow the table, so <n> entries
+ * fit without resize.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param n Number of entries.
+ */
+static void
+__flat_hashmap_reserve (flat_hashmap *hm, size_t n)
+{
+  size_t capacity = hm->capacity;
+
+  while (__flat_hashmap_max_size (capacity) < n)
+    capacity *= FLAT_HASHMAP_INCREASE_CAPACITY_FACTOR;
+
+  if (capacity != hm->capacity)
+    __flat_hashmap_resize (hm, capacity);
+}
+
+/**
+ * @brief Function to prefetch control bytes and
+ * slots of the first group in probe sequence.
+ *
+ * @param hm Pointer to flat_hashmap instance.
+ * @param hash Hash of the key.
+ */
+inline static void
+__flat_hashmap_prefetch (const flat_hashmap *hm, hash64 hash)
+{
+  size_t pos = __flat_hashmap_h1 (hash) & (hm->capacity - 1);
+
+  __builtin_prefetch (hm->ctrl + pos);
+  __builtin_prefetch (hm->slots + pos);
+}
+
+////////////////////////////////////////////////////
+/*   Public API functions of the flat_hashmap     */
+////////////////////////////////////////////////////
+
+flat_hashmap *
+flat_hashmap_create (bool (*cmp) (constdptr key1, constdptr key2),
+                     size_t (*size_func) (constdptr key),
+                     void (*key_destr) (dptr key),
+                     void (*value_destr) (dptr value))
+{
+  return flat_hashmap_create_with_hash (cmp, size_func, key_destr,
+                                        value_destr, hash_wy,
+                                        hash_random_seed ());
+}
+
+flat_hashmap *
+flat_hashmap_create_with_hash (bool (*cmp) (constdptr key1, constdptr key2),
+                               size_t (*size_func) (constdptr key),
+                               void (*key_destr) (dptr key),
+                               void (*value_destr) (dptr value),
+                               hash_func hash, uint64_t seed)
+{
+  return flat_hashmap_create_with_allocator (cmp, size_func, key_destr,
+                                             value_destr, hash, seed, NULL);
+}
+
+flat_hashmap *
+flat_hashmap_create_with_allocator (
+    bool (*cmp) (constdptr key1, constdptr key2),
+    size_t (*size_func) (constdptr key), void (*key_destr) (dptr key),
+    void (*value_destr) (dptr value), hash_func hash, uint64_t seed,
+    const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+
+  // Allocation memory for the flat_hashmap instance.
+  flat_hashmap *hm
+      = (flat_hashmap *)allocator_allocate (&al, sizeof (flat_hashmap));
+
+  hm->alloc = al;
+
+  hm->size = 0;
+
+  // Allocating slots and control bytes.
+  __flat_hashmap_allocate_table (hm, FLAT_HASHMAP_STARTING_CAPACITY);
+
+  // Setting compare func for keys.
+  hm->cmp = cmp;
+
+  // Setting sizeof-func for keys.
+  hm->size_func = size_func;
+
+  // Setting hash function and its seed.
+  hm->hash = hash;
+  hm->seed = seed;
+
+  // Setting destructors provided by user.
+  hm->key_destr = key_destr;
+  hm->value_destr = value_destr;
+
+  return hm;
+}
+
+dptr
+flat_hashmap_at (const flat_hashmap *hm, constdptr key)
+{
+  size_t index
+      = __flat_hashmap_find (hm, key, __flat_hashmap_hash (hm, key));
+
+  if (index == hm->capacity)
+    return NULL;
+
+  return hm->slots[index].value;
+}
+
+void
+flat_hashmap_at_batch (const flat_hashmap *hm, const constdptr *keys,
+                       dptr *vals, size_t n)
+{
+  hash64 hashes[FLAT_HASHMAP_BATCH_WINDOW];
+
+  for (size_t start = 0; start < n; start += FLAT_HASHMAP_BATCH_WINDOW)
+    {
+      size_t count = n - start < FLAT_HASHMAP_BATCH_WINDOW
+                         ? n - start
+                         : FLAT_HASHMAP_BATCH_WINDOW;
+
+      // Hashing whole window and prefetching first groups.
+      for (size_t i = 0; i < count; i++)
+        {
+          hashes[i] = __flat_hashmap_hash (hm, keys[start + i]);
+          __flat_hashmap_prefetch (hm, hashes[i]);
+        }
+
+      for (size_t i = 0; i < count; i++)
+        {
+          size_t index = __flat_hashmap_find (hm, keys[start + i], hashes[i]);
+
+          vals[start + i]
+              = index != hm->capacity ? hm->slots[index].value : NULL;
+        }
+    }
+}
+
+inline size_t
+flat_hashmap_bucket_count (const flat_hashmap *hm)
+{
+  return hm->capacity;
+}
+
+void
+flat_hashmap_clear (flat_hashmap *hm)
+{
+  __flat_hashmap_destroy_entries (hm);
+
+  // Marking every slot as empty.
+  memset (hm->ctrl, FLAT_HASHMAP_CTRL_EMPTY,
+          hm->capacity + FLAT_HASHMAP_GROUP_WIDTH);
+
+  hm->size = 0;
+  hm->growth_left = __flat_hashmap_max_size (hm->capacity);
+}
+
+inline bool
+flat_hashmap_contains (const flat_hashmap *hm, constdptr key)
+{
+  return __flat_hashmap_find (hm, key, __flat_hashmap_hash (hm, key))
+         != hm->capacity;
+}
+
+inline __attribute__ ((always_inline)) bool
+flat_hashmap_empty (const flat_hashmap *hm)
+{
+  return hm->size == 0;
+}
+
+void
+flat_hashmap_erase (flat_hashmap *hm, constdptr key)
+{
+  size_t index
+      = __flat_hashmap_find (hm, key, __flat_hashmap_hash (hm, key));
+
+  if (index == hm->capacity)
+    return;
+
+  if (hm->key_destr)
+    hm->key_destr (hm->slots[index].key);
+  if (hm->value_destr)
+    hm->value_destr (hm->slots[index].value);
+
+  // If there is no group window of full slots around <index>,
+  // no probe sequence has ever gone through this slot, so it can
+  // be empty. Otherwise leaving tombstone to not break probing.
+  size_t index_before
+      = (index - FLAT_HASHMAP_GROUP_WIDTH) & (hm->capacity - 1);
+  uint32_t empty_after = __flat_hashmap_group_match_empty (hm->ctrl + index);
+  uint32_t empty_before
+      = __flat_hashmap_group_match_empty (hm->ctrl + index_before);
+
+  if (empty_after && empty_before
+      && (size_t)(__builtin_ctz (empty_after)
+                  + __builtin_clz (empty_before << FLAT_HASHMAP_GROUP_WIDTH))
+             < FLAT_HASHMAP_GROUP_WIDTH)
+    {
+      __flat_hashmap_set_ctrl (hm, index, FLAT_HASHMAP_CTRL_EMPTY);
+      hm->growth_left++;
+    }
+  else
+    __flat_hashmap_set_ctrl (hm, index, FLAT_HASHMAP_CTRL_DELETED);
+
+  hm->size--;
+}
+
+void
+flat_hashmap_insert (flat_hashmap *hm, constdptr key, constdptr val)
+{
+  __flat_hashmap_insert_hashed (hm, key, val, __flat_hashmap_hash (hm, key));
+}
+
+void
+flat_hashmap_insert_batch (flat_hashmap *hm, const constdptr *keys,
+                           const constdptr *vals, size_t n)
+{
+  hash64 hashes[FLAT_HASHMAP_BATCH_WINDOW];
+
+  // Making room for all keys at once.
+  __flat_hashmap_reserve (hm, hm->size + n);
+
+  for (size_t start = 0; start < n; start += FLAT_HASHMAP_BATCH_WINDOW)
+    {
+      size_t count = n - start < FLAT_HASHMAP_BATCH_WINDOW
+                         ? n - start
+                         : FLAT_HASHMAP_BATCH_WINDOW;
+
+      // Hashing whole window and prefetching first groups.
+      for (size_t i = 0; i < count; i++)
+        {
+          hashes[i] = __flat_hashmap_hash (hm, keys[start + i]);
+          __flat_hashmap_prefetch (hm, hashes[i]);
+        }
+
+      for (size_t i = 0; i < count; i++)
+        __flat_hashmap_insert_hashed (hm, keys[start + i],
+                                      vals ? vals[start + i] : NULL,
+                                      hashes[i]);
+    }
+}
+
+inline float
+flat_hashmap_load_factor (const flat_hashmap *hm)
+{
+  return (float)flat_hashmap_size (hm) / flat_hashmap_bucket_count (hm);
+}
+
+inline __attribute__ ((always_inline)) size_t
+flat_hashmap_size (const flat_hashmap *hm)
+{
+  return hm->size;
+}
+
+void
+flat_hashmap_destroy (flat_hashmap *hm)
+{
+  __flat_hashmap_destroy_entries (hm);
+
+  // Slots and control bytes are one allocation.
+  allocator_deallocate (&hm->alloc, hm->slots,
+                        __flat_hashmap_table_size (hm->capacity));
+
+  // Destroying flat_hashmap instance.
+  allocator_deallocate (&hm->alloc, hm, sizeof (flat_hashmap));
+}
@@ -0,0 +1,346 @@
+/**
+ * @file flat_hashmap.h Implementation of open addressing
+ * Hashmap. Keys, values and cached hashes are stored
+ * inline in one flat table, guarded by an array of
+ * control bytes (SwissTable-style).
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_FLAT_HASHMAP_H
+#define _EXTENDED_C_LIB_LIB_FLAT_HASHMAP_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <stdint.h>  // int8_t
+#include <stdlib.h>  // malloc, free
+
+#include "allocator.h"
+#include "hash.h"
+#include "types.h"
+
+/**
+ * @brief Number of control bytes checked at once.
+ * One SSE2 register.
+ */
+#define FLAT_HASHMAP_GROUP_WIDTH 16
+
+#define FLAT_HASHMAP_STARTING_CAPACITY FLAT_HASHMAP_GROUP_WIDTH
+#define FLAT_HASHMAP_INCREASE_CAPACITY_FACTOR 2
+
+/**
+ * @brief Number of keys, that batch functions hash
+ * and prefetch before probing.
+ */
+#define FLAT_HASHMAP_BATCH_WINDOW 16
+
+/**
+ * @brief Maximum load factor of the table
+ * expressed as fraction (7/8).
+ */
+#define FLAT_HASHMAP_MAX_LOAD_NUMERATOR 7
+#define FLAT_HASHMAP_MAX_LOAD_DENOMINATOR 8
+
+/**
+ * @brief Values of the control bytes.
+ * Full slot holds 7 lowest bits of the hash (0..127),
+ * so every special value has the sign bit set.
+ */
+#define FLAT_HASHMAP_CTRL_EMPTY ((int8_t)-128)
+#define FLAT_HASHMAP_CTRL_DELETED ((int8_t)-2)
+
+/**
+ * @struct __flat_hashmap_slot
+ * @brief One slot of the flat table.
+ */
+struct __flat_hashmap_slot
+{
+  /**
+   * @brief Cached hash of the key.
+   */
+  hash64 hash;
+
+  /**
+   * @brief Key of the entry.
+   */
+  dptr key;
+
+  /**
+   * @brief Value of the entry.
+   */
+  dptr value;
+};
+
+/**
+ * @struct flat_hashmap
+ * @brief Implementation of open addressing Hashmap.
+ */
+typedef struct flat_hashmap
+{
+  /**
+   * @brief Counting current number of entries.
+   */
+  size_t size;
+
+  /**
+   * @brief Number of slots. Always power of 2.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Number of entries, that can be inserted
+   * before resize. Tombstones consume it too.
+   */
+  size_t growth_left;
+
+  /**
+   * @brief Control bytes, one per slot, followed by
+   * copy of first FLAT_HASHMAP_GROUP_WIDTH bytes, so group
+   * can be loaded from any position without wrapping.
+   * Lives in the same allocation as <slots>.
+   */
+  int8_t *ctrl;
+
+  /**
+   * @brief Array of slots.
+   */
+  struct __flat_hashmap_slot *slots;
+
+  /**
+   * @brief Compare function for keys.
+   * Return true if key1 == key2.
+   * Return false if key1 != key2.
+   */
+  bool (*cmp) (constdptr, constdptr);
+
+  /**
+   * @brief Function to get to know size
+   * of the key. Needs for hash alg.
+   */
+  size_t (*size_func) (constdptr);
+
+  /**
+   * @brief Hash function for keys.
+   */
+  hash_func hash;
+
+  /**
+   * @brief Seed of the hash function.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief Destructor for keys.
+   * Null if should not be freed.
+   */
+  void (*key_destr) (dptr);
+
+  /**
+   * @brief Destructor for values.
+   * Null if should not be freed.
+   */
+  void (*value_destr) (dptr);
+
+  /**
+   * @brief Allocator of the flat_hashmap
+   * instance and table.
+   */
+  allocator alloc;
+} flat_hashmap;
+
+////////////////////////////////////////////////////
+/*   Public API functions of the flat_hashmap     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new flat_hashmap. Allocates the memory.
+ * Should be destroyed at the end. Keys are hashed by hash_wy()
+ * with random seed.
+ *
+ * @param keys_cmp Function to compare keys.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param key_destr Destructor for keys.
+ * Null if should not be freed.
+ * @param value_destr Destructor for values.
+ * Null if should not be freed.
+ * @return Pointer to new flat_hashmap.
+ */
+flat_hashmap *flat_hashmap_create (bool (*keys_cmp) (constdptr key1,
+                                                     constdptr key2),
+                                   size_t (*size_func) (constdptr key),
+                                   void (*key_destr) (dptr key),
+                                   void (*value_destr) (dptr value));
+
+/**
+ * @brief Function to create new flat_hashmap with custom
+ * hash function. Allocates the memory. Should be destroyed
+ * at the end.
+ *
+ * @param keys_cmp Function to compare keys.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param key_destr Destructor for keys.
+ * Null if should not be freed.
+ * @param value_destr Destructor for values.
+ * Null if should not be freed.
+ * @param hash Hash function for keys.
+ * @param seed Seed of the hash function.
+ * @return Pointer to new flat_hashmap.
+ */
+flat_hashmap *flat_hashmap_create_with_hash (
+    bool (*keys_cmp) (constdptr key1, constdptr key2),
+    size_t (*size_func) (constdptr key), void (*key_destr) (dptr key),
+    void (*value_destr) (dptr value), hash_func hash, uint64_t seed);
+
+/**
+ * @brief Function to create new flat_hashmap, that takes
+ * memory for itself and its table from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param keys_cmp Function to compare keys.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param key_destr Destructor for keys.
+ * Null if should not be freed.
+ * @param value_destr Destructor for values.
+ * Null if should not be freed.
+ * @param hash Hash function for keys.
+ * @param seed Seed of the hash function.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new flat_hashmap.
+ */
+flat_hashmap *flat_hashmap_create_with_allocator (
+    bool (*keys_cmp) (constdptr key1, constdptr key2),
+    size_t (*size_func) (constdptr key), void (*key_destr) (dptr key),
+    void (*value_destr) (dptr value), hash_func hash, uint64_t seed,
+    const allocator *alloc);
+
+/**
+ * @brief Function to get value by key from the
+ * flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param key Key for searching.
+ * @return dptr Value that associated this key,
+ * or NULL if key is not in flat_hashmap.
+ */
+dptr flat_hashmap_at (const flat_hashmap *hm, constdptr key);
+
+/**
+ * @brief Function to get values of <n> keys. Keys are
+ * hashed and their first groups are prefetched by windows
+ * of FLAT_HASHMAP_BATCH_WINDOW before probing.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param keys Array of <n> keys for searching.
+ * @param vals Array of <n> values to fill. NULL for
+ * keys, that are not in flat_hashmap.
+ * @param n Number of keys.
+ */
+void flat_hashmap_at_batch (const flat_hashmap *hm, const constdptr *keys,
+                            dptr *vals, size_t n);
+
+/**
+ * @brief Function to get number of slots in the table.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @return size_t Number of slots.
+ */
+size_t flat_hashmap_bucket_count (const flat_hashmap *hm);
+
+/**
+ * @brief Function to clear flat_hashmap.
+ * Do not destroy instance of flat_hashmap and
+ * keeps its capacity.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ */
+void flat_hashmap_clear (flat_hashmap *hm);
+
+/**
+ * @brief Function to check if key is in
+ * the flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param key Key to check on existense.
+ * @return true If key is in flat_hashmap,
+ *  false If key is not in flat_hashmap.
+ */
+bool flat_hashmap_contains (const flat_hashmap *hm, constdptr key);
+
+/**
+ * @brief Function to check if flat_hashmap is empty.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @return true If flat_hashmap is empty.
+ * @return false If flat_hashmap is not empty.
+ */
+bool flat_hashmap_empty (const flat_hashmap *hm);
+
+/**
+ * @brief Function to erase entry by key
+ * from the flat_hashmap. Does nothing if
+ * key is not in flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param key Key to find entry to erase.
+ */
+void flat_hashmap_erase (flat_hashmap *hm, constdptr key);
+
+/**
+ * @brief Function to insert new pair of key, val into
+ * the flat_hashmap, or update value of existing entry.
+ * On update former value is destroyed by value_destr()
+ * and former key is kept.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param key Key of the entry to insert.
+ * @param val Val of the entry to insert.
+ */
+void flat_hashmap_insert (flat_hashmap *hm, constdptr key, constdptr val);
+
+/**
+ * @brief Function to insert <n> pairs of keys and values.
+ * Grows the table for all of them first, then hashes keys
+ * and prefetches their first groups by windows of
+ * FLAT_HASHMAP_BATCH_WINDOW. Works like flat_hashmap_insert()
+ * for every pair in order.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @param keys Array of <n> keys.
+ * @param vals Array of <n> values. NULL to insert NULL values.
+ * @param n Number of pairs.
+ */
+void flat_hashmap_insert_batch (flat_hashmap *hm, const constdptr *keys,
+                                const constdptr *vals, size_t n);
+
+/**
+ * @brief Function to get load of flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @return float Size / Number of slots.
+ */
+float flat_hashmap_load_factor (const flat_hashmap *hm);
+
+/**
+ * @brief Function to get number of entries
+ * in flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ * @return size_t Number of entries in flat_hashmap.
+ */
+size_t flat_hashmap_size (const flat_hashmap *hm);
+
+/**
+ * @brief Destructor for flat_hashmap.
+ *
+ * @param hm Pointer to the instance of flat_hashmap.
+ */
+void flat_hashmap_destroy (flat_hashmap *hm);
+
+#endif
@@ -0,0 +1,109 @@
+#include "flat_hashset.h"
+
+////////////////////////////////////////////////////
+/*   Public API functions of the flat_hashset     */
+////////////////////////////////////////////////////
+
+flat_hashset *
+flat_hashset_create (bool (*cmp) (constdptr val1, constdptr val2),
+                     size_t (*size_func) (constdptr val),
+                     void (*destr) (dptr val))
+{
+  flat_hashset *hs = (flat_hashset *)malloc (sizeof (flat_hashset));
+
+  // Elements are keys of the map, values are always NULL.
+  hs->map = flat_hashmap_create (cmp, size_func, destr, NULL);
+
+  return hs;
+}
+
+flat_hashset *
+flat_hashset_create_with_hash (bool (*cmp) (constdptr val1, constdptr val2),
+                               size_t (*size_func) (constdptr val),
+                               void (*destr) (dptr val), hash_func hash,
+                               uint64_t seed)
+{
+  flat_hashset *hs = (flat_hashset *)malloc (sizeof (flat_hashset));
+
+  // Elements are keys of the map, values are always NULL.
+  hs->map = flat_hashmap_create_with_hash (cmp, size_func, destr, NULL, hash,
+                                           seed);
+
+  return hs;
+}
+
+flat_hashset *
+flat_hashset_create_with_allocator (
+    bool (*cmp) (constdptr val1, constdptr val2),
+    size_t (*size_func) (constdptr val), void (*destr) (dptr val),
+    hash_func hash, uint64_t seed, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  flat_hashset *hs
+      = (flat_hashset *)allocator_allocate (&al, sizeof (flat_hashset));
+
+  // Elements are keys of the map, values are always NULL.
+  hs->map = flat_hashmap_create_with_allocator (cmp, size_func, destr, NULL,
+                                                hash, seed, &al);
+
+  return hs;
+}
+
+inline size_t
+flat_hashset_bucket_count (const flat_hashset *hs)
+{
+  return flat_hashmap_bucket_count (hs->map);
+}
+
+inline void
+flat_hashset_clear (flat_hashset *hs)
+{
+  flat_hashmap_clear (hs->map);
+}
+
+inline bool
+flat_hashset_contains (const flat_hashset *hs, constdptr val)
+{
+  return flat_hashmap_contains (hs->map, val);
+}
+
+inline bool
+flat_hashset_empty (const flat_hashset *hs)
+{
+  return flat_hashmap_empty (hs->map);
+}
+
+inline void
+flat_hashset_erase (flat_hashset *hs, constdptr val)
+{
+  flat_hashmap_erase (hs->map, val);
+}
+
+inline void
+flat_hashset_insert (flat_hashset *hs, constdptr val)
+{
+  // Existing element is kept, because map keeps former key.
+  flat_hashmap_insert (hs->map, val, NULL);
+}
+
+inline float
+flat_hashset_load_factor (const flat_hashset *hs)
+{
+  return flat_hashmap_load_factor (hs->map);
+}
+
+inline size_t
+flat_hashset_size (const flat_hashset *hs)
+{
+  return flat_hashmap_size (hs->map);
+}
+
+void
+flat_hashset_destroy (flat_hashset *hs)
+{
+  // Set instance is freed through allocator of the map.
+  allocator al = hs->map->alloc;
+
+  flat_hashmap_destroy (hs->map);
+  allocator_deallocate (&al, hs, sizeof (flat_hashset));
+}
@@ -0,0 +1,173 @@
+/**
+ * @file flat_hashset.h Implementation of open addressing
+ * Hashset based on flat_hashmap.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_FLAT_HASHSET_H
+#define _EXTENDED_C_LIB_LIB_FLAT_HASHSET_H
+
+#include <stdbool.h> // bool
+#include <stdlib.h>  // malloc, free
+
+#include "flat_hashmap.h"
+#include "types.h"
+
+/**
+ * @struct flat_hashset
+ * @brief Implementation of open addressing Hashset.
+ * Wrapper around flat_hashmap, that stores elements
+ * as keys without values.
+ */
+typedef struct flat_hashset
+{
+  /**
+   * @brief Instance of flat_hashmap.
+   */
+  flat_hashmap *map;
+} flat_hashset;
+
+////////////////////////////////////////////////////
+/*   Public API functions of the flat_hashset     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new flat_hashset. Allocates the memory.
+ * Should be destroyed at the end. Elements are hashed by hash_wy()
+ * with random seed.
+ *
+ * @param vals_cmp Function to compare vals.
+ * Return true if val1 == val2.
+ * Return false if val1 != val2.
+ * @param size_func Function to compute
+ * size of the val.
+ * @param destr Destructor for elements.
+ * Null if should not be freed.
+ * @return Pointer to new flat_hashset.
+ */
+flat_hashset *flat_hashset_create (bool (*vals_cmp) (constdptr val1,
+                                                     constdptr val2),
+                                   size_t (*size_func) (constdptr val),
+                                   void (*destr) (dptr val));
+
+/**
+ * @brief Function to create new flat_hashset with custom
+ * hash function. Allocates the memory. Should be destroyed
+ * at the end.
+ *
+ * @param vals_cmp Function to compare vals.
+ * Return true if val1 == val2.
+ * Return false if val1 != val2.
+ * @param size_func Function to compute
+ * size of the val.
+ * @param destr Destructor for elements.
+ * Null if should not be freed.
+ * @param hash Hash function for elements.
+ * @param seed Seed of the hash function.
+ * @return Pointer to new flat_hashset.
+ */
+flat_hashset *flat_hashset_create_with_hash (
+    bool (*vals_cmp) (constdptr val1, constdptr val2),
+    size_t (*size_func) (constdptr val), void (*destr) (dptr val),
+    hash_func hash, uint64_t seed);
+
+/**
+ * @brief Function to create new flat_hashset, that takes
+ * memory for itself and its table from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param vals_cmp Function to compare vals.
+ * Return true if val1 == val2.
+ * Return false if val1 != val2.
+ * @param size_func Function to compute
+ * size of the val.
+ * @param destr Destructor for elements.
+ * Null if should not be freed.
+ * @param hash Hash function for elements.
+ * @param seed Seed of the hash function.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new flat_hashset.
+ */
+flat_hashset *flat_hashset_create_with_allocator (
+    bool (*vals_cmp) (constdptr val1, constdptr val2),
+    size_t (*size_func) (constdptr val), void (*destr) (dptr val),
+    hash_func hash, uint64_t seed, const allocator *alloc);
+
+/**
+ * @brief Function to get number of slots in the table.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @return size_t Number of slots.
+ */
+size_t flat_hashset_bucket_count (const flat_hashset *hs);
+
+/**
+ * @brief Function to clear flat_hashset.
+ * Do not destroy instance of flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ */
+void flat_hashset_clear (flat_hashset *hs);
+
+/**
+ * @brief Function to check if element is in
+ * the flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @param val Element to check on existense.
+ * @return true If element is in flat_hashset,
+ *  false If element is not in flat_hashset.
+ */
+bool flat_hashset_contains (const flat_hashset *hs, constdptr val);
+
+/**
+ * @brief Function to check if flat_hashset is empty.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @return true If flat_hashset is empty.
+ * @return false If flat_hashset is not empty.
+ */
+bool flat_hashset_empty (const flat_hashset *hs);
+
+/**
+ * @brief Function to erase element
+ * from the flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @param val Element to erase.
+ */
+void flat_hashset_erase (flat_hashset *hs, constdptr val);
+
+/**
+ * @brief Function to insert new val into
+ * the flat_hashset or not if val already exist.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @param val Val to insert.
+ */
+void flat_hashset_insert (flat_hashset *hs, constdptr val);
+
+/**
+ * @brief Function to get load of flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @return float Size / Number of slots.
+ */
+float flat_hashset_load_factor (const flat_hashset *hs);
+
+/**
+ * @brief Function to get number of elements
+ * in flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ * @return size_t Number of elements in flat_hashset.
+ */
+size_t flat_hashset_size (const flat_hashset *hs);
+
+/**
+ * @brief Destructor for flat_hashset.
+ *
+ * @param hs Pointer to the instance of flat_hashset.
+ */
+void flat_hashset_destroy (flat_hashset *hs);
+
+#endif
@@ -1,5 +1,7 @@
 #include "forward_list.h"
 
+#include "pool_allocator.h"
+
 ////////////////////////////////////////////////////
 /*   Public API functions of the forward_list     */
 ////////////////////////////////////////////////////
@@ -7,10 +9,30 @@
 forward_list *
 forward_list_create ()
 {
-  forward_list *l = (forward_list *)malloc (sizeof (forward_list));
+  return forward_list_create_with_allocator (NULL);
+}
+
+forward_list *
+forward_list_create_with_allocator (const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  forward_list *l
+      = (forward_list *)allocator_allocate (&al, sizeof (forward_list));
 
   l->front = NULL;
   l->size = 0;
+  l->pool = NULL;
+  l->alloc = al;
+
+  return l;
+}
+
+forward_list *
+forward_list_create_with_pool (size_t nodes_number)
+{
+  forward_list *l = forward_list_create ();
+
+  l->pool = pool_allocator_create (sizeof (struct flnode), nodes_number);
 
   return l;
 }
@@ -26,11 +48,19 @@ forward_list_clear (forward_list *l, void (*destr) (dptr data))
 {
   struct flnode *tmp = l->front;
 
+  /* If all nodes are in the pool and there is no data to
+     destroy, releasing them at once. */
+  if (l->pool && !destr && pool_allocator_used (l->pool) == l->size)
+    {
+      pool_allocator_reset (l->pool);
+      tmp = NULL;
+    }
+
   /* Deleting all nodes. */
   while (tmp)
     {
       struct flnode *tmp_next = tmp->next;
-      __o_node_destroy (tmp, destr);
+      __o_node_destroy_from (l->pool, &l->alloc, tmp, destr);
       tmp = tmp_next;
     }
 
@@ -45,7 +75,7 @@ forward_list_copy (const forward_list *l, dptr (*cpy) (const dptr data))
   if (!l)
     return NULL;
   /* Creating dest forward list. */
-  forward_list *other = forward_list_create ();
+  forward_list *other = forward_list_create_with_allocator (&l->alloc);
   /* Copy values to dest forward list. */
   struct flnode *cur = l->front;
   struct flnode *cur_other = NULL;
@@ -99,10 +129,14 @@ forward_list_count_if (const forward_list *l,
 void
 forward_list_destroy (forward_list *l, void (*destr) (dptr data))
 {
-  /* Deleting all nodes. */
-  forward_list_clear (l, destr);
+  /* Deleting all nodes. Nodes in the pool are
+     freed with the pool itself. */
+  if (!l->pool || destr || pool_allocator_used (l->pool) != l->size)
+    forward_list_clear (l, destr);
+  if (l->pool)
+    pool_allocator_destroy (l->pool);
   /* Frees the memory for struct forward list. */
-  free (l);
+  allocator_deallocate (&l->alloc, l, sizeof (forward_list));
 }
 
 inline __attribute__ ((always_inline)) forward_list_iterator
@@ -149,7 +183,7 @@ forward_list_erase_after (forward_list *l, forward_list_iterator where,
   l->size--;
 
   /* Calling destructor. */
-  __o_node_destroy (tmp, destr);
+  __o_node_destroy_from (l->pool, &l->alloc, tmp, destr);
 }
 
 inline __attribute__ ((always_inline)) dptr
@@ -202,7 +236,7 @@ forward_list_insert_after (forward_list *l, forward_list_iterator where,
       return l->front;
     }
 
-  where->next = __o_node_create (data, where->next);
+  where->next = __o_node_create_from (l->pool, &l->alloc, data, where->next);
   l->size++;
 
   return where->next;
@@ -246,13 +280,13 @@ forward_list_pop_front (forward_list *l, void (*destr) (dptr data))
   l->front = tmp->next;
   l->size--;
 
-  __o_node_destroy (tmp, destr);
+  __o_node_destroy_from (l->pool, &l->alloc, tmp, destr);
 }
 
 inline void
 forward_list_push_front (forward_list *l, constdptr data)
 {
-  l->front = __o_node_create (data, l->front);
+  l->front = __o_node_create_from (l->pool, &l->alloc, data, l->front);
   l->size++;
 }
 
@@ -311,8 +345,16 @@ forward_list_size (const forward_list *l)
   return l->size;
 }
 
-void forward_list_sort (forward_list *l,
-                        int (*cmp) (constdptr first, constdptr second));
+void
+forward_list_sort (forward_list *l,
+                   int (*cmp) (constdptr first, constdptr second))
+{
+  if (!l || l->size < 2)
+    return;
+
+  l->front = __node_sort (l->front, offsetof (struct flnode, data),
+                          offsetof (struct flnode, next), cmp);
+}
 
 void forward_list_unique (forward_list *l,
                           bool (*predicate) (constdptr first,
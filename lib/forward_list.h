@@ -10,6 +10,7 @@
 #include <stddef.h>  // size_t
 #include <stdlib.h>  // malloc, free
 
+#include "allocator.h"
 #include "types.h"
 
 #define flnode o_node
@@ -35,6 +36,18 @@ typedef struct forward_list
    * @brief Pointer to the front of forward list.
    */
   struct flnode *front;
+
+  /**
+   * @brief Pool allocator for nodes. NULL if
+   * nodes are allocated by malloc.
+   */
+  struct pool_allocator *pool;
+
+  /**
+   * @brief Allocator of the forward list instance
+   * and nodes, that are not in the pool.
+   */
+  allocator alloc;
 } forward_list;
 
 ////////////////////////////////////////////////////
@@ -48,6 +61,26 @@ typedef struct forward_list
  */
 forward_list *forward_list_create ();
 
+/**
+ * @brief Function to create new forward list with pool of
+ * nodes. Allocates the memory. Should be destroyed at the end.
+ * Nodes are taken from own pool of <nodes_number> nodes and
+ * from malloc, when pool is exhausted. If all nodes are in the
+ * pool and there is no destructor, clear/destroy releases them at once.
+ * @param nodes_number Number of nodes in the pool.
+ * @return Pointer to new forward list.
+ */
+forward_list *forward_list_create_with_pool (size_t nodes_number);
+
+/**
+ * @brief Function to create new forward list, that takes
+ * memory for itself and its nodes from <alloc>.
+ * Should be destroyed at the end.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new forward list.
+ */
+forward_list *forward_list_create_with_allocator (const allocator *alloc);
+
 /**
  * @brief Function returns iterator to
  * first element.
@@ -303,7 +336,10 @@ void forward_list_reverse (forward_list *l);
 size_t forward_list_size (const forward_list *l);
 
 /**
- * @brief Function to sort the forward list.
+ * @brief Function to sort the forward list by natural
+ * merge sort. Nodes are relinked, data is not copied
+ * and no memory is allocated. Stable, O(n log n),
+ * sorted or reversed forward list takes O(n).
  *
  * @param l Pointer to the forward list.
  * @param cmp Function of comparing
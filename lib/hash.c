@@ -1,11 +1,266 @@
 #include "hash.h"
 
+#include <string.h> // memcpy
+#include <time.h>   // clock_gettime
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h> // _mm_crc32_u64, _mm_crc32_u8
+#endif
+
+#ifdef __linux__
+#include <sys/random.h> // getrandom
+#endif
+
+////////////////////////////////////////////////////
+/*          Private functions of the hash         */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Secret constants of wyhash.
+ */
+static const uint64_t __hash_wy_secret[4]
+    = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+        0x4d5a2da51de1aa47ull };
+
+#ifndef __SSE4_2__
+/**
+ * @brief Table for software CRC32C, one byte per step.
+ * Polynomial 0x82F63B78 (reflected).
+ */
+static const uint32_t __hash_crc32c_table[256] = {
+  0x00000000u, 0xf26b8303u, 0xe13b70f7u, 0x1350f3f4u,
+  0xc79a971fu, 0x35f1141cu, 0x26a1e7e8u, 0xd4ca64ebu,
+  0x8ad958cfu, 0x78b2dbccu, 0x6be22838u, 0x9989ab3bu,
+  0x4d43cfd0u, 0xbf284cd3u, 0xac78bf27u, 0x5e133c24u,
+  0x105ec76fu, 0xe235446cu, 0xf165b798u, 0x030e349bu,
+  0xd7c45070u, 0x25afd373u, 0x36ff2087u, 0xc494a384u,
+  0x9a879fa0u, 0x68ec1ca3u, 0x7bbcef57u, 0x89d76c54u,
+  0x5d1d08bfu, 0xaf768bbcu, 0xbc267848u, 0x4e4dfb4bu,
+  0x20bd8edeu, 0xd2d60dddu, 0xc186fe29u, 0x33ed7d2au,
+  0xe72719c1u, 0x154c9ac2u, 0x061c6936u, 0xf477ea35u,
+  0xaa64d611u, 0x580f5512u, 0x4b5fa6e6u, 0xb93425e5u,
+  0x6dfe410eu, 0x9f95c20du, 0x8cc531f9u, 0x7eaeb2fau,
+  0x30e349b1u, 0xc288cab2u, 0xd1d83946u, 0x23b3ba45u,
+  0xf779deaeu, 0x05125dadu, 0x1642ae59u, 0xe4292d5au,
+  0xba3a117eu, 0x4851927du, 0x5b016189u, 0xa96ae28au,
+  0x7da08661u, 0x8fcb0562u, 0x9c9bf696u, 0x6ef07595u,
+  0x417b1dbcu, 0xb3109ebfu, 0xa0406d4bu, 0x522bee48u,
+  0x86e18aa3u, 0x748a09a0u, 0x67dafa54u, 0x95b17957u,
+  0xcba24573u, 0x39c9c670u, 0x2a993584u, 0xd8f2b687u,
+  0x0c38d26cu, 0xfe53516fu, 0xed03a29bu, 0x1f682198u,
+  0x5125dad3u, 0xa34e59d0u, 0xb01eaa24u, 0x42752927u,
+  0x96bf4dccu, 0x64d4cecfu, 0x77843d3bu, 0x85efbe38u,
+  0xdbfc821cu, 0x2997011fu, 0x3ac7f2ebu, 0xc8ac71e8u,
+  0x1c661503u, 0xee0d9600u, 0xfd5d65f4u, 0x0f36e6f7u,
+  0x61c69362u, 0x93ad1061u, 0x80fde395u, 0x72966096u,
+  0xa65c047du, 0x5437877eu, 0x4767748au, 0xb50cf789u,
+  0xeb1fcbadu, 0x197448aeu, 0x0a24bb5au, 0xf84f3859u,
+  0x2c855cb2u, 0xdeeedfb1u, 0xcdbe2c45u, 0x3fd5af46u,
+  0x7198540du, 0x83f3d70eu, 0x90a324fau, 0x62c8a7f9u,
+  0xb602c312u, 0x44694011u, 0x5739b3e5u, 0xa55230e6u,
+  0xfb410cc2u, 0x092a8fc1u, 0x1a7a7c35u, 0xe811ff36u,
+  0x3cdb9bddu, 0xceb018deu, 0xdde0eb2au, 0x2f8b6829u,
+  0x82f63b78u, 0x709db87bu, 0x63cd4b8fu, 0x91a6c88cu,
+  0x456cac67u, 0xb7072f64u, 0xa457dc90u, 0x563c5f93u,
+  0x082f63b7u, 0xfa44e0b4u, 0xe9141340u, 0x1b7f9043u,
+  0xcfb5f4a8u, 0x3dde77abu, 0x2e8e845fu, 0xdce5075cu,
+  0x92a8fc17u, 0x60c37f14u, 0x73938ce0u, 0x81f80fe3u,
+  0x55326b08u, 0xa759e80bu, 0xb4091bffu, 0x466298fcu,
+  0x1871a4d8u, 0xea1a27dbu, 0xf94ad42fu, 0x0b21572cu,
+  0xdfeb33c7u, 0x2d80b0c4u, 0x3ed04330u, 0xccbbc033u,
+  0xa24bb5a6u, 0x502036a5u, 0x4370c551u, 0xb11b4652u,
+  0x65d122b9u, 0x97baa1bau, 0x84ea524eu, 0x7681d14du,
+  0x2892ed69u, 0xdaf96e6au, 0xc9a99d9eu, 0x3bc21e9du,
+  0xef087a76u, 0x1d63f975u, 0x0e330a81u, 0xfc588982u,
+  0xb21572c9u, 0x407ef1cau, 0x532e023eu, 0xa145813du,
+  0x758fe5d6u, 0x87e466d5u, 0x94b49521u, 0x66df1622u,
+  0x38cc2a06u, 0xcaa7a905u, 0xd9f75af1u, 0x2b9cd9f2u,
+  0xff56bd19u, 0x0d3d3e1au, 0x1e6dcdeeu, 0xec064eedu,
+  0xc38d26c4u, 0x31e6a5c7u, 0x22b65633u, 0xd0ddd530u,
+  0x0417b1dbu, 0xf67c32d8u, 0xe52cc12cu, 0x1747422fu,
+  0x49547e0bu, 0xbb3ffd08u, 0xa86f0efcu, 0x5a048dffu,
+  0x8ecee914u, 0x7ca56a17u, 0x6ff599e3u, 0x9d9e1ae0u,
+  0xd3d3e1abu, 0x21b862a8u, 0x32e8915cu, 0xc083125fu,
+  0x144976b4u, 0xe622f5b7u, 0xf5720643u, 0x07198540u,
+  0x590ab964u, 0xab613a67u, 0xb831c993u, 0x4a5a4a90u,
+  0x9e902e7bu, 0x6cfbad78u, 0x7fab5e8cu, 0x8dc0dd8fu,
+  0xe330a81au, 0x115b2b19u, 0x020bd8edu, 0xf0605beeu,
+  0x24aa3f05u, 0xd6c1bc06u, 0xc5914ff2u, 0x37faccf1u,
+  0x69e9f0d5u, 0x9b8273d6u, 0x88d28022u, 0x7ab90321u,
+  0xae7367cau, 0x5c18e4c9u, 0x4f48173du, 0xbd23943eu,
+  0xf36e6f75u, 0x0105ec76u, 0x12551f82u, 0xe03e9c81u,
+  0x34f4f86au, 0xc69f7b69u, 0xd5cf889du, 0x27a40b9eu,
+  0x79b737bau, 0x8bdcb4b9u, 0x988c474du, 0x6ae7c44eu,
+  0xbe2da0a5u, 0x4c4623a6u, 0x5f16d052u, 0xad7d5351u,
+};
+#endif
+
+/**
+ * @brief Function to multiply two 64bit numbers.
+ * Low half of the product is stored into <a>,
+ * high half into <b>.
+ *
+ * @param a First number.
+ * @param b Second number.
+ */
+inline static void
+__hash_mum (uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t)*a * *b;
+
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r >> 64);
+#else
+  uint64_t ha = *a >> 32, hb = *b >> 32;
+  uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32), c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/**
+ * @brief Function to mix two 64bit numbers.
+ *
+ * @param a First number.
+ * @param b Second number.
+ * @return uint64_t Xor of halves of the product.
+ */
+inline static uint64_t
+__hash_mix (uint64_t a, uint64_t b)
+{
+  __hash_mum (&a, &b);
+  return a ^ b;
+}
+
+/**
+ * @brief Function to read 8 bytes from unaligned address.
+ *
+ * @param p Address to read.
+ * @return uint64_t Read value.
+ */
+inline static uint64_t
+__hash_read8 (const uint8_t *p)
+{
+  uint64_t v;
+  memcpy (&v, p, sizeof (v));
+  return v;
+}
+
+/**
+ * @brief Function to read 4 bytes from unaligned address.
+ *
+ * @param p Address to read.
+ * @return uint64_t Read value.
+ */
+inline static uint64_t
+__hash_read4 (const uint8_t *p)
+{
+  uint32_t v;
+  memcpy (&v, p, sizeof (v));
+  return v;
+}
+
+/**
+ * @brief Function to read 1..3 bytes.
+ *
+ * @param p Address to read.
+ * @param len Number of bytes.
+ * @return uint64_t Read value.
+ */
+inline static uint64_t
+__hash_read3 (const uint8_t *p, size_t len)
+{
+  return ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+}
+
+/**
+ * @brief Function to finish wyhash from two last
+ * words of the key.
+ *
+ * @param a First word.
+ * @param b Second word.
+ * @param seed Current state.
+ * @param len Length of the key.
+ * @return hash64 Resulting hash.
+ */
+inline static hash64
+__hash_wy_finish (uint64_t a, uint64_t b, uint64_t seed, size_t len)
+{
+  a ^= __hash_wy_secret[1];
+  b ^= seed;
+  __hash_mum (&a, &b);
+
+  return __hash_mix (a ^ __hash_wy_secret[0] ^ len, b ^ __hash_wy_secret[1]);
+}
+
+/**
+ * @brief Function to prepare seed of wyhash.
+ *
+ * @param seed User's seed.
+ * @return uint64_t Initial state.
+ */
+inline static uint64_t
+__hash_wy_seed (uint64_t seed)
+{
+  return seed
+         ^ __hash_mix (seed ^ __hash_wy_secret[0], __hash_wy_secret[1]);
+}
+
+/**
+ * @brief Body of hash_short() with prepared seed.
+ *
+ * @param p Pointer to key.
+ * @param len Length of the key. Must be <= 16.
+ * @param seed Initial state.
+ * @return hash64 Resulting hash.
+ */
+inline static hash64
+__hash_short (const uint8_t *p, size_t len, uint64_t seed)
+{
+  uint64_t a, b;
+
+  // Two overlapping pairs of 4 byte loads cover 4..16 bytes.
+  if (len >= 4)
+    {
+      size_t shift = (len >> 3) << 2;
+
+      a = (__hash_read4 (p) << 32) | __hash_read4 (p + shift);
+      b = (__hash_read4 (p + len - 4) << 32)
+          | __hash_read4 (p + len - 4 - shift);
+    }
+  else if (len > 0)
+    {
+      a = __hash_read3 (p, len);
+      b = 0;
+    }
+  else
+    a = b = 0;
+
+  return __hash_wy_finish (a, b, seed, len);
+}
+
+////////////////////////////////////////////////////
+/*       Public API functions of the hash         */
+////////////////////////////////////////////////////
+
 hash32
 hash (constdptr key, size_t len)
 {
-  hash32 hash = 0;
+  return (hash32)hash_jenkins (key, len, 0);
+}
+
+hash64
+hash_jenkins (constdptr key, size_t len, uint64_t seed)
+{
+  hash32 hash = (hash32)seed ^ (hash32)(seed >> 32);
 
-  for (uint32_t i = 0; i < len; i++)
+  for (size_t i = 0; i < len; i++)
     {
       hash += ((char *)key)[i];
       hash += (hash << 10);
@@ -17,4 +272,111 @@ hash (constdptr key, size_t len)
   hash += (hash << 15);
 
   return hash;
-}
\ No newline at end of file
+}
+
+hash64
+hash_wy (constdptr key, size_t len, uint64_t seed)
+{
+  const uint8_t *p = (const uint8_t *)key;
+
+  seed = __hash_wy_seed (seed);
+
+  if (len <= 16)
+    return __hash_short (p, len, seed);
+
+  size_t i = len;
+
+  // Three independent lanes of 16 bytes for long keys.
+  if (i >= 48)
+    {
+      uint64_t see1 = seed, see2 = seed;
+
+      do
+        {
+          seed = __hash_mix (__hash_read8 (p) ^ __hash_wy_secret[1],
+                             __hash_read8 (p + 8) ^ seed);
+          see1 = __hash_mix (__hash_read8 (p + 16) ^ __hash_wy_secret[2],
+                             __hash_read8 (p + 24) ^ see1);
+          see2 = __hash_mix (__hash_read8 (p + 32) ^ __hash_wy_secret[3],
+                             __hash_read8 (p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        }
+      while (i >= 48);
+
+      seed ^= see1 ^ see2;
+    }
+
+  while (i > 16)
+    {
+      seed = __hash_mix (__hash_read8 (p) ^ __hash_wy_secret[1],
+                         __hash_read8 (p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+
+  // Last 16 bytes, may overlap with processed ones.
+  return __hash_wy_finish (__hash_read8 (p + i - 16),
+                           __hash_read8 (p + i - 8), seed, len);
+}
+
+hash64
+hash_short (constdptr key, size_t len, uint64_t seed)
+{
+  return __hash_short ((const uint8_t *)key, len, __hash_wy_seed (seed));
+}
+
+hash64
+hash_crc32c (constdptr key, size_t len, uint64_t seed)
+{
+  hash64 h = crc32c (key, len, (hash32)seed ^ (hash32)(seed >> 32));
+
+  // Spreading 32 bits of crc to the whole word.
+  h = (h ^ ((uint64_t)len << 32)) * 0x9e3779b97f4a7c15ull;
+
+  return h ^ (h >> 29);
+}
+
+hash32
+crc32c (constdptr data, size_t len, hash32 crc)
+{
+  const uint8_t *p = (const uint8_t *)data;
+
+  crc = ~crc;
+
+#ifdef __SSE4_2__
+  uint64_t crc64 = crc;
+
+  for (; len >= 8; len -= 8, p += 8)
+    crc64 = _mm_crc32_u64 (crc64, __hash_read8 (p));
+
+  crc = (uint32_t)crc64;
+
+  for (; len > 0; len--, p++)
+    crc = _mm_crc32_u8 (crc, *p);
+#else
+  for (; len > 0; len--, p++)
+    crc = __hash_crc32c_table[(crc ^ *p) & 0xff] ^ (crc >> 8);
+#endif
+
+  return ~crc;
+}
+
+uint64_t
+hash_random_seed (void)
+{
+  uint64_t seed = 0;
+
+#ifdef __linux__
+  if (getrandom (&seed, sizeof (seed), GRND_NONBLOCK) == sizeof (seed))
+    return seed;
+#endif
+
+  // Fallback: mixing time and addresses (ASLR).
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return __hash_mix ((uint64_t)ts.tv_nsec ^ ((uint64_t)ts.tv_sec << 32)
+                         ^ __hash_wy_secret[2],
+                     (uint64_t)(uintptr_t)&seed ^ __hash_wy_secret[3]);
+}
@@ -1,5 +1,5 @@
 /**
- * @file hash.h Implementation of hash algorithm
+ * @file hash.h Implementation of hash algorithms
  * for Hashset and Hashmap.
  */
 
@@ -16,6 +16,23 @@
  */
 typedef uint32_t hash32;
 
+/**
+ * @brief Alias for unsigned int 64 bits.
+ */
+typedef uint64_t hash64;
+
+/**
+ * @brief Type of the hash function, that can be
+ * passed to the containers.
+ *
+ * @param key Pointer to value to hash.
+ * @param len Length (size) of key.
+ * @param seed Seed of the hash. Different seeds give
+ * unrelated hashes for the same key.
+ * @return hash64 Resulting hash.
+ */
+typedef hash64 (*hash_func) (constdptr key, size_t len, uint64_t seed);
+
 /**
  * @brief Implementation of Jenkins's
  * hash function. Produce 32bit hash.
@@ -29,4 +46,75 @@ typedef uint32_t hash32;
  */
 hash32 hash (constdptr key, size_t len);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Seeded version of Jenkins's hash function.
+ * Processes one byte per step. hash_jenkins(key, len, 0)
+ * is equal to hash(key, len).
+ *
+ * @param key Pointer to value to hash.
+ * @param len Length (size) of key.
+ * @param seed Seed of the hash.
+ * @return hash64 Resulting 32bit hash.
+ */
+hash64 hash_jenkins (constdptr key, size_t len, uint64_t seed);
+
+/**
+ * @brief Fast 64bit hash function of wyhash family.
+ * Processes 16 bytes per step (48 for long keys) with
+ * 64x64->128 bit multiplication. Keys up to 16 bytes
+ * are handled by hash_short().
+ *
+ * @param key Pointer to value to hash.
+ * @param len Length (size) of key.
+ * @param seed Seed of the hash.
+ * @return hash64 Resulting hash.
+ */
+hash64 hash_wy (constdptr key, size_t len, uint64_t seed);
+
+/**
+ * @brief Specialization of hash_wy() for short keys
+ * (integers, pointers, short strings). Reads the key by
+ * at most four overlapping loads without loops.
+ * Gives the same result as hash_wy().
+ *
+ * @param key Pointer to value to hash.
+ * @param len Length (size) of key. Must be <= 16.
+ * @param seed Seed of the hash.
+ * @return hash64 Resulting hash.
+ */
+hash64 hash_short (constdptr key, size_t len, uint64_t seed);
+
+/**
+ * @brief Hash function based on CRC32C. Uses crc32
+ * instruction (8 bytes per step) if SSE4.2 is available.
+ * Very fast, but CRC is linear, so seed does not protect
+ * from crafted keys. Use hash_wy() for untrusted input.
+ *
+ * @param key Pointer to value to hash.
+ * @param len Length (size) of key.
+ * @param seed Seed of the hash.
+ * @return hash64 Resulting hash.
+ */
+hash64 hash_crc32c (constdptr key, size_t len, uint64_t seed);
+
+/**
+ * @brief Function to compute CRC32C (Castagnoli)
+ * checksum of the data.
+ *
+ * @param data Pointer to data.
+ * @param len Length (size) of data.
+ * @param crc Checksum of previous data, 0 at start.
+ * @return hash32 Resulting checksum.
+ */
+hash32 crc32c (constdptr data, size_t len, hash32 crc);
+
+/**
+ * @brief Function to get random seed for the hash
+ * function. Containers with random seed resist
+ * HashDoS attacks.
+ *
+ * @return uint64_t Random seed.
+ */
+uint64_t hash_random_seed (void);
+
+#endif
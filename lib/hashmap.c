@@ -5,31 +5,176 @@
 ////////////////////////////////////////////////////
 
 /**
- * @brief Function to calculate index
- * in buckets array by key.
+ * @brief Function to calculate hash of the key.
  *
  * @param hm Pointer to hashmap instance.
- * @param key Key to calculate index.
- * @param keysize Size of key.
- * @return hash32 Index for the key.
+ * @param key Key to hash.
+ * @return hash64 Hash of the key.
  */
-inline static hash32
-__hashmap_index_from_key (const hashmap *hm, constdptr key, size_t keysize)
+inline static hash64
+__hashmap_hash (const hashmap *hm, constdptr key)
 {
-  return hash (key, keysize) % hashmap_bucket_count (hm);
+  return hm->hash (key, hm->size_func (key), hm->seed);
 }
 
 /**
- * @brief Function to get bucket by index.
+ * @brief Function to get bucket by hash.
  *
  * @param hm Pointer to hashmap instance.
- * @param index Index to get bucket.
+ * @param h Hash of the key.
  * @return forward_list* Forward list of bucket.
  */
 inline static forward_list *
-__hashmap_bucket_by_index (const hashmap *hm, hash32 index)
+__hashmap_bucket_by_hash (const hashmap *hm, hash64 h)
 {
-  return array_at (hm->buckets, index);
+  return array_at (hm->buckets, h % hashmap_bucket_count (hm));
+}
+
+/**
+ * @brief Function to create new entry.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param key Key of the entry.
+ * @param val Value of the entry.
+ * @param h Hash of the key.
+ * @return struct __hashmap_entry* New entry.
+ */
+static struct __hashmap_entry *
+__hashmap_entry_create (const hashmap *hm, constdptr key, constdptr val,
+                        hash64 h)
+{
+  struct __hashmap_entry *entry
+      = (struct __hashmap_entry *)allocator_allocate (
+          &hm->alloc, sizeof (struct __hashmap_entry));
+
+  entry->pair.key = (dptr)key;
+  entry->pair.value = (dptr)val;
+  entry->hash = h;
+
+  return entry;
+}
+
+/**
+ * @brief Function to destroy entry. If hashmap owns
+ * entries, key and value are destroyed and entry is
+ * freed by hashmap, otherwise the whole entry is given
+ * to destructor of the user.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param entry Entry to destroy.
+ */
+inline static void
+__hashmap_entry_destroy (const hashmap *hm, dptr entry)
+{
+  if (!hm->free_entries)
+    {
+      hm->destr (entry);
+      return;
+    }
+
+  if (hm->key_destr)
+    hm->key_destr (((struct pair *)entry)->key);
+  if (hm->value_destr)
+    hm->value_destr (((struct pair *)entry)->value);
+  allocator_deallocate (&hm->alloc, entry, sizeof (struct __hashmap_entry));
+}
+
+/**
+ * @brief Function to destroy all entries of the bucket
+ * and its nodes.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param bucket Bucket to clear.
+ */
+static void
+__hashmap_bucket_clear (const hashmap *hm, forward_list *bucket)
+{
+  for (forward_list_iterator cur = forward_list_begin (bucket); cur;
+       cur = cur->next)
+    __hashmap_entry_destroy (hm, cur->data);
+
+  forward_list_clear (bucket, NULL);
+}
+
+/**
+ * @brief Function to find node of the bucket, that
+ * holds entry with <key> key. Comparator is called only
+ * for entries with the same hash.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param bucket Bucket to search.
+ * @param key Key to find.
+ * @param h Hash of the key.
+ * @param prev Pointer to store node before found one.
+ * Could be NULL.
+ * @return forward_list_iterator Node with entry or
+ * forward_list_end() if not found.
+ */
+static forward_list_iterator
+__hashmap_find_in_bucket (const hashmap *hm, const forward_list *bucket,
+                          constdptr key, hash64 h,
+                          forward_list_iterator *prev)
+{
+  struct pair pattern = { (dptr)key, NULL };
+  forward_list_iterator before = NULL;
+
+  for (forward_list_iterator cur = forward_list_begin (bucket); cur;
+       cur = cur->next)
+    {
+      struct __hashmap_entry *entry = (struct __hashmap_entry *)cur->data;
+
+      if (entry->hash == h && hm->cmp (&pattern, &entry->pair))
+        {
+          if (prev)
+            *prev = before;
+          return cur;
+        }
+      before = cur;
+    }
+
+  return forward_list_end ();
+}
+
+/**
+ * @brief Function to find node, that holds entry with
+ * <key> key. During incremental rehash checks both
+ * new and old buckets.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param key Key to find.
+ * @param h Hash of the key.
+ * @param bucket Pointer to store bucket, where
+ * node has been found (or new bucket if not found).
+ * @param prev Pointer to store node before found one.
+ * Could be NULL.
+ * @return forward_list_iterator Node with entry or
+ * forward_list_end() if not found.
+ */
+static forward_list_iterator
+__hashmap_find (const hashmap *hm, constdptr key, hash64 h,
+                forward_list **bucket, forward_list_iterator *prev)
+{
+  *bucket = __hashmap_bucket_by_hash (hm, h);
+
+  forward_list_iterator node
+      = __hashmap_find_in_bucket (hm, *bucket, key, h, prev);
+
+  if (node != forward_list_end () || !hm->old_buckets)
+    return node;
+
+  // Buckets before rehash_index are already moved.
+  size_t index = h % array_size (hm->old_buckets);
+
+  if (index < hm->rehash_index)
+    return forward_list_end ();
+
+  forward_list *old = array_at (hm->old_buckets, index);
+  node = __hashmap_find_in_bucket (hm, old, key, h, prev);
+
+  if (node != forward_list_end ())
+    *bucket = old;
+
+  return node;
 }
 
 /**
@@ -37,31 +182,161 @@ __hashmap_bucket_by_index (const hashmap *hm, hash32 index)
  * by key.
  *
  * @param hm Pointer to hashmap instance.
- * @param key Key to calculate index.
- * @param keysize Size of key.
+ * @param key Key to find.
  * @return struct pair* Pair of elements.
  */
-static struct pair *
-__hashmap_pair_by_key (const hashmap *hm, constdptr key, size_t keysize)
+inline static struct pair *
+__hashmap_pair_by_key (const hashmap *hm, constdptr key)
 {
-  // Calculating index of bucket by hash.
-  hash32 index = __hashmap_index_from_key (hm, key, keysize);
+  return hashmap_find_hashed (hm, key, __hashmap_hash (hm, key));
+}
 
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashmap_bucket_by_index (hm, index);
+/**
+ * @brief Function to create array of empty buckets.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param size Number of buckets.
+ * @return array* Array of buckets.
+ */
+static array *
+__hashmap_buckets_create (const hashmap *hm, size_t size)
+{
+  array *buckets = array_create_with_allocator (size, &hm->alloc);
 
-  struct pair pattern = { (dptr)key, NULL };
-  // Finding pair.
-  forward_list_iterator pair = forward_list_find (bucket, &pattern, hm->cmp);
+  // Creating every bucket.
+  for (size_t i = 0; i < size; i++)
+    array_push_back (buckets,
+                     (dptr *)forward_list_create_with_allocator (&hm->alloc));
 
-  if (pair != forward_list_end ())
-    return (struct pair *)(pair->data);
+  return buckets;
+}
 
-  return NULL;
+/**
+ * @brief Function to destroy array of buckets.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param buckets Array of buckets.
+ * @param entries true if entries should be destroyed.
+ */
+static void
+__hashmap_buckets_destroy (const hashmap *hm, array *buckets, bool entries)
+{
+  for (size_t i = 0; i < array_size (buckets); i++)
+    {
+      if (entries)
+        __hashmap_bucket_clear (hm, array_at (buckets, i));
+      forward_list_destroy (array_at (buckets, i), NULL);
+    }
+
+  array_destroy (buckets, NULL);
+}
+
+/**
+ * @brief Function to move all nodes of <old> bucket into
+ * current buckets. Nodes are relinked by cached hash,
+ * so there is no allocation, hashing or comparing.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param old Bucket to move.
+ */
+static void
+__hashmap_move_bucket (hashmap *hm, forward_list *old)
+{
+  forward_list_iterator cur = forward_list_begin (old);
+
+  while (cur)
+    {
+      forward_list_iterator next = cur->next;
+      forward_list *bucket = __hashmap_bucket_by_hash (
+          hm, ((struct __hashmap_entry *)cur->data)->hash);
+
+      cur->next = bucket->front;
+      bucket->front = cur;
+      bucket->size++;
+
+      cur = next;
+    }
+
+  // Old bucket is empty now.
+  old->front = NULL;
+  old->size = 0;
+}
+
+/**
+ * @brief Function to move up to <nbuckets> not empty
+ * old buckets into the new ones. Finishes rehash
+ * if all old buckets are moved.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param nbuckets Number of buckets to move.
+ */
+static void
+__hashmap_rehash_buckets (hashmap *hm, size_t nbuckets)
+{
+  size_t old_count = array_size (hm->old_buckets);
+
+  // Limiting number of visited empty buckets too.
+  size_t empty_visits = nbuckets * HASHMAP_REHASH_EMPTY_VISITS;
+
+  while (nbuckets > 0 && hm->rehash_index < old_count)
+    {
+      forward_list *old = array_at (hm->old_buckets, hm->rehash_index++);
+
+      if (!forward_list_empty (old))
+        {
+          __hashmap_move_bucket (hm, old);
+          nbuckets--;
+        }
+      else if (--empty_visits == 0)
+        break;
+    }
+
+  if (hm->rehash_index == old_count)
+    {
+      __hashmap_buckets_destroy (hm, hm->old_buckets, false);
+      hm->old_buckets = NULL;
+      hm->rehash_index = 0;
+    }
+}
+
+/**
+ * @brief Function to finish incremental rehash,
+ * if it is in progress.
+ *
+ * @param hm Pointer to hashmap instance.
+ */
+inline static void
+__hashmap_rehash_finish (hashmap *hm)
+{
+  while (hm->old_buckets)
+    __hashmap_rehash_buckets (hm, array_size (hm->old_buckets));
+}
+
+/**
+ * @brief Function to compute number of buckets, that
+ * holds <n> entries without exceeding max load factor.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param n Number of entries.
+ * @return size_t Number of buckets (at least 1).
+ */
+inline static size_t
+__hashmap_buckets_for (const hashmap *hm, size_t n)
+{
+  double exact = (double)n / hm->max_load_factor;
+  size_t count = (size_t)exact;
+
+  // Rounding up.
+  if ((double)count < exact)
+    count++;
+
+  return count ? count : 1;
 }
 
 /**
  * @brief Function of resizing array of buckets.
+ * In incremental mode old buckets are kept and moved
+ * by modifying operations, otherwise all at once.
  *
  * @param hm Pointer to hashmap instance.
  * @param size New size.
@@ -69,69 +344,206 @@ __hashmap_pair_by_key (const hashmap *hm, constdptr key, size_t keysize)
 static void
 __hashmap_resize_buckets_array (hashmap *hm, size_t size)
 {
+  // Only one rehash at time.
+  __hashmap_rehash_finish (hm);
+
   // Saving old buckets.
-  array *old_buckets = hm->buckets;
+  hm->old_buckets = hm->buckets;
+  hm->rehash_index = 0;
 
   // Creating new buckets.
-  hm->buckets = array_create (size);
+  hm->buckets = __hashmap_buckets_create (hm, size);
 
-  // Setting size = 0, because of new insertions.
-  hm->size = 0;
+  if (hm->rehash_step == 0)
+    __hashmap_rehash_finish (hm);
+}
 
-  // Creating every bucket.
-  for (size_t i = 0; i < size; i++)
-    array_push_back (hm->buckets, (dptr *)forward_list_create ());
+/**
+ * @brief Function to prefetch buckets of hashed keys.
+ * Bucket is reached through slot of <buckets> array,
+ * list header and the first node, so they are prefetched
+ * by separate passes. Every pass reads only lines, that
+ * previous pass has requested, and misses of all keys
+ * in the window overlap.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param hashes Hashes of the keys.
+ * @param count Number of hashes, not greater than
+ * HASHMAP_BATCH_WINDOW.
+ */
+static void
+__hashmap_prefetch_window (const hashmap *hm, const hash64 *hashes,
+                           size_t count)
+{
+  size_t index[HASHMAP_BATCH_WINDOW];
+  dptr *slots = hm->buckets->vec;
 
-  // Inserting every element from old buckets to new buckets.
-  for (size_t i = 0; i < array_size (old_buckets); i++)
+  for (size_t i = 0; i < count; i++)
     {
-      forward_list_iterator cur
-          = forward_list_begin ((forward_list *)array_at (old_buckets, i));
+      index[i] = hashes[i] % hashmap_bucket_count (hm);
+      __builtin_prefetch (slots + index[i]);
+    }
 
-      while (cur)
-        {
-          struct pair *cur_pair = (struct pair *)(cur->data);
-          hashmap_insert (hm, cur_pair->key, cur_pair->value);
-          cur = cur->next;
-        }
+  for (size_t i = 0; i < count; i++)
+    __builtin_prefetch (slots[index[i]]);
 
-      forward_list_destroy (array_at (old_buckets, i), hm->destr);
+  for (size_t i = 0; i < count; i++)
+    __builtin_prefetch (((forward_list *)slots[index[i]])->front);
+}
+
+/**
+ * @brief Function to find entry with already computed
+ * hash of the key, or insert new one with <val> value.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param key Key of the entry.
+ * @param val Value of the new entry.
+ * @param h Hash of the key.
+ * @param inserted Pointer to store true, if entry is new.
+ * @return struct pair* Found or inserted entry.
+ */
+static struct pair *
+__hashmap_emplace (hashmap *hm, constdptr key, constdptr val, hash64 h,
+                   bool *inserted)
+{
+  // Checking for existance.
+  forward_list *bucket;
+  forward_list_iterator former = __hashmap_find (hm, key, h, &bucket, NULL);
+
+  *inserted = former == forward_list_end ();
+  if (!*inserted)
+    return (struct pair *)(former->data);
+
+  // Checking if we need to increase array buckets's size.
+  if ((double)(hm->size + 1)
+      > (double)hm->max_load_factor * hashmap_bucket_count (hm))
+    {
+      size_t count
+          = hashmap_bucket_count (hm) * HASHMAP_INCREASE_BUCKETS_FACTOR;
+      size_t need = __hashmap_buckets_for (hm, hm->size + 1);
+
+      __hashmap_resize_buckets_array (hm, count > need ? count : need);
     }
 
-  array_destroy (old_buckets, NULL);
+  // Inserting new entry to the bucket of new table.
+  struct __hashmap_entry *entry = __hashmap_entry_create (hm, key, val, h);
+  forward_list_push_front (__hashmap_bucket_by_hash (hm, h), entry);
+  hm->size++;
+
+  return (struct pair *)entry;
 }
 
-////////////////////////////////////////////////////
-/*     Public API functions of the hashset        */
-////////////////////////////////////////////////////
+/**
+ * @brief Function to insert entry with already computed
+ * hash of the key, or update value of existing entry.
+ *
+ * @param hm Pointer to hashmap instance.
+ * @param key Key of the entry.
+ * @param val Value of the entry.
+ * @param h Hash of the key.
+ */
+inline static void
+__hashmap_insert_hashed (hashmap *hm, constdptr key, constdptr val, hash64 h)
+{
+  bool inserted;
+  struct pair *pair = __hashmap_emplace (hm, key, val, h, &inserted);
 
-hashmap *
-hashmap_create (bool (*cmp) (constdptr pair1, constdptr pair2),
-                size_t (*size_func) (constdptr key), void (*destr) (dptr pair))
+  // If exist => updating value.
+  if (!inserted)
+    pair->value = (dptr)val;
+}
+
+/**
+ * @brief Function to create hashmap without destructors.
+ * Constructors set destructors and ownership of entries.
+ *
+ * @param cmp Function to compare keys of the pair.
+ * @param size_func Function to compute size of the key.
+ * @param hash Hash function for keys.
+ * @param seed Seed of the hash function.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return hashmap* New hashmap.
+ */
+static hashmap *
+__hashmap_create (bool (*cmp) (constdptr pair1, constdptr pair2),
+                  size_t (*size_func) (constdptr key), hash_func hash,
+                  uint64_t seed, const allocator *alloc)
 {
-  // Allocation memory for the hashmap instance.
-  hashmap *hm = (hashmap *)malloc (sizeof (hashmap));
+  allocator al = allocator_or_default (alloc);
 
-  // Creating array of buckets..
-  hm->buckets = array_create (HASHMAP_STARTING_NUMBER_OF_BUCKETS);
+  // Allocation memory for the hashmap instance.
+  hashmap *hm = (hashmap *)allocator_allocate (&al, sizeof (hashmap));
+  hm->alloc = al;
 
-  // Creating buckets (forward lists).
-  for (size_t i = 0; i < HASHMAP_STARTING_NUMBER_OF_BUCKETS; i++)
-    array_push_back (hm->buckets, (dptr *)forward_list_create ());
+  // Creating array of buckets (forward lists).
+  hm->buckets
+      = __hashmap_buckets_create (hm, HASHMAP_STARTING_NUMBER_OF_BUCKETS);
 
   hm->size = 0;
 
+  // Incremental rehash is disabled by default.
+  hm->old_buckets = NULL;
+  hm->rehash_index = 0;
+  hm->rehash_step = 0;
+
+  hm->max_load_factor = HASHMAP_DEFAULT_MAX_LOAD_FACTOR;
+
   // Setting compare func for keys.
   hm->cmp = cmp;
 
   // Setting sizeof-func for keys.
   hm->size_func = size_func;
 
-  // Setting destructor for the pair, provided by user.
-  if (destr)
-    hm->destr = destr;
-  else
-    hm->destr = pair_destroy_default;
+  // Setting hash function and its seed.
+  hm->hash = hash;
+  hm->seed = seed;
+
+  return hm;
+}
+
+////////////////////////////////////////////////////
+/*     Public API functions of the hashset        */
+////////////////////////////////////////////////////
+
+hashmap *
+hashmap_create (bool (*cmp) (constdptr pair1, constdptr pair2),
+                size_t (*size_func) (constdptr key), void (*destr) (dptr pair))
+{
+  return hashmap_create_with_hash (cmp, size_func, destr, hash_jenkins, 0);
+}
+
+hashmap *
+hashmap_create_with_hash (bool (*cmp) (constdptr pair1, constdptr pair2),
+                          size_t (*size_func) (constdptr key),
+                          void (*destr) (dptr pair), hash_func hash,
+                          uint64_t seed)
+{
+  hashmap *hm = __hashmap_create (cmp, size_func, hash, seed, NULL);
+
+  // Entries are freed by destructor, provided by user.
+  hm->destr = destr ? destr : pair_destroy_default;
+  hm->key_destr = NULL;
+  hm->value_destr = NULL;
+  hm->free_entries = false;
+
+  return hm;
+}
+
+hashmap *
+hashmap_create_with_allocator (bool (*cmp) (constdptr pair1, constdptr pair2),
+                               size_t (*size_func) (constdptr key),
+                               void (*key_destr) (dptr key),
+                               void (*value_destr) (dptr value),
+                               hash_func hash, uint64_t seed,
+                               const allocator *alloc)
+{
+  hashmap *hm = __hashmap_create (cmp, size_func, hash, seed, alloc);
+
+  // Entries are freed by hashmap, key and value by user.
+  hm->destr = NULL;
+  hm->key_destr = key_destr;
+  hm->value_destr = value_destr;
+  hm->free_entries = true;
 
   return hm;
 }
@@ -140,7 +552,7 @@ dptr
 hashmap_at (const hashmap *hm, constdptr key)
 {
   // Getting pair by key.
-  struct pair *pair = __hashmap_pair_by_key (hm, key, hm->size_func (key));
+  struct pair *pair = __hashmap_pair_by_key (hm, key);
 
   // If pair exist, returning its value.
   if (pair)
@@ -150,10 +562,38 @@ hashmap_at (const hashmap *hm, constdptr key)
   return NULL;
 }
 
+void
+hashmap_at_batch (const hashmap *hm, const constdptr *keys, dptr *vals,
+                  size_t n)
+{
+  hash64 hashes[HASHMAP_BATCH_WINDOW];
+
+  for (size_t start = 0; start < n; start += HASHMAP_BATCH_WINDOW)
+    {
+      size_t count = n - start < HASHMAP_BATCH_WINDOW ? n - start
+                                                      : HASHMAP_BATCH_WINDOW;
+
+      for (size_t i = 0; i < count; i++)
+        hashes[i] = __hashmap_hash (hm, keys[start + i]);
+      __hashmap_prefetch_window (hm, hashes, count);
+
+      for (size_t i = 0; i < count; i++)
+        {
+          forward_list *bucket;
+          forward_list_iterator node = __hashmap_find (
+              hm, keys[start + i], hashes[i], &bucket, NULL);
+
+          vals[start + i] = node != forward_list_end ()
+                                ? ((struct pair *)(node->data))->value
+                                : NULL;
+        }
+    }
+}
+
 inline size_t
 hashmap_bucket (const hashmap *hm, constdptr key)
 {
-  return (size_t)__hashmap_index_from_key (hm, key, hm->size_func (key));
+  return (size_t)(__hashmap_hash (hm, key) % hashmap_bucket_count (hm));
 }
 
 inline size_t
@@ -173,7 +613,15 @@ hashmap_clear (hashmap *hm)
 {
   // Calling clear func for every bucket.
   for (size_t i = 0; i < array_size (hm->buckets); i++)
-    forward_list_clear (array_at (hm->buckets, i), hm->destr);
+    __hashmap_bucket_clear (hm, array_at (hm->buckets, i));
+
+  // Dropping rehash in progress.
+  if (hm->old_buckets)
+    {
+      __hashmap_buckets_destroy (hm, hm->old_buckets, true);
+      hm->old_buckets = NULL;
+      hm->rehash_index = 0;
+    }
 
   // Setting size = 0
   hm->size = 0;
@@ -182,7 +630,7 @@ hashmap_clear (hashmap *hm)
 inline bool
 hashmap_contains (const hashmap *hm, constdptr key)
 {
-  return __hashmap_pair_by_key (hm, key, hm->size_func (key)) != NULL;
+  return __hashmap_pair_by_key (hm, key) != NULL;
 }
 
 inline __attribute__ ((always_inline)) bool
@@ -191,54 +639,102 @@ hashmap_empty (const hashmap *hm)
   return hm->size == 0;
 }
 
-void
+struct pair *
+hashmap_emplace_hashed (hashmap *hm, constdptr key, hash64 h, bool *inserted)
+{
+  // Making step of incremental rehash.
+  if (hm->old_buckets)
+    __hashmap_rehash_buckets (hm, hm->rehash_step);
+
+  return __hashmap_emplace (hm, key, NULL, h, inserted);
+}
+
+inline void
 hashmap_erase (hashmap *hm, constdptr key)
 {
-  // Calculating index of bucket by hash.
-  hash32 index = __hashmap_index_from_key (hm, key, hm->size_func (key));
+  hashmap_erase_hashed (hm, key, __hashmap_hash (hm, key));
+}
+
+void
+hashmap_erase_hashed (hashmap *hm, constdptr key, hash64 h)
+{
+  // Making step of incremental rehash.
+  if (hm->old_buckets)
+    __hashmap_rehash_buckets (hm, hm->rehash_step);
 
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashmap_bucket_by_index (hm, index);
+  // Finding node, its bucket and node before it.
+  forward_list *bucket;
+  forward_list_iterator prev = NULL;
+  forward_list_iterator node = __hashmap_find (hm, key, h, &bucket, &prev);
 
-  // Creating fake pair to set pattern to search.
-  struct pair pattern = { (dptr)key, NULL };
+  if (node == forward_list_end ())
+    return;
 
   // Removing element by key.
-  forward_list_remove (bucket, &pattern, hm->cmp, hm->destr);
+  dptr entry = node->data;
+  forward_list_erase_after (bucket, prev, NULL);
+  __hashmap_entry_destroy (hm, entry);
   hm->size--;
 }
 
+struct pair *
+hashmap_find_hashed (const hashmap *hm, constdptr key, hash64 h)
+{
+  forward_list *bucket;
+  forward_list_iterator node = __hashmap_find (hm, key, h, &bucket, NULL);
+
+  if (node != forward_list_end ())
+    return (struct pair *)(node->data);
+
+  return NULL;
+}
+
+inline hash64
+hashmap_hash (const hashmap *hm, constdptr key)
+{
+  return __hashmap_hash (hm, key);
+}
+
 void
 hashmap_insert (hashmap *hm, constdptr key, constdptr val)
 {
-  // Checking if we need to increase array buckets's size.
-  if (hashmap_bucket_count (hm) == hm->size)
-    __hashmap_resize_buckets_array (hm, hm->size
-                                            * HASHMAP_INCREASE_BUCKETS_FACTOR);
+  // Making step of incremental rehash.
+  if (hm->old_buckets)
+    __hashmap_rehash_buckets (hm, hm->rehash_step);
 
-  // Calculating index of bucket by hash.
-  hash32 index = __hashmap_index_from_key (hm, key, hm->size_func (key));
-
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashmap_bucket_by_index (hm, index);
+  __hashmap_insert_hashed (hm, key, val, __hashmap_hash (hm, key));
+}
 
-  // Creating pattern to find
-  struct pair pattern = { (dptr)key, NULL };
+void
+hashmap_insert_batch (hashmap *hm, const constdptr *keys,
+                      const constdptr *vals, size_t n)
+{
+  hash64 hashes[HASHMAP_BATCH_WINDOW];
 
-  // Checking for existance.
-  forward_list_iterator former = forward_list_find (bucket, &pattern, hm->cmp);
+  // Finishing rehash and making room for all keys
+  // at once, so no bucket moves during the batch.
+  __hashmap_rehash_finish (hm);
+  hashmap_reserve (hm, hm->size + n);
 
-  // If not exist => Inserting new pair to the bucket.
-  if (former == forward_list_end ())
+  for (size_t start = 0; start < n; start += HASHMAP_BATCH_WINDOW)
     {
-      // Creating new pair from <key> and <val>
-      struct pair *pair = pair_create (key, val);
-      forward_list_push_front (bucket, (constdptr)pair);
-      hm->size++;
-      return;
+      size_t count = n - start < HASHMAP_BATCH_WINDOW ? n - start
+                                                      : HASHMAP_BATCH_WINDOW;
+
+      for (size_t i = 0; i < count; i++)
+        hashes[i] = __hashmap_hash (hm, keys[start + i]);
+      __hashmap_prefetch_window (hm, hashes, count);
+
+      for (size_t i = 0; i < count; i++)
+        __hashmap_insert_hashed (hm, keys[start + i],
+                                 vals ? vals[start + i] : NULL, hashes[i]);
     }
-  // Else, updating value
-  ((struct pair *)(former->data))->value = (dptr)val;
+}
+
+inline bool
+hashmap_is_rehashing (const hashmap *hm)
+{
+  return hm->old_buckets != NULL;
 }
 
 inline float
@@ -247,7 +743,76 @@ hashmap_load_factor (const hashmap *hm)
   return (float)hashmap_size (hm) / hashmap_bucket_count (hm);
 }
 
-void hashmap_rehash (hashmap *hm);
+inline float
+hashmap_max_load_factor (const hashmap *hm)
+{
+  return hm->max_load_factor;
+}
+
+void
+hashmap_rehash (hashmap *hm, size_t count)
+{
+  size_t need = __hashmap_buckets_for (hm, hm->size);
+
+  if (count < need)
+    count = need;
+
+  // Rebuilding buckets at once, even in incremental mode.
+  if (count != hashmap_bucket_count (hm))
+    __hashmap_resize_buckets_array (hm, count);
+
+  __hashmap_rehash_finish (hm);
+}
+
+bool
+hashmap_rehash_step (hashmap *hm, size_t nbuckets)
+{
+  if (hm->old_buckets)
+    __hashmap_rehash_buckets (hm, nbuckets);
+
+  return hashmap_is_rehashing (hm);
+}
+
+void
+hashmap_reserve (hashmap *hm, size_t n)
+{
+  size_t need = __hashmap_buckets_for (hm, n);
+
+  // Never shrinking here.
+  if (need > hashmap_bucket_count (hm))
+    hashmap_rehash (hm, need);
+}
+
+void
+hashmap_set_max_load_factor (hashmap *hm, float ml)
+{
+  // Rejecting values <= 0 and NaN, they would break
+  // computing number of buckets.
+  if (!(ml > 0))
+    return;
+
+  hm->max_load_factor = ml;
+
+  // Growing if current load exceeds new maximum.
+  if (hashmap_load_factor (hm) > ml)
+    hashmap_rehash (hm, 0);
+}
+
+inline void
+hashmap_set_rehash_step (hashmap *hm, size_t step)
+{
+  hm->rehash_step = step;
+
+  // Switching off incremental mode finishes current rehash.
+  if (step == 0)
+    __hashmap_rehash_finish (hm);
+}
+
+void
+hashmap_shrink_to_fit (hashmap *hm)
+{
+  hashmap_rehash (hm, 0);
+}
 
 inline __attribute__ ((always_inline)) size_t
 hashmap_size (const hashmap *hm)
@@ -258,13 +823,13 @@ hashmap_size (const hashmap *hm)
 void
 hashmap_destroy (hashmap *hm)
 {
-  // Destoying buckets.
-  for (size_t i = 0; i < array_size (hm->buckets); i++)
-    forward_list_destroy (array_at (hm->buckets, i), hm->destr);
+  // Destoying buckets and array of buckets.
+  __hashmap_buckets_destroy (hm, hm->buckets, true);
 
-  // Destroying Destroying Array of buckets.
-  array_destroy (hm->buckets, NULL);
+  // Destroying old buckets, if rehash is in progress.
+  if (hm->old_buckets)
+    __hashmap_buckets_destroy (hm, hm->old_buckets, true);
 
   // Destroying hashtable instance.
-  free (hm);
+  allocator_deallocate (&hm->alloc, hm, sizeof (hashmap));
 }
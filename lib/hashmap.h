@@ -9,6 +9,7 @@
 #include <stdbool.h> // bool
 #include <stdlib.h>  //malloc, free
 
+#include "allocator.h"
 #include "array.h"
 #include "forward_list.h"
 #include "hash.h"
@@ -16,6 +17,39 @@
 
 #define HASHMAP_STARTING_NUMBER_OF_BUCKETS 5
 #define HASHMAP_INCREASE_BUCKETS_FACTOR 2
+#define HASHMAP_DEFAULT_MAX_LOAD_FACTOR 1.0f
+
+/**
+ * @brief Number of keys, that batch functions hash
+ * and prefetch before probing.
+ */
+#define HASHMAP_BATCH_WINDOW 16
+
+/**
+ * @brief Number of empty buckets, that incremental rehash
+ * may skip per one bucket to move.
+ */
+#define HASHMAP_REHASH_EMPTY_VISITS 10
+
+/**
+ * @struct __hashmap_entry
+ * @brief Entry of the hashmap. Pair goes first, so
+ * pointer to entry is pointer to pair for cmp() and destr().
+ */
+struct __hashmap_entry
+{
+  /**
+   * @brief Key and value of the entry.
+   */
+  struct pair pair;
+
+  /**
+   * @brief Cached hash of the key.
+   * Needs to move entry on resize
+   * without hashing and comparing.
+   */
+  hash64 hash;
+};
 
 /**
  * @struct hashmap.
@@ -30,10 +64,34 @@ typedef struct hashmap
 
   /**
    * @brief Array that contains
-   * instances of forward_list.
+   * instances of forward_list
+   * of struct __hashmap_entry.
    */
   array *buckets;
 
+  /**
+   * @brief Buckets, that are being moved by incremental
+   * rehash. NULL if rehash is not in progress.
+   */
+  array *old_buckets;
+
+  /**
+   * @brief Index of the next old bucket to move.
+   */
+  size_t rehash_index;
+
+  /**
+   * @brief Number of buckets to move per insert or
+   * erase. 0 if incremental rehash is disabled.
+   */
+  size_t rehash_step;
+
+  /**
+   * @brief Maximum average number of entries per bucket.
+   * Buckets grow, when insert would exceed it.
+   */
+  float max_load_factor;
+
   /**
    * @brief Compare function for keys
    * of the pair.
@@ -48,10 +106,47 @@ typedef struct hashmap
    */
   size_t (*size_func) (constdptr);
 
+  /**
+   * @brief Hash function for keys.
+   */
+  hash_func hash;
+
+  /**
+   * @brief Seed of the hash function.
+   */
+  uint64_t seed;
+
   /**
    * @brief Destructor for pairs.
+   * Receives pointer to the entry, that
+   * was allocated by hashmap, so should free it.
+   * Used only, if <free_entries> isn't set.
    */
   void (*destr) (dptr);
+
+  /**
+   * @brief Destructor for keys, NULL if they should
+   * not be freed. Used only, if <free_entries> is set.
+   */
+  void (*key_destr) (dptr);
+
+  /**
+   * @brief Destructor for values, NULL if they should
+   * not be freed. Used only, if <free_entries> is set.
+   */
+  void (*value_destr) (dptr);
+
+  /**
+   * @brief Allocator of the hashmap instance,
+   * buckets, their nodes and entries.
+   */
+  allocator alloc;
+
+  /**
+   * @brief true if entries are freed by hashmap through
+   * <alloc> after <key_destr> and <value_destr>.
+   */
+  bool free_entries;
 } hashmap;
 
 ////////////////////////////////////////////////////
@@ -60,7 +155,7 @@ typedef struct hashmap
 
 /**
  * @brief Function to create new hashmap. Allocates the memory. Should be
- * destroyed at the end.
+ * destroyed at the end. Keys are hashed by hash().
  * @param pair_keys_cmp Function to compare keys of
  * the pair.
  * Return true if key1 == key2.
@@ -75,6 +170,55 @@ hashmap *hashmap_create (bool (*pair_keys_cmp) (constdptr pair1,
                          size_t (*size_func) (constdptr key),
                          void (*destr) (dptr pair));
 
+/**
+ * @brief Function to create new hashmap with custom hash
+ * function. Allocates the memory. Should be destroyed at the end.
+ * @param pair_keys_cmp Function to compare keys of
+ * the pair.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param destr Destructor for elements.
+ * @param hash Hash function for keys.
+ * @param seed Seed of the hash function. Use hash_random_seed()
+ * for tables with untrusted keys.
+ * @return Pointer to new hashmap.
+ */
+hashmap *hashmap_create_with_hash (bool (*pair_keys_cmp) (constdptr pair1,
+                                                          constdptr pair2),
+                                   size_t (*size_func) (constdptr key),
+                                   void (*destr) (dptr pair), hash_func hash,
+                                   uint64_t seed);
+
+/**
+ * @brief Function to create new hashmap, that takes memory
+ * for itself, buckets, their nodes and entries from <alloc>.
+ * Should be destroyed at the end. Unlike hashmap_create(),
+ * entries are owned and freed by hashmap, so there is no
+ * destructor for the whole pair, but separate destructors
+ * for its key and value, like in flat_hashmap.
+ * @param pair_keys_cmp Function to compare keys of
+ * the pair.
+ * Return true if key1 == key2.
+ * Return false if key1 != key2.
+ * @param size_func Function to compute
+ * size of the key.
+ * @param key_destr Destructor for keys.
+ * Null if should not be freed.
+ * @param value_destr Destructor for values.
+ * Null if should not be freed.
+ * @param hash Hash function for keys.
+ * @param seed Seed of the hash function.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new hashmap.
+ */
+hashmap *hashmap_create_with_allocator (
+    bool (*pair_keys_cmp) (constdptr pair1, constdptr pair2),
+    size_t (*size_func) (constdptr key), void (*key_destr) (dptr key),
+    void (*value_destr) (dptr value), hash_func hash, uint64_t seed,
+    const allocator *alloc);
+
 /**
  * @brief Function to get value by key from the
  * hashmap.
@@ -85,6 +229,21 @@ hashmap *hashmap_create (bool (*pair_keys_cmp) (constdptr pair1,
  */
 dptr hashmap_at (const hashmap *hm, constdptr key);
 
+/**
+ * @brief Function to get values of <n> keys. Keys are
+ * hashed and their buckets are prefetched by windows of
+ * HASHMAP_BATCH_WINDOW, so cache misses of independent
+ * keys overlap.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param keys Array of <n> keys for searching.
+ * @param vals Array of <n> values to fill. NULL for
+ * keys, that are not in hashmap.
+ * @param n Number of keys.
+ */
+void hashmap_at_batch (const hashmap *hm, const constdptr *keys, dptr *vals,
+                       size_t n);
+
 /**
  * @brief Function to get number of bucket for
  * <key> key.
@@ -133,6 +292,22 @@ void hashmap_clear (hashmap *hm);
  */
 bool hashmap_contains (const hashmap *hm, constdptr key);
 
+/**
+ * @brief Function to find pair by key with hash, computed
+ * by caller, or insert new pair with NULL value. Needs one
+ * lookup for "insert if absent" and "compute if absent".
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param key Key of the pair.
+ * @param h Hash of the key. Should be equal to
+ * hashmap_hash (hm, key).
+ * @param inserted Pointer to store true, if pair is new.
+ * @return struct pair* Found or inserted pair. Its value
+ * could be changed, its key should not.
+ */
+struct pair *hashmap_emplace_hashed (hashmap *hm, constdptr key, hash64 h,
+                                     bool *inserted);
+
 /**
  * @brief Function to check if hashmap is empty.
  *
@@ -144,13 +319,51 @@ bool hashmap_empty (const hashmap *hm);
 
 /**
  * @brief Function to erase pair by key
- * from the hashmap.
+ * from the hashmap. Does nothing if key
+ * is not in hashmap.
  *
  * @param hm Pointer to the instance of hashmap.
  * @param key Key to find element to erase.
  */
 void hashmap_erase (hashmap *hm, constdptr key);
 
+/**
+ * @brief Function to erase pair by key with hash,
+ * computed by caller. Works like hashmap_erase().
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param key Key to find element to erase.
+ * @param h Hash of the key. Should be equal to
+ * hashmap_hash (hm, key).
+ */
+void hashmap_erase_hashed (hashmap *hm, constdptr key, hash64 h);
+
+/**
+ * @brief Function to find pair by key with hash,
+ * computed by caller. Unlike hashmap_at(), tells apart
+ * absent key and key with NULL value.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param key Key for searching.
+ * @param h Hash of the key. Should be equal to
+ * hashmap_hash (hm, key).
+ * @return struct pair* Pair with the key, or NULL
+ * if key is not in hashmap.
+ */
+struct pair *hashmap_find_hashed (const hashmap *hm, constdptr key,
+                                  hash64 h);
+
+/**
+ * @brief Function to get hash of the key, the same as
+ * hashmap uses. Hash could be computed once and passed
+ * to *_hashed functions.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param key Key to hash.
+ * @return hash64 Hash of the key.
+ */
+hash64 hashmap_hash (const hashmap *hm, constdptr key);
+
 /**
  * @brief Function to insert new pair of key, val into
  * the hashmap, or update existing pair.
@@ -161,6 +374,31 @@ void hashmap_erase (hashmap *hm, constdptr key);
  */
 void hashmap_insert (hashmap *hm, constdptr key, constdptr val);
 
+/**
+ * @brief Function to insert <n> pairs of keys and values.
+ * Reserves buckets for all of them first, then hashes keys
+ * and prefetches their buckets by windows of
+ * HASHMAP_BATCH_WINDOW. Works like hashmap_insert() for
+ * every pair in order.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param keys Array of <n> keys.
+ * @param vals Array of <n> values. NULL to insert NULL values.
+ * @param n Number of pairs.
+ */
+void hashmap_insert_batch (hashmap *hm, const constdptr *keys,
+                           const constdptr *vals, size_t n);
+
+/**
+ * @brief Function to check if incremental rehash
+ * is in progress.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @return true If old buckets are still being moved.
+ * @return false Otherwise.
+ */
+bool hashmap_is_rehashing (const hashmap *hm);
+
 /**
  * @brief Function to get load of hashmap.
  *
@@ -170,11 +408,79 @@ void hashmap_insert (hashmap *hm, constdptr key, constdptr val);
 float hashmap_load_factor (const hashmap *hm);
 
 /**
- * @brief Function to rehash hashmap.
+ * @brief Function to get maximum load factor.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @return float Maximum load factor.
+ */
+float hashmap_max_load_factor (const hashmap *hm);
+
+/**
+ * @brief Function to rebuild buckets of hashmap with
+ * <count> buckets, or with minimal number of buckets,
+ * that keeps load factor <= max load factor, if it
+ * is bigger. Finishes incremental rehash.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param count Wanted number of buckets.
+ */
+void hashmap_rehash (hashmap *hm, size_t count);
+
+/**
+ * @brief Function to move up to <nbuckets> buckets
+ * of incremental rehash in progress. Lets to finish
+ * rehash, when there are no inserts and erases.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param nbuckets Number of buckets to move.
+ * @return true If rehash is still in progress.
+ * @return false If rehash is finished.
+ */
+bool hashmap_rehash_step (hashmap *hm, size_t nbuckets);
+
+/**
+ * @brief Function to prepare hashmap for <n> entries,
+ * so inserting them causes no resize. Does nothing
+ * if there are enough buckets already.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param n Number of entries.
+ */
+void hashmap_reserve (hashmap *hm, size_t n);
+
+/**
+ * @brief Function to set maximum load factor.
+ * Rehashes hashmap, if current load factor exceeds it.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param ml New maximum load factor. Values <= 0
+ * and NaN are ignored, old maximum stays.
+ */
+void hashmap_set_max_load_factor (hashmap *hm, float ml);
+
+/**
+ * @brief Function to enable incremental rehash (like in
+ * Redis dict). When buckets array grows, old buckets are
+ * kept and every insert and erase moves <step> of them into
+ * the new ones, so no operation pays for the whole resize.
+ * Lookups check both arrays, but never move buckets, so they
+ * stay read-only. hashmap_bucket(), hashmap_bucket_count() and
+ * hashmap_bucket_size() describe new buckets only.
+ *
+ * @param hm Pointer to the instance of hashmap.
+ * @param step Number of buckets to move per operation.
+ * 0 disables incremental rehash (default) and finishes
+ * current one.
+ */
+void hashmap_set_rehash_step (hashmap *hm, size_t step);
+
+/**
+ * @brief Function to reduce number of buckets to
+ * minimal one, that fits current entries.
  *
  * @param hm Pointer to the instance of hashmap.
  */
-void hashmap_rehash (hashmap *hm);
+void hashmap_shrink_to_fit (hashmap *hm);
 
 /**
  * @brief Function to get number of elements
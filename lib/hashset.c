@@ -5,97 +5,266 @@
 ////////////////////////////////////////////////////
 
 /**
- * @brief Function to calculate index
- * in buckets array by value.
+ * @brief Function to calculate hash of the element.
  *
  * @param hs Pointer to hashset instance.
- * @param val element to calculate index.
- * @param valsize Size of element.
- * @return hash32 Index for the element.
+ * @param val Element to hash.
+ * @return hash64 Hash of the element.
  */
-inline static hash32
-__hashset_index_from_val (const hashset *hs, constdptr val, size_t valsize)
+inline static hash64
+__hashset_hash (const hashset *hs, constdptr val)
 {
-  return hash (val, valsize) % hashset_bucket_count (hs);
+  return hs->hash (val, hs->size_func (val), hs->seed);
 }
 
 /**
- * @brief Function to get bucket by index.
+ * @brief Function to get bucket by hash.
  *
  * @param hs Pointer to hashset instance.
- * @param index Index to get bucket.
+ * @param h Hash of the element.
  * @return forward_list* Forward list of bucket.
  */
 inline static forward_list *
-__hashset_bucket_by_index (const hashset *hs, hash32 index)
+__hashset_bucket_by_hash (const hashset *hs, hash64 h)
 {
-  return array_at (hs->buckets, index);
+  return array_at (hs->buckets, h % hashset_bucket_count (hs));
 }
 
 /**
- * @brief Function to get value.
+ * @brief Function to find node of the bucket, that
+ * holds <val> element.
  *
- * @param hs Pointer to hashmap instance.
- * @param val Val to get.
- * @param valsize Size of val.
- * @return dptr Val or NULL.
+ * @param hs Pointer to hashset instance.
+ * @param bucket Bucket to search.
+ * @param val Element to find.
+ * @param prev Pointer to store node before found one.
+ * Could be NULL.
+ * @return forward_list_iterator Node with element or
+ * forward_list_end() if not found.
  */
-dptr
-__hashmap_get_value (const hashset *hs, constdptr val, size_t valsize)
+static forward_list_iterator
+__hashset_find_in_bucket (const hashset *hs, const forward_list *bucket,
+                          constdptr val, forward_list_iterator *prev)
 {
-  // Calculating index of bucket by hash.
-  hash32 index = __hashset_index_from_val (hs, val, valsize);
+  forward_list_iterator before = NULL;
 
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashset_bucket_by_index (hs, index);
+  for (forward_list_iterator cur = forward_list_begin (bucket); cur;
+       cur = cur->next)
+    {
+      if (hs->cmp (val, cur->data))
+        {
+          if (prev)
+            *prev = before;
+          return cur;
+        }
+      before = cur;
+    }
 
-  // Finding pair.
-  forward_list_iterator value = forward_list_find (bucket, val, hs->cmp);
+  return forward_list_end ();
+}
 
-  if (value != forward_list_end ())
-    return value->data;
+/**
+ * @brief Function to find node, that holds <val>
+ * element. During incremental rehash checks both
+ * new and old buckets.
+ *
+ * @param hs Pointer to hashset instance.
+ * @param val Element to find.
+ * @param h Hash of the element.
+ * @param bucket Pointer to store bucket, where
+ * node has been found (or new bucket if not found).
+ * @param prev Pointer to store node before found one.
+ * Could be NULL.
+ * @return forward_list_iterator Node with element or
+ * forward_list_end() if not found.
+ */
+static forward_list_iterator
+__hashset_find (const hashset *hs, constdptr val, hash64 h,
+                forward_list **bucket, forward_list_iterator *prev)
+{
+  *bucket = __hashset_bucket_by_hash (hs, h);
+
+  forward_list_iterator node
+      = __hashset_find_in_bucket (hs, *bucket, val, prev);
+
+  if (node != forward_list_end () || !hs->old_buckets)
+    return node;
+
+  // Buckets before rehash_index are already moved.
+  size_t index = h % array_size (hs->old_buckets);
+
+  if (index < hs->rehash_index)
+    return forward_list_end ();
 
-  return NULL;
+  forward_list *old = array_at (hs->old_buckets, index);
+  node = __hashset_find_in_bucket (hs, old, val, prev);
+
+  if (node != forward_list_end ())
+    *bucket = old;
+
+  return node;
 }
 
 /**
- * @brief Function of resizing array of buckets.
+ * @brief Function to create array of empty buckets.
  *
  * @param hs Pointer to hashset instance.
- * @param size New size.
+ * @param size Number of buckets.
+ * @return array* Array of buckets.
+ */
+static array *
+__hashset_buckets_create (const hashset *hs, size_t size)
+{
+  array *buckets = array_create_with_allocator (size, &hs->alloc);
+
+  // Creating every bucket.
+  for (size_t i = 0; i < size; i++)
+    array_push_back (buckets,
+                     (dptr *)forward_list_create_with_allocator (&hs->alloc));
+
+  return buckets;
+}
+
+/**
+ * @brief Function to destroy array of buckets.
+ *
+ * @param buckets Array of buckets.
+ * @param destr Destructor for elements.
  */
 static void
-__hashset_resize_buckets_array (hashset *hs, size_t size)
+__hashset_buckets_destroy (array *buckets, void (*destr) (dptr val))
 {
-  // Saving old buckets.
-  array *old_buckets = hs->buckets;
+  for (size_t i = 0; i < array_size (buckets); i++)
+    forward_list_destroy (array_at (buckets, i), destr);
 
-  // Creating new buckets.
-  hs->buckets = array_create (size);
+  array_destroy (buckets, NULL);
+}
 
-  // Setting size = 0, because of new insertions.
-  hs->size = 0;
+/**
+ * @brief Function to move all nodes of <old> bucket into
+ * current buckets. Nodes are relinked, so there is
+ * no allocation and no comparing.
+ *
+ * @param hs Pointer to hashset instance.
+ * @param old Bucket to move.
+ */
+static void
+__hashset_move_bucket (hashset *hs, forward_list *old)
+{
+  forward_list_iterator cur = forward_list_begin (old);
 
-  // Creating every bucket.
-  for (size_t i = 0; i < size; i++)
-    array_push_back (hs->buckets, (dptr *)forward_list_create ());
+  while (cur)
+    {
+      forward_list_iterator next = cur->next;
+      forward_list *bucket
+          = __hashset_bucket_by_hash (hs, __hashset_hash (hs, cur->data));
+
+      cur->next = bucket->front;
+      bucket->front = cur;
+      bucket->size++;
+
+      cur = next;
+    }
+
+  // Old bucket is empty now.
+  old->front = NULL;
+  old->size = 0;
+}
 
-  // Inserting every element from old buckets to new buckets.
-  for (size_t i = 0; i < array_size (old_buckets); i++)
+/**
+ * @brief Function to move up to <nbuckets> not empty
+ * old buckets into the new ones. Finishes rehash
+ * if all old buckets are moved.
+ *
+ * @param hs Pointer to hashset instance.
+ * @param nbuckets Number of buckets to move.
+ */
+static void
+__hashset_rehash_buckets (hashset *hs, size_t nbuckets)
+{
+  size_t old_count = array_size (hs->old_buckets);
+
+  // Limiting number of visited empty buckets too.
+  size_t empty_visits = nbuckets * HASHSET_REHASH_EMPTY_VISITS;
+
+  while (nbuckets > 0 && hs->rehash_index < old_count)
     {
-      forward_list_iterator cur
-          = forward_list_begin ((forward_list *)array_at (old_buckets, i));
+      forward_list *old = array_at (hs->old_buckets, hs->rehash_index++);
 
-      while (cur)
+      if (!forward_list_empty (old))
         {
-          hashset_insert (hs, cur->data);
-          cur = cur->next;
+          __hashset_move_bucket (hs, old);
+          nbuckets--;
         }
+      else if (--empty_visits == 0)
+        break;
+    }
 
-      forward_list_destroy (array_at (old_buckets, i), hs->destr);
+  if (hs->rehash_index == old_count)
+    {
+      __hashset_buckets_destroy (hs->old_buckets, NULL);
+      hs->old_buckets = NULL;
+      hs->rehash_index = 0;
     }
+}
+
+/**
+ * @brief Function to finish incremental rehash,
+ * if it is in progress.
+ *
+ * @param hs Pointer to hashset instance.
+ */
+inline static void
+__hashset_rehash_finish (hashset *hs)
+{
+  while (hs->old_buckets)
+    __hashset_rehash_buckets (hs, array_size (hs->old_buckets));
+}
+
+/**
+ * @brief Function to compute number of buckets, that
+ * holds <n> elements without exceeding max load factor.
+ *
+ * @param hs Pointer to hashset instance.
+ * @param n Number of elements.
+ * @return size_t Number of buckets (at least 1).
+ */
+inline static size_t
+__hashset_buckets_for (const hashset *hs, size_t n)
+{
+  double exact = (double)n / hs->max_load_factor;
+  size_t count = (size_t)exact;
+
+  // Rounding up.
+  if ((double)count < exact)
+    count++;
+
+  return count ? count : 1;
+}
 
-  array_destroy (old_buckets, NULL);
+/**
+ * @brief Function of resizing array of buckets.
+ * In incremental mode old buckets are kept and moved
+ * by modifying operations, otherwise all at once.
+ *
+ * @param hs Pointer to hashset instance.
+ * @param size New size.
+ */
+static void
+__hashset_resize_buckets_array (hashset *hs, size_t size)
+{
+  // Only one rehash at time.
+  __hashset_rehash_finish (hs);
+
+  // Saving old buckets.
+  hs->old_buckets = hs->buckets;
+  hs->rehash_index = 0;
+
+  // Creating new buckets.
+  hs->buckets = __hashset_buckets_create (hs, size);
+
+  if (hs->rehash_step == 0)
+    __hashset_rehash_finish (hs);
 }
 
 ////////////////////////////////////////////////////
@@ -106,24 +275,54 @@ hashset *
 hashset_create (bool (*cmp) (constdptr val1, constdptr val2),
                 size_t (*size_func) (constdptr val), void (*destr) (dptr val))
 {
-  // Allocation memory for the hashset instance.
-  hashset *hs = (hashset *)malloc (sizeof (hashset));
+  return hashset_create_with_hash (cmp, size_func, destr, hash_jenkins, 0);
+}
+
+hashset *
+hashset_create_with_hash (bool (*cmp) (constdptr val1, constdptr val2),
+                          size_t (*size_func) (constdptr val),
+                          void (*destr) (dptr val), hash_func hash,
+                          uint64_t seed)
+{
+  return hashset_create_with_allocator (cmp, size_func, destr, hash, seed,
+                                        NULL);
+}
 
-  // Creating array of buckets..
-  hs->buckets = array_create (HASHSET_STARTING_NUMBER_OF_BUCKETS);
+hashset *
+hashset_create_with_allocator (bool (*cmp) (constdptr val1, constdptr val2),
+                               size_t (*size_func) (constdptr val),
+                               void (*destr) (dptr val), hash_func hash,
+                               uint64_t seed, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+
+  // Allocation memory for the hashset instance.
+  hashset *hs = (hashset *)allocator_allocate (&al, sizeof (hashset));
+  hs->alloc = al;
 
-  // Creating buckets (forward lists).
-  for (size_t i = 0; i < HASHSET_STARTING_NUMBER_OF_BUCKETS; i++)
-    array_push_back (hs->buckets, (dptr *)forward_list_create ());
+  // Creating array of buckets (forward lists).
+  hs->buckets
+      = __hashset_buckets_create (hs, HASHSET_STARTING_NUMBER_OF_BUCKETS);
 
   hs->size = 0;
 
+  // Incremental rehash is disabled by default.
+  hs->old_buckets = NULL;
+  hs->rehash_index = 0;
+  hs->rehash_step = 0;
+
+  hs->max_load_factor = HASHSET_DEFAULT_MAX_LOAD_FACTOR;
+
   // Setting compare func for vals.
   hs->cmp = cmp;
 
   // Setting sizeof-func for vals.
   hs->size_func = size_func;
 
+  // Setting hash function and its seed.
+  hs->hash = hash;
+  hs->seed = seed;
+
   // Setting destructor provided by user.
   hs->destr = destr;
 
@@ -133,7 +332,7 @@ hashset_create (bool (*cmp) (constdptr val1, constdptr val2),
 inline size_t
 hashset_bucket (const hashset *hs, constdptr val)
 {
-  return (size_t)__hashset_index_from_val (hs, val, hs->size_func (val));
+  return (size_t)(__hashset_hash (hs, val) % hashset_bucket_count (hs));
 }
 
 inline size_t
@@ -155,6 +354,14 @@ hashset_clear (hashset *hs)
   for (size_t i = 0; i < array_size (hs->buckets); i++)
     forward_list_clear (array_at (hs->buckets, i), hs->destr);
 
+  // Dropping rehash in progress.
+  if (hs->old_buckets)
+    {
+      __hashset_buckets_destroy (hs->old_buckets, hs->destr);
+      hs->old_buckets = NULL;
+      hs->rehash_index = 0;
+    }
+
   // Setting size = 0
   hs->size = 0;
 }
@@ -162,7 +369,9 @@ hashset_clear (hashset *hs)
 inline bool
 hashset_contains (const hashset *hs, constdptr val)
 {
-  return __hashmap_get_value (hs, val, hs->size_func (val)) != NULL;
+  forward_list *bucket;
+  return __hashset_find (hs, val, __hashset_hash (hs, val), &bucket, NULL)
+         != forward_list_end ();
 }
 
 inline __attribute__ ((always_inline)) bool
@@ -174,40 +383,58 @@ hashset_empty (const hashset *hs)
 void
 hashset_erase (hashset *hs, constdptr val)
 {
-  // Calculating index of bucket by hash.
-  hash32 index = __hashset_index_from_val (hs, val, hs->size_func (val));
+  // Making step of incremental rehash.
+  if (hs->old_buckets)
+    __hashset_rehash_buckets (hs, hs->rehash_step);
+
+  // Finding node, its bucket and node before it.
+  forward_list *bucket;
+  forward_list_iterator prev = NULL;
+  forward_list_iterator node
+      = __hashset_find (hs, val, __hashset_hash (hs, val), &bucket, &prev);
 
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashset_bucket_by_index (hs, index);
+  if (node == forward_list_end ())
+    return;
 
-  // Removing element by val.
-  forward_list_remove (bucket, (dptr)val, hs->cmp, hs->destr);
+  // Removing element.
+  forward_list_erase_after (bucket, prev, hs->destr);
   hs->size--;
 }
 
 void
 hashset_insert (hashset *hs, constdptr val)
 {
-  // Checking if we need to increase array buckets's size.
-  if (hashset_bucket_count (hs) == hs->size)
-    __hashset_resize_buckets_array (hs, hs->size
-                                            * HASHSET_INCREASE_BUCKETS_FACTOR);
+  // Making step of incremental rehash.
+  if (hs->old_buckets)
+    __hashset_rehash_buckets (hs, hs->rehash_step);
 
-  // Calculating index of bucket by hash.
-  hash32 index = __hashset_index_from_val (hs, val, hs->size_func (val));
-
-  // Getting appropriate bucket.
-  forward_list *bucket = __hashset_bucket_by_index (hs, index);
+  hash64 h = __hashset_hash (hs, val);
 
   // Checking for existance.
-  forward_list_iterator former = forward_list_find (bucket, val, hs->cmp);
+  forward_list *bucket;
+  if (__hashset_find (hs, val, h, &bucket, NULL) != forward_list_end ())
+    return;
 
-  // If not exist => Inserting new pair to the bucket.
-  if (former == forward_list_end ())
+  // Checking if we need to increase array buckets's size.
+  if ((double)(hs->size + 1)
+      > (double)hs->max_load_factor * hashset_bucket_count (hs))
     {
-      forward_list_push_front (bucket, val);
-      hs->size++;
+      size_t count
+          = hashset_bucket_count (hs) * HASHSET_INCREASE_BUCKETS_FACTOR;
+      size_t need = __hashset_buckets_for (hs, hs->size + 1);
+
+      __hashset_resize_buckets_array (hs, count > need ? count : need);
     }
+
+  // Inserting new element to the bucket of new table.
+  forward_list_push_front (__hashset_bucket_by_hash (hs, h), val);
+  hs->size++;
+}
+
+inline bool
+hashset_is_rehashing (const hashset *hs)
+{
+  return hs->old_buckets != NULL;
 }
 
 inline float
@@ -216,7 +443,76 @@ hashset_load_factor (const hashset *hs)
   return (float)hashset_size (hs) / hashset_bucket_count (hs);
 }
 
-void hashmap_rehash (hashset *hs);
+inline float
+hashset_max_load_factor (const hashset *hs)
+{
+  return hs->max_load_factor;
+}
+
+void
+hashset_rehash (hashset *hs, size_t count)
+{
+  size_t need = __hashset_buckets_for (hs, hs->size);
+
+  if (count < need)
+    count = need;
+
+  // Rebuilding buckets at once, even in incremental mode.
+  if (count != hashset_bucket_count (hs))
+    __hashset_resize_buckets_array (hs, count);
+
+  __hashset_rehash_finish (hs);
+}
+
+bool
+hashset_rehash_step (hashset *hs, size_t nbuckets)
+{
+  if (hs->old_buckets)
+    __hashset_rehash_buckets (hs, nbuckets);
+
+  return hashset_is_rehashing (hs);
+}
+
+void
+hashset_reserve (hashset *hs, size_t n)
+{
+  size_t need = __hashset_buckets_for (hs, n);
+
+  // Never shrinking here.
+  if (need > hashset_bucket_count (hs))
+    hashset_rehash (hs, need);
+}
+
+void
+hashset_set_max_load_factor (hashset *hs, float ml)
+{
+  // Rejecting values <= 0 and NaN, they would break
+  // computing number of buckets.
+  if (!(ml > 0))
+    return;
+
+  hs->max_load_factor = ml;
+
+  // Growing if current load exceeds new maximum.
+  if (hashset_load_factor (hs) > ml)
+    hashset_rehash (hs, 0);
+}
+
+inline void
+hashset_set_rehash_step (hashset *hs, size_t step)
+{
+  hs->rehash_step = step;
+
+  // Switching off incremental mode finishes current rehash.
+  if (step == 0)
+    __hashset_rehash_finish (hs);
+}
+
+void
+hashset_shrink_to_fit (hashset *hs)
+{
+  hashset_rehash (hs, 0);
+}
 
 inline __attribute__ ((always_inline)) size_t
 hashset_size (const hashset *hs)
@@ -227,13 +523,17 @@ hashset_size (const hashset *hs)
 void
 hashset_destroy (hashset *hs)
 {
-  // Destoying buckets.
+  // Destroying buckets.
   for (size_t i = 0; i < array_size (hs->buckets); i++)
     forward_list_destroy (array_at (hs->buckets, i), hs->destr);
 
-  // Destroying Destroying Array of buckets.
+  // Destroying array of buckets.
   array_destroy (hs->buckets, NULL);
 
+  // Destroying buckets of rehash in progress.
+  if (hs->old_buckets)
+    __hashset_buckets_destroy (hs->old_buckets, hs->destr);
+
   // Destroying hashset instance.
-  free (hs);
-}
\ No newline at end of file
+  allocator_deallocate (&hs->alloc, hs, sizeof (hashset));
+}
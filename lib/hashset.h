@@ -9,6 +9,7 @@
 #include <stdbool.h> // bool
 #include <stdlib.h>  //malloc, free
 
+#include "allocator.h"
 #include "array.h"
 #include "forward_list.h"
 #include "hash.h"
@@ -16,6 +17,13 @@
 
 #define HASHSET_STARTING_NUMBER_OF_BUCKETS 5
 #define HASHSET_INCREASE_BUCKETS_FACTOR 2
+#define HASHSET_DEFAULT_MAX_LOAD_FACTOR 1.0f
+
+/**
+ * @brief Number of empty buckets, that incremental rehash
+ * may skip per one bucket to move.
+ */
+#define HASHSET_REHASH_EMPTY_VISITS 10
 
 /**
  * @struct hashset.
@@ -34,6 +42,29 @@ typedef struct hashset
    */
   array *buckets;
 
+  /**
+   * @brief Buckets, that are being moved by incremental
+   * rehash. NULL if rehash is not in progress.
+   */
+  array *old_buckets;
+
+  /**
+   * @brief Index of the next old bucket to move.
+   */
+  size_t rehash_index;
+
+  /**
+   * @brief Number of buckets to move per insert or
+   * erase. 0 if incremental rehash is disabled.
+   */
+  size_t rehash_step;
+
+  /**
+   * @brief Maximum average number of elements per bucket.
+   * Buckets grow, when insert would exceed it.
+   */
+  float max_load_factor;
+
   /**
    * @brief Compare function for elemnts.
    * Return true if val1 == val2.
@@ -47,11 +78,27 @@ typedef struct hashset
    */
   size_t (*size_func) (constdptr);
 
+  /**
+   * @brief Hash function for elements.
+   */
+  hash_func hash;
+
+  /**
+   * @brief Seed of the hash function.
+   */
+  uint64_t seed;
+
   /**
    * @brief Destructor for elements.
    * Null if shouldnot be freed.
    */
   void (*destr) (dptr);
+
+  /**
+   * @brief Allocator of the hashset instance,
+   * buckets and their nodes.
+   */
+  allocator alloc;
 } hashset;
 
 ////////////////////////////////////////////////////
@@ -60,7 +107,7 @@ typedef struct hashset
 
 /**
  * @brief Function to create new hashset. Allocates the memory. Should be
- * destroyed at the end.
+ * destroyed at the end. Elements are hashed by hash().
  * @param pair_vals_cmp Function to compare vals
  * Return true if val1 == val2.
  * Return false if val1 != val2.
@@ -74,6 +121,48 @@ hashset *
 hashset_create (bool (*pair_vals_cmp) (constdptr val1, constdptr val2),
                 size_t (*size_func) (constdptr val), void (*destr) (dptr val));
 
+/**
+ * @brief Function to create new hashset with custom hash
+ * function. Allocates the memory. Should be destroyed at the end.
+ * @param pair_vals_cmp Function to compare vals
+ * Return true if val1 == val2.
+ * Return false if val1 != val2.
+ * @param size_func Function to compute
+ * size of the Val.
+ * @param destr Destructor for elements.
+ * Null if should not be freed.
+ * @param hash Hash function for elements.
+ * @param seed Seed of the hash function. Use hash_random_seed()
+ * for tables with untrusted elements.
+ * @return Pointer to new hashset.
+ */
+hashset *hashset_create_with_hash (bool (*pair_vals_cmp) (constdptr val1,
+                                                          constdptr val2),
+                                   size_t (*size_func) (constdptr val),
+                                   void (*destr) (dptr val), hash_func hash,
+                                   uint64_t seed);
+
+/**
+ * @brief Function to create new hashset, that takes memory
+ * for itself, buckets and their nodes from <alloc>.
+ * Should be destroyed at the end.
+ * @param pair_vals_cmp Function to compare vals
+ * Return true if val1 == val2.
+ * Return false if val1 != val2.
+ * @param size_func Function to compute
+ * size of the Val.
+ * @param destr Destructor for elements.
+ * Null if should not be freed.
+ * @param hash Hash function for elements.
+ * @param seed Seed of the hash function.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new hashset.
+ */
+hashset *hashset_create_with_allocator (
+    bool (*pair_vals_cmp) (constdptr val1, constdptr val2),
+    size_t (*size_func) (constdptr val), void (*destr) (dptr val),
+    hash_func hash, uint64_t seed, const allocator *alloc);
+
 /**
  * @brief Function to get number of bucket for
  * <val> element.
@@ -149,6 +238,16 @@ void hashset_erase (hashset *hs, constdptr val);
  */
 void hashset_insert (hashset *hs, constdptr val);
 
+/**
+ * @brief Function to check if incremental rehash
+ * is in progress.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @return true If old buckets are still being moved.
+ * @return false Otherwise.
+ */
+bool hashset_is_rehashing (const hashset *hs);
+
 /**
  * @brief Function to get load of hashset.
  *
@@ -158,11 +257,73 @@ void hashset_insert (hashset *hs, constdptr val);
 float hashset_load_factor (const hashset *hs);
 
 /**
- * @brief Function to rehash hashset.
+ * @brief Function to get maximum load factor.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @return float Maximum load factor.
+ */
+float hashset_max_load_factor (const hashset *hs);
+
+/**
+ * @brief Function to rebuild buckets of hashset with
+ * <count> buckets, or with minimal number of buckets,
+ * that keeps load factor <= max load factor, if it
+ * is bigger. Finishes incremental rehash.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @param count Wanted number of buckets.
+ */
+void hashset_rehash (hashset *hs, size_t count);
+
+/**
+ * @brief Function to move up to <nbuckets> buckets
+ * of incremental rehash in progress.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @param nbuckets Number of buckets to move.
+ * @return true If rehash is still in progress.
+ * @return false If rehash is finished.
+ */
+bool hashset_rehash_step (hashset *hs, size_t nbuckets);
+
+/**
+ * @brief Function to prepare hashset for <n> elements,
+ * so inserting them causes no resize. Does nothing
+ * if there are enough buckets already.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @param n Number of elements.
+ */
+void hashset_reserve (hashset *hs, size_t n);
+
+/**
+ * @brief Function to set maximum load factor.
+ * Rehashes hashset, if current load factor exceeds it.
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @param ml New maximum load factor. Values <= 0
+ * and NaN are ignored, old maximum stays.
+ */
+void hashset_set_max_load_factor (hashset *hs, float ml);
+
+/**
+ * @brief Function to enable incremental rehash. Works
+ * the same way as hashmap_set_rehash_step().
+ *
+ * @param hs Pointer to the instance of hashset.
+ * @param step Number of buckets to move per operation.
+ * 0 disables incremental rehash (default) and finishes
+ * current one.
+ */
+void hashset_set_rehash_step (hashset *hs, size_t step);
+
+/**
+ * @brief Function to reduce number of buckets to
+ * minimal one, that fits current elements.
  *
  * @param hs Pointer to the instance of hashset.
  */
-void hashset_rehash (hashset *hs);
+void hashset_shrink_to_fit (hashset *hs);
 
 /**
  * @brief Function to get number of elements
@@ -1,59 +1,302 @@
 #include "linear_allocator.h"
 
+////////////////////////////////////////////////////
+/*    Private functions of the linear_allocator   */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to map memory of the block.
+ *
+ * @param capacity Pointer to number of bytes. Rounded
+ * up to huge page, if LINEAR_ALLOCATOR_HUGE_PAGES is set.
+ * @param flags LINEAR_ALLOCATOR_* flags.
+ * @return dptr Memory of the block, NULL if mapping failed.
+ */
+static dptr
+__linear_allocator_map (size_t *capacity, int flags)
+{
+  dptr ptr;
+
+  if (flags & LINEAR_ALLOCATOR_HUGE_PAGES)
+    {
+      *capacity = (*capacity + LINEAR_ALLOCATOR_HUGE_PAGE_SIZE - 1)
+                  & ~(size_t)(LINEAR_ALLOCATOR_HUGE_PAGE_SIZE - 1);
+
+#ifdef MAP_HUGETLB
+      // Reserved huge pages.
+      ptr = mmap (NULL, *capacity, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (ptr != MAP_FAILED)
+        return ptr;
+#endif // MAP_HUGETLB
+    }
+
+  // Allocating memory to manage through syscall mmap
+  ptr = mmap (NULL, *capacity, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+
+#ifdef MADV_HUGEPAGE
+  // Transparent huge pages, if there are no reserved ones.
+  if (flags & LINEAR_ALLOCATOR_HUGE_PAGES)
+    madvise (ptr, *capacity, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+
+  return ptr;
+}
+
+/**
+ * @brief Function to get padding, that
+ * aligns <offset> of the current block.
+ *
+ * @param al Pointer to Linear allocator.
+ * @param offset Offset in the current block.
+ * @param align Alignment, 0 means no alignment.
+ * @return size_t Number of bytes of padding.
+ */
+inline static size_t
+__linear_allocator_padding (const linear_allocator *al, size_t offset,
+                            size_t align)
+{
+  if (align == 0)
+    return 0;
+
+  // Aligning address, not offset or count.
+  uintptr_t addr = (uintptr_t)al->ptr + offset;
+
+  return (align - addr % align) % align;
+}
+
+/**
+ * @brief Function to chain new block, that fits
+ * <count> bytes with any padding.
+ *
+ * @param al Pointer to Linear allocator.
+ * @param count Number of bytes to fit.
+ * @param align Alignment of the chunk.
+ * @return bool true if new block is mapped.
+ */
+static bool
+__linear_allocator_grow (linear_allocator *al, size_t count, size_t align)
+{
+  // Doubling blocks, so number of blocks is logarithmic.
+  size_t capacity = al->capacity * 2;
+  if (capacity < count + align)
+    capacity = count + align;
+
+  dptr ptr = __linear_allocator_map (&capacity, al->flags);
+  if (!ptr)
+    return false;
+
+  // Remembering current block.
+  struct __linear_allocator_block *block
+      = (struct __linear_allocator_block *)malloc (
+          sizeof (struct __linear_allocator_block));
+  block->ptr = al->ptr;
+  block->capacity = al->capacity;
+  block->prev = al->prev;
+
+  al->prev = block;
+  al->ptr = ptr;
+  al->capacity = capacity;
+  al->offset = 0;
+
+  return true;
+}
+
+/**
+ * @brief Function to unmap current block and make
+ * previous one current. Offset is not changed.
+ *
+ * @param al Pointer to Linear allocator.
+ */
+static void
+__linear_allocator_pop_block (linear_allocator *al)
+{
+  struct __linear_allocator_block *block = al->prev;
+
+  munmap (al->ptr, al->capacity);
+
+  al->ptr = block->ptr;
+  al->capacity = block->capacity;
+  al->prev = block->prev;
+
+  free (block);
+}
+
+/**
+ * @brief Allocate function of the allocator interface.
+ *
+ * @param ctx Pointer to Linear allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ */
+static dptr
+__linear_allocator_interface_allocate (dptr ctx, size_t size)
+{
+  return linear_allocator_allocate_aligned (
+      ctx, size, LINEAR_ALLOCATOR_INTERFACE_ALIGNMENT);
+}
+
+/**
+ * @brief Reallocate function of the allocator interface.
+ * The last chunk of the current block is resized in place,
+ * other ones are copied to new chunk.
+ *
+ * @param ctx Pointer to Linear allocator.
+ * @param ptr Memory to resize.
+ * @param old_size Number of bytes in <ptr>.
+ * @param new_size New number of bytes.
+ * @return dptr Pointer to resized memory.
+ */
+static dptr
+__linear_allocator_interface_reallocate (dptr ctx, dptr ptr, size_t old_size,
+                                         size_t new_size)
+{
+  linear_allocator *al = (linear_allocator *)ctx;
+
+  // Last chunk, that fits the current block.
+  if (ptr && ptr + old_size == al->ptr + al->offset
+      && new_size <= al->capacity - (size_t)(ptr - al->ptr))
+    {
+      al->offset = (size_t)(ptr - al->ptr) + new_size;
+      return ptr;
+    }
+
+  dptr res = __linear_allocator_interface_allocate (ctx, new_size);
+
+  if (res && ptr)
+    memcpy (res, ptr, old_size < new_size ? old_size : new_size);
+
+  return res;
+}
+
+/**
+ * @brief Deallocate function of the allocator interface.
+ * Memory is freed with all allocator only.
+ *
+ * @param ctx Not used.
+ * @param ptr Not used.
+ * @param size Not used.
+ */
+static void
+__linear_allocator_interface_deallocate (dptr ctx, dptr ptr, size_t size)
+{
+  (void)ctx;
+  (void)ptr;
+  (void)size;
+}
+
 ////////////////////////////////////////////////////
 /* Public API functions of the linear_allocator   */
 ////////////////////////////////////////////////////
 
 linear_allocator *
 linear_allocator_create (size_t capacity, uint8_t align)
+{
+  return linear_allocator_create_with_flags (capacity, align, 0);
+}
+
+linear_allocator *
+linear_allocator_create_with_flags (size_t capacity, uint8_t align, int flags)
 {
   // Allocating memory for allocator instance.
   linear_allocator *al
       = (linear_allocator *)malloc (sizeof (linear_allocator));
 
   // Set starting values for allocator.
-  al->capacity = capacity;
   al->offset = 0;
   al->align = align;
+  al->flags = flags;
+  al->prev = NULL;
 
-  // Allocating memory to manage through syscall mmap
-  al->ptr = mmap (NULL, al->capacity, PROT_READ | PROT_WRITE,
-                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  al->ptr = __linear_allocator_map (&capacity, flags);
+  al->capacity = capacity;
 
   return al;
 }
 
-dptr
+inline dptr
 linear_allocator_allocate (linear_allocator *al, size_t count)
+{
+  return linear_allocator_allocate_aligned (al, count, al->align);
+}
+
+dptr
+linear_allocator_allocate_aligned (linear_allocator *al, size_t count,
+                                   size_t align)
 {
   // Calculating empty space (junk) for alignment.
-  uint8_t junk
-      = al->align == 0 ? 0 : (al->align - count % al->align) % al->align;
+  size_t junk = __linear_allocator_padding (al, al->offset, align);
 
   // Checking enough space.
-  if (al->offset + count + junk > al->capacity)
-    return NULL;
+  if (al->offset + junk > al->capacity
+      || count > al->capacity - al->offset - junk)
+    {
+      if (!(al->flags & LINEAR_ALLOCATOR_GROWABLE)
+          || !__linear_allocator_grow (al, count, align))
+        return NULL;
+
+      junk = __linear_allocator_padding (al, 0, align);
+    }
 
   // Prepare ptr to give in use.
-  dptr *ptr = (al->ptr + al->offset + junk);
+  dptr ptr = al->ptr + al->offset + junk;
 
   // Setting new offset.
-  al->offset += count + junk;
+  al->offset += junk + count;
 
   return ptr;
 }
 
-inline __attribute__ ((always_inline)) void
+inline linear_allocator_checkpoint
+linear_allocator_checkpoint_save (const linear_allocator *al)
+{
+  return (linear_allocator_checkpoint){ al->ptr, al->offset };
+}
+
+void
+linear_allocator_checkpoint_restore (linear_allocator *al,
+                                     linear_allocator_checkpoint checkpoint)
+{
+  // Checkpoint is already restored.
+  if (al->ptr == checkpoint.ptr && checkpoint.offset > al->offset)
+    return;
+
+  // Unmapping blocks chained after checkpoint.
+  while (al->ptr != checkpoint.ptr && al->prev)
+    __linear_allocator_pop_block (al);
+
+  al->offset = checkpoint.offset;
+}
+
+void
 linear_allocator_free (linear_allocator *al)
 {
+  // Keeping only the first block.
+  while (al->prev)
+    __linear_allocator_pop_block (al);
+
   // Freeing memory by moving offset to zero.
   al->offset = 0;
 }
 
-inline void
+inline allocator
+linear_allocator_as_allocator (linear_allocator *al)
+{
+  return (allocator){ __linear_allocator_interface_allocate,
+                      __linear_allocator_interface_reallocate,
+                      __linear_allocator_interface_deallocate, al };
+}
+
+void
 linear_allocator_destroy (linear_allocator *al)
 {
   // deallocate allocator's memory.
+  while (al->prev)
+    __linear_allocator_pop_block (al);
+
   munmap (al->ptr, al->capacity);
 
   // deallocate allocator instance.
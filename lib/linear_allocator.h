@@ -6,20 +6,92 @@
 #ifndef _EXTENDED_C_LIB_LINEAR_ALLOCATOR_H
 #define _EXTENDED_C_LIB_LINEAR_ALLOCATOR_H
 
+#include <stdbool.h>  // bool
 #include <stdint.h>   // uint8_t
 #include <stdlib.h>   // malloc, free
-#include <sys/mman.h> // mmap, munmap
+#include <string.h>   // memcpy
+#include <sys/mman.h> // mmap, munmap, madvise
 
+#include "allocator.h"
 #include "types.h"
 
+/**
+ * @brief Flag to map new block, when allocator
+ * is full, instead of returning NULL.
+ */
+#define LINEAR_ALLOCATOR_GROWABLE 1
+
+/**
+ * @brief Flag to back allocator by huge pages.
+ * MAP_HUGETLB is tried first, if there are no
+ * reserved huge pages, transparent huge pages
+ * are asked by madvise.
+ */
+#define LINEAR_ALLOCATOR_HUGE_PAGES 2
+
+/**
+ * @brief Size of the huge page. Blocks with huge
+ * pages are rounded up to it.
+ */
+#define LINEAR_ALLOCATOR_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * @brief Alignment of memory, that is given
+ * through allocator interface.
+ */
+#define LINEAR_ALLOCATOR_INTERFACE_ALIGNMENT 16
+
+/**
+ * @struct __linear_allocator_block
+ * @brief Block, that was filled before the current one.
+ */
+struct __linear_allocator_block
+{
+  /**
+   * @brief Memory of the block.
+   */
+  dptr ptr;
+
+  /**
+   * @brief Number of bytes in the block.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Block, that was filled before this one,
+   * NULL if this one is the first.
+   */
+  struct __linear_allocator_block *prev;
+};
+
+/**
+ * @struct linear_allocator_checkpoint
+ * @brief Saved position of the linear allocator.
+ */
+typedef struct linear_allocator_checkpoint
+{
+  /**
+   * @brief Block of the position.
+   */
+  dptr ptr;
+
+  /**
+   * @brief Offset in the block.
+   */
+  size_t offset;
+} linear_allocator_checkpoint;
+
 /**
  * @struct linear_allocator
  * @brief Implemenation of linear_allocator.
+ * Memory is given by bumping offset in the current
+ * block. Growable allocator chains new blocks, when
+ * current one is full.
  */
 typedef struct linear_allocator
 {
   /**
-   * @brief Pointer to memory to manage by allocator.
+   * @brief Pointer to memory of the current block.
    */
   dptr ptr;
 
@@ -32,14 +104,26 @@ typedef struct linear_allocator
 
   /**
    * @brief Number of bytes that contain
-   * allocator to manage.
+   * current block.
    */
   size_t capacity;
 
   /**
-   * @brief Allignment in allocator.
+   * @brief Allignment in allocator. Addresses
+   * are multiple of it. 0 means no alignment.
    */
   uint8_t align;
+
+  /**
+   * @brief LINEAR_ALLOCATOR_* flags.
+   */
+  int flags;
+
+  /**
+   * @brief Blocks, that were filled before the
+   * current one. NULL if there is one block.
+   */
+  struct __linear_allocator_block *prev;
 } linear_allocator;
 
 ////////////////////////////////////////////////////
@@ -48,6 +132,7 @@ typedef struct linear_allocator
 
 /**
  * @brief Contructor for the linear allocator.
+ * Allocator does not grow.
  *
  * @param capacity Number of bytes for memory
  * managment.
@@ -57,6 +142,20 @@ typedef struct linear_allocator
  */
 linear_allocator *linear_allocator_create (size_t capacity, uint8_t align);
 
+/**
+ * @brief Contructor for the linear allocator
+ * with LINEAR_ALLOCATOR_* flags.
+ *
+ * @param capacity Number of bytes for the first block.
+ * @param align Align in allocator.
+ * @param flags Bitwise or of LINEAR_ALLOCATOR_* flags.
+ * @return linear_allocator* Pointer to
+ * linear_allocator instance.
+ */
+linear_allocator *linear_allocator_create_with_flags (size_t capacity,
+                                                      uint8_t align,
+                                                      int flags);
+
 /**
  * @brief Function to allocate new chunk of memory
  * from allocator.
@@ -65,17 +164,68 @@ linear_allocator *linear_allocator_create (size_t capacity, uint8_t align);
  * @param count Number of bytes to get from
  * Allocator.
  * @return dptr Pointer to allocated memory.
+ * NULL if allocator is full and is not growable.
  */
 dptr linear_allocator_allocate (linear_allocator *al, size_t count);
 
+/**
+ * @brief Function to allocate new chunk of memory
+ * with alignment, that overrides alignment of
+ * allocator. Useful for SIMD data.
+ *
+ * @param al Pointer to Linear allocator.
+ * @param count Number of bytes to get from
+ * Allocator.
+ * @param align Alignment of the address. 0 means
+ * no alignment.
+ * @return dptr Pointer to allocated memory.
+ * NULL if allocator is full and is not growable.
+ */
+dptr linear_allocator_allocate_aligned (linear_allocator *al, size_t count,
+                                        size_t align);
+
+/**
+ * @brief Function to save current position.
+ *
+ * @param al Pointer to Linear allocator.
+ * @return linear_allocator_checkpoint Current position.
+ */
+linear_allocator_checkpoint
+linear_allocator_checkpoint_save (const linear_allocator *al);
+
+/**
+ * @brief Function to free all chunks allocated after
+ * <checkpoint> was saved. Blocks chained after it
+ * are unmapped. Checkpoints saved after <checkpoint>
+ * become invalid.
+ *
+ * @param al Pointer to Linear allocator.
+ * @param checkpoint Saved position.
+ */
+void linear_allocator_checkpoint_restore (
+    linear_allocator *al, linear_allocator_checkpoint checkpoint);
+
 /**
  * @brief Function to free all chunks of memory.
- * Actualy just moving offset to 0 position.
+ * Actualy just moving offset to 0 position of
+ * the first block, other blocks are unmapped.
  *
  * @param al Pointer to Linear allocator.
  */
 void linear_allocator_free (linear_allocator *al);
 
+/**
+ * @brief Function to get allocator interface, that
+ * takes memory from linear allocator. Memory is aligned
+ * to LINEAR_ALLOCATOR_INTERFACE_ALIGNMENT, deallocation
+ * does nothing, so containers created with it could be
+ * freed at once by linear_allocator_free().
+ *
+ * @param al Pointer to Linear allocator.
+ * @return allocator Allocator interface.
+ */
+allocator linear_allocator_as_allocator (linear_allocator *al);
+
 /**
  * @brief Destructor for Linear allocator.
  *
@@ -83,4 +233,4 @@ void linear_allocator_free (linear_allocator *al);
  */
 void linear_allocator_destroy (linear_allocator *al);
 
-#endif
\ No newline at end of file
+#endif
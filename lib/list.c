@@ -1,5 +1,7 @@
 #include "list.h"
 
+#include "pool_allocator.h"
+
 ////////////////////////////////////////////////////
 /*        Public API functions of the list        */
 ////////////////////////////////////////////////////
@@ -7,11 +9,30 @@
 list *
 list_create ()
 {
-  list *l = (list *)malloc (sizeof (list));
+  return list_create_with_allocator (NULL);
+}
+
+list *
+list_create_with_allocator (const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  list *l = (list *)allocator_allocate (&al, sizeof (list));
 
   l->front = NULL;
   l->back = NULL;
   l->size = 0;
+  l->pool = NULL;
+  l->alloc = al;
+
+  return l;
+}
+
+list *
+list_create_with_pool (size_t nodes_number)
+{
+  list *l = list_create ();
+
+  l->pool = pool_allocator_create (sizeof (struct lnode), nodes_number);
 
   return l;
 }
@@ -39,11 +60,19 @@ list_clear (list *l, void (*destr) (dptr data))
 {
   struct lnode *tmp = l->front;
 
+  /* If all nodes are in the pool and there is no data to
+     destroy, releasing them at once. */
+  if (l->pool && !destr && pool_allocator_used (l->pool) == l->size)
+    {
+      pool_allocator_reset (l->pool);
+      tmp = NULL;
+    }
+
   /* Deleting all nodes. */
   while (tmp)
     {
       struct lnode *tmp_next = tmp->next;
-      __do_node_destroy (tmp, destr);
+      __do_node_destroy_from (l->pool, &l->alloc, tmp, destr);
       tmp = tmp_next;
     }
 
@@ -59,7 +88,7 @@ list_copy (const list *l, dptr (*cpy) (const dptr data))
   if (!l)
     return NULL;
   /* Creating dest list. */
-  list *other = list_create ();
+  list *other = list_create_with_allocator (&l->alloc);
   /* Copy values to dest list. */
   struct lnode *cur = l->front;
 
@@ -110,10 +139,14 @@ list_count_if (const list *l, bool (*predicate) (constdptr data))
 inline void
 list_destroy (list *l, void (*destr) (dptr data))
 {
-  /* Deleting all nodes. */
-  list_clear (l, destr);
+  /* Deleting all nodes. Nodes in the pool are
+     freed with the pool itself. */
+  if (!l->pool || destr || pool_allocator_used (l->pool) != l->size)
+    list_clear (l, destr);
+  if (l->pool)
+    pool_allocator_destroy (l->pool);
   /* Frees the memory for struct list. */
-  free (l);
+  allocator_deallocate (&l->alloc, l, sizeof (list));
 }
 
 inline __attribute__ ((always_inline)) list_iterator
@@ -172,7 +205,7 @@ list_erase (list *l, list_iterator where, void (*destr) (dptr data))
     l->front = where->next;
   l->size--;
 
-  __do_node_destroy (tmp, destr);
+  __do_node_destroy_from (l->pool, &l->alloc, tmp, destr);
 }
 
 void
@@ -282,7 +315,8 @@ list_insert (list *l, list_iterator where, constdptr data)
   else
     {
       /* If new element going to the middle. */
-      where->prev->next = __do_node_create (data, where, where->prev);
+      where->prev->next = __do_node_create_from (l->pool, &l->alloc, data,
+                                                 where, where->prev);
       where->prev = where->prev->next;
 
       l->size++;
@@ -340,7 +374,7 @@ list_pop_back (list *l, void (*destr) (dptr data))
     l->front = NULL;
   l->size--;
   /* Deleting old front element. */
-  __do_node_destroy (tmp, destr);
+  __do_node_destroy_from (l->pool, &l->alloc, tmp, destr);
 }
 
 void
@@ -364,7 +398,7 @@ list_pop_front (list *l, void (*destr) (dptr data))
     l->back = NULL;
   l->size--;
   /* Deleting old front element. */
-  __do_node_destroy (tmp, destr);
+  __do_node_destroy_from (l->pool, &l->alloc, tmp, destr);
 }
 
 void
@@ -373,7 +407,7 @@ list_push_back (list *l, constdptr data)
   /* Saving old back element. */
   struct lnode *tmp = l->back;
   /* Creating new last element. */
-  l->back = __do_node_create (data, NULL, l->back);
+  l->back = __do_node_create_from (l->pool, &l->alloc, data, NULL, l->back);
 
   /* If l->front was exist => tmp != NULL, so making ref to the next
       Esle new element is front element too. */
@@ -391,7 +425,8 @@ list_push_front (list *l, constdptr data)
   /* Saving old front element. */
   struct lnode *tmp = l->front;
   /* Creating new first element. */
-  l->front = __do_node_create (data, l->front, NULL);
+  l->front
+      = __do_node_create_from (l->pool, &l->alloc, data, l->front, NULL);
 
   /* If l->back was exist => tmp != NULL, so making ref to the prev
       Esle new element is back element too. */
@@ -444,7 +479,25 @@ list_size (const list *l)
   return l->size;
 }
 
-void list_sort (list *l, int (*cmp) (constdptr first, constdptr second));
+void
+list_sort (list *l, int (*cmp) (constdptr first, constdptr second))
+{
+  if (!l || l->size < 2)
+    return;
+
+  // Chain is sorted through <next> only.
+  l->front = __node_sort (l->front, offsetof (struct lnode, data),
+                          offsetof (struct lnode, next), cmp);
+
+  // Restoring <prev> and <back> in a single pass.
+  struct lnode *prev = NULL;
+  for (struct lnode *cur = l->front; cur; cur = cur->next)
+    {
+      cur->prev = prev;
+      prev = cur;
+    }
+  l->back = prev;
+}
 
 void list_unique (list *l,
                   bool (*predicate) (constdptr first, constdptr second));
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <stddef.h>  // size_t
 #include <stdlib.h>  // malloc, free
 
+#include "allocator.h"
 #include "types.h"
 
 #define lnode do_node
@@ -39,6 +40,18 @@ typedef struct list
    * @brief Pointer to the back of list.
    */
   struct lnode *back;
+
+  /**
+   * @brief Pool allocator for nodes. NULL if
+   * nodes are allocated by malloc.
+   */
+  struct pool_allocator *pool;
+
+  /**
+   * @brief Allocator of the list instance and
+   * nodes, that are not in the pool.
+   */
+  allocator alloc;
 } list;
 
 ////////////////////////////////////////////////////
@@ -52,6 +65,26 @@ typedef struct list
  */
 list *list_create ();
 
+/**
+ * @brief Function to create new list with pool of nodes.
+ * Allocates the memory. Should be destroyed at the end.
+ * Nodes are taken from own pool of <nodes_number> nodes and
+ * from malloc, when pool is exhausted. If all nodes are in the
+ * pool and there is no destructor, clear/destroy releases them at once.
+ * @param nodes_number Number of nodes in the pool.
+ * @return Pointer to new list.
+ */
+list *list_create_with_pool (size_t nodes_number);
+
+/**
+ * @brief Function to create new list, that takes
+ * memory for itself and its nodes from <alloc>.
+ * Should be destroyed at the end.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return Pointer to new list.
+ */
+list *list_create_with_allocator (const allocator *alloc);
+
 /**
  * @brief Function returns last element of
  * the list.
@@ -397,7 +430,10 @@ void list_reverse (list *l);
 size_t list_size (const list *l);
 
 /**
- * @brief Function to sort the list.
+ * @brief Function to sort the list by natural
+ * merge sort. Nodes are relinked, data is not copied
+ * and no memory is allocated. Stable, O(n log n),
+ * sorted or reversed list takes O(n).
  *
  * @param l Pointer to the list.
  * @param cmp Function of comparing
@@ -10,16 +10,95 @@
   struct pair var_name = { 0 };                                               \
   var_name.key = (dptr)key;
 
+////////////////////////////////////////////////////
+/*          Private functions of the map          */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create map with tree, that
+ * destroys pairs by <destr>.
+ *
+ * @param cmp Compare function.
+ * @param destr Destructor of the tree.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return map* New map.
+ */
+static map *
+__map_create (int (*cmp) (constdptr first, constdptr second),
+              void (*destr) (dptr pair), const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  map *mp = (map *)allocator_allocate (&al, sizeof (map));
+
+  mp->alloc = al;
+  mp->tree = rbtree_create_with_allocator (cmp, destr, false, &mp->alloc);
+
+  return mp;
+}
+
+/**
+ * @brief Function to destroy pair, that is owned by map.
+ *
+ * @param mp Pointer to map.
+ * @param pr Pair to destroy.
+ */
+inline static void
+__map_pair_destroy (map *mp, struct pair *pr)
+{
+  if (mp->key_destr)
+    mp->key_destr (pr->key);
+  if (mp->value_destr)
+    mp->value_destr (pr->value);
+  allocator_deallocate (&mp->alloc, pr, sizeof (struct pair));
+}
+
+/**
+ * @brief Function to destroy all pairs, if they are
+ * owned by map. Nodes of the tree stay untouched.
+ *
+ * @param mp Pointer to map.
+ */
+static void
+__map_pairs_destroy (map *mp)
+{
+  if (!mp->free_pairs)
+    return;
+
+  for (map_iterator iter = map_begin (mp); iter != map_end ();
+       iter = map_next (iter))
+    __map_pair_destroy (mp, iter->data);
+}
+
+////////////////////////////////////////////////////
+/*       Public API functions of the map          */
+////////////////////////////////////////////////////
+
 map *
 map_create (int (*cmp) (constdptr first, constdptr second),
             void (*destr) (dptr pair))
 {
-  map *mp = (map *)malloc (sizeof (map));
+  map *mp = __map_create (cmp, destr ? destr : pair_destroy_default, NULL);
+
+  // Pairs are freed by destructor, provided by user.
+  mp->key_destr = NULL;
+  mp->value_destr = NULL;
+  mp->free_pairs = false;
+
+  return mp;
+}
 
-  mp->tree = rbtree_create (cmp, destr, false);
+map *
+map_create_with_allocator (int (*cmp) (constdptr first, constdptr second),
+                           void (*key_destr) (dptr key),
+                           void (*value_destr) (dptr value),
+                           const allocator *alloc)
+{
+  map *mp = __map_create (cmp, NULL, alloc);
 
-  if (!destr)
-    mp->tree->destr = pair_destroy_default;
+  // Pairs are freed by map, key and value by user.
+  mp->key_destr = key_destr;
+  mp->value_destr = value_destr;
+  mp->free_pairs = true;
 
   return mp;
 }
@@ -27,9 +106,7 @@ map_create (int (*cmp) (constdptr first, constdptr second),
 dptr
 map_at (const map *mp, constdptr key)
 {
-  __MAP_FAKE_PAIR (key, pr);
-
-  map_iterator iter = map_find (mp, &pr);
+  map_iterator iter = map_find (mp, key);
 
   if (!iter)
     return NULL;
@@ -61,6 +138,7 @@ map_clear (map *mp)
   if (!mp)
     return;
 
+  __map_pairs_destroy (mp);
   rbtree_clear (mp->tree);
 }
 
@@ -91,7 +169,9 @@ map_destroy (map *mp)
   if (!mp)
     return;
 
+  __map_pairs_destroy (mp);
   rbtree_destroy (mp->tree);
+  allocator_deallocate (&mp->alloc, mp, sizeof (map));
 }
 
 inline map_iterator
@@ -100,9 +180,27 @@ map_insert (map *mp, constdptr key, constdptr value)
   if (!mp)
     return NULL;
 
-  struct pair *pr = pair_create (key, value);
+  struct pair *pr;
+
+  if (mp->free_pairs)
+    {
+      pr = (struct pair *)allocator_allocate (&mp->alloc,
+                                              sizeof (struct pair));
+      pr->key = (dptr)key;
+      pr->value = (dptr)value;
+    }
+  else
+    pr = pair_create (key, value);
+
+  map_iterator iter = rbtree_insert (mp->tree, pr);
+
+  // Key is already in map, pair is not needed.
+  if (!iter && mp->free_pairs)
+    allocator_deallocate (&mp->alloc, pr, sizeof (struct pair));
+  else if (!iter)
+    free (pr);
 
-  return rbtree_insert (mp->tree, pr);
+  return iter;
 }
 
 inline map_iterator
@@ -120,10 +218,19 @@ map_rend ()
 inline map_iterator
 map_erase (map *mp, map_iterator iter)
 {
-  if (!mp)
+  if (!mp || !iter)
     return NULL;
 
-  return rbtree_erase (mp->tree, iter);
+  if (!mp->free_pairs)
+    return rbtree_erase (mp->tree, iter);
+
+  // Tree swaps data of nodes on erase, so pair is saved before.
+  struct pair *pr = iter->data;
+  map_iterator next = rbtree_erase (mp->tree, iter);
+
+  __map_pair_destroy (mp, pr);
+
+  return next;
 }
 
 inline bool
@@ -154,7 +261,7 @@ map_remove (map *mp, constdptr key)
 
   __MAP_FAKE_PAIR (key, pr);
 
-  rbtree_remove (mp->tree, &pr);
+  map_erase (mp, rbtree_find (mp->tree, &pr));
 }
 
 inline size_t
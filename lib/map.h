@@ -10,6 +10,7 @@
 #include <stdbool.h> // bool
 #include <stdlib.h>  //malloc, free
 
+#include "allocator.h"
 #include "rbtree.h"
 
 /**
@@ -24,6 +25,30 @@ typedef struct map
    * @brief Instance of Red-Black Tree.
    */
   rbtree *tree;
+
+  /**
+   * @brief Destructor for keys, NULL if they should
+   * not be freed. Used only, if <free_pairs> is set.
+   */
+  void (*key_destr) (dptr);
+
+  /**
+   * @brief Destructor for values, NULL if they should
+   * not be freed. Used only, if <free_pairs> is set.
+   */
+  void (*value_destr) (dptr);
+
+  /**
+   * @brief Allocator of the map instance and its tree.
+   */
+  allocator alloc;
+
+  /**
+   * @brief true if pairs are allocated and freed by map
+   * through <alloc>, false if they are freed by
+   * destructor of the tree.
+   */
+  bool free_pairs;
 } map;
 
 typedef rbtree_iterator map_iterator;
@@ -48,6 +73,28 @@ typedef const_rbtree_iterator const_map_iterator;
 map *map_create (int (*cmp) (constdptr first, constdptr second),
                  void (*destr) (dptr pair));
 
+/**
+ * @brief Function to create new map, that takes memory
+ * for itself, its nodes and pairs from <alloc>. Unlike
+ * map_create(), pairs are owned and freed by map, so there
+ * is no destructor for the whole pair, but separate
+ * destructors for its key and value, like in
+ * hashmap_create_with_allocator().
+ *
+ * @param cmp Compare function, the same as in map_create().
+ * @param key_destr Destructor for keys.
+ * Null if should not be freed.
+ * @param value_destr Destructor for values.
+ * Null if should not be freed.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return map * New instanse of map.
+ */
+map *map_create_with_allocator (int (*cmp) (constdptr first,
+                                            constdptr second),
+                                void (*key_destr) (dptr key),
+                                void (*value_destr) (dptr value),
+                                const allocator *alloc);
+
 /**
  * @brief Function to get value by key from the
  * hmap.
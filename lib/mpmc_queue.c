@@ -0,0 +1,267 @@
+#include "mpmc_queue.h"
+
+////////////////////////////////////////////////////
+/*      Private functions of the mpmc_queue       */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to wait in blocking functions.
+ * Spins first, then yields the CPU.
+ *
+ * @param spins Pointer to the number of waits.
+ */
+inline static void
+__mpmc_queue_backoff (unsigned *spins)
+{
+  if (*spins < MPMC_QUEUE_SPIN_LIMIT)
+    (*spins)++;
+  else
+    sched_yield ();
+}
+
+/**
+ * @brief Function to get cell by position.
+ *
+ * @param q Pointer to the queue.
+ * @param pos Position.
+ * @return struct __mpmc_queue_cell* Cell.
+ */
+inline static struct __mpmc_queue_cell *
+__mpmc_queue_cell (const mpmc_queue *q, size_t pos)
+{
+  return q->cells + (pos & (q->capacity - 1));
+}
+
+/**
+ * @brief Function to claim up to <count> positions, which
+ * cells are ready already: sequence of the cell is equal
+ * to position + <lap>. Batch stops at the first cell, that
+ * isn't ready, so function never waits for other threads.
+ * Claimed cells can't be changed by others, because
+ * nobody else can claim their positions.
+ *
+ * @param q Pointer to the queue.
+ * @param pos Counter of own side.
+ * @param lap 0 for producers, 1 for consumers.
+ * @param count Maximal number of positions.
+ * @param first Pointer to store the first claimed position.
+ * @return size_t Number of claimed positions.
+ */
+static size_t
+__mpmc_queue_claim (mpmc_queue *q, atomic_size_t *pos, size_t lap,
+                    size_t count, size_t *first)
+{
+  size_t cur = atomic_load_explicit (pos, memory_order_relaxed);
+
+  if (count == 0)
+    return 0;
+
+  for (;;)
+    {
+      size_t seq = atomic_load_explicit (&__mpmc_queue_cell (q, cur)->sequence,
+                                         memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)(cur + lap);
+
+      // Cell is not finished on the previous lap:
+      // queue is full for producer or empty for consumer.
+      if (diff < 0)
+        return 0;
+
+      // Other thread has claimed <cur> already.
+      if (diff > 0)
+        {
+          cur = atomic_load_explicit (pos, memory_order_relaxed);
+          continue;
+        }
+
+      size_t n = 1;
+      while (n < count
+             && atomic_load_explicit (
+                    &__mpmc_queue_cell (q, cur + n)->sequence,
+                    memory_order_acquire)
+                    == cur + n + lap)
+        n++;
+
+      if (atomic_compare_exchange_weak_explicit (
+              pos, &cur, cur + n, memory_order_relaxed, memory_order_relaxed))
+        {
+          *first = cur;
+          return n;
+        }
+    }
+}
+
+////////////////////////////////////////////////////
+/*     Public API functions of the mpmc_queue     */
+////////////////////////////////////////////////////
+
+mpmc_queue *
+mpmc_queue_create (size_t capacity)
+{
+  mpmc_queue *q = (mpmc_queue *)aligned_alloc (MPMC_QUEUE_CACHE_LINE,
+                                               sizeof (mpmc_queue));
+
+  // Rounding capacity up to power of 2. With capacity 1
+  // free and full cell would have the same sequence.
+  q->capacity = 2;
+  while (q->capacity < capacity)
+    q->capacity <<= 1;
+
+  q->cells = (struct __mpmc_queue_cell *)malloc (
+      sizeof (struct __mpmc_queue_cell) * q->capacity);
+
+  // Every cell waits for producer of the first lap.
+  for (size_t i = 0; i < q->capacity; i++)
+    atomic_init (&q->cells[i].sequence, i);
+
+  atomic_init (&q->enqueue_pos, 0);
+  atomic_init (&q->dequeue_pos, 0);
+
+  return q;
+}
+
+inline size_t
+mpmc_queue_capacity (const mpmc_queue *q)
+{
+  if (!q)
+    return 0;
+  return q->capacity;
+}
+
+void
+mpmc_queue_destroy (mpmc_queue *q)
+{
+  if (!q)
+    return;
+
+  free (q->cells);
+  free (q);
+}
+
+inline bool
+mpmc_queue_empty (const mpmc_queue *q)
+{
+  return mpmc_queue_size (q) == 0;
+}
+
+dptr
+mpmc_queue_pop (mpmc_queue *q)
+{
+  dptr data;
+  unsigned spins = 0;
+
+  while (!mpmc_queue_try_pop (q, &data))
+    __mpmc_queue_backoff (&spins);
+
+  return data;
+}
+
+void
+mpmc_queue_pop_many (mpmc_queue *q, dptr *out, size_t count)
+{
+  unsigned spins = 0;
+
+  while (count > 0)
+    {
+      size_t popped = mpmc_queue_try_pop_many (q, out, count);
+
+      if (popped == 0)
+        __mpmc_queue_backoff (&spins);
+
+      out += popped;
+      count -= popped;
+    }
+}
+
+void
+mpmc_queue_push (mpmc_queue *q, constdptr data)
+{
+  unsigned spins = 0;
+
+  while (!mpmc_queue_try_push (q, data))
+    __mpmc_queue_backoff (&spins);
+}
+
+void
+mpmc_queue_push_many (mpmc_queue *q, const dptr *data, size_t count)
+{
+  unsigned spins = 0;
+
+  while (count > 0)
+    {
+      size_t pushed = mpmc_queue_try_push_many (q, data, count);
+
+      if (pushed == 0)
+        __mpmc_queue_backoff (&spins);
+
+      data += pushed;
+      count -= pushed;
+    }
+}
+
+size_t
+mpmc_queue_size (const mpmc_queue *q)
+{
+  if (!q)
+    return 0;
+
+  size_t deq = atomic_load_explicit (&q->dequeue_pos, memory_order_acquire);
+  size_t enq = atomic_load_explicit (&q->enqueue_pos, memory_order_acquire);
+
+  // Counters are read not at once, so difference may be negative.
+  return ((intptr_t)(enq - deq) > 0) ? enq - deq : 0;
+}
+
+inline bool
+mpmc_queue_try_pop (mpmc_queue *q, dptr *data)
+{
+  return mpmc_queue_try_pop_many (q, data, 1) == 1;
+}
+
+size_t
+mpmc_queue_try_pop_many (mpmc_queue *q, dptr *out, size_t count)
+{
+  size_t first;
+  size_t n = __mpmc_queue_claim (q, &q->dequeue_pos, 1, count, &first);
+
+  for (size_t i = 0; i < n; i++)
+    {
+      struct __mpmc_queue_cell *cell = __mpmc_queue_cell (q, first + i);
+
+      out[i] = cell->data;
+
+      // Cell is free for producer of the next lap.
+      atomic_store_explicit (&cell->sequence, first + i + q->capacity,
+                             memory_order_release);
+    }
+
+  return n;
+}
+
+inline bool
+mpmc_queue_try_push (mpmc_queue *q, constdptr data)
+{
+  dptr elem = (dptr)data;
+
+  return mpmc_queue_try_push_many (q, &elem, 1) == 1;
+}
+
+size_t
+mpmc_queue_try_push_many (mpmc_queue *q, const dptr *data, size_t count)
+{
+  size_t first;
+  size_t n = __mpmc_queue_claim (q, &q->enqueue_pos, 0, count, &first);
+
+  for (size_t i = 0; i < n; i++)
+    {
+      struct __mpmc_queue_cell *cell = __mpmc_queue_cell (q, first + i);
+
+      cell->data = data[i];
+
+      // Cell is ready for consumer.
+      atomic_store_explicit (&cell->sequence, first + i + 1,
+                             memory_order_release);
+    }
+
+  return n;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file mpmc_queue.h Implementation of bounded lock-free
+ * Queue for many producer and many consumer threads.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_MPMC_QUEUE_H
+#define _EXTENDED_C_LIB_LIB_MPMC_QUEUE_H
+
+#include <sched.h>     // sched_yield
+#include <stdatomic.h> // atomic_size_t
+#include <stdbool.h>   // bool
+#include <stddef.h>    // size_t
+#include <stdint.h>    // intptr_t
+#include <stdlib.h>    // aligned_alloc, free
+
+#include "types.h"
+
+/**
+ * @brief Size of the cache line. Positions of producers
+ * and consumers are aligned to it, so they don't share
+ * one line.
+ */
+#define MPMC_QUEUE_CACHE_LINE 64
+
+/**
+ * @brief Number of spins of blocking functions,
+ * before they start to yield the CPU.
+ */
+#define MPMC_QUEUE_SPIN_LIMIT 128
+
+/**
+ * @struct __mpmc_queue_cell
+ * @brief Cell of the queue. <sequence> tells, whose
+ * turn is to use the cell: it is equal to position
+ * for producer and to position + 1 for consumer.
+ */
+struct __mpmc_queue_cell
+{
+  /**
+   * @brief Sequence number of the cell.
+   */
+  atomic_size_t sequence;
+
+  /**
+   * @brief Element.
+   */
+  dptr data;
+};
+
+/**
+ * @struct mpmc_queue
+ * @brief Bounded queue in style of Dmitry Vyukov.
+ * Threads check sequences of cells and claim ready
+ * ones by CAS, so producers and consumers don't
+ * touch the same counter.
+ */
+typedef struct mpmc_queue
+{
+  /**
+   * @brief Ring buffer of cells.
+   */
+  struct __mpmc_queue_cell *cells;
+
+  /**
+   * @brief Capacity of <cells>, power of two, at least 2.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Position of the next push.
+   */
+  atomic_size_t enqueue_pos __attribute__ ((aligned (MPMC_QUEUE_CACHE_LINE)));
+
+  /**
+   * @brief Position of the next pop.
+   */
+  atomic_size_t dequeue_pos __attribute__ ((aligned (MPMC_QUEUE_CACHE_LINE)));
+} mpmc_queue;
+
+////////////////////////////////////////////////////
+/*     Public API functions of the mpmc_queue     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new mpmc queue.
+ * Allocates the memory. Should be destroyed at the end.
+ *
+ * @param capacity Maximal number of elements,
+ * rounded up to power of two, at least 2.
+ * @return mpmc_queue* Pointer to new queue.
+ */
+mpmc_queue *mpmc_queue_create (size_t capacity);
+
+/**
+ * @brief Function to get capacity of the queue.
+ *
+ * @param q Pointer to the queue.
+ * @return size_t Capacity.
+ */
+size_t mpmc_queue_capacity (const mpmc_queue *q);
+
+/**
+ * @brief Destructor of the queue. Elements
+ * are not destroyed. Should not be called,
+ * while queue is used by other threads.
+ *
+ * @param q Pointer to the queue.
+ */
+void mpmc_queue_destroy (mpmc_queue *q);
+
+/**
+ * @brief Function to check if queue is empty.
+ * Result may be outdated, when it is returned.
+ *
+ * @param q Pointer to the queue.
+ * @return true If queue is empty.
+ * @return false If queue isn't empty.
+ */
+bool mpmc_queue_empty (const mpmc_queue *q);
+
+/**
+ * @brief Function to pop element. Waits, while
+ * queue is empty.
+ *
+ * @param q Pointer to the queue.
+ * @return dptr Popped element.
+ */
+dptr mpmc_queue_pop (mpmc_queue *q);
+
+/**
+ * @brief Function to pop <count> elements to <out>.
+ * Waits, until all of them are popped. Elements
+ * of one call are contiguous in the queue order,
+ * while there are no other consumers waiting.
+ *
+ * @param q Pointer to the queue.
+ * @param out Memory for <count> elements.
+ * @param count Number of elements.
+ */
+void mpmc_queue_pop_many (mpmc_queue *q, dptr *out, size_t count);
+
+/**
+ * @brief Function to push element. Waits, while
+ * queue is full.
+ *
+ * @param q Pointer to the queue.
+ * @param data Element to push.
+ */
+void mpmc_queue_push (mpmc_queue *q, constdptr data);
+
+/**
+ * @brief Function to push <count> elements from <data>.
+ * Waits, until all of them are pushed.
+ *
+ * @param q Pointer to the queue.
+ * @param data Elements to push.
+ * @param count Number of elements.
+ */
+void mpmc_queue_push_many (mpmc_queue *q, const dptr *data, size_t count);
+
+/**
+ * @brief Function to get number of elements.
+ * Result may be outdated, when it is returned.
+ *
+ * @param q Pointer to the queue.
+ * @return size_t Number of claimed elements.
+ */
+size_t mpmc_queue_size (const mpmc_queue *q);
+
+/**
+ * @brief Function to pop element without waiting.
+ *
+ * @param q Pointer to the queue.
+ * @param data Pointer to store popped element.
+ * @return true If element was popped.
+ * @return false If queue is empty.
+ */
+bool mpmc_queue_try_pop (mpmc_queue *q, dptr *data);
+
+/**
+ * @brief Function to pop up to <count> elements to
+ * <out> without waiting. Range of cells, that are
+ * written already, is claimed by one CAS. Range stops
+ * at the first cell, which producer hasn't finished yet.
+ *
+ * @param q Pointer to the queue.
+ * @param out Memory for <count> elements.
+ * @param count Maximal number of elements.
+ * @return size_t Number of popped elements.
+ */
+size_t mpmc_queue_try_pop_many (mpmc_queue *q, dptr *out, size_t count);
+
+/**
+ * @brief Function to push element without waiting.
+ *
+ * @param q Pointer to the queue.
+ * @param data Element to push.
+ * @return true If element was pushed.
+ * @return false If queue is full.
+ */
+bool mpmc_queue_try_push (mpmc_queue *q, constdptr data);
+
+/**
+ * @brief Function to push up to <count> elements from
+ * <data> without waiting. Range of cells, that are read
+ * already, is claimed by one CAS. Range stops at the
+ * first cell, which consumer hasn't finished yet.
+ *
+ * @param q Pointer to the queue.
+ * @param data Elements to push.
+ * @param count Maximal number of elements.
+ * @return size_t Number of pushed elements.
+ */
+size_t mpmc_queue_try_push_many (mpmc_queue *q, const dptr *data,
+                                 size_t count);
+
+#endif
@@ -1,5 +1,80 @@
 #include "pool_allocator.h"
 
+#include <string.h> // memcpy
+
+////////////////////////////////////////////////////
+/*    Private functions of the pool_allocator     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to read link to the next free
+ * block, stored in the first bytes of <block>.
+ *
+ * @param block Free block.
+ * @return dptr Next free block.
+ */
+inline static dptr
+__pool_allocator_next (constdptr block)
+{
+  dptr next;
+  memcpy (&next, block, sizeof (dptr));
+  return next;
+}
+
+/**
+ * @brief Function to store link to the next free
+ * block into the first bytes of <block>. Block may
+ * be not aligned for pointer, so memcpy is used.
+ *
+ * @param block Free block.
+ * @param next Next free block.
+ */
+inline static void
+__pool_allocator_set_next (dptr block, dptr next)
+{
+  memcpy (block, &next, sizeof (dptr));
+}
+
+#ifdef DEBUG
+
+/**
+ * @brief Function to get index of the block.
+ *
+ * @param al Pointer to pool allocator.
+ * @param ptr Block.
+ * @return size_t Index of the block.
+ */
+inline static size_t
+__pool_allocator_index (const pool_allocator *al, constdptr ptr)
+{
+  return (size_t)(ptr - al->ptr_begin) / al->block_size;
+}
+
+/**
+ * @brief Function to mark block as allocated or free.
+ *
+ * @param al Pointer to pool allocator.
+ * @param ptr Block.
+ * @param allocated New state of the block.
+ * @return bool Former state of the block.
+ */
+static bool
+__pool_allocator_mark (pool_allocator *al, constdptr ptr, bool allocated)
+{
+  size_t index = __pool_allocator_index (al, ptr);
+  uint8_t bit = (uint8_t)(1u << (index % 8));
+  bool former = al->allocated[index / 8] & bit;
+
+  if (allocated)
+    al->allocated[index / 8] |= bit;
+  else
+    al->allocated[index / 8] &= (uint8_t)~bit;
+
+  return former;
+}
+
+#endif // DEBUG
+
 ////////////////////////////////////////////////////
 /*  Public API functions of the pool_allocator    */
 ////////////////////////////////////////////////////
@@ -9,12 +84,17 @@ pool_allocator_create (size_t block_size, size_t blocks_number)
 {
   pool_allocator *al = (pool_allocator *)malloc (sizeof (pool_allocator));
 
+  // Free block should fit link to the next one.
+  if (block_size < sizeof (dptr))
+    block_size = sizeof (dptr);
+
   // counting size.
   size_t size = block_size * blocks_number;
   al->block_size = block_size;
   al->blocks_number = blocks_number;
 
-  // allocating memory for allocator.
+  // allocating memory for allocator. Pages are not
+  // touched until blocks are allocated.
   al->ptr_begin = mmap (NULL, size, PROT_READ | PROT_WRITE,
                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 
@@ -22,12 +102,14 @@ pool_allocator_create (size_t block_size, size_t blocks_number)
   // that allocator can manipulate. )
   al->ptr_end = al->ptr_begin + size;
 
-  // creating forward_list for free blocks.
-  al->free_blocks = forward_list_create ();
+  // All blocks are untouched, there are no freed ones.
+  al->used = 0;
+  al->free_list = NULL;
+  al->untouched = al->ptr_end;
 
-  for (size_t i = 0; i < al->blocks_number; i++)
-    forward_list_push_front (al->free_blocks,
-                             al->ptr_begin + al->block_size * i);
+#ifdef DEBUG
+  al->allocated = (uint8_t *)calloc ((blocks_number + 7) / 8, 1);
+#endif // DEBUG
 
   return al;
 }
@@ -37,15 +119,26 @@ pool_allocator_allocate (pool_allocator *al)
 {
   dptr ptr = NULL;
 
-  // Getting free block if there are free blocks,
-  // otherwise ptr will be NULL.
-  if (!forward_list_empty (al->free_blocks))
+  // Reusing last freed block, otherwise carving
+  // new one. If both are absent, ptr will be NULL.
+  if (al->free_list)
     {
-      ptr = forward_list_front (al->free_blocks);
-
-      // Removing this block from free_blocks.
-      forward_list_pop_front (al->free_blocks, NULL);
+      ptr = al->free_list;
+      al->free_list = __pool_allocator_next (ptr);
     }
+  else if (al->untouched != al->ptr_begin)
+    {
+      al->untouched -= al->block_size;
+      ptr = al->untouched;
+    }
+  else
+    return NULL;
+
+#ifdef DEBUG
+  __pool_allocator_mark (al, ptr, true);
+#endif // DEBUG
+
+  al->used++;
 
   return ptr;
 }
@@ -59,26 +152,60 @@ pool_allocator_deallocate (pool_allocator *al, dptr ptr)
   if (al->ptr_begin > ptr || al->ptr_end <= ptr)
     return;
 
-  if ((size_t)ptr % al->block_size != (size_t)al->ptr_begin % al->block_size)
+  if ((size_t)(ptr - al->ptr_begin) % al->block_size != 0)
     return;
 
   // Checking if all blocks are already freed.
-  if (forward_list_size (al->free_blocks) == al->blocks_number)
+  if (al->used == 0)
+    return;
+
+#ifdef DEBUG
+  // Checking if this block is already freed.
+  if (ptr < al->untouched || !__pool_allocator_mark (al, ptr, false))
     return;
+#endif // DEBUG
 
   // If everything is OK, pushing ptr to free blocks.
-  forward_list_push_front (al->free_blocks, ptr);
+  __pool_allocator_set_next (ptr, al->free_list);
+  al->free_list = ptr;
+  al->used--;
+}
+
+inline bool
+pool_allocator_owns (const pool_allocator *al, constdptr ptr)
+{
+  return al->ptr_begin <= ptr && ptr < al->ptr_end;
+}
+
+void
+pool_allocator_reset (pool_allocator *al)
+{
+  // Forgetting freed blocks, all blocks are untouched again.
+  al->used = 0;
+  al->free_list = NULL;
+  al->untouched = al->ptr_end;
+
+#ifdef DEBUG
+  memset (al->allocated, 0, (al->blocks_number + 7) / 8);
+#endif // DEBUG
+}
+
+inline size_t
+pool_allocator_used (const pool_allocator *al)
+{
+  return al->used;
 }
 
 void
 pool_allocator_destroy (pool_allocator *al)
 {
-  // freeing memory of forward_list by calling destructor.
-  forward_list_destroy (al->free_blocks, NULL);
+#ifdef DEBUG
+  free (al->allocated);
+#endif // DEBUG
 
   // freeing ptr
   munmap (al->ptr_begin, al->block_size * al->blocks_number);
 
   // freeing allocator.
   free (al);
-}
\ No newline at end of file
+}
@@ -6,15 +6,21 @@
 #ifndef _EXTENDED_C_LIB_POOL_ALLOCATOR_H
 #define _EXTENDED_C_LIB_POOL_ALLOCATOR_H
 
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uint8_t
 #include <stdlib.h>   // malloc, free
 #include <sys/mman.h> // mmap, munmap
 
-#include "forward_list.h"
 #include "types.h"
 
 /**
  * @struct pool_allocator
  * @brief Implemenation of pool_allocator.
+ * Free blocks are linked through their first bytes, so
+ * allocator needs no memory except of the pool itself.
+ * Blocks, that have never been allocated, are not linked
+ * at all: they are carved from the end of the pool
+ * one by one.
  */
 typedef struct pool_allocator
 {
@@ -27,10 +33,11 @@ typedef struct pool_allocator
    * @brief Pointer to the next after last
    * byte that allocator manages.
    */
-
   dptr ptr_end;
+
   /**
    * @brief Size of one block (in bytes).
+   * At least sizeof (dptr).
    */
   size_t block_size;
 
@@ -40,9 +47,29 @@ typedef struct pool_allocator
   size_t blocks_number;
 
   /**
-   * @brief Forward list to manage free blocks.
+   * @brief Number of allocated blocks.
+   */
+  size_t used;
+
+  /**
+   * @brief Head of the list of freed blocks.
+   * NULL if there are no freed blocks.
+   */
+  dptr free_list;
+
+  /**
+   * @brief Blocks in [ptr_begin, untouched) have never
+   * been allocated.
+   */
+  dptr untouched;
+
+#ifdef DEBUG
+  /**
+   * @brief Bit per block, set if block is allocated.
+   * Catches double free.
    */
-  forward_list *free_blocks;
+  uint8_t *allocated;
+#endif // DEBUG
 } pool_allocator;
 
 ////////////////////////////////////////////////////
@@ -51,6 +78,7 @@ typedef struct pool_allocator
 
 /**
  * @brief Contructor for the pool allocator.
+ * Does not touch memory of blocks.
  *
  * @param block_size Number of bytes for one
  * block.
@@ -63,23 +91,52 @@ pool_allocator *pool_allocator_create (size_t block_size,
 
 /**
  * @brief Function to allocate new block of memory
- * from allocator.
+ * from allocator. Last freed block is returned first.
  *
  * @param al Pointer to pool allocator.
  * @return dptr Pointer to allocated memory.
+ * NULL if there are no free blocks.
  */
 dptr pool_allocator_allocate (pool_allocator *al);
 
 /**
- * @brief Function to allocate new block of memory
- * from allocator.
+ * @brief Function to return block of memory
+ * to allocator. Pointers out of pool and not to
+ * the start of the block are ignored. In DEBUG
+ * mode double free is ignored too.
  *
  * @param al Pointer to pool allocator.
- * @param ptr Pointer to block to deallocate. Allocator
- * will add to forward_list of free blocks.
+ * @param ptr Pointer to block to deallocate.
  */
 void pool_allocator_deallocate (pool_allocator *al, dptr ptr);
 
+/**
+ * @brief Function to check if <ptr> block
+ * belongs to allocator's memory.
+ *
+ * @param al Pointer to pool allocator.
+ * @param ptr Pointer to check.
+ * @return true If ptr is inside allocator's memory.
+ * @return false Otherwise.
+ */
+bool pool_allocator_owns (const pool_allocator *al, constdptr ptr);
+
+/**
+ * @brief Function to make all blocks free at once, O(1).
+ * Blocks, that were allocated, should not be used after.
+ *
+ * @param al Pointer to pool allocator.
+ */
+void pool_allocator_reset (pool_allocator *al);
+
+/**
+ * @brief Function to get number of allocated blocks.
+ *
+ * @param al Pointer to pool allocator.
+ * @return size_t Number of blocks in use.
+ */
+size_t pool_allocator_used (const pool_allocator *al);
+
 /**
  * @brief Destructor for pool allocator.
  *
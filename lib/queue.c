@@ -1,4 +1,6 @@
 #include "queue.h"
+
+#include "pool_allocator.h"
 #include <stdbool.h>
 
 ////////////////////////////////////////////////////
@@ -8,12 +10,50 @@
 queue *
 queue_create (void (*destr) (dptr data))
 {
-  queue *q = (queue *)malloc (sizeof (queue));
+  return queue_create_with_allocator (destr, NULL);
+}
+
+queue *
+queue_create_with_allocator (void (*destr) (dptr data),
+                             const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  queue *q = (queue *)allocator_allocate (&al, sizeof (queue));
 
   q->front = NULL;
   q->back = NULL;
   q->size = 0;
   q->destr = destr;
+  q->pool = NULL;
+  q->alloc = al;
+  q->ring = NULL;
+
+  return q;
+}
+
+queue *
+queue_create_with_pool (void (*destr) (dptr data), size_t nodes_number)
+{
+  queue *q = queue_create (destr);
+
+  q->pool = pool_allocator_create (sizeof (struct qnode), nodes_number);
+
+  return q;
+}
+
+queue *
+queue_create_ring (void (*destr) (dptr data), size_t capacity)
+{
+  return queue_create_ring_with_allocator (destr, capacity, NULL);
+}
+
+queue *
+queue_create_ring_with_allocator (void (*destr) (dptr data),
+                                  size_t capacity, const allocator *alloc)
+{
+  queue *q = queue_create_with_allocator (destr, alloc);
+
+  q->ring = deque_create_with_allocator (capacity, &q->alloc);
 
   return q;
 }
@@ -24,7 +64,17 @@ queue_push (queue *q, constdptr data)
   if (!q)
     return;
 
-  q->front = __do_node_create (data, q->front, NULL);
+  /* Ring is filled from front to back, so queue's
+     front (the newest element) is ring's back. */
+  if (q->ring)
+    {
+      deque_push_back (q->ring, data);
+      q->size++;
+      return;
+    }
+
+  q->front
+      = __do_node_create_from (q->pool, &q->alloc, data, q->front, NULL);
 
   /* If Queue wasn't empty => adding reference from former front to the
       new front */
@@ -42,6 +92,13 @@ queue_pop (queue *q)
   if (!q || q->size == 0)
     return;
 
+  if (q->ring)
+    {
+      deque_pop_front (q->ring, q->destr);
+      q->size--;
+      return;
+    }
+
   /* Saving back to free it, but not lose back's references */
   struct qnode *tmp = q->back;
 
@@ -56,12 +113,14 @@ queue_pop (queue *q)
     q->front = NULL;
   q->size--;
 
-  __do_node_destroy (tmp, q->destr);
+  __do_node_destroy_from (q->pool, &q->alloc, tmp, q->destr);
 }
 
 inline dptr
 queue_front (const queue *q)
 {
+  if (q && q->ring)
+    return deque_back (q->ring);
   if (q)
     return do_node_get (q->front);
   return NULL;
@@ -70,6 +129,8 @@ queue_front (const queue *q)
 inline dptr
 queue_back (const queue *q)
 {
+  if (q && q->ring)
+    return deque_front (q->ring);
   if (q)
     return do_node_get (q->back);
   return NULL;
@@ -99,14 +160,25 @@ queue_destroy (queue *q)
 
   struct qnode *tmp = q->front;
 
+  /* If all nodes are in the pool and there is no data to
+     destroy, they are freed with the pool. */
+  if (q->pool && !q->destr && pool_allocator_used (q->pool) == q->size)
+    tmp = NULL;
+
   /* Destroying queue from front one by one.
     tmp is to save references of deleting element. */
   while (tmp)
     {
       struct qnode *tmp_next = tmp->next;
-      __do_node_destroy (tmp, q->destr);
+      __do_node_destroy_from (q->pool, &q->alloc, tmp, q->destr);
       tmp = tmp_next;
     }
 
-  free (q);
+  if (q->pool)
+    pool_allocator_destroy (q->pool);
+
+  if (q->ring)
+    deque_destroy (q->ring, q->destr);
+
+  allocator_deallocate (&q->alloc, q, sizeof (queue));
 }
@@ -9,6 +9,8 @@
 #include <stddef.h>  // size_t
 #include <stdlib.h>  // malloc, free
 
+#include "allocator.h"
+#include "deque.h"
 #include "types.h"
 
 #define qnode do_node
@@ -38,6 +40,24 @@ typedef struct queue
    * @brief Destructor for data.
    */
   void (*destr) (dptr);
+
+  /**
+   * @brief Pool allocator for nodes. NULL if
+   * nodes are allocated by malloc.
+   */
+  struct pool_allocator *pool;
+
+  /**
+   * @brief Allocator of the queue instance and
+   * nodes, that are not in the pool.
+   */
+  allocator alloc;
+
+  /**
+   * @brief Ring buffer of elements. NULL if
+   * elements are stored in nodes.
+   */
+  deque *ring;
 } queue;
 
 ////////////////////////////////////////////////////
@@ -54,6 +74,66 @@ typedef struct queue
  */
 queue *queue_create (void (*destr) (dptr data));
 
+/**
+ * @brief Function to create new queue with pool of nodes.
+ * Allocates the memory. Should be destroyed at the end
+ * by calling queue_destroy().
+ * Nodes are taken from own pool of <nodes_number> nodes and
+ * from malloc, when pool is exhausted. If all nodes are in the
+ * pool and there is no destructor, queue_destroy() releases them at once.
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param nodes_number Number of nodes in the pool.
+ * @return queue * Pointer to new queue.
+ */
+queue *queue_create_with_pool (void (*destr) (dptr data),
+                               size_t nodes_number);
+
+/**
+ * @brief Function to create new queue, that takes
+ * memory for itself and its nodes from <alloc>.
+ * Should be destroyed at the end by calling queue_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return queue * Pointer to new queue.
+ */
+queue *queue_create_with_allocator (void (*destr) (dptr data),
+                                    const allocator *alloc);
+
+/**
+ * @brief Function to create new queue, that stores
+ * elements in ring buffer instead of nodes, so push and
+ * pop don't allocate until buffer is full. Buffer grows
+ * twice by copying. Should be destroyed at the end
+ * by calling queue_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param capacity Starting capacity, rounded up to
+ * power of two. 0 means DEQUE_CAPACITY_DEFAULT.
+ * @return queue * Pointer to new queue.
+ */
+queue *queue_create_ring (void (*destr) (dptr data), size_t capacity);
+
+/**
+ * @brief Function to create new ring buffer queue, that
+ * takes memory for itself and buffer from <alloc>.
+ * Should be destroyed at the end by calling queue_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param capacity Starting capacity, the same as
+ * in queue_create_ring.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return queue * Pointer to new queue.
+ */
+queue *queue_create_ring_with_allocator (void (*destr) (dptr data),
+                                         size_t capacity,
+                                         const allocator *alloc);
+
 /**
  * @brief Function to push new element to the queue's front.
  * Safety for NULL <q> param.
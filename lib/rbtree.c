@@ -32,6 +32,7 @@ static void __rbtree_balance_on_erase (rbtree *tree, struct __rbt_node *del,
 /**
  * @brief Function to create rbtree node.
  *
+ * @param alloc Allocator of the tree.
  * @param data Data of new element.
  * @param left Pointer to the left child.
  * @param right Pointer to the right child.
@@ -39,11 +40,11 @@ static void __rbtree_balance_on_erase (rbtree *tree, struct __rbt_node *del,
  * @param is_red Color flag.
  */
 static struct __rbt_node *
-__rbt_node_create (constdptr data, dptr left, dptr right, dptr parent,
-                   bool is_red)
+__rbt_node_create (const allocator *alloc, constdptr data, dptr left,
+                   dptr right, dptr parent, bool is_red)
 {
-  struct __rbt_node *nd
-      = (struct __rbt_node *)malloc (sizeof (struct __rbt_node));
+  struct __rbt_node *nd = (struct __rbt_node *)allocator_allocate (
+      alloc, sizeof (struct __rbt_node));
 
   nd->left = left;
   nd->right = right;
@@ -57,16 +58,18 @@ __rbt_node_create (constdptr data, dptr left, dptr right, dptr parent,
 /**
  * @brief Function to destroy node with given destructor.
  *
+ * @param alloc Allocator of the tree.
  * @param nd rbtree node to destroy.
  * @param destr - Destructor function.
  */
 inline static void
-__rbt_node_destroy (struct __rbt_node *nd, void (*destr) (dptr data))
+__rbt_node_destroy (const allocator *alloc, struct __rbt_node *nd,
+                    void (*destr) (dptr data))
 {
   if (destr)
     destr (nd->data);
 
-  free (nd);
+  allocator_deallocate (alloc, nd, sizeof (struct __rbt_node));
 }
 
 #ifdef DEBUG
@@ -79,7 +82,7 @@ __rbt_node_destroy (struct __rbt_node *nd, void (*destr) (dptr data))
  * @return bool true if root is black,
  * false otherwise.
  */
-bool
+static bool
 __rbtree_is_root_black (struct __rbt_node *root)
 {
   if (!root)
@@ -98,7 +101,7 @@ __rbtree_is_root_black (struct __rbt_node *root)
  * Search Tree,
  * false otherwise.
  */
-bool
+static bool
 __rbtree_is_bst (rbtree *tree, struct __rbt_node *root)
 {
   if (!root)
@@ -120,7 +123,7 @@ __rbtree_is_bst (rbtree *tree, struct __rbt_node *root)
  * red parent and red child cases,
  * false otherwise.
  */
-bool
+static bool
 __rbtree_is_no_red_red (struct __rbt_node *root)
 {
   if (!root)
@@ -143,14 +146,13 @@ __rbtree_is_no_red_red (struct __rbt_node *root)
  * @return int Black height for <nd>
  * node.
  */
-int
+static int
 __rbtree_black_height (struct __rbt_node *nd)
 {
   if (nd == NULL)
     return 1;
 
   int left_height = __rbtree_black_height (nd->left);
-  int right_height = __rbtree_black_height (nd->right);
 
   if (nd->is_red == false)
     return 1 + left_height;
@@ -167,7 +169,7 @@ __rbtree_black_height (struct __rbt_node *nd)
  * the same for every tree level,
  * false otherwise.
  */
-bool
+static bool
 __rbtree_is_black_height_same (struct __rbt_node *root)
 {
   if (!root)
@@ -208,18 +210,18 @@ __rbtree_is_correct (rbtree *tree)
 /**
  * @brief Function to destroy rbtree recursively.
  *
+ * @param tree Pointer to rbtree instance.
  * @param root Node that is root in this context.
- * @param destr Destructor function.
  */
 static void
-__rbtree_recursive_destroy (struct __rbt_node *root, void (*destr) (dptr data))
+__rbtree_recursive_destroy (const rbtree *tree, struct __rbt_node *root)
 {
   if (!root)
     return;
-  __rbtree_recursive_destroy (root->left, destr);
-  __rbtree_recursive_destroy (root->right, destr);
+  __rbtree_recursive_destroy (tree, root->left);
+  __rbtree_recursive_destroy (tree, root->right);
 
-  __rbt_node_destroy (root, destr);
+  __rbt_node_destroy (&tree->alloc, root, tree->destr);
 }
 
 /**
@@ -504,7 +506,7 @@ __rbtree_insert_without_balance (rbtree *tree, constdptr data)
     {
       // Always making new node with red color.
       struct __rbt_node *new_node
-          = __rbt_node_create (data, NULL, NULL, prev, true);
+          = __rbt_node_create (&tree->alloc, data, NULL, NULL, prev, true);
 
       // Setting reference for the parent of inserted node.
       // If no parent => new node is root.
@@ -681,7 +683,7 @@ __rbtree_erase_handler (rbtree *tree, rbtree_iterator iter)
               else if (replace->parent->right == replace)
                 replace->parent->right = NULL;
             }
-          __rbt_node_destroy (replace, tree->destr);
+          __rbt_node_destroy (&tree->alloc, replace, tree->destr);
           tree->size--;
         }
     }
@@ -690,18 +692,18 @@ __rbtree_erase_handler (rbtree *tree, rbtree_iterator iter)
       if (replace == tree->root)
         {
           tree->root = NULL;
-          __rbt_node_destroy (replace, tree->destr);
+          __rbt_node_destroy (&tree->alloc, replace, tree->destr);
         }
       else if (replace->left)
         {
           __RBNODE_VALUES_SWAP (replace, replace->left);
-          __rbt_node_destroy (replace->left, tree->destr);
+          __rbt_node_destroy (&tree->alloc, replace->left, tree->destr);
           replace->left = NULL;
         }
       else
         {
           __rbtree_balance_on_erase (tree, replace, true);
-          __rbt_node_destroy (replace, tree->destr);
+          __rbt_node_destroy (&tree->alloc, replace, tree->destr);
         }
       tree->size--;
     }
@@ -716,8 +718,18 @@ rbtree *
 rbtree_create (int (*cmp) (constdptr first, constdptr second),
                void (*destr) (dptr data), bool allow_same)
 {
-  rbtree *tree = (rbtree *)malloc (sizeof (rbtree));
+  return rbtree_create_with_allocator (cmp, destr, allow_same, NULL);
+}
 
+rbtree *
+rbtree_create_with_allocator (int (*cmp) (constdptr first, constdptr second),
+                              void (*destr) (dptr data), bool allow_same,
+                              const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  rbtree *tree = (rbtree *)allocator_allocate (&al, sizeof (rbtree));
+
+  tree->alloc = al;
   tree->root = NULL;
   tree->size = 0;
   tree->cmp = cmp;
@@ -749,7 +761,7 @@ inline void
 rbtree_clear (rbtree *tree)
 {
   if (tree)
-    __rbtree_recursive_destroy (tree->root, tree->destr);
+    __rbtree_recursive_destroy (tree, tree->root);
 
   tree->root = NULL;
   tree->size = 0;
@@ -777,10 +789,11 @@ rbtree_count (const rbtree *tree, constdptr data)
 inline void
 rbtree_destroy (rbtree *tree)
 {
-  if (tree)
-    __rbtree_recursive_destroy (tree->root, tree->destr);
+  if (!tree)
+    return;
 
-  free (tree);
+  __rbtree_recursive_destroy (tree, tree->root);
+  allocator_deallocate (&tree->alloc, tree, sizeof (rbtree));
 }
 
 rbtree_iterator
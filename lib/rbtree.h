@@ -9,6 +9,7 @@
 #include <stdbool.h> // bool
 #include <stdlib.h>  //malloc, free
 
+#include "allocator.h"
 #include "types.h"
 
 /**
@@ -90,6 +91,11 @@ typedef struct rbtree
    * false - disallows.
    */
   bool allow_same;
+
+  /**
+   * @brief Allocator of the tree instance and nodes.
+   */
+  allocator alloc;
 } rbtree;
 
 // Debug function
@@ -119,6 +125,23 @@ bool __rbtree_is_correct (rbtree *tree);
 rbtree *rbtree_create (int (*cmp) (constdptr first, constdptr second),
                        void (*destr) (dptr data), bool allow_same);
 
+/**
+ * @brief Function create new instanse of rbtree, that
+ * takes memory for itself and its nodes from <alloc>.
+ *
+ * @param cmp Compare function.
+ * @param destr Destructor function for nodes.
+ * Null if should not be freed.
+ * @param allow_same flag that allows of disallows
+ * the same values (when cmp() func returns 0).
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return rbtree * New instanse of Red-black Tree.
+ */
+rbtree *rbtree_create_with_allocator (int (*cmp) (constdptr first,
+                                                  constdptr second),
+                                      void (*destr) (dptr data),
+                                      bool allow_same, const allocator *alloc);
+
 /**
  * @brief Function to get iterator to the
  * first element.
@@ -9,9 +9,18 @@ set *
 set_create (int (*cmp) (constdptr first, constdptr second),
             void (*destr) (dptr data))
 {
-  set *st = (set *)malloc (sizeof (set));
+  return set_create_with_allocator (cmp, destr, NULL);
+}
 
-  st->tree = rbtree_create (cmp, destr, false);
+set *
+set_create_with_allocator (int (*cmp) (constdptr first, constdptr second),
+                           void (*destr) (dptr data), const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  set *st = (set *)allocator_allocate (&al, sizeof (set));
+
+  // Set instance is freed through allocator of the tree.
+  st->tree = rbtree_create_with_allocator (cmp, destr, false, &al);
 
   return st;
 }
@@ -63,8 +72,10 @@ set_destroy (set *st)
   if (!st)
     return;
 
+  allocator al = st->tree->alloc;
+
   rbtree_destroy (st->tree);
-  free (st);
+  allocator_deallocate (&al, st, sizeof (set));
 }
 
 inline set_iterator
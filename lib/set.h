@@ -48,6 +48,21 @@ typedef const_rbtree_iterator const_set_iterator;
 set *set_create (int (*cmp) (constdptr first, constdptr second),
                  void (*destr) (dptr data));
 
+/**
+ * @brief Function create new instanse of set, that
+ * takes memory for itself and its nodes from <alloc>.
+ *
+ * @param cmp Compare function.
+ * @param destr Destructor function for nodes.
+ * Null if should not be freed.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return set * New instanse of set.
+ */
+set *set_create_with_allocator (int (*cmp) (constdptr first,
+                                            constdptr second),
+                                void (*destr) (dptr data),
+                                const allocator *alloc);
+
 /**
  * @brief Function to get iterator to the
  * first element.
@@ -0,0 +1,277 @@
+#include "slab_allocator.h"
+
+////////////////////////////////////////////////////
+/*     Private functions of the slab_allocator    */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Size of the large header with padding,
+ * so pointer is aligned.
+ */
+#define __SLAB_LARGE_HEADER_SIZE                                              \
+  ((sizeof (struct __slab_large) + SLAB_ALLOCATOR_ALIGNMENT - 1)              \
+   & ~(size_t)(SLAB_ALLOCATOR_ALIGNMENT - 1))
+
+/**
+ * @brief Sizes of the classes.
+ */
+static const size_t __slab_allocator_sizes[SLAB_ALLOCATOR_CLASSES]
+    = { 8,    16,   32,   48,   64,   80,   96,   112,  128,  160,
+        192,  224,  256,  320,  384,  448,  512,  640,  768,  896,
+        1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096 };
+
+/**
+ * @brief Function to get owner of the slab or large
+ * mapping of the pointer.
+ *
+ * @param ptr Pointer, returned by slab allocator.
+ * @return chunked_pool_allocator* Pool of the class,
+ * or NULL, if pointer is large mapping.
+ */
+inline static chunked_pool_allocator *
+__slab_allocator_owner (constdptr ptr)
+{
+  return ((struct __chunked_pool_chunk *)((uintptr_t)ptr
+                                          & ~(uintptr_t)(
+                                              SLAB_ALLOCATOR_SLAB_SIZE - 1)))
+      ->owner;
+}
+
+/**
+ * @brief Function to get header of large mapping.
+ *
+ * @param ptr Pointer, returned by slab allocator.
+ * @return struct __slab_large* Header of the mapping.
+ */
+inline static struct __slab_large *
+__slab_allocator_large_of (constdptr ptr)
+{
+  return (struct __slab_large *)((uintptr_t)ptr
+                                 & ~(uintptr_t)(SLAB_ALLOCATOR_SLAB_SIZE
+                                                - 1));
+}
+
+/**
+ * @brief Function to map memory for large request.
+ * Mapping is aligned to slab size, so its header is
+ * found by the same mask, as header of the slab.
+ *
+ * @param al Pointer to slab allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to memory after header,
+ * or NULL if mapping failed.
+ */
+static dptr
+__slab_allocator_large_allocate (slab_allocator *al, size_t size)
+{
+  size_t page = (size_t)sysconf (_SC_PAGESIZE);
+  size_t mapped = (__SLAB_LARGE_HEADER_SIZE + size + page - 1) & ~(page - 1);
+
+  // mmap aligns only to page, so slab more is mapped
+  // and extra parts are unmapped.
+  uint8_t *raw
+      = (uint8_t *)mmap (NULL, mapped + SLAB_ALLOCATOR_SLAB_SIZE,
+                         PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1, 0);
+
+  if (raw == MAP_FAILED)
+    return NULL;
+
+  uint8_t *aligned = (uint8_t *)(((uintptr_t)raw + SLAB_ALLOCATOR_SLAB_SIZE
+                                  - 1)
+                                 & ~(uintptr_t)(SLAB_ALLOCATOR_SLAB_SIZE - 1));
+
+  if (aligned != raw)
+    munmap (raw, (size_t)(aligned - raw));
+
+  if (aligned + mapped != raw + mapped + SLAB_ALLOCATOR_SLAB_SIZE)
+    munmap (aligned + mapped,
+            (size_t)(raw + SLAB_ALLOCATOR_SLAB_SIZE - aligned));
+
+  struct __slab_large *large = (struct __slab_large *)aligned;
+
+  large->owner = NULL;
+  large->size = mapped;
+
+  // Linking mapping, so destructor can unmap it.
+  large->prev = NULL;
+  large->next = al->large;
+  if (al->large)
+    al->large->prev = large;
+  al->large = large;
+
+  return aligned + __SLAB_LARGE_HEADER_SIZE;
+}
+
+/**
+ * @brief Function to unmap large mapping.
+ *
+ * @param al Pointer to slab allocator.
+ * @param large Header of the mapping.
+ */
+static void
+__slab_allocator_large_deallocate (slab_allocator *al,
+                                   struct __slab_large *large)
+{
+  if (large->prev)
+    large->prev->next = large->next;
+  else
+    al->large = large->next;
+
+  if (large->next)
+    large->next->prev = large->prev;
+
+  munmap (large, large->size);
+}
+
+/**
+ * @brief Allocate function of the allocator interface.
+ *
+ * @param ctx Pointer to slab allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ */
+static dptr
+__slab_allocator_interface_allocate (dptr ctx, size_t size)
+{
+  return slab_allocator_allocate (ctx, size);
+}
+
+/**
+ * @brief Reallocate function of the allocator interface.
+ *
+ * @param ctx Pointer to slab allocator.
+ * @param ptr Memory to resize.
+ * @param old_size Not used, size is known by slab.
+ * @param new_size New number of bytes.
+ * @return dptr Pointer to resized memory.
+ */
+static dptr
+__slab_allocator_interface_reallocate (dptr ctx, dptr ptr, size_t old_size,
+                                       size_t new_size)
+{
+  (void)old_size;
+  return slab_allocator_reallocate (ctx, ptr, new_size);
+}
+
+/**
+ * @brief Deallocate function of the allocator interface.
+ *
+ * @param ctx Pointer to slab allocator.
+ * @param ptr Memory to free.
+ * @param size Not used, size is known by slab.
+ */
+static void
+__slab_allocator_interface_deallocate (dptr ctx, dptr ptr, size_t size)
+{
+  (void)size;
+  slab_allocator_deallocate (ctx, ptr);
+}
+
+////////////////////////////////////////////////////
+/*   Public API functions of the slab_allocator   */
+////////////////////////////////////////////////////
+
+slab_allocator *
+slab_allocator_create ()
+{
+  slab_allocator *al = (slab_allocator *)malloc (sizeof (slab_allocator));
+  size_t cls = 0;
+
+  // Pools do not map slabs until first allocation.
+  for (size_t i = 0; i < SLAB_ALLOCATOR_CLASSES; i++)
+    al->classes[i] = chunked_pool_allocator_create_with_chunk_size (
+        __slab_allocator_sizes[i], SLAB_ALLOCATOR_SLAB_SIZE, true);
+
+  // Filling table of the smallest fitting class.
+  for (size_t i = 0; i <= SLAB_ALLOCATOR_MAX_SMALL / 8; i++)
+    {
+      while (__slab_allocator_sizes[cls] < i * 8)
+        cls++;
+
+      al->class_of[i] = (uint8_t)cls;
+    }
+
+  al->large = NULL;
+
+  return al;
+}
+
+dptr
+slab_allocator_allocate (slab_allocator *al, size_t size)
+{
+  if (size > SLAB_ALLOCATOR_MAX_SMALL)
+    return __slab_allocator_large_allocate (al, size);
+
+  return chunked_pool_allocator_allocate (
+      al->classes[al->class_of[(size + 7) / 8]]);
+}
+
+void
+slab_allocator_deallocate (slab_allocator *al, dptr ptr)
+{
+  if (!ptr)
+    return;
+
+  chunked_pool_allocator *owner = __slab_allocator_owner (ptr);
+
+  if (owner)
+    chunked_pool_allocator_deallocate (owner, ptr);
+  else
+    __slab_allocator_large_deallocate (al, __slab_allocator_large_of (ptr));
+}
+
+dptr
+slab_allocator_reallocate (slab_allocator *al, dptr ptr, size_t size)
+{
+  if (!ptr)
+    return slab_allocator_allocate (al, size);
+
+  size_t usable = slab_allocator_usable_size (al, ptr);
+
+  // Keeping memory, if it fits and at most half is wasted.
+  if (size <= usable && size > usable / 2)
+    return ptr;
+
+  dptr new_ptr = slab_allocator_allocate (al, size);
+
+  if (!new_ptr)
+    return NULL;
+
+  memcpy (new_ptr, ptr, size < usable ? size : usable);
+  slab_allocator_deallocate (al, ptr);
+
+  return new_ptr;
+}
+
+size_t
+slab_allocator_usable_size (__attribute__ ((unused)) const slab_allocator *al,
+                            constdptr ptr)
+{
+  chunked_pool_allocator *owner = __slab_allocator_owner (ptr);
+
+  if (owner)
+    return owner->block_size;
+
+  return __slab_allocator_large_of (ptr)->size - __SLAB_LARGE_HEADER_SIZE;
+}
+
+inline allocator
+slab_allocator_as_allocator (slab_allocator *al)
+{
+  return (allocator){ __slab_allocator_interface_allocate,
+                      __slab_allocator_interface_reallocate,
+                      __slab_allocator_interface_deallocate, al };
+}
+
+void
+slab_allocator_destroy (slab_allocator *al)
+{
+  for (size_t i = 0; i < SLAB_ALLOCATOR_CLASSES; i++)
+    chunked_pool_allocator_destroy (al->classes[i]);
+
+  while (al->large)
+    __slab_allocator_large_deallocate (al, al->large);
+
+  free (al);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file slab_allocator.h Implementation of Slab
+ * Allocator. Small requests are served by pools of
+ * size classes, large ones are mapped directly.
+ */
+
+#ifndef _EXTENDED_C_LIB_SLAB_ALLOCATOR_H
+#define _EXTENDED_C_LIB_SLAB_ALLOCATOR_H
+
+#include <stdint.h>   // uint8_t
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcpy
+#include <sys/mman.h> // mmap, munmap
+
+#include "allocator.h"
+#include "chunked_pool_allocator.h"
+#include "types.h"
+
+/**
+ * @brief Size of one slab. Slabs of all classes and
+ * large mappings are aligned to it, so header of any
+ * pointer is found by mask.
+ */
+#define SLAB_ALLOCATOR_SLAB_SIZE 65536
+
+/**
+ * @brief Number of size classes.
+ */
+#define SLAB_ALLOCATOR_CLASSES 29
+
+/**
+ * @brief Greatest size, that is served by size class.
+ */
+#define SLAB_ALLOCATOR_MAX_SMALL 4096
+
+/**
+ * @brief Alignment of the pointer of large request.
+ */
+#define SLAB_ALLOCATOR_ALIGNMENT 16
+
+/**
+ * @struct __slab_large
+ * @brief Header of the large mapping. Layout of the
+ * first field is the same as in slab header, NULL
+ * owner means large mapping.
+ */
+struct __slab_large
+{
+  /**
+   * @brief Always NULL.
+   */
+  struct chunked_pool_allocator *owner;
+
+  /**
+   * @brief Size of the mapping.
+   */
+  size_t size;
+
+  /**
+   * @brief Neighbours in the list of large mappings.
+   */
+  struct __slab_large *prev, *next;
+};
+
+/**
+ * @struct slab_allocator
+ * @brief Implementation of slab_allocator.
+ * Size classes are like in jemalloc: 8, 16, then
+ * 4 classes per doubling up to SLAB_ALLOCATOR_MAX_SMALL,
+ * so at most 25% of block is wasted. Every class is
+ * chunked pool with slabs of SLAB_ALLOCATOR_SLAB_SIZE
+ * bytes. Free slabs are returned to the system.
+ */
+typedef struct slab_allocator
+{
+  /**
+   * @brief Pools of size classes.
+   */
+  chunked_pool_allocator *classes[SLAB_ALLOCATOR_CLASSES];
+
+  /**
+   * @brief Class of the size, indexed by
+   * (size + 7) / 8.
+   */
+  uint8_t class_of[SLAB_ALLOCATOR_MAX_SMALL / 8 + 1];
+
+  /**
+   * @brief List of large mappings.
+   */
+  struct __slab_large *large;
+} slab_allocator;
+
+////////////////////////////////////////////////////
+/*   Public API functions of the slab_allocator   */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Contructor for the slab allocator.
+ * Does not map any slab.
+ *
+ * @return slab_allocator* Pointer to
+ * slab_allocator instance.
+ */
+slab_allocator *slab_allocator_create ();
+
+/**
+ * @brief Function to allocate <size> bytes from
+ * allocator. Pointer is aligned to 16 bytes, if
+ * size is greater than 8.
+ *
+ * @param al Pointer to slab allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ * NULL if system is out of memory.
+ */
+dptr slab_allocator_allocate (slab_allocator *al, size_t size);
+
+/**
+ * @brief Function to return memory to allocator.
+ * Size of the memory is found by header of its slab.
+ * NULL is ignored.
+ *
+ * @param al Pointer to slab allocator.
+ * @param ptr Pointer, returned by slab allocator.
+ */
+void slab_allocator_deallocate (slab_allocator *al, dptr ptr);
+
+/**
+ * @brief Function to change size of the memory.
+ * Memory is kept, if it fits new size and is not
+ * much greater, otherwise content is moved.
+ *
+ * @param al Pointer to slab allocator.
+ * @param ptr Pointer, returned by slab allocator, or NULL.
+ * @param size New number of bytes.
+ * @return dptr Pointer to the memory of new size.
+ */
+dptr slab_allocator_reallocate (slab_allocator *al, dptr ptr, size_t size);
+
+/**
+ * @brief Function to get number of bytes, that can
+ * be used by pointer.
+ *
+ * @param al Pointer to slab allocator.
+ * @param ptr Pointer, returned by slab allocator.
+ * @return size_t Size of the block or large mapping.
+ */
+size_t slab_allocator_usable_size (const slab_allocator *al, constdptr ptr);
+
+/**
+ * @brief Function to get allocator interface, that
+ * takes memory from slab allocator. Containers created
+ * with it should be destroyed before <al>.
+ *
+ * @param al Pointer to slab allocator.
+ * @return allocator Allocator interface.
+ */
+allocator slab_allocator_as_allocator (slab_allocator *al);
+
+/**
+ * @brief Destructor for slab allocator.
+ * Unmaps all slabs and large mappings.
+ *
+ * @param al Pointer to slab allocator.
+ */
+void slab_allocator_destroy (slab_allocator *al);
+
+#endif
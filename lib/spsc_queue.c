@@ -0,0 +1,267 @@
+#include "spsc_queue.h"
+
+////////////////////////////////////////////////////
+/*      Private functions of the spsc_queue       */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to wait in blocking functions.
+ * Spins first, then yields the CPU, so waiting
+ * thread doesn't take the core of the other side.
+ *
+ * @param spins Pointer to the number of waits.
+ */
+inline static void
+__spsc_queue_backoff (unsigned *spins)
+{
+  if (*spins < SPSC_QUEUE_SPIN_LIMIT)
+    (*spins)++;
+  else
+    sched_yield ();
+}
+
+/**
+ * @brief Function to get number of free cells for
+ * producer. Reloads <head> only, if cached copy shows
+ * less than <need> free cells.
+ *
+ * @param q Pointer to the queue.
+ * @param tail Current tail.
+ * @param need Wanted number of free cells.
+ * @return size_t Number of free cells.
+ */
+inline static size_t
+__spsc_queue_free (spsc_queue *q, size_t tail, size_t need)
+{
+  size_t free_cells = q->capacity - (tail - q->cached_head);
+
+  if (free_cells < need)
+    {
+      // Acquire pairs with release of consumer, so cells are read.
+      q->cached_head = atomic_load_explicit (&q->head, memory_order_acquire);
+      free_cells = q->capacity - (tail - q->cached_head);
+    }
+
+  return free_cells;
+}
+
+/**
+ * @brief Function to get number of ready elements for
+ * consumer. Reloads <tail> only, if cached copy shows
+ * less than <need> elements.
+ *
+ * @param q Pointer to the queue.
+ * @param head Current head.
+ * @param need Wanted number of elements.
+ * @return size_t Number of ready elements.
+ */
+inline static size_t
+__spsc_queue_ready (spsc_queue *q, size_t head, size_t need)
+{
+  size_t ready = q->cached_tail - head;
+
+  if (ready < need)
+    {
+      // Acquire pairs with release of producer, so cells are written.
+      q->cached_tail = atomic_load_explicit (&q->tail, memory_order_acquire);
+      ready = q->cached_tail - head;
+    }
+
+  return ready;
+}
+
+////////////////////////////////////////////////////
+/*     Public API functions of the spsc_queue     */
+////////////////////////////////////////////////////
+
+spsc_queue *
+spsc_queue_create (size_t capacity)
+{
+  spsc_queue *q = (spsc_queue *)aligned_alloc (SPSC_QUEUE_CACHE_LINE,
+                                               sizeof (spsc_queue));
+
+  // Rounding capacity up to power of 2.
+  q->capacity = 1;
+  while (q->capacity < capacity)
+    q->capacity <<= 1;
+
+  q->buf = (dptr *)malloc (sizeof (dptr) * q->capacity);
+  q->cached_head = 0;
+  q->cached_tail = 0;
+  atomic_init (&q->head, 0);
+  atomic_init (&q->tail, 0);
+
+  return q;
+}
+
+inline size_t
+spsc_queue_capacity (const spsc_queue *q)
+{
+  if (!q)
+    return 0;
+  return q->capacity;
+}
+
+void
+spsc_queue_destroy (spsc_queue *q)
+{
+  if (!q)
+    return;
+
+  free (q->buf);
+  free (q);
+}
+
+inline bool
+spsc_queue_empty (const spsc_queue *q)
+{
+  return spsc_queue_size (q) == 0;
+}
+
+dptr
+spsc_queue_pop (spsc_queue *q)
+{
+  dptr data;
+  unsigned spins = 0;
+
+  while (!spsc_queue_try_pop (q, &data))
+    __spsc_queue_backoff (&spins);
+
+  return data;
+}
+
+void
+spsc_queue_pop_many (spsc_queue *q, dptr *out, size_t count)
+{
+  unsigned spins = 0;
+
+  while (count > 0)
+    {
+      size_t popped = spsc_queue_try_pop_many (q, out, count);
+
+      if (popped == 0)
+        __spsc_queue_backoff (&spins);
+
+      out += popped;
+      count -= popped;
+    }
+}
+
+void
+spsc_queue_push (spsc_queue *q, constdptr data)
+{
+  unsigned spins = 0;
+
+  while (!spsc_queue_try_push (q, data))
+    __spsc_queue_backoff (&spins);
+}
+
+void
+spsc_queue_push_many (spsc_queue *q, const dptr *data, size_t count)
+{
+  unsigned spins = 0;
+
+  while (count > 0)
+    {
+      size_t pushed = spsc_queue_try_push_many (q, data, count);
+
+      if (pushed == 0)
+        __spsc_queue_backoff (&spins);
+
+      data += pushed;
+      count -= pushed;
+    }
+}
+
+size_t
+spsc_queue_size (const spsc_queue *q)
+{
+  if (!q)
+    return 0;
+
+  size_t head = atomic_load_explicit (&q->head, memory_order_acquire);
+  size_t tail = atomic_load_explicit (&q->tail, memory_order_acquire);
+
+  return tail - head;
+}
+
+inline bool
+spsc_queue_try_pop (spsc_queue *q, dptr *data)
+{
+  size_t head = atomic_load_explicit (&q->head, memory_order_relaxed);
+
+  if (__spsc_queue_ready (q, head, 1) == 0)
+    return false;
+
+  *data = q->buf[head & (q->capacity - 1)];
+
+  // Release lets producer reuse the cell after reading.
+  atomic_store_explicit (&q->head, head + 1, memory_order_release);
+
+  return true;
+}
+
+size_t
+spsc_queue_try_pop_many (spsc_queue *q, dptr *out, size_t count)
+{
+  size_t head = atomic_load_explicit (&q->head, memory_order_relaxed);
+  size_t ready = __spsc_queue_ready (q, head, count);
+
+  if (count > ready)
+    count = ready;
+  if (count == 0)
+    return 0;
+
+  // Copying in two parts, if range wraps around the end.
+  size_t start = head & (q->capacity - 1);
+  size_t first = q->capacity - start;
+  if (first > count)
+    first = count;
+
+  memcpy (out, q->buf + start, sizeof (dptr) * first);
+  memcpy (out + first, q->buf, sizeof (dptr) * (count - first));
+
+  atomic_store_explicit (&q->head, head + count, memory_order_release);
+
+  return count;
+}
+
+inline bool
+spsc_queue_try_push (spsc_queue *q, constdptr data)
+{
+  size_t tail = atomic_load_explicit (&q->tail, memory_order_relaxed);
+
+  if (__spsc_queue_free (q, tail, 1) == 0)
+    return false;
+
+  q->buf[tail & (q->capacity - 1)] = (dptr)data;
+
+  // Release publishes the cell to consumer.
+  atomic_store_explicit (&q->tail, tail + 1, memory_order_release);
+
+  return true;
+}
+
+size_t
+spsc_queue_try_push_many (spsc_queue *q, const dptr *data, size_t count)
+{
+  size_t tail = atomic_load_explicit (&q->tail, memory_order_relaxed);
+  size_t free_cells = __spsc_queue_free (q, tail, count);
+
+  if (count > free_cells)
+    count = free_cells;
+  if (count == 0)
+    return 0;
+
+  size_t start = tail & (q->capacity - 1);
+  size_t first = q->capacity - start;
+  if (first > count)
+    first = count;
+
+  memcpy (q->buf + start, data, sizeof (dptr) * first);
+  memcpy (q->buf, data + first, sizeof (dptr) * (count - first));
+
+  atomic_store_explicit (&q->tail, tail + count, memory_order_release);
+
+  return count;
+}
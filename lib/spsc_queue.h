@@ -0,0 +1,208 @@
+/**
+ * @file spsc_queue.h Implementation of bounded lock-free
+ * Queue for one producer and one consumer thread.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_SPSC_QUEUE_H
+#define _EXTENDED_C_LIB_LIB_SPSC_QUEUE_H
+
+#include <sched.h>     // sched_yield
+#include <stdatomic.h> // atomic_size_t
+#include <stdbool.h>   // bool
+#include <stddef.h>    // size_t
+#include <stdlib.h>    // aligned_alloc, free
+#include <string.h>    // memcpy
+
+#include "types.h"
+
+/**
+ * @brief Size of the cache line. Producer and consumer
+ * indices are aligned to it, so threads don't write
+ * to the same line.
+ */
+#define SPSC_QUEUE_CACHE_LINE 64
+
+/**
+ * @brief Number of spins of blocking functions,
+ * before they start to yield the CPU.
+ */
+#define SPSC_QUEUE_SPIN_LIMIT 128
+
+/**
+ * @struct spsc_queue
+ * @brief Lamport ring buffer. Indices grow without
+ * wrapping and are masked on access. Every side keeps
+ * cached copy of the other side's index, so shared
+ * line is read only, when queue looks full or empty.
+ */
+typedef struct spsc_queue
+{
+  /**
+   * @brief Index of the next pushed element.
+   * Written by producer only.
+   */
+  atomic_size_t tail __attribute__ ((aligned (SPSC_QUEUE_CACHE_LINE)));
+
+  /**
+   * @brief Producer's copy of <head>.
+   */
+  size_t cached_head;
+
+  /**
+   * @brief Index of the next popped element.
+   * Written by consumer only.
+   */
+  atomic_size_t head __attribute__ ((aligned (SPSC_QUEUE_CACHE_LINE)));
+
+  /**
+   * @brief Consumer's copy of <tail>.
+   */
+  size_t cached_tail;
+
+  /**
+   * @brief Ring buffer of elements.
+   */
+  dptr *buf __attribute__ ((aligned (SPSC_QUEUE_CACHE_LINE)));
+
+  /**
+   * @brief Capacity of <buf>, power of two.
+   */
+  size_t capacity;
+} spsc_queue;
+
+////////////////////////////////////////////////////
+/*     Public API functions of the spsc_queue     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new spsc queue.
+ * Allocates the memory. Should be destroyed at the end.
+ *
+ * @param capacity Maximal number of elements,
+ * rounded up to power of two.
+ * @return spsc_queue* Pointer to new queue.
+ */
+spsc_queue *spsc_queue_create (size_t capacity);
+
+/**
+ * @brief Function to get capacity of the queue.
+ *
+ * @param q Pointer to the queue.
+ * @return size_t Capacity.
+ */
+size_t spsc_queue_capacity (const spsc_queue *q);
+
+/**
+ * @brief Destructor of the queue. Elements
+ * are not destroyed. Should not be called,
+ * while queue is used by other threads.
+ *
+ * @param q Pointer to the queue.
+ */
+void spsc_queue_destroy (spsc_queue *q);
+
+/**
+ * @brief Function to check if queue is empty.
+ * Result may be outdated, when it is returned.
+ *
+ * @param q Pointer to the queue.
+ * @return true If queue is empty.
+ * @return false If queue isn't empty.
+ */
+bool spsc_queue_empty (const spsc_queue *q);
+
+/**
+ * @brief Function to pop element. Waits, while
+ * queue is empty. Called by consumer only.
+ *
+ * @param q Pointer to the queue.
+ * @return dptr Popped element.
+ */
+dptr spsc_queue_pop (spsc_queue *q);
+
+/**
+ * @brief Function to pop <count> elements to <out>.
+ * Waits, until all of them are popped.
+ * Called by consumer only.
+ *
+ * @param q Pointer to the queue.
+ * @param out Memory for <count> elements.
+ * @param count Number of elements.
+ */
+void spsc_queue_pop_many (spsc_queue *q, dptr *out, size_t count);
+
+/**
+ * @brief Function to push element. Waits, while
+ * queue is full. Called by producer only.
+ *
+ * @param q Pointer to the queue.
+ * @param data Element to push.
+ */
+void spsc_queue_push (spsc_queue *q, constdptr data);
+
+/**
+ * @brief Function to push <count> elements from <data>.
+ * Waits, until all of them are pushed.
+ * Called by producer only.
+ *
+ * @param q Pointer to the queue.
+ * @param data Elements to push.
+ * @param count Number of elements.
+ */
+void spsc_queue_push_many (spsc_queue *q, const dptr *data, size_t count);
+
+/**
+ * @brief Function to get number of elements.
+ * Result may be outdated, when it is returned.
+ *
+ * @param q Pointer to the queue.
+ * @return size_t Number of elements.
+ */
+size_t spsc_queue_size (const spsc_queue *q);
+
+/**
+ * @brief Function to pop element without waiting.
+ * Called by consumer only.
+ *
+ * @param q Pointer to the queue.
+ * @param data Pointer to store popped element.
+ * @return true If element was popped.
+ * @return false If queue is empty.
+ */
+bool spsc_queue_try_pop (spsc_queue *q, dptr *data);
+
+/**
+ * @brief Function to pop up to <count> elements to
+ * <out> without waiting. Called by consumer only.
+ *
+ * @param q Pointer to the queue.
+ * @param out Memory for <count> elements.
+ * @param count Maximal number of elements.
+ * @return size_t Number of popped elements.
+ */
+size_t spsc_queue_try_pop_many (spsc_queue *q, dptr *out, size_t count);
+
+/**
+ * @brief Function to push element without waiting.
+ * Called by producer only.
+ *
+ * @param q Pointer to the queue.
+ * @param data Element to push.
+ * @return true If element was pushed.
+ * @return false If queue is full.
+ */
+bool spsc_queue_try_push (spsc_queue *q, constdptr data);
+
+/**
+ * @brief Function to push up to <count> elements from
+ * <data> without waiting. Called by producer only.
+ *
+ * @param q Pointer to the queue.
+ * @param data Elements to push.
+ * @param count Maximal number of elements.
+ * @return size_t Number of pushed elements.
+ */
+size_t spsc_queue_try_push_many (spsc_queue *q, const dptr *data,
+                                 size_t count);
+
+#endif
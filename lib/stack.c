@@ -1,5 +1,126 @@
 #include "stack.h"
 
+#include "pool_allocator.h"
+
+////////////////////////////////////////////////////
+/*         Private functions of the stack         */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to allocate new chunk.
+ *
+ * @param s Pointer to the stack.
+ * @param prev Lower chunk or NULL.
+ * @param capacity Number of elements in the chunk.
+ * @return struct __stack_chunk* New chunk.
+ */
+static struct __stack_chunk *
+__stack_chunk_create (stack *s, struct __stack_chunk *prev, size_t capacity)
+{
+  struct __stack_chunk *chunk = (struct __stack_chunk *)allocator_allocate (
+      &s->alloc, sizeof (struct __stack_chunk) + sizeof (dptr) * capacity);
+
+  chunk->prev = prev;
+  chunk->next = NULL;
+  chunk->capacity = capacity;
+
+  return chunk;
+}
+
+/**
+ * @brief Function to free chunk. Elements are not destroyed.
+ *
+ * @param s Pointer to the stack.
+ * @param chunk Chunk to free.
+ */
+inline static void
+__stack_chunk_destroy (stack *s, struct __stack_chunk *chunk)
+{
+  allocator_deallocate (&s->alloc, chunk,
+                        sizeof (struct __stack_chunk)
+                            + sizeof (dptr) * chunk->capacity);
+}
+
+/**
+ * @brief Function to push element to chunked stack.
+ * Moves to the next chunk, if current one is full.
+ *
+ * @param s Pointer to the stack.
+ * @param data Data to push.
+ */
+inline static void
+__stack_chunked_push (stack *s, constdptr data)
+{
+  if (s->chunk_size == s->chunk->capacity)
+    {
+      if (!s->chunk->next)
+        s->chunk->next
+            = __stack_chunk_create (s, s->chunk, s->chunk->capacity * 2);
+      s->chunk = s->chunk->next;
+      s->chunk_size = 0;
+    }
+
+  s->chunk->items[s->chunk_size++] = (dptr)data;
+}
+
+/**
+ * @brief Function to pop element from chunked stack.
+ * Emptied chunk stays as spare one, and the spare chunk
+ * above it is freed, so memory is given back, but push
+ * and pop on the border of chunks don't allocate.
+ *
+ * @param s Pointer to the stack.
+ */
+inline static void
+__stack_chunked_pop (stack *s)
+{
+  s->chunk_size--;
+  if (s->destr)
+    s->destr (s->chunk->items[s->chunk_size]);
+
+  if (s->chunk_size == 0 && s->chunk->prev)
+    {
+      if (s->chunk->next)
+        {
+          __stack_chunk_destroy (s, s->chunk->next);
+          s->chunk->next = NULL;
+        }
+
+      s->chunk = s->chunk->prev;
+      s->chunk_size = s->chunk->capacity;
+    }
+}
+
+/**
+ * @brief Function to destroy elements and free
+ * all chunks of chunked stack.
+ *
+ * @param s Pointer to the stack.
+ */
+static void
+__stack_chunked_destroy (stack *s)
+{
+  struct __stack_chunk *chunk = s->chunk;
+  size_t size = s->chunk_size;
+
+  if (chunk->next)
+    __stack_chunk_destroy (s, chunk->next);
+
+  while (chunk)
+    {
+      struct __stack_chunk *prev = chunk->prev;
+
+      if (s->destr)
+        for (size_t i = 0; i < size; i++)
+          s->destr (chunk->items[i]);
+
+      __stack_chunk_destroy (s, chunk);
+      chunk = prev;
+      if (chunk)
+        size = chunk->capacity;
+    }
+}
+
 ////////////////////////////////////////////////////
 /*      Public API functions of the stack         */
 ////////////////////////////////////////////////////
@@ -7,11 +128,53 @@
 stack *
 stack_create (void (*destr) (dptr data))
 {
-  stack *st = (stack *)malloc (sizeof (stack));
+  return stack_create_with_allocator (destr, NULL);
+}
+
+stack *
+stack_create_with_allocator (void (*destr) (dptr data),
+                             const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  stack *st = (stack *)allocator_allocate (&al, sizeof (stack));
 
   st->size = 0;
   st->top = NULL;
   st->destr = destr;
+  st->pool = NULL;
+  st->alloc = al;
+  st->chunk = NULL;
+  st->chunk_size = 0;
+
+  return st;
+}
+
+stack *
+stack_create_with_pool (void (*destr) (dptr data), size_t nodes_number)
+{
+  stack *st = stack_create (destr);
+
+  st->pool = pool_allocator_create (sizeof (struct snode), nodes_number);
+
+  return st;
+}
+
+stack *
+stack_create_chunked (void (*destr) (dptr data), size_t chunk_capacity)
+{
+  return stack_create_chunked_with_allocator (destr, chunk_capacity, NULL);
+}
+
+stack *
+stack_create_chunked_with_allocator (void (*destr) (dptr data),
+                                     size_t chunk_capacity,
+                                     const allocator *alloc)
+{
+  stack *st = stack_create_with_allocator (destr, alloc);
+
+  st->chunk = __stack_chunk_create (
+      st, NULL,
+      (chunk_capacity == 0) ? STACK_CHUNK_CAPACITY_DEFAULT : chunk_capacity);
 
   return st;
 }
@@ -22,7 +185,14 @@ stack_push (stack *s, constdptr data)
   if (!s)
     return;
 
-  s->top = __o_node_create (data, s->top);
+  if (s->chunk)
+    {
+      __stack_chunked_push (s, data);
+      s->size++;
+      return;
+    }
+
+  s->top = __o_node_create_from (s->pool, &s->alloc, data, s->top);
   s->size++;
 }
 
@@ -32,6 +202,13 @@ stack_pop (stack *s)
   if (!s || s->size == 0)
     return;
 
+  if (s->chunk)
+    {
+      __stack_chunked_pop (s);
+      s->size--;
+      return;
+    }
+
   /* Save old top to not lose references. */
   struct snode *tmp = s->top;
 
@@ -40,7 +217,7 @@ stack_pop (stack *s)
   s->size--;
 
   /* Destroy old top node. */
-  __o_node_destroy (tmp, s->destr);
+  __o_node_destroy_from (s->pool, &s->alloc, tmp, s->destr);
 }
 
 inline dptr
@@ -48,6 +225,8 @@ stack_top (const stack *s)
 {
   if (!s)
     return NULL;
+  if (s->chunk)
+    return (s->size == 0) ? NULL : s->chunk->items[s->chunk_size - 1];
   return o_node_get (s->top);
 }
 
@@ -79,12 +258,23 @@ stack_destroy (stack *s)
   tmp is to save references of deleting element. */
   struct snode *tmp = s->top;
 
+  /* If all nodes are in the pool and there is no data to
+     destroy, they are freed with the pool. */
+  if (s->pool && !s->destr && pool_allocator_used (s->pool) == s->size)
+    tmp = NULL;
+
   while (tmp)
     {
       struct snode *tmp_next = tmp->next;
-      __o_node_destroy (tmp, s->destr);
+      __o_node_destroy_from (s->pool, &s->alloc, tmp, s->destr);
       tmp = tmp_next;
     }
 
-  free (s);
+  if (s->pool)
+    pool_allocator_destroy (s->pool);
+
+  if (s->chunk)
+    __stack_chunked_destroy (s);
+
+  allocator_deallocate (&s->alloc, s, sizeof (stack));
 }
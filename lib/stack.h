@@ -9,10 +9,47 @@
 #include <stddef.h>  // size_t
 #include <stdlib.h>  // malloc, free
 
+#include "allocator.h"
 #include "types.h"
 
 #define snode o_node
 
+/**
+ * @brief Number of elements in the first chunk of
+ * chunked stack, if 0 is passed to stack_create_chunked.
+ */
+#define STACK_CHUNK_CAPACITY_DEFAULT 64
+
+/**
+ * @struct __stack_chunk
+ * @brief Contiguous block of elements of chunked stack.
+ * Chunks are linked from the top to the bottom.
+ */
+struct __stack_chunk
+{
+  /**
+   * @brief Previous (lower) chunk. NULL for the first one.
+   */
+  struct __stack_chunk *prev;
+
+  /**
+   * @brief Next (upper) chunk, that is kept empty
+   * after popping, so push and pop on the border
+   * of chunks don't allocate every time.
+   */
+  struct __stack_chunk *next;
+
+  /**
+   * @brief Number of elements, chunk can store.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Elements.
+   */
+  dptr items[];
+};
+
 /**
  * @struct stack
  * @brief Implements Stack data struct.
@@ -35,6 +72,29 @@ typedef struct stack
    * @brief Destructor for data.
    */
   void (*destr) (dptr);
+
+  /**
+   * @brief Pool allocator for nodes. NULL if
+   * nodes are allocated by malloc.
+   */
+  struct pool_allocator *pool;
+
+  /**
+   * @brief Allocator of the stack instance and
+   * nodes, that are not in the pool.
+   */
+  allocator alloc;
+
+  /**
+   * @brief Chunk with the top element. NULL if
+   * elements are stored in nodes.
+   */
+  struct __stack_chunk *chunk;
+
+  /**
+   * @brief Number of elements in <chunk>.
+   */
+  size_t chunk_size;
 } stack;
 
 ////////////////////////////////////////////////////
@@ -51,6 +111,68 @@ typedef struct stack
  */
 stack *stack_create (void (*destr) (dptr data));
 
+/**
+ * @brief Function to create new stack with pool of nodes.
+ * Allocates the memory. Should be destroyed at the end.
+ * Nodes are taken from own pool of <nodes_number> nodes and
+ * from malloc, when pool is exhausted. If all nodes are in the
+ * pool and there is no destructor, stack_destroy() releases them at once.
+ *
+ * @param destr Destructor for data.
+ * Null if Should not be freed.
+ * @param nodes_number Number of nodes in the pool.
+ * @return Pointer to new stack.
+ */
+stack *stack_create_with_pool (void (*destr) (dptr data),
+                               size_t nodes_number);
+
+/**
+ * @brief Function to create new stack, that takes
+ * memory for itself and its nodes from <alloc>.
+ * Should be destroyed at the end by calling stack_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return stack * Pointer to new stack.
+ */
+stack *stack_create_with_allocator (void (*destr) (dptr data),
+                                    const allocator *alloc);
+
+/**
+ * @brief Function to create new stack, that stores
+ * elements in contiguous chunks instead of nodes, so push
+ * and pop don't allocate until chunk is full. Every new
+ * chunk is twice bigger than the previous one. Elements
+ * are never moved, so pointers to them stay valid, while
+ * they are in the stack. Should be destroyed at the end
+ * by calling stack_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param chunk_capacity Capacity of the first chunk.
+ * 0 means STACK_CHUNK_CAPACITY_DEFAULT.
+ * @return stack * Pointer to new stack.
+ */
+stack *stack_create_chunked (void (*destr) (dptr data),
+                             size_t chunk_capacity);
+
+/**
+ * @brief Function to create new chunked stack, that
+ * takes memory for itself and chunks from <alloc>.
+ * Should be destroyed at the end by calling stack_destroy().
+ *
+ * @param destr Destructor for data. Null if should not
+ * be freed.
+ * @param chunk_capacity Capacity of the first chunk,
+ * the same as in stack_create_chunked.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return stack * Pointer to new stack.
+ */
+stack *stack_create_chunked_with_allocator (void (*destr) (dptr data),
+                                            size_t chunk_capacity,
+                                            const allocator *alloc);
+
 /**
  * @brief Function to push new element to the stack's top.
  * Safety for NULL <s> param.
@@ -0,0 +1,302 @@
+#include "stack_allocator.h"
+
+////////////////////////////////////////////////////
+/*    Private functions of the stack_allocator    */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Size of the canary after allocation.
+ */
+#ifdef DEBUG
+#define __STACK_ALLOCATOR_CANARY_SIZE sizeof (uint64_t)
+#else
+#define __STACK_ALLOCATOR_CANARY_SIZE 0
+#endif // DEBUG
+
+/**
+ * @brief Function to get header of the allocation.
+ *
+ * @param ptr Allocation.
+ * @return struct __stack_allocator_header* Header.
+ */
+inline static struct __stack_allocator_header *
+__stack_allocator_header (constdptr ptr)
+{
+  return (struct __stack_allocator_header *)(ptr
+                                             - sizeof (
+                                                 struct
+                                                 __stack_allocator_header));
+}
+
+/**
+ * @brief Function to check, if <size> bytes and
+ * canary fit into <avail> bytes. Written without
+ * adding to <size>, so huge sizes don't overflow.
+ *
+ * @param avail Number of free bytes.
+ * @param size Number of bytes to allocate.
+ * @return bool true if allocation fits.
+ */
+inline static bool
+__stack_allocator_fits (size_t avail, size_t size)
+{
+  size_t canary = __STACK_ALLOCATOR_CANARY_SIZE;
+
+  return avail >= canary && size <= avail - canary;
+}
+
+#ifdef DEBUG
+
+/**
+ * @brief Function to check canary of the allocation.
+ *
+ * @param ptr Allocation.
+ * @return bool true if allocation wasn't overflowed.
+ */
+inline static bool
+__stack_allocator_canary_is_correct (constdptr ptr)
+{
+  uint64_t canary;
+
+  memcpy (&canary, ptr + __stack_allocator_header (ptr)->size,
+          sizeof (uint64_t));
+
+  return canary == STACK_ALLOCATOR_CANARY;
+}
+
+/**
+ * @brief Function to check canaries of
+ * all allocations.
+ *
+ * @param al Pointer to stack allocator.
+ * @return bool true if no allocation was
+ * overflowed, false otherwise.
+ */
+bool
+__stack_allocator_is_correct (const stack_allocator *al)
+{
+  for (dptr top = al->top; top; top = __stack_allocator_header (top)->prev_top)
+    if (!__stack_allocator_canary_is_correct (top))
+      return false;
+
+  return true;
+}
+
+#endif // DEBUG
+
+/**
+ * @brief Function to move offset back. In DEBUG mode
+ * canaries of released allocations are asserted and
+ * released memory is poisoned, so use after free
+ * is noticeable.
+ *
+ * @param al Pointer to stack allocator.
+ * @param offset New offset, not greater than current.
+ * @param top New last allocation.
+ */
+inline static void
+__stack_allocator_pop (stack_allocator *al, size_t offset, dptr top)
+{
+#ifdef DEBUG
+  // Every released allocation should keep its canary.
+  for (dptr ptr = al->top; ptr && ptr != top;
+       ptr = __stack_allocator_header (ptr)->prev_top)
+    assert (__stack_allocator_canary_is_correct (ptr));
+
+  memset (al->ptr + offset, STACK_ALLOCATOR_POISON, al->offset - offset);
+#endif // DEBUG
+
+  al->offset = offset;
+  al->top = top;
+}
+
+/**
+ * @brief Allocate function of the allocator interface.
+ *
+ * @param ctx Pointer to stack allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ */
+static dptr
+__stack_allocator_interface_allocate (dptr ctx, size_t size)
+{
+  return stack_allocator_allocate (ctx, size);
+}
+
+/**
+ * @brief Reallocate function of the allocator interface.
+ * The last allocation is resized in place, other ones
+ * are copied to new allocation.
+ *
+ * @param ctx Pointer to stack allocator.
+ * @param ptr Memory to resize.
+ * @param old_size Number of bytes in <ptr>.
+ * @param new_size New number of bytes.
+ * @return dptr Pointer to resized memory.
+ */
+static dptr
+__stack_allocator_interface_reallocate (dptr ctx, dptr ptr, size_t old_size,
+                                        size_t new_size)
+{
+  stack_allocator *al = (stack_allocator *)ctx;
+
+  // Last allocation, that fits allocator.
+  if (ptr && ptr == al->top
+      && __stack_allocator_fits (al->capacity - (size_t)(ptr - al->ptr),
+                                 new_size))
+    {
+#ifdef DEBUG
+      uint64_t canary = STACK_ALLOCATOR_CANARY;
+
+      __stack_allocator_header (ptr)->size = new_size;
+      memcpy (ptr + new_size, &canary, sizeof (uint64_t));
+#endif // DEBUG
+
+      al->offset
+          = (size_t)(ptr - al->ptr) + new_size + __STACK_ALLOCATOR_CANARY_SIZE;
+      return ptr;
+    }
+
+  dptr res = stack_allocator_allocate (al, new_size);
+
+  if (res && ptr)
+    memcpy (res, ptr, old_size < new_size ? old_size : new_size);
+
+  return res;
+}
+
+/**
+ * @brief Deallocate function of the allocator interface.
+ *
+ * @param ctx Pointer to stack allocator.
+ * @param ptr Memory to free.
+ * @param size Not used.
+ */
+static void
+__stack_allocator_interface_deallocate (dptr ctx, dptr ptr, size_t size)
+{
+  (void)size;
+  stack_allocator_deallocate (ctx, ptr);
+}
+
+////////////////////////////////////////////////////
+/*   Public API functions of the stack_allocator  */
+////////////////////////////////////////////////////
+
+stack_allocator *
+stack_allocator_create (size_t capacity)
+{
+  // Allocating memory for allocator instance.
+  stack_allocator *al = (stack_allocator *)malloc (sizeof (stack_allocator));
+
+  // Set starting values for allocator.
+  al->capacity = capacity;
+  al->offset = 0;
+  al->top = NULL;
+
+  // Allocating memory to manage through syscall mmap
+  al->ptr = mmap (NULL, al->capacity, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  return al;
+}
+
+inline dptr
+stack_allocator_allocate (stack_allocator *al, size_t size)
+{
+  return stack_allocator_allocate_aligned (al, size,
+                                           STACK_ALLOCATOR_DEFAULT_ALIGNMENT);
+}
+
+dptr
+stack_allocator_allocate_aligned (stack_allocator *al, size_t size,
+                                  size_t align)
+{
+  // Header lies right before allocation, so it
+  // should be aligned too.
+  if (align < _Alignof (struct __stack_allocator_header))
+    align = _Alignof (struct __stack_allocator_header);
+
+  // Aligning address, not offset, mmap gives only
+  // page alignment.
+  uintptr_t base = (uintptr_t)al->ptr;
+  uintptr_t start
+      = base + al->offset + sizeof (struct __stack_allocator_header);
+  size_t used = ((start + align - 1) & ~(uintptr_t)(align - 1)) - base;
+
+  // Checking enough space.
+  if (used > al->capacity
+      || !__stack_allocator_fits (al->capacity - used, size))
+    return NULL;
+
+  dptr ptr = al->ptr + used;
+  struct __stack_allocator_header *header = __stack_allocator_header (ptr);
+
+  header->prev_offset = al->offset;
+  header->prev_top = al->top;
+
+#ifdef DEBUG
+  uint64_t canary = STACK_ALLOCATOR_CANARY;
+
+  header->size = size;
+  memcpy (ptr + size, &canary, sizeof (uint64_t));
+#endif // DEBUG
+
+  // Setting new offset.
+  al->offset = used + size + __STACK_ALLOCATOR_CANARY_SIZE;
+  al->top = ptr;
+
+  return ptr;
+}
+
+void
+stack_allocator_deallocate (stack_allocator *al, dptr ptr)
+{
+  // Only last allocation can be freed.
+  if (!ptr || ptr != al->top)
+    return;
+
+  struct __stack_allocator_header *header = __stack_allocator_header (ptr);
+
+  __stack_allocator_pop (al, header->prev_offset, header->prev_top);
+}
+
+inline stack_allocator_marker
+stack_allocator_mark (const stack_allocator *al)
+{
+  return (stack_allocator_marker){ al->offset, al->top };
+}
+
+void
+stack_allocator_rewind (stack_allocator *al, stack_allocator_marker marker)
+{
+  // Marker is already rewound.
+  if (marker.offset > al->offset)
+    return;
+
+  __stack_allocator_pop (al, marker.offset, marker.top);
+}
+
+inline void
+stack_allocator_free (stack_allocator *al)
+{
+  __stack_allocator_pop (al, 0, NULL);
+}
+
+inline allocator
+stack_allocator_as_allocator (stack_allocator *al)
+{
+  return (allocator){ __stack_allocator_interface_allocate,
+                      __stack_allocator_interface_reallocate,
+                      __stack_allocator_interface_deallocate, al };
+}
+
+inline void
+stack_allocator_destroy (stack_allocator *al)
+{
+  // deallocate allocator's memory.
+  munmap (al->ptr, al->capacity);
+
+  // deallocate allocator instance.
+  free (al);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file stack_allocator.h Implementation of Stack
+ * Allocator.
+ */
+
+#ifndef _EXTENDED_C_LIB_STACK_ALLOCATOR_H
+#define _EXTENDED_C_LIB_STACK_ALLOCATOR_H
+
+#include <assert.h>   // assert
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uintptr_t
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcpy, memset
+#include <sys/mman.h> // mmap, munmap
+
+#include "allocator.h"
+#include "types.h"
+
+/**
+ * @brief Alignment of allocations by default.
+ */
+#define STACK_ALLOCATOR_DEFAULT_ALIGNMENT 16
+
+/**
+ * @brief Value, that is written after every
+ * allocation in DEBUG mode. It is asserted, when
+ * allocation is freed by deallocate, rewind or free.
+ */
+#define STACK_ALLOCATOR_CANARY 0xDEADBEEFCAFEBABEull
+
+/**
+ * @brief Value, that fills popped memory in DEBUG mode.
+ */
+#define STACK_ALLOCATOR_POISON 0xDD
+
+/**
+ * @struct __stack_allocator_header
+ * @brief Header, that lies before every allocation.
+ */
+struct __stack_allocator_header
+{
+  /**
+   * @brief Offset of the allocator before allocation.
+   */
+  size_t prev_offset;
+
+  /**
+   * @brief Previous allocation, NULL if it is the first.
+   */
+  dptr prev_top;
+
+#ifdef DEBUG
+  /**
+   * @brief Size of the allocation. Canary lies after it.
+   */
+  size_t size;
+#endif // DEBUG
+};
+
+/**
+ * @struct stack_allocator_marker
+ * @brief Saved position of the stack allocator.
+ */
+typedef struct stack_allocator_marker
+{
+  /**
+   * @brief Offset of the allocator.
+   */
+  size_t offset;
+
+  /**
+   * @brief Last allocation.
+   */
+  dptr top;
+} stack_allocator_marker;
+
+/**
+ * @struct stack_allocator
+ * @brief Implemenation of stack_allocator.
+ * Memory is bumped like in linear_allocator, but
+ * it can be freed in LIFO order: last allocation
+ * one by one, or everything after saved marker.
+ */
+typedef struct stack_allocator
+{
+  /**
+   * @brief Pointer to memory to manage by allocator.
+   */
+  dptr ptr;
+
+  /**
+   * @brief Current offset from <ptr>.
+   * Points to the next place to allocate from
+   * allocator.
+   */
+  size_t offset;
+
+  /**
+   * @brief Number of bytes that contain
+   * allocator to manage.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Last allocation, NULL if there
+   * are no allocations.
+   */
+  dptr top;
+} stack_allocator;
+
+// Debug function
+#ifdef DEBUG
+bool __stack_allocator_is_correct (const stack_allocator *al);
+#endif // DEBUG
+
+////////////////////////////////////////////////////
+/*   Public API functions of the stack_allocator  */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Contructor for the stack allocator.
+ *
+ * @param capacity Number of bytes for memory
+ * managment.
+ * @return stack_allocator* Pointer to
+ * stack_allocator instance.
+ */
+stack_allocator *stack_allocator_create (size_t capacity);
+
+/**
+ * @brief Function to allocate new chunk of memory
+ * aligned to STACK_ALLOCATOR_DEFAULT_ALIGNMENT.
+ *
+ * @param al Pointer to stack allocator.
+ * @param size Number of bytes.
+ * @return dptr Pointer to allocated memory.
+ * NULL if there is not enough space.
+ */
+dptr stack_allocator_allocate (stack_allocator *al, size_t size);
+
+/**
+ * @brief Function to allocate new chunk of memory
+ * with given alignment.
+ *
+ * @param al Pointer to stack allocator.
+ * @param size Number of bytes.
+ * @param align Alignment, power of 2. Alignments less
+ * than header alignment are rounded up.
+ * @return dptr Pointer to allocated memory.
+ * NULL if there is not enough space.
+ */
+dptr stack_allocator_allocate_aligned (stack_allocator *al, size_t size,
+                                       size_t align);
+
+/**
+ * @brief Function to free last allocation.
+ * Other pointers are ignored.
+ *
+ * @param al Pointer to stack allocator.
+ * @param ptr Pointer to the last allocation.
+ */
+void stack_allocator_deallocate (stack_allocator *al, dptr ptr);
+
+/**
+ * @brief Function to save current position.
+ *
+ * @param al Pointer to stack allocator.
+ * @return stack_allocator_marker Current position.
+ */
+stack_allocator_marker stack_allocator_mark (const stack_allocator *al);
+
+/**
+ * @brief Function to free all allocations made after
+ * <marker> was saved. Markers saved after <marker>
+ * become invalid.
+ *
+ * @param al Pointer to stack allocator.
+ * @param marker Saved position.
+ */
+void stack_allocator_rewind (stack_allocator *al,
+                             stack_allocator_marker marker);
+
+/**
+ * @brief Function to free all chunks of memory.
+ * Actualy just moving offset to 0 position.
+ *
+ * @param al Pointer to stack allocator.
+ */
+void stack_allocator_free (stack_allocator *al);
+
+/**
+ * @brief Function to get allocator interface, that
+ * takes memory from stack allocator. Only the last
+ * allocation is really freed, so container should
+ * be the only user of <al> or be rewound by marker.
+ *
+ * @param al Pointer to stack allocator.
+ * @return allocator Allocator interface.
+ */
+allocator stack_allocator_as_allocator (stack_allocator *al);
+
+/**
+ * @brief Destructor for stack allocator.
+ *
+ * @param al Pointer to stack allocator.
+ */
+void stack_allocator_destroy (stack_allocator *al);
+
+#endif
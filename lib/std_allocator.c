@@ -1,7 +1,26 @@
 #include "std_allocator.h"
 
 ////////////////////////////////////////////////////
-/*  Public API functions of the pool_allocator    */
+/*     Private functions of the std_allocator     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to map memory for huge request.
+ *
+ * @param size Number of bytes.
+ * @return dptr Pointer to memory, or NULL.
+ */
+inline static dptr
+__std_allocator_map (size_t size)
+{
+  dptr ptr = mmap (NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+////////////////////////////////////////////////////
+/*   Public API functions of the std_allocator    */
 ////////////////////////////////////////////////////
 
 std_allocator *
@@ -9,12 +28,11 @@ std_allocator_create (size_t type_size,
                       __attribute__ ((unused)) size_t capacity,
                       __attribute__ ((unused)) uint8_t align)
 {
-  std_allocator *al = (std_allocator *)mmap (
-      NULL, sizeof (std_allocator), PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  std_allocator *al = (std_allocator *)malloc (sizeof (std_allocator));
 
   al->type_size = type_size;
   al->n = 0;
+  al->slab = slab_allocator_create ();
 
   return al;
 }
@@ -22,9 +40,16 @@ std_allocator_create (size_t type_size,
 dptr
 std_allocator_allocate (std_allocator *al, size_t count)
 {
-  dptr ptr = mmap (NULL, al->type_size * count, PROT_READ | PROT_WRITE,
-                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-  al->n += count;
+  size_t size = al->type_size * count;
+  dptr ptr;
+
+  if (size > STD_ALLOCATOR_MMAP_THRESHOLD)
+    ptr = __std_allocator_map (size);
+  else
+    ptr = slab_allocator_allocate (al->slab, size);
+
+  if (ptr)
+    al->n += count;
 
   return ptr;
 }
@@ -33,8 +58,43 @@ dptr
 std_allocator_reallocate (std_allocator *al, dptr ptr, size_t old_count,
                           size_t new_count)
 {
-  dptr new_ptr = mremap (ptr, al->type_size * old_count,
-                         al->type_size * new_count, MREMAP_MAYMOVE);
+  size_t old_size = al->type_size * old_count;
+  size_t new_size = al->type_size * new_count;
+  dptr new_ptr;
+
+  // Both are huge, kernel moves pages without copying.
+  if (old_size > STD_ALLOCATOR_MMAP_THRESHOLD
+      && new_size > STD_ALLOCATOR_MMAP_THRESHOLD)
+    {
+      new_ptr = mremap (ptr, old_size, new_size, MREMAP_MAYMOVE);
+      new_ptr = new_ptr == MAP_FAILED ? NULL : new_ptr;
+    }
+  // Both are small, slab keeps block if it fits.
+  else if (old_size <= STD_ALLOCATOR_MMAP_THRESHOLD
+           && new_size <= STD_ALLOCATOR_MMAP_THRESHOLD)
+    new_ptr = slab_allocator_reallocate (al->slab, ptr, new_size);
+  // Crossing threshold, content is copied.
+  else if (new_size > STD_ALLOCATOR_MMAP_THRESHOLD)
+    {
+      new_ptr = __std_allocator_map (new_size);
+      if (new_ptr)
+        {
+          memcpy (new_ptr, ptr, old_size);
+          slab_allocator_deallocate (al->slab, ptr);
+        }
+    }
+  else
+    {
+      new_ptr = slab_allocator_allocate (al->slab, new_size);
+      if (new_ptr)
+        {
+          memcpy (new_ptr, ptr, new_size);
+          munmap (ptr, old_size);
+        }
+    }
+
+  if (!new_ptr)
+    return NULL;
 
   al->n += new_count;
   al->n -= old_count;
@@ -45,12 +105,19 @@ std_allocator_reallocate (std_allocator *al, dptr ptr, size_t old_count,
 void
 std_allocator_deallocate (std_allocator *al, dptr ptr, size_t count)
 {
-  munmap (ptr, count * al->type_size);
+  size_t size = al->type_size * count;
+
+  if (size > STD_ALLOCATOR_MMAP_THRESHOLD)
+    munmap (ptr, size);
+  else
+    slab_allocator_deallocate (al->slab, ptr);
+
   al->n -= count;
 }
 
 void
 std_allocator_destroy (std_allocator *al)
 {
-  munmap (al, sizeof (std_allocator));
+  slab_allocator_destroy (al->slab);
+  free (al);
 }
@@ -12,10 +12,20 @@
 
 #include <stddef.h> // NULL
 #include <stdint.h>
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcpy
 #include <sys/mman.h> // mmap, munmap, mremap
 
+#include "slab_allocator.h"
 #include "types.h"
 
+/**
+ * @brief Requests greater than this number of bytes
+ * are mapped directly, smaller ones are served by
+ * slab allocator.
+ */
+#define STD_ALLOCATOR_MMAP_THRESHOLD SLAB_ALLOCATOR_MAX_SMALL
+
 /**
  * @brief Mactor to check if this type of allocator can
  * be used with containers. It will be assert this macro
@@ -29,7 +39,10 @@
 /**
  * @struct std_allocator
  * @brief Implemenation of std_allocator.
- * Just wrapper around malloc, free (mmap, munmap).
+ * Small requests are sub-allocated from slabs, huge
+ * ones are mapped by mmap and resized by mremap.
+ * Size of every request is known from the count, so
+ * huge mappings need no header.
  */
 typedef struct std_allocator
 {
@@ -48,6 +61,11 @@ typedef struct std_allocator
    * equal to 0.
    */
   size_t n;
+
+  /**
+   * @brief Allocator of the small requests.
+   */
+  slab_allocator *slab;
 } std_allocator;
 
 ////////////////////////////////////////////////////
@@ -99,6 +117,8 @@ void std_allocator_deallocate (std_allocator *al, dptr ptr, size_t count);
  * @param ptr Pointer to the first chunk to reallocate.
  * @param old_count Number of chunks before reallocation.
  * @param new_count Number of chunks should be after reallocation.
+ * @return dptr Pointer to reallocated memory. May differ
+ * from <ptr>, then <ptr> should not be used.
  */
 dptr std_allocator_reallocate (std_allocator *al, dptr ptr, size_t old_count,
                                size_t new_count);
@@ -21,7 +21,8 @@ __string_increase_capacity (string *str, size_t size)
   size_t new_capacity
       = str->capacity + size * STRING_ARRAY_CAPACITY_INCREASE_FACTOR;
 
-  char *ptr = realloc (str->arr, new_capacity);
+  char *ptr = allocator_reallocate (&str->alloc, str->arr, str->capacity,
+                                    new_capacity);
 
   str->capacity = new_capacity;
   str->arr = ptr;
@@ -35,11 +36,19 @@ __string_increase_capacity (string *str, size_t size)
 string *
 string_create_capacity (size_t capacity)
 {
-  string *str = (string *)malloc (sizeof (string));
+  return string_create_with_allocator (capacity, NULL);
+}
+
+string *
+string_create_with_allocator (size_t capacity, const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  string *str = (string *)allocator_allocate (&al, sizeof (string));
 
   str->capacity = capacity;
   str->size = 0;
-  str->arr = (char *)malloc (sizeof (char) * str->capacity);
+  str->alloc = al;
+  str->arr = (char *)allocator_allocate (&al, sizeof (char) * str->capacity);
   if (str->capacity > 0)
     str->arr[0] = '\0';
 
@@ -255,7 +264,7 @@ string_copy_substr (const string *str, size_t offset, size_t count)
     return NULL;
 
   // Reserving one symbol for '\0'
-  string *new_str = string_create_capacity (count + 1);
+  string *new_str = string_create_with_allocator (count + 1, &str->alloc);
 
   for (size_t i = 0; i < count; i++)
     new_str->arr[i] = str->arr[i + offset];
@@ -421,7 +430,8 @@ string_length (const string *str)
 inline void
 string_push_back (string *str, char c)
 {
-  __string_increase_capacity (str, 1);
+  // Symbol and '\0' after it.
+  __string_increase_capacity (str, 2);
 
   str->arr[str->size] = c;
   str->size++;
@@ -539,7 +549,8 @@ string_reserve (string *str, size_t count)
   if (!str || count < str->capacity)
     return;
 
-  char *ptr = (char *)realloc (str->arr, count);
+  char *ptr = (char *)allocator_reallocate (&str->alloc, str->arr,
+                                           str->capacity, count);
   str->capacity = count;
   str->arr = ptr;
 }
@@ -666,7 +677,7 @@ string_substr (const string *str, size_t offset, size_t count)
   if (str->size < offset + count)
     count = str->size - offset;
 
-  string *new_str = string_create_capacity (count + 1);
+  string *new_str = string_create_with_allocator (count + 1, &str->alloc);
   string_replace_substr (new_str, str, 0, offset, count);
 
   return new_str;
@@ -679,7 +690,7 @@ string_destroy (string *str)
     return;
 
   if (str->arr)
-    free (str->arr);
+    allocator_deallocate (&str->alloc, str->arr, str->capacity);
 
-  free (str);
+  allocator_deallocate (&str->alloc, str, sizeof (string));
 }
@@ -11,6 +11,7 @@
 #include <stdlib.h>  // malloc, realloc, free
 #include <string.h>  // string functions with char *arrays.
 
+#include "allocator.h"
 #include "types.h"
 
 #define STRING_ARRAY_CAPACITY_INCREASE_FACTOR 2
@@ -37,6 +38,11 @@ typedef struct string
    * @brief Current capacity of string.
    */
   size_t capacity;
+
+  /**
+   * @brief Allocator of the string instance and <arr>.
+   */
+  allocator alloc;
 } string;
 
 /**
@@ -93,6 +99,19 @@ string *string_create_char (char sym, size_t count);
  */
 string *string_create_default ();
 
+/**
+ * @brief Constructor. Creates new string
+ * with <capactiy> capacity, that takes memory
+ * for itself and its chars from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param capacity Starting capacity for the string.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return string* Pointer to new string.
+ */
+string *string_create_with_allocator (size_t capacity,
+                                      const allocator *alloc);
+
 ////////////////////////////////////////////////////
 /*         End of Bunch of constructors.          */
 ////////////////////////////////////////////////////
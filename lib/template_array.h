@@ -0,0 +1,165 @@
+/**
+ * @file template_array.h Macro template of Dynamic array,
+ * that is specialized for element type at compile time.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_TEMPLATE_ARRAY_H
+#define _EXTENDED_C_LIB_LIB_TEMPLATE_ARRAY_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <string.h>  // memmove
+
+#include "allocator.h"
+#include "types.h"
+
+#define TEMPLATE_ARRAY_CAPACITY_INCREASE_FACTOR 2
+#define TEMPLATE_ARRAY_CAPACITY_DEFAULT 10
+
+/**
+ * @brief Macro to define array of <T> elements,
+ * named <name>. Elements are stored by value and all
+ * functions are static inline, so loops over them
+ * are optimized as loops over plain C array.
+ *
+ * Defines type <name> and functions:
+ * name_create (capacity), name_create_with_allocator
+ * (capacity, alloc), name_destroy (arr), name_at (arr, pos),
+ * name_back (arr), name_capacity (arr), name_clear (arr),
+ * name_data (arr), name_empty (arr), name_erase (arr, pos),
+ * name_insert (arr, pos, value), name_pop_back (arr),
+ * name_push_back (arr, value), name_reserve (arr, count),
+ * name_size (arr).
+ *
+ * @param name Name of the array type.
+ * @param T Type of elements.
+ */
+#define DEFINE_ARRAY(name, T)                                                 \
+  typedef struct name                                                         \
+  {                                                                           \
+    T *data;                                                                  \
+    size_t size;                                                              \
+    size_t capacity;                                                          \
+    allocator alloc;                                                          \
+  } name;                                                                     \
+                                                                              \
+  /* Sets capacity, that is not less than size. */                            \
+  static inline void name##__set_capacity (name *arr, size_t capacity)        \
+  {                                                                           \
+    arr->data = (T *)allocator_reallocate (&arr->alloc, arr->data,            \
+                                           sizeof (T) * arr->capacity,        \
+                                           sizeof (T) * capacity);            \
+    arr->capacity = capacity;                                                 \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create_with_allocator (size_t capacity,          \
+                                                    const allocator *alloc)   \
+  {                                                                           \
+    allocator al = allocator_or_default (alloc);                              \
+    name *arr = (name *)allocator_allocate (&al, sizeof (name));              \
+                                                                              \
+    arr->size = 0;                                                            \
+    arr->capacity                                                             \
+        = (capacity == 0) ? TEMPLATE_ARRAY_CAPACITY_DEFAULT : capacity;       \
+    arr->alloc = al;                                                          \
+    arr->data = (T *)allocator_allocate (&al, sizeof (T) * arr->capacity);    \
+                                                                              \
+    return arr;                                                               \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create (size_t capacity)                         \
+  {                                                                           \
+    return name##_create_with_allocator (capacity, NULL);                     \
+  }                                                                           \
+                                                                              \
+  static inline void name##_destroy (name *arr)                               \
+  {                                                                           \
+    if (!arr)                                                                 \
+      return;                                                                 \
+                                                                              \
+    allocator_deallocate (&arr->alloc, arr->data,                             \
+                          sizeof (T) * arr->capacity);                        \
+    allocator_deallocate (&arr->alloc, arr, sizeof (name));                   \
+  }                                                                           \
+                                                                              \
+  /* Returns NULL if <pos> is out of range. */                                \
+  static inline T *name##_at (const name *arr, size_t pos)                    \
+  {                                                                           \
+    if (pos >= arr->size)                                                     \
+      return NULL;                                                            \
+    return arr->data + pos;                                                   \
+  }                                                                           \
+                                                                              \
+  static inline T *name##_back (const name *arr)                              \
+  {                                                                           \
+    if (arr->size == 0)                                                       \
+      return NULL;                                                            \
+    return arr->data + arr->size - 1;                                         \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_capacity (const name *arr)                      \
+  {                                                                           \
+    return arr->capacity;                                                     \
+  }                                                                           \
+                                                                              \
+  static inline void name##_clear (name *arr) { arr->size = 0; }              \
+                                                                              \
+  static inline T *name##_data (const name *arr) { return arr->data; }        \
+                                                                              \
+  static inline bool name##_empty (const name *arr)                           \
+  {                                                                           \
+    return arr->size == 0;                                                    \
+  }                                                                           \
+                                                                              \
+  static inline void name##_erase (name *arr, size_t pos)                     \
+  {                                                                           \
+    if (pos >= arr->size)                                                     \
+      return;                                                                 \
+                                                                              \
+    memmove (arr->data + pos, arr->data + pos + 1,                            \
+             sizeof (T) * (arr->size - pos - 1));                             \
+    arr->size--;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline void name##_reserve (name *arr, size_t count)                 \
+  {                                                                           \
+    if (count > arr->capacity)                                                \
+      name##__set_capacity (arr, count);                                      \
+  }                                                                           \
+                                                                              \
+  /* Returns pointer to inserted element, NULL if <pos> > size. */            \
+  static inline T *name##_insert (name *arr, size_t pos, T value)             \
+  {                                                                           \
+    if (pos > arr->size)                                                      \
+      return NULL;                                                            \
+                                                                              \
+    if (arr->size == arr->capacity)                                           \
+      name##__set_capacity (                                                  \
+          arr, arr->capacity * TEMPLATE_ARRAY_CAPACITY_INCREASE_FACTOR);      \
+                                                                              \
+    memmove (arr->data + pos + 1, arr->data + pos,                            \
+             sizeof (T) * (arr->size - pos));                                 \
+    arr->data[pos] = value;                                                   \
+    arr->size++;                                                              \
+                                                                              \
+    return arr->data + pos;                                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_pop_back (name *arr)                              \
+  {                                                                           \
+    if (arr->size > 0)                                                        \
+      arr->size--;                                                            \
+  }                                                                           \
+                                                                              \
+  static inline void name##_push_back (name *arr, T value)                    \
+  {                                                                           \
+    if (arr->size == arr->capacity)                                           \
+      name##__set_capacity (                                                  \
+          arr, arr->capacity * TEMPLATE_ARRAY_CAPACITY_INCREASE_FACTOR);      \
+                                                                              \
+    arr->data[arr->size++] = value;                                           \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_size (const name *arr) { return arr->size; }
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file template_hashmap.h Macro template of Hashmap,
+ * that is specialized for key and value types at compile time.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_TEMPLATE_HASHMAP_H
+#define _EXTENDED_C_LIB_LIB_TEMPLATE_HASHMAP_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <string.h>  // memset
+
+#include "allocator.h"
+#include "hash.h"
+#include "types.h"
+
+#define TEMPLATE_HASHMAP_CAPACITY_DEFAULT 16
+#define TEMPLATE_HASHMAP_LOAD_FACTOR_NUM 3
+#define TEMPLATE_HASHMAP_LOAD_FACTOR_DEN 4
+
+/**
+ * @brief Macro to define hashmap from <K> to <V>,
+ * named <name>. Uses open addressing with linear probing,
+ * keys and values are stored in slots by value. <hashfn>
+ * and <eqfn> are called directly, so they could be inlined.
+ *
+ * Defines type <name> and functions:
+ * name_create (), name_create_with_allocator (alloc),
+ * name_destroy (hm), name_at (hm, key), name_clear (hm),
+ * name_contains (hm, key), name_empty (hm),
+ * name_erase (hm, key), name_insert (hm, key, value),
+ * name_reserve (hm, count), name_size (hm).
+ *
+ * @param name Name of the hashmap type.
+ * @param K Type of keys.
+ * @param V Type of values.
+ * @param hashfn Function or macro hash64 (K key).
+ * @param eqfn Function or macro bool (K first, K second).
+ */
+#define DEFINE_HASHMAP(name, K, V, hashfn, eqfn)                              \
+  struct name##_slot                                                          \
+  {                                                                           \
+    K key;                                                                    \
+    V value;                                                                  \
+    bool used;                                                                \
+  };                                                                          \
+                                                                              \
+  typedef struct name                                                         \
+  {                                                                           \
+    struct name##_slot *slots;                                                \
+    size_t size;                                                              \
+    size_t capacity;                                                          \
+    allocator alloc;                                                          \
+  } name;                                                                     \
+                                                                              \
+  /* Allocates <capacity> empty slots, <capacity> is power of 2. */           \
+  static inline void name##__slots_create (name *hm, size_t capacity)         \
+  {                                                                           \
+    size_t bytes = sizeof (struct name##_slot) * capacity;                    \
+                                                                              \
+    hm->slots = (struct name##_slot *)allocator_allocate (&hm->alloc,         \
+                                                          bytes);             \
+    memset (hm->slots, 0, bytes);                                             \
+    hm->capacity = capacity;                                                  \
+  }                                                                           \
+                                                                              \
+  /* Returns slot with <key> or the first empty slot on its way. */           \
+  static inline struct name##_slot *name##__find_slot (const name *hm,        \
+                                                       K key)                 \
+  {                                                                           \
+    size_t mask = hm->capacity - 1;                                           \
+    size_t i = (size_t)(hashfn (key)) & mask;                                 \
+                                                                              \
+    while (hm->slots[i].used && !(eqfn (hm->slots[i].key, key)))              \
+      i = (i + 1) & mask;                                                     \
+                                                                              \
+    return hm->slots + i;                                                     \
+  }                                                                           \
+                                                                              \
+  /* Moves all used slots to new array of <capacity> slots. */                \
+  static inline void name##__rehash (name *hm, size_t capacity)               \
+  {                                                                           \
+    struct name##_slot *old = hm->slots;                                      \
+    size_t old_capacity = hm->capacity;                                       \
+                                                                              \
+    name##__slots_create (hm, capacity);                                      \
+                                                                              \
+    for (size_t i = 0; i < old_capacity; i++)                                 \
+      if (old[i].used)                                                        \
+        *name##__find_slot (hm, old[i].key) = old[i];                         \
+                                                                              \
+    allocator_deallocate (&hm->alloc, old,                                    \
+                          sizeof (struct name##_slot) * old_capacity);        \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create_with_allocator (const allocator *alloc)   \
+  {                                                                           \
+    allocator al = allocator_or_default (alloc);                              \
+    name *hm = (name *)allocator_allocate (&al, sizeof (name));               \
+                                                                              \
+    hm->size = 0;                                                             \
+    hm->alloc = al;                                                           \
+    name##__slots_create (hm, TEMPLATE_HASHMAP_CAPACITY_DEFAULT);             \
+                                                                              \
+    return hm;                                                                \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create (void)                                    \
+  {                                                                           \
+    return name##_create_with_allocator (NULL);                               \
+  }                                                                           \
+                                                                              \
+  static inline void name##_destroy (name *hm)                                \
+  {                                                                           \
+    if (!hm)                                                                  \
+      return;                                                                 \
+                                                                              \
+    allocator_deallocate (&hm->alloc, hm->slots,                              \
+                          sizeof (struct name##_slot) * hm->capacity);        \
+    allocator_deallocate (&hm->alloc, hm, sizeof (name));                     \
+  }                                                                           \
+                                                                              \
+  /* Returns pointer to value inside hashmap, NULL if no <key>. */            \
+  static inline V *name##_at (const name *hm, K key)                          \
+  {                                                                           \
+    struct name##_slot *slot = name##__find_slot (hm, key);                   \
+                                                                              \
+    return slot->used ? &slot->value : NULL;                                  \
+  }                                                                           \
+                                                                              \
+  static inline void name##_clear (name *hm)                                  \
+  {                                                                           \
+    memset (hm->slots, 0, sizeof (struct name##_slot) * hm->capacity);        \
+    hm->size = 0;                                                             \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_contains (const name *hm, K key)                  \
+  {                                                                           \
+    return name##__find_slot (hm, key)->used;                                 \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_empty (const name *hm) { return hm->size == 0; }  \
+                                                                              \
+  /* Backward shift deletion, so no tombstones are left. */                   \
+  static inline bool name##_erase (name *hm, K key)                           \
+  {                                                                           \
+    size_t mask = hm->capacity - 1;                                           \
+    struct name##_slot *slot = name##__find_slot (hm, key);                   \
+                                                                              \
+    if (!slot->used)                                                          \
+      return false;                                                           \
+                                                                              \
+    size_t hole = (size_t)(slot - hm->slots);                                 \
+    size_t i = hole;                                                          \
+                                                                              \
+    for (;;)                                                                  \
+      {                                                                       \
+        i = (i + 1) & mask;                                                   \
+        if (!hm->slots[i].used)                                               \
+          break;                                                              \
+                                                                              \
+        /* Slot may fill the hole, if its home is not in (hole, i]. */        \
+        size_t home = (size_t)(hashfn (hm->slots[i].key)) & mask;             \
+        if (((i - home) & mask) >= ((i - hole) & mask))                       \
+          {                                                                   \
+            hm->slots[hole] = hm->slots[i];                                   \
+            hole = i;                                                         \
+          }                                                                   \
+      }                                                                       \
+                                                                              \
+    hm->slots[hole].used = false;                                             \
+    hm->size--;                                                               \
+                                                                              \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  /* Inserts <key> or updates its value. Returns pointer to value. */         \
+  static inline V *name##_insert (name *hm, K key, V value)                   \
+  {                                                                           \
+    if ((hm->size + 1) * TEMPLATE_HASHMAP_LOAD_FACTOR_DEN                     \
+        > hm->capacity * TEMPLATE_HASHMAP_LOAD_FACTOR_NUM)                    \
+      name##__rehash (hm, hm->capacity * 2);                                  \
+                                                                              \
+    struct name##_slot *slot = name##__find_slot (hm, key);                   \
+                                                                              \
+    if (!slot->used)                                                          \
+      {                                                                       \
+        slot->key = key;                                                      \
+        slot->used = true;                                                    \
+        hm->size++;                                                           \
+      }                                                                       \
+    slot->value = value;                                                      \
+                                                                              \
+    return &slot->value;                                                      \
+  }                                                                           \
+                                                                              \
+  /* Makes room for <count> keys without rehashing. */                        \
+  static inline void name##_reserve (name *hm, size_t count)                  \
+  {                                                                           \
+    size_t capacity = hm->capacity;                                           \
+                                                                              \
+    while (count * TEMPLATE_HASHMAP_LOAD_FACTOR_DEN                           \
+           > capacity * TEMPLATE_HASHMAP_LOAD_FACTOR_NUM)                     \
+      capacity *= 2;                                                          \
+                                                                              \
+    if (capacity != hm->capacity)                                             \
+      name##__rehash (hm, capacity);                                          \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_size (const name *hm) { return hm->size; }
+
+#endif
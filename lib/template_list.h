@@ -0,0 +1,186 @@
+/**
+ * @file template_list.h Macro template of List,
+ * that is specialized for element type at compile time.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_TEMPLATE_LIST_H
+#define _EXTENDED_C_LIB_LIB_TEMPLATE_LIST_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+
+#include "allocator.h"
+#include "types.h"
+
+/**
+ * @brief Macro to define doubly linked list of <T>
+ * elements, named <name>. Elements are stored in
+ * nodes by value and all functions are static inline.
+ *
+ * Defines types <name>, struct name_node and functions:
+ * name_create (), name_create_with_allocator (alloc),
+ * name_destroy (l), name_back (l), name_begin (l),
+ * name_clear (l), name_empty (l), name_erase (l, node),
+ * name_front (l), name_insert (l, node, value),
+ * name_next (node), name_pop_back (l), name_pop_front (l),
+ * name_push_back (l, value), name_push_front (l, value),
+ * name_size (l).
+ *
+ * @param name Name of the list type.
+ * @param T Type of elements.
+ */
+#define DEFINE_LIST(name, T)                                                  \
+  struct name##_node                                                          \
+  {                                                                           \
+    T data;                                                                   \
+    struct name##_node *next;                                                 \
+    struct name##_node *prev;                                                 \
+  };                                                                          \
+                                                                              \
+  typedef struct name                                                         \
+  {                                                                           \
+    struct name##_node *front;                                                \
+    struct name##_node *back;                                                 \
+    size_t size;                                                              \
+    allocator alloc;                                                          \
+  } name;                                                                     \
+                                                                              \
+  static inline name *name##_create_with_allocator (const allocator *alloc)   \
+  {                                                                           \
+    allocator al = allocator_or_default (alloc);                              \
+    name *l = (name *)allocator_allocate (&al, sizeof (name));                \
+                                                                              \
+    l->front = NULL;                                                          \
+    l->back = NULL;                                                           \
+    l->size = 0;                                                              \
+    l->alloc = al;                                                            \
+                                                                              \
+    return l;                                                                 \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create (void)                                    \
+  {                                                                           \
+    return name##_create_with_allocator (NULL);                               \
+  }                                                                           \
+                                                                              \
+  static inline T *name##_back (const name *l)                                \
+  {                                                                           \
+    return l->back ? &l->back->data : NULL;                                   \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_begin (const name *l)              \
+  {                                                                           \
+    return l->front;                                                          \
+  }                                                                           \
+                                                                              \
+  static inline void name##_clear (name *l)                                   \
+  {                                                                           \
+    struct name##_node *cur = l->front;                                       \
+                                                                              \
+    while (cur)                                                               \
+      {                                                                       \
+        struct name##_node *next = cur->next;                                 \
+        allocator_deallocate (&l->alloc, cur, sizeof (struct name##_node));   \
+        cur = next;                                                           \
+      }                                                                       \
+                                                                              \
+    l->front = NULL;                                                          \
+    l->back = NULL;                                                           \
+    l->size = 0;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline void name##_destroy (name *l)                                 \
+  {                                                                           \
+    if (!l)                                                                   \
+      return;                                                                 \
+                                                                              \
+    name##_clear (l);                                                         \
+    allocator_deallocate (&l->alloc, l, sizeof (name));                       \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_empty (const name *l) { return l->size == 0; }    \
+                                                                              \
+  /* Returns node after erased one. */                                        \
+  static inline struct name##_node *name##_erase (name *l,                    \
+                                                  struct name##_node *node)   \
+  {                                                                           \
+    struct name##_node *next = node->next;                                    \
+                                                                              \
+    if (node->prev)                                                           \
+      node->prev->next = node->next;                                          \
+    else                                                                      \
+      l->front = node->next;                                                  \
+                                                                              \
+    if (node->next)                                                           \
+      node->next->prev = node->prev;                                          \
+    else                                                                      \
+      l->back = node->prev;                                                   \
+                                                                              \
+    allocator_deallocate (&l->alloc, node, sizeof (struct name##_node));      \
+    l->size--;                                                                \
+                                                                              \
+    return next;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline T *name##_front (const name *l)                               \
+  {                                                                           \
+    return l->front ? &l->front->data : NULL;                                 \
+  }                                                                           \
+                                                                              \
+  /* Inserts before <where>, NULL <where> means end of the list. */           \
+  static inline struct name##_node *name##_insert (                           \
+      name *l, struct name##_node *where, T value)                            \
+  {                                                                           \
+    struct name##_node *node = (struct name##_node *)allocator_allocate (     \
+        &l->alloc, sizeof (struct name##_node));                              \
+                                                                              \
+    node->data = value;                                                       \
+    node->next = where;                                                       \
+    node->prev = where ? where->prev : l->back;                               \
+                                                                              \
+    if (node->prev)                                                           \
+      node->prev->next = node;                                                \
+    else                                                                      \
+      l->front = node;                                                        \
+                                                                              \
+    if (where)                                                                \
+      where->prev = node;                                                     \
+    else                                                                      \
+      l->back = node;                                                         \
+                                                                              \
+    l->size++;                                                                \
+                                                                              \
+    return node;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_next (                             \
+      const struct name##_node *node)                                         \
+  {                                                                           \
+    return node->next;                                                        \
+  }                                                                           \
+                                                                              \
+  static inline void name##_pop_back (name *l)                                \
+  {                                                                           \
+    if (l->back)                                                              \
+      name##_erase (l, l->back);                                              \
+  }                                                                           \
+                                                                              \
+  static inline void name##_pop_front (name *l)                               \
+  {                                                                           \
+    if (l->front)                                                             \
+      name##_erase (l, l->front);                                             \
+  }                                                                           \
+                                                                              \
+  static inline void name##_push_back (name *l, T value)                      \
+  {                                                                           \
+    name##_insert (l, NULL, value);                                           \
+  }                                                                           \
+                                                                              \
+  static inline void name##_push_front (name *l, T value)                     \
+  {                                                                           \
+    name##_insert (l, l->front, value);                                       \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_size (const name *l) { return l->size; }
+
+#endif
@@ -0,0 +1,531 @@
+/**
+ * @file template_rbtree.h Macro templates of Red-Black tree
+ * and Set, that are specialized for element type at compile time.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_TEMPLATE_RBTREE_H
+#define _EXTENDED_C_LIB_LIB_TEMPLATE_RBTREE_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+
+#include "allocator.h"
+#include "types.h"
+
+/**
+ * @brief Macro to define Red-Black tree of <T>
+ * elements, named <name>. Elements are stored in
+ * nodes by value, <cmpfn> is called directly.
+ *
+ * Defines types <name>, struct name_node and functions:
+ * name_create (allow_same), name_create_with_allocator
+ * (allow_same, alloc), name_destroy (tree), name_begin (tree),
+ * name_clear (tree), name_erase (tree, node),
+ * name_find (tree, value), name_insert (tree, value),
+ * name_lower_bound (tree, value), name_next (node),
+ * name_prev (node), name_rbegin (tree), name_size (tree).
+ *
+ * @param name Name of the tree type.
+ * @param T Type of elements.
+ * @param cmpfn Function or macro int (T first, T second),
+ * that returns negative, zero or positive value.
+ */
+#define DEFINE_RBTREE(name, T, cmpfn)                                         \
+  struct name##_node                                                          \
+  {                                                                           \
+    T data;                                                                   \
+    struct name##_node *left;                                                 \
+    struct name##_node *right;                                                \
+    struct name##_node *parent;                                               \
+    bool is_red;                                                              \
+  };                                                                          \
+                                                                              \
+  typedef struct name                                                         \
+  {                                                                           \
+    struct name##_node *root;                                                 \
+    size_t size;                                                              \
+    bool allow_same;                                                          \
+    allocator alloc;                                                          \
+  } name;                                                                     \
+                                                                              \
+  static inline void name##__rotate_left (name *tree,                         \
+                                          struct name##_node *x)              \
+  {                                                                           \
+    struct name##_node *y = x->right;                                         \
+                                                                              \
+    x->right = y->left;                                                       \
+    if (y->left)                                                              \
+      y->left->parent = x;                                                    \
+                                                                              \
+    y->parent = x->parent;                                                    \
+    if (!x->parent)                                                           \
+      tree->root = y;                                                         \
+    else if (x == x->parent->left)                                            \
+      x->parent->left = y;                                                    \
+    else                                                                      \
+      x->parent->right = y;                                                   \
+                                                                              \
+    y->left = x;                                                              \
+    x->parent = y;                                                            \
+  }                                                                           \
+                                                                              \
+  static inline void name##__rotate_right (name *tree,                        \
+                                           struct name##_node *x)             \
+  {                                                                           \
+    struct name##_node *y = x->left;                                          \
+                                                                              \
+    x->left = y->right;                                                       \
+    if (y->right)                                                             \
+      y->right->parent = x;                                                   \
+                                                                              \
+    y->parent = x->parent;                                                    \
+    if (!x->parent)                                                           \
+      tree->root = y;                                                         \
+    else if (x == x->parent->right)                                           \
+      x->parent->right = y;                                                   \
+    else                                                                      \
+      x->parent->left = y;                                                    \
+                                                                              \
+    y->right = x;                                                             \
+    x->parent = y;                                                            \
+  }                                                                           \
+                                                                              \
+  static inline void name##__insert_fixup (name *tree,                        \
+                                           struct name##_node *z)             \
+  {                                                                           \
+    while (z->parent && z->parent->is_red)                                    \
+      {                                                                       \
+        struct name##_node *gp = z->parent->parent;                           \
+                                                                              \
+        if (z->parent == gp->left)                                            \
+          {                                                                   \
+            struct name##_node *uncle = gp->right;                            \
+                                                                              \
+            if (uncle && uncle->is_red)                                       \
+              {                                                               \
+                z->parent->is_red = false;                                    \
+                uncle->is_red = false;                                        \
+                gp->is_red = true;                                            \
+                z = gp;                                                       \
+                continue;                                                     \
+              }                                                               \
+            if (z == z->parent->right)                                        \
+              {                                                               \
+                z = z->parent;                                                \
+                name##__rotate_left (tree, z);                                \
+              }                                                               \
+            z->parent->is_red = false;                                        \
+            gp->is_red = true;                                                \
+            name##__rotate_right (tree, gp);                                  \
+          }                                                                   \
+        else                                                                  \
+          {                                                                   \
+            struct name##_node *uncle = gp->left;                             \
+                                                                              \
+            if (uncle && uncle->is_red)                                       \
+              {                                                               \
+                z->parent->is_red = false;                                    \
+                uncle->is_red = false;                                        \
+                gp->is_red = true;                                            \
+                z = gp;                                                       \
+                continue;                                                     \
+              }                                                               \
+            if (z == z->parent->left)                                         \
+              {                                                               \
+                z = z->parent;                                                \
+                name##__rotate_right (tree, z);                               \
+              }                                                               \
+            z->parent->is_red = false;                                        \
+            gp->is_red = true;                                                \
+            name##__rotate_left (tree, gp);                                   \
+          }                                                                   \
+      }                                                                       \
+                                                                              \
+    tree->root->is_red = false;                                               \
+  }                                                                           \
+                                                                              \
+  /* Puts <v> on place of <u> in <u>'s parent. */                             \
+  static inline void name##__transplant (name *tree,                          \
+                                         struct name##_node *u,               \
+                                         struct name##_node *v)               \
+  {                                                                           \
+    if (!u->parent)                                                           \
+      tree->root = v;                                                         \
+    else if (u == u->parent->left)                                            \
+      u->parent->left = v;                                                    \
+    else                                                                      \
+      u->parent->right = v;                                                   \
+                                                                              \
+    if (v)                                                                    \
+      v->parent = u->parent;                                                  \
+  }                                                                           \
+                                                                              \
+  /* <x> may be NULL, so its parent is passed separately. */                  \
+  static inline void name##__erase_fixup (name *tree,                         \
+                                          struct name##_node *x,              \
+                                          struct name##_node *parent)         \
+  {                                                                           \
+    while (x != tree->root && (!x || !x->is_red))                             \
+      {                                                                       \
+        if (x == parent->left)                                                \
+          {                                                                   \
+            struct name##_node *w = parent->right;                            \
+                                                                              \
+            if (w->is_red)                                                    \
+              {                                                               \
+                w->is_red = false;                                            \
+                parent->is_red = true;                                        \
+                name##__rotate_left (tree, parent);                           \
+                w = parent->right;                                            \
+              }                                                               \
+            if ((!w->left || !w->left->is_red)                                \
+                && (!w->right || !w->right->is_red))                          \
+              {                                                               \
+                w->is_red = true;                                             \
+                x = parent;                                                   \
+                parent = x->parent;                                           \
+                continue;                                                     \
+              }                                                               \
+            if (!w->right || !w->right->is_red)                               \
+              {                                                               \
+                w->left->is_red = false;                                      \
+                w->is_red = true;                                             \
+                name##__rotate_right (tree, w);                               \
+                w = parent->right;                                            \
+              }                                                               \
+            w->is_red = parent->is_red;                                       \
+            parent->is_red = false;                                           \
+            w->right->is_red = false;                                         \
+            name##__rotate_left (tree, parent);                               \
+            x = tree->root;                                                   \
+          }                                                                   \
+        else                                                                  \
+          {                                                                   \
+            struct name##_node *w = parent->left;                             \
+                                                                              \
+            if (w->is_red)                                                    \
+              {                                                               \
+                w->is_red = false;                                            \
+                parent->is_red = true;                                        \
+                name##__rotate_right (tree, parent);                          \
+                w = parent->left;                                             \
+              }                                                               \
+            if ((!w->left || !w->left->is_red)                                \
+                && (!w->right || !w->right->is_red))                          \
+              {                                                               \
+                w->is_red = true;                                             \
+                x = parent;                                                   \
+                parent = x->parent;                                           \
+                continue;                                                     \
+              }                                                               \
+            if (!w->left || !w->left->is_red)                                 \
+              {                                                               \
+                w->right->is_red = false;                                     \
+                w->is_red = true;                                             \
+                name##__rotate_left (tree, w);                                \
+                w = parent->left;                                             \
+              }                                                               \
+            w->is_red = parent->is_red;                                       \
+            parent->is_red = false;                                           \
+            w->left->is_red = false;                                          \
+            name##__rotate_right (tree, parent);                              \
+            x = tree->root;                                                   \
+          }                                                                   \
+      }                                                                       \
+                                                                              \
+    if (x)                                                                    \
+      x->is_red = false;                                                      \
+  }                                                                           \
+                                                                              \
+  static inline void name##__destroy_subtree (name *tree,                     \
+                                              struct name##_node *node)       \
+  {                                                                           \
+    while (node)                                                              \
+      {                                                                       \
+        struct name##_node *left = node->left;                                \
+                                                                              \
+        name##__destroy_subtree (tree, node->right);                          \
+        allocator_deallocate (&tree->alloc, node,                             \
+                              sizeof (struct name##_node));                   \
+        node = left;                                                          \
+      }                                                                       \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create_with_allocator (bool allow_same,          \
+                                                    const allocator *alloc)   \
+  {                                                                           \
+    allocator al = allocator_or_default (alloc);                              \
+    name *tree = (name *)allocator_allocate (&al, sizeof (name));             \
+                                                                              \
+    tree->root = NULL;                                                        \
+    tree->size = 0;                                                           \
+    tree->allow_same = allow_same;                                            \
+    tree->alloc = al;                                                         \
+                                                                              \
+    return tree;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create (bool allow_same)                         \
+  {                                                                           \
+    return name##_create_with_allocator (allow_same, NULL);                   \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_begin (const name *tree)           \
+  {                                                                           \
+    struct name##_node *node = tree->root;                                    \
+                                                                              \
+    while (node && node->left)                                                \
+      node = node->left;                                                      \
+                                                                              \
+    return node;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline void name##_clear (name *tree)                                \
+  {                                                                           \
+    name##__destroy_subtree (tree, tree->root);                               \
+    tree->root = NULL;                                                        \
+    tree->size = 0;                                                           \
+  }                                                                           \
+                                                                              \
+  static inline void name##_destroy (name *tree)                              \
+  {                                                                           \
+    if (!tree)                                                                \
+      return;                                                                 \
+                                                                              \
+    name##_clear (tree);                                                      \
+    allocator_deallocate (&tree->alloc, tree, sizeof (name));                 \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_next (                             \
+      const struct name##_node *node)                                         \
+  {                                                                           \
+    if (node->right)                                                          \
+      {                                                                       \
+        node = node->right;                                                   \
+        while (node->left)                                                    \
+          node = node->left;                                                  \
+        return (struct name##_node *)node;                                    \
+      }                                                                       \
+                                                                              \
+    while (node->parent && node == node->parent->right)                       \
+      node = node->parent;                                                    \
+                                                                              \
+    return node->parent;                                                      \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_prev (                             \
+      const struct name##_node *node)                                         \
+  {                                                                           \
+    if (node->left)                                                           \
+      {                                                                       \
+        node = node->left;                                                    \
+        while (node->right)                                                   \
+          node = node->right;                                                 \
+        return (struct name##_node *)node;                                    \
+      }                                                                       \
+                                                                              \
+    while (node->parent && node == node->parent->left)                        \
+      node = node->parent;                                                    \
+                                                                              \
+    return node->parent;                                                      \
+  }                                                                           \
+                                                                              \
+  static inline void name##_erase (name *tree, struct name##_node *z)         \
+  {                                                                           \
+    struct name##_node *y = z;                                                \
+    struct name##_node *x;                                                    \
+    struct name##_node *x_parent;                                             \
+    bool was_red = y->is_red;                                                 \
+                                                                              \
+    if (!z->left)                                                             \
+      {                                                                       \
+        x = z->right;                                                         \
+        x_parent = z->parent;                                                 \
+        name##__transplant (tree, z, z->right);                               \
+      }                                                                       \
+    else if (!z->right)                                                       \
+      {                                                                       \
+        x = z->left;                                                          \
+        x_parent = z->parent;                                                 \
+        name##__transplant (tree, z, z->left);                                \
+      }                                                                       \
+    else                                                                      \
+      {                                                                       \
+        /* Successor <y> takes place and color of <z>. */                     \
+        y = z->right;                                                         \
+        while (y->left)                                                       \
+          y = y->left;                                                        \
+                                                                              \
+        was_red = y->is_red;                                                  \
+        x = y->right;                                                         \
+                                                                              \
+        if (y->parent == z)                                                   \
+          x_parent = y;                                                       \
+        else                                                                  \
+          {                                                                   \
+            x_parent = y->parent;                                             \
+            name##__transplant (tree, y, y->right);                           \
+            y->right = z->right;                                              \
+            y->right->parent = y;                                             \
+          }                                                                   \
+                                                                              \
+        name##__transplant (tree, z, y);                                      \
+        y->left = z->left;                                                    \
+        y->left->parent = y;                                                  \
+        y->is_red = z->is_red;                                                \
+      }                                                                       \
+                                                                              \
+    if (!was_red && tree->root)                                               \
+      name##__erase_fixup (tree, x, x_parent);                                \
+                                                                              \
+    allocator_deallocate (&tree->alloc, z, sizeof (struct name##_node));      \
+    tree->size--;                                                             \
+  }                                                                           \
+                                                                              \
+  /* Returns the leftmost node, that is not less than <value>. */             \
+  static inline struct name##_node *name##_lower_bound (const name *tree,     \
+                                                        T value)              \
+  {                                                                           \
+    struct name##_node *node = tree->root;                                    \
+    struct name##_node *res = NULL;                                           \
+                                                                              \
+    while (node)                                                              \
+      {                                                                       \
+        if ((cmpfn (node->data, value)) < 0)                                  \
+          node = node->right;                                                 \
+        else                                                                  \
+          {                                                                   \
+            res = node;                                                       \
+            node = node->left;                                                \
+          }                                                                   \
+      }                                                                       \
+                                                                              \
+    return res;                                                               \
+  }                                                                           \
+                                                                              \
+  /* Returns the leftmost node equal to <value>, NULL if no. */               \
+  static inline struct name##_node *name##_find (const name *tree, T value)   \
+  {                                                                           \
+    struct name##_node *node = name##_lower_bound (tree, value);              \
+                                                                              \
+    if (node && (cmpfn (node->data, value)) == 0)                             \
+      return node;                                                            \
+    return NULL;                                                              \
+  }                                                                           \
+                                                                              \
+  /* Returns new node, NULL if <value> exists and !allow_same. */             \
+  static inline struct name##_node *name##_insert (name *tree, T value)       \
+  {                                                                           \
+    struct name##_node *parent = NULL;                                        \
+    struct name##_node **link = &tree->root;                                  \
+                                                                              \
+    while (*link)                                                             \
+      {                                                                       \
+        int res = cmpfn (value, (*link)->data);                               \
+                                                                              \
+        if (res == 0 && !tree->allow_same)                                    \
+          return NULL;                                                        \
+                                                                              \
+        parent = *link;                                                       \
+        link = (res < 0) ? &parent->left : &parent->right;                    \
+      }                                                                       \
+                                                                              \
+    struct name##_node *node = (struct name##_node *)allocator_allocate (     \
+        &tree->alloc, sizeof (struct name##_node));                           \
+                                                                              \
+    node->data = value;                                                       \
+    node->left = NULL;                                                        \
+    node->right = NULL;                                                       \
+    node->parent = parent;                                                    \
+    node->is_red = true;                                                      \
+    *link = node;                                                             \
+    tree->size++;                                                             \
+                                                                              \
+    name##__insert_fixup (tree, node);                                        \
+                                                                              \
+    return node;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_node *name##_rbegin (const name *tree)          \
+  {                                                                           \
+    struct name##_node *node = tree->root;                                    \
+                                                                              \
+    while (node && node->right)                                               \
+      node = node->right;                                                     \
+                                                                              \
+    return node;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_size (const name *tree) { return tree->size; }
+
+/**
+ * @brief Macro to define set of unique <T> elements,
+ * named <name>, on top of DEFINE_RBTREE.
+ *
+ * Defines types <name>, name_rbtree and functions:
+ * name_create (), name_create_with_allocator (alloc),
+ * name_destroy (s), name_begin (s), name_contains (s, value),
+ * name_erase (s, value), name_insert (s, value),
+ * name_next (node), name_size (s).
+ *
+ * @param name Name of the set type.
+ * @param T Type of elements.
+ * @param cmpfn Function or macro int (T first, T second).
+ */
+#define DEFINE_SET(name, T, cmpfn)                                            \
+  DEFINE_RBTREE (name##_rbtree, T, cmpfn)                                     \
+                                                                              \
+  typedef name##_rbtree name;                                                 \
+                                                                              \
+  static inline name *name##_create_with_allocator (const allocator *alloc)   \
+  {                                                                           \
+    return name##_rbtree_create_with_allocator (false, alloc);                \
+  }                                                                           \
+                                                                              \
+  static inline name *name##_create (void)                                    \
+  {                                                                           \
+    return name##_create_with_allocator (NULL);                               \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_rbtree_node *name##_begin (const name *s)       \
+  {                                                                           \
+    return name##_rbtree_begin (s);                                           \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_contains (const name *s, T value)                 \
+  {                                                                           \
+    return name##_rbtree_find (s, value) != NULL;                             \
+  }                                                                           \
+                                                                              \
+  static inline void name##_destroy (name *s) { name##_rbtree_destroy (s); }  \
+                                                                              \
+  /* Returns true if <value> was erased. */                                   \
+  static inline bool name##_erase (name *s, T value)                          \
+  {                                                                           \
+    struct name##_rbtree_node *node = name##_rbtree_find (s, value);          \
+                                                                              \
+    if (!node)                                                                \
+      return false;                                                           \
+                                                                              \
+    name##_rbtree_erase (s, node);                                            \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  /* Returns false if <value> is already in set. */                           \
+  static inline bool name##_insert (name *s, T value)                         \
+  {                                                                           \
+    return name##_rbtree_insert (s, value) != NULL;                           \
+  }                                                                           \
+                                                                              \
+  static inline struct name##_rbtree_node *name##_next (                      \
+      const struct name##_rbtree_node *node)                                  \
+  {                                                                           \
+    return name##_rbtree_next (node);                                         \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_size (const name *s)                            \
+  {                                                                           \
+    return name##_rbtree_size (s);                                            \
+  }
+
+#endif
@@ -0,0 +1,354 @@
+#include "typed_array.h"
+
+////////////////////////////////////////////////////
+/*      Private functions of the typed_array      */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to get pointer to element.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position of element.
+ * @return dptr Pointer to element.
+ */
+inline static dptr
+__typed_array_elem (const typed_array *arr, size_t pos)
+{
+  return arr->data + pos * arr->elem_size;
+}
+
+/**
+ * @brief Function to set capacity.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param capacity New capacity, not less than size.
+ */
+static void
+__typed_array_set_capacity (typed_array *arr, size_t capacity)
+{
+  arr->data = allocator_reallocate (&arr->alloc, arr->data,
+                                    arr->elem_size * arr->capacity,
+                                    arr->elem_size * capacity);
+  arr->capacity = capacity;
+}
+
+/**
+ * @brief Function to increase capacity, if
+ * <count> more elements don't fit.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param count Number of elements to add.
+ */
+inline static void
+__typed_array_increase_capacity_if_need (typed_array *arr, size_t count)
+{
+  if (arr->size + count <= arr->capacity)
+    return;
+
+  size_t capacity = arr->capacity * TYPED_ARRAY_CAPACITY_INCREASE_FACTOR;
+  if (capacity < arr->size + count)
+    capacity = arr->size + count;
+
+  __typed_array_set_capacity (arr, capacity);
+}
+
+/**
+ * @brief Function to get offset of <data> in the memory of
+ * the array. Used to find <data> again, if it points to
+ * array's own elements, which are moved by realloc or memmove.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param data Pointer to check.
+ * @return size_t Offset in bytes, or SIZE_MAX if <data>
+ * is outside of the elements.
+ */
+inline static size_t
+__typed_array_offset (const typed_array *arr, constdptr data)
+{
+  uintptr_t begin = (uintptr_t)arr->data;
+  uintptr_t ptr = (uintptr_t)data;
+
+  if (ptr < begin || ptr >= begin + arr->elem_size * arr->size)
+    return SIZE_MAX;
+  return ptr - begin;
+}
+
+////////////////////////////////////////////////////
+/*    Public API functions of the typed_array     */
+////////////////////////////////////////////////////
+
+typed_array *
+typed_array_create (size_t elem_size, size_t capacity)
+{
+  return typed_array_create_with_allocator (elem_size, capacity, NULL);
+}
+
+typed_array *
+typed_array_create_with_allocator (size_t elem_size, size_t capacity,
+                                   const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+
+  // Allocating memory for array instance.
+  typed_array *arr
+      = (typed_array *)allocator_allocate (&al, sizeof (typed_array));
+
+  // Setting starting values.
+  arr->size = 0;
+  arr->elem_size = elem_size;
+  arr->capacity = (capacity == 0) ? TYPED_ARRAY_CAPACITY_DEFAULT : capacity;
+  arr->alloc = al;
+
+  // Allocating memory for elements.
+  arr->data = allocator_allocate (&al, elem_size * arr->capacity);
+
+  return arr;
+}
+
+inline dptr
+typed_array_at (const typed_array *arr, size_t pos)
+{
+  // Checking if pos is not out of range.
+  if (!arr || pos >= arr->size)
+    return NULL;
+  return __typed_array_elem (arr, pos);
+}
+
+inline dptr
+typed_array_back (const typed_array *arr)
+{
+  if (!arr || arr->size == 0)
+    return NULL;
+  return __typed_array_elem (arr, arr->size - 1);
+}
+
+inline size_t
+typed_array_capacity (const typed_array *arr)
+{
+  if (!arr)
+    return 0;
+  return arr->capacity;
+}
+
+inline void
+typed_array_clear (typed_array *arr)
+{
+  if (arr)
+    arr->size = 0;
+}
+
+typed_array *
+typed_array_copy (const typed_array *arr)
+{
+  if (!arr)
+    return NULL;
+
+  typed_array *other = typed_array_create_with_allocator (
+      arr->elem_size, arr->capacity, &arr->alloc);
+
+  // Elements are plain bytes, so copying all at once.
+  memcpy (other->data, arr->data, arr->elem_size * arr->size);
+  other->size = arr->size;
+
+  return other;
+}
+
+inline dptr
+typed_array_data (const typed_array *arr)
+{
+  if (!arr)
+    return NULL;
+  return arr->data;
+}
+
+void
+typed_array_destroy (typed_array *arr)
+{
+  if (!arr)
+    return;
+
+  allocator_deallocate (&arr->alloc, arr->data,
+                        arr->elem_size * arr->capacity);
+  allocator_deallocate (&arr->alloc, arr, sizeof (typed_array));
+}
+
+inline dptr
+typed_array_emplace_back (typed_array *arr)
+{
+  if (!arr)
+    return NULL;
+
+  __typed_array_increase_capacity_if_need (arr, 1);
+
+  return __typed_array_elem (arr, arr->size++);
+}
+
+inline bool
+typed_array_empty (const typed_array *arr)
+{
+  if (!arr)
+    return true;
+  return arr->size == 0;
+}
+
+inline void
+typed_array_erase (typed_array *arr, size_t pos)
+{
+  typed_array_erase_many (arr, pos, 1);
+}
+
+void
+typed_array_erase_many (typed_array *arr, size_t pos, size_t count)
+{
+  if (!arr || pos >= arr->size)
+    return;
+
+  // Cutting range to the end of array.
+  if (count > arr->size - pos)
+    count = arr->size - pos;
+
+  // Moving tail over erased elements.
+  memmove (__typed_array_elem (arr, pos),
+           __typed_array_elem (arr, pos + count),
+           arr->elem_size * (arr->size - pos - count));
+  arr->size -= count;
+}
+
+size_t
+typed_array_find (const typed_array *arr, constdptr data,
+                  bool (*cmp) (constdptr first, constdptr second))
+{
+  if (!arr)
+    return 0;
+
+  for (size_t i = 0; i < arr->size; i++)
+    {
+      dptr cur = __typed_array_elem (arr, i);
+
+      if (cmp ? cmp (data, cur) : memcmp (data, cur, arr->elem_size) == 0)
+        return i;
+    }
+
+  return arr->size;
+}
+
+inline dptr
+typed_array_front (const typed_array *arr)
+{
+  if (!arr || arr->size == 0)
+    return NULL;
+  return arr->data;
+}
+
+inline dptr
+typed_array_insert (typed_array *arr, size_t pos, constdptr data)
+{
+  return typed_array_insert_many (arr, pos, data, 1);
+}
+
+dptr
+typed_array_insert_many (typed_array *arr, size_t pos, constdptr data,
+                         size_t count)
+{
+  if (!arr || pos > arr->size)
+    return NULL;
+
+  size_t offset = __typed_array_offset (arr, data);
+  size_t bytes = arr->elem_size * count;
+
+  __typed_array_increase_capacity_if_need (arr, count);
+
+  dptr where = __typed_array_elem (arr, pos);
+
+  // Making room by moving tail, then copying new elements.
+  memmove (__typed_array_elem (arr, pos + count), where,
+           arr->elem_size * (arr->size - pos));
+
+  if (offset == SIZE_MAX)
+    memcpy (where, data, bytes);
+  else
+    {
+      // Source is array's own elements. Part of them before
+      // <pos> stays in place, the rest is moved by the gap.
+      size_t gap = arr->elem_size * pos;
+      size_t before = (offset >= gap) ? 0 : gap - offset;
+
+      if (before > bytes)
+        before = bytes;
+
+      memcpy (where, arr->data + offset, before);
+      memcpy (where + before, arr->data + offset + before + bytes,
+              bytes - before);
+    }
+
+  arr->size += count;
+
+  return where;
+}
+
+inline void
+typed_array_pop_back (typed_array *arr)
+{
+  if (arr && arr->size > 0)
+    arr->size--;
+}
+
+inline void
+typed_array_push_back (typed_array *arr, constdptr data)
+{
+  if (!arr)
+    return;
+
+  // Element of the array is found again after realloc.
+  size_t offset = __typed_array_offset (arr, data);
+
+  __typed_array_increase_capacity_if_need (arr, 1);
+
+  if (offset != SIZE_MAX)
+    data = arr->data + offset;
+  memcpy (__typed_array_elem (arr, arr->size), data, arr->elem_size);
+  arr->size++;
+}
+
+inline void
+typed_array_reserve (typed_array *arr, size_t count)
+{
+  if (!arr || count <= arr->capacity)
+    return;
+
+  __typed_array_set_capacity (arr, count);
+}
+
+void
+typed_array_resize (typed_array *arr, size_t size)
+{
+  if (!arr)
+    return;
+
+  if (size > arr->size)
+    {
+      __typed_array_increase_capacity_if_need (arr, size - arr->size);
+      memset (__typed_array_elem (arr, arr->size), 0,
+              arr->elem_size * (size - arr->size));
+    }
+
+  arr->size = size;
+}
+
+inline void
+typed_array_shrink_to_fit (typed_array *arr)
+{
+  // Empty array keeps its memory, so <data> is never NULL.
+  if (!arr || arr->capacity == arr->size || arr->size == 0)
+    return;
+
+  __typed_array_set_capacity (arr, arr->size);
+}
+
+inline size_t
+typed_array_size (const typed_array *arr)
+{
+  if (!arr)
+    return 0;
+  return arr->size;
+}
@@ -0,0 +1,282 @@
+/**
+ * @file typed_array.h Implementation of Dynamic array,
+ * that stores elements of the same size contiguously.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_TYPED_ARRAY_H
+#define _EXTENDED_C_LIB_LIB_TYPED_ARRAY_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uintptr_t, SIZE_MAX
+#include <stdlib.h>  // malloc, realloc, free
+#include <string.h>  // memcpy, memmove, memset
+
+#include "allocator.h"
+#include "types.h"
+
+#define TYPED_ARRAY_CAPACITY_INCREASE_FACTOR 2
+#define TYPED_ARRAY_CAPACITY_DEFAULT 10
+
+/**
+ * @brief Macro to access element as <type> lvalue.
+ * Not checking range, so loops over it are as fast
+ * as over plain C array.
+ */
+#define TYPED_ARRAY_AT(arr, type, pos) (((type *)(arr)->data)[(pos)])
+
+/**
+ * @struct typed_array
+ * @brief Implementation of typed array.
+ * Elements are copied into array by value,
+ * instead of storing pointers to them.
+ */
+typedef struct typed_array
+{
+  /**
+   * @brief Contiguous memory of elements.
+   */
+  dptr data;
+
+  /**
+   * @brief Current number of elements.
+   */
+  size_t size;
+
+  /**
+   * @brief Current capacity in elements.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Size of one element in bytes.
+   */
+  size_t elem_size;
+
+  /**
+   * @brief Allocator of the array instance and <data>.
+   */
+  allocator alloc;
+} typed_array;
+
+////////////////////////////////////////////////////
+/*    Public API functions of the typed_array     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new typed array.
+ * Allocates the memory. Should be
+ * destroyed at the end.
+ *
+ * @param elem_size Size of one element in bytes.
+ * @param capacity Starting capacity in elements.
+ * @return typed_array* Pointer to new array.
+ */
+typed_array *typed_array_create (size_t elem_size, size_t capacity);
+
+/**
+ * @brief Function to create new typed array, that
+ * takes memory for itself and elements from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param elem_size Size of one element in bytes.
+ * @param capacity Starting capacity in elements.
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return typed_array* Pointer to new array.
+ */
+typed_array *typed_array_create_with_allocator (size_t elem_size,
+                                                size_t capacity,
+                                                const allocator *alloc);
+
+/**
+ * @brief Function to get element by position.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position of element.
+ * @return dptr Pointer to element inside array.
+ * NULL if <pos> is out of range.
+ */
+dptr typed_array_at (const typed_array *arr, size_t pos);
+
+/**
+ * @brief Function to get last element.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return dptr Pointer to element, NULL if empty.
+ */
+dptr typed_array_back (const typed_array *arr);
+
+/**
+ * @brief Function to get capacity.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return size_t Capacity in elements.
+ */
+size_t typed_array_capacity (const typed_array *arr);
+
+/**
+ * @brief Function to remove all elements.
+ * Capacity is kept.
+ *
+ * @param arr Pointer to typed array instance.
+ */
+void typed_array_clear (typed_array *arr);
+
+/**
+ * @brief Function to copy array. Elements are
+ * copied by memcpy, allocator is shared.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return typed_array* New array.
+ */
+typed_array *typed_array_copy (const typed_array *arr);
+
+/**
+ * @brief Function to get memory of elements.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return dptr Pointer to the first element.
+ */
+dptr typed_array_data (const typed_array *arr);
+
+/**
+ * @brief Destructor for typed array.
+ *
+ * @param arr Pointer to typed array instance.
+ */
+void typed_array_destroy (typed_array *arr);
+
+/**
+ * @brief Function to add new uninitialized
+ * element at the end, so it could be filled
+ * in place without copying.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return dptr Pointer to new element.
+ */
+dptr typed_array_emplace_back (typed_array *arr);
+
+/**
+ * @brief Function to check if array is empty.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return true If array is empty.
+ * @return false If array is not empty.
+ */
+bool typed_array_empty (const typed_array *arr);
+
+/**
+ * @brief Function to erase element by position.
+ * Elements after it are moved by memmove.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position of element.
+ */
+void typed_array_erase (typed_array *arr, size_t pos);
+
+/**
+ * @brief Function to erase <count> elements
+ * starting from <pos>.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position of the first element.
+ * @param count Number of elements. Cut to
+ * the end of the array.
+ */
+void typed_array_erase_many (typed_array *arr, size_t pos, size_t count);
+
+/**
+ * @brief Function to find first occurence of <data>.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param data Pointer to element to find.
+ * @param cmp Function to compare elements. NULL means
+ * bytewise comparison.
+ * @return size_t Position of element, size of
+ * array if there is no such element.
+ */
+size_t typed_array_find (const typed_array *arr, constdptr data,
+                         bool (*cmp) (constdptr first, constdptr second));
+
+/**
+ * @brief Function to get first element.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return dptr Pointer to element, NULL if empty.
+ */
+dptr typed_array_front (const typed_array *arr);
+
+/**
+ * @brief Function to insert copy of <data> to <pos>.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position, not greater than size.
+ * @param data Pointer to element.
+ * @return dptr Pointer to inserted element,
+ * NULL if <pos> is out of range.
+ */
+dptr typed_array_insert (typed_array *arr, size_t pos, constdptr data);
+
+/**
+ * @brief Function to insert <count> elements
+ * from <data> to <pos>.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param pos Position, not greater than size.
+ * @param data Pointer to contiguous elements.
+ * @param count Number of elements.
+ * @return dptr Pointer to the first inserted element,
+ * NULL if <pos> is out of range.
+ */
+dptr typed_array_insert_many (typed_array *arr, size_t pos, constdptr data,
+                              size_t count);
+
+/**
+ * @brief Function to remove last element.
+ *
+ * @param arr Pointer to typed array instance.
+ */
+void typed_array_pop_back (typed_array *arr);
+
+/**
+ * @brief Function to add copy of <data> at the end.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param data Pointer to element.
+ */
+void typed_array_push_back (typed_array *arr, constdptr data);
+
+/**
+ * @brief Function to reserve capacity.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param count New capacity in elements. Ignored,
+ * if it is less than size.
+ */
+void typed_array_reserve (typed_array *arr, size_t count);
+
+/**
+ * @brief Function to change size. New
+ * elements are filled by zeros.
+ *
+ * @param arr Pointer to typed array instance.
+ * @param size New size.
+ */
+void typed_array_resize (typed_array *arr, size_t size);
+
+/**
+ * @brief Function to set capacity equal to size.
+ *
+ * @param arr Pointer to typed array instance.
+ */
+void typed_array_shrink_to_fit (typed_array *arr);
+
+/**
+ * @brief Function to get size.
+ *
+ * @param arr Pointer to typed array instance.
+ * @return size_t Number of elements.
+ */
+size_t typed_array_size (const typed_array *arr);
+
+#endif
@@ -1,6 +1,10 @@
 #include "types.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "pool_allocator.h"
 
 /**
  * @brief Implementation of do_node functions.
@@ -26,6 +30,41 @@ __do_node_destroy (struct do_node *node, void (*destr) (dptr data))
   free (node);
 }
 
+struct do_node *
+__do_node_create_from (struct pool_allocator *pool,
+                       const struct allocator *alloc, constdptr data,
+                       struct do_node *next, struct do_node *prev)
+{
+  struct do_node *nd = NULL;
+
+  // Taking node from the pool, if there is free block.
+  if (pool)
+    nd = (struct do_node *)pool_allocator_allocate (pool);
+  if (!nd)
+    nd = (struct do_node *)allocator_allocate (alloc,
+                                               sizeof (struct do_node));
+
+  nd->next = next;
+  nd->data = (dptr)data;
+  nd->prev = prev;
+
+  return nd;
+}
+
+inline __attribute__ ((always_inline)) void
+__do_node_destroy_from (struct pool_allocator *pool,
+                        const struct allocator *alloc, struct do_node *node,
+                        void (*destr) (dptr data))
+{
+  if (destr)
+    destr (node->data);
+
+  if (pool && pool_allocator_owns (pool, node))
+    pool_allocator_deallocate (pool, node);
+  else
+    allocator_deallocate (alloc, node, sizeof (*node));
+}
+
 inline dptr
 do_node_get (const struct do_node *nd)
 {
@@ -57,6 +96,40 @@ __o_node_destroy (struct o_node *node, void (*destr) (dptr data))
   free (node);
 }
 
+struct o_node *
+__o_node_create_from (struct pool_allocator *pool,
+                      const struct allocator *alloc, constdptr data,
+                      struct o_node *next)
+{
+  struct o_node *nd = NULL;
+
+  // Taking node from the pool, if there is free block.
+  if (pool)
+    nd = (struct o_node *)pool_allocator_allocate (pool);
+  if (!nd)
+    nd = (struct o_node *)allocator_allocate (alloc,
+                                              sizeof (struct o_node));
+
+  nd->next = next;
+  nd->data = (dptr)data;
+
+  return nd;
+}
+
+inline __attribute__ ((always_inline)) void
+__o_node_destroy_from (struct pool_allocator *pool,
+                       const struct allocator *alloc, struct o_node *node,
+                       void (*destr) (dptr data))
+{
+  if (destr)
+    destr (node->data);
+
+  if (pool && pool_allocator_owns (pool, node))
+    pool_allocator_deallocate (pool, node);
+  else
+    allocator_deallocate (alloc, node, sizeof (*node));
+}
+
 inline dptr
 o_node_get (const struct o_node *nd)
 {
@@ -65,6 +138,199 @@ o_node_get (const struct o_node *nd)
   return NULL;
 }
 
+/**
+ * @brief Implementation of node sorting.
+ */
+
+/**
+ * @struct __node_sort_ctx
+ * @brief Layout of sorted nodes and function of comparing.
+ * Fields of nodes are accessed through memcpy by offsets,
+ * so any node type with <data> and <next> pointers could
+ * be sorted without type punning.
+ */
+struct __node_sort_ctx
+{
+  size_t data_offset;
+  size_t next_offset;
+  int (*cmp) (constdptr first, constdptr second);
+};
+
+/**
+ * @brief Function to read <next> link of the node.
+ *
+ * @param ctx Layout of nodes.
+ * @param node Node.
+ * @return dptr Next node.
+ */
+inline static dptr
+__node_next (const struct __node_sort_ctx *ctx, constdptr node)
+{
+  dptr next;
+  memcpy (&next, (const char *)node + ctx->next_offset, sizeof (dptr));
+  return next;
+}
+
+/**
+ * @brief Function to write <next> link of the node.
+ *
+ * @param ctx Layout of nodes.
+ * @param node Node.
+ * @param next Next node.
+ */
+inline static void
+__node_set_next (const struct __node_sort_ctx *ctx, dptr node, dptr next)
+{
+  memcpy ((char *)node + ctx->next_offset, &next, sizeof (dptr));
+}
+
+/**
+ * @brief Function to compare data of two nodes.
+ *
+ * @param ctx Layout of nodes and function of comparing.
+ * @param first First node.
+ * @param second Second node.
+ * @return int Result of comparing data of nodes.
+ */
+inline static int
+__node_cmp (const struct __node_sort_ctx *ctx, constdptr first,
+            constdptr second)
+{
+  dptr fdata, sdata;
+  memcpy (&fdata, (const char *)first + ctx->data_offset, sizeof (dptr));
+  memcpy (&sdata, (const char *)second + ctx->data_offset, sizeof (dptr));
+  return ctx->cmp (fdata, sdata);
+}
+
+/**
+ * @brief Function to merge two sorted chains of nodes
+ * by relinking <next> pointers. Nodes of <first> go
+ * first, if equal, so merging is stable.
+ *
+ * @param ctx Layout of nodes and function of comparing.
+ * @param first Chain of earlier nodes, NULL terminated.
+ * @param second Chain of later nodes, NULL terminated.
+ * @return dptr Head of merged chain.
+ */
+static dptr
+__node_merge (const struct __node_sort_ctx *ctx, dptr first, dptr second)
+{
+  dptr head, tail;
+
+  // Taking head first, so there is always a tail to link to.
+  if (__node_cmp (ctx, second, first) < 0)
+    {
+      head = second;
+      second = __node_next (ctx, second);
+    }
+  else
+    {
+      head = first;
+      first = __node_next (ctx, first);
+    }
+  tail = head;
+
+  while (first && second)
+    {
+      dptr next;
+      if (__node_cmp (ctx, second, first) < 0)
+        {
+          next = second;
+          second = __node_next (ctx, second);
+        }
+      else
+        {
+          next = first;
+          first = __node_next (ctx, first);
+        }
+      __node_set_next (ctx, tail, next);
+      tail = next;
+    }
+
+  __node_set_next (ctx, tail, first ? first : second);
+
+  return head;
+}
+
+/**
+ * @brief Function to cut natural run from the front
+ * of the chain. Strictly descending run is reversed,
+ * so it stays stable.
+ *
+ * @param ctx Layout of nodes and function of comparing.
+ * @param rest Pointer to the chain, is set to
+ * the node after the run.
+ * @return dptr Head of ascending run, NULL terminated.
+ */
+static dptr
+__node_take_run (const struct __node_sort_ctx *ctx, dptr *rest)
+{
+  dptr run = *rest;
+  dptr cur = __node_next (ctx, run);
+
+  if (cur && __node_cmp (ctx, cur, run) < 0)
+    {
+      // Reversing descending run while cutting it.
+      __node_set_next (ctx, run, NULL);
+      while (cur && __node_cmp (ctx, cur, run) < 0)
+        {
+          dptr next = __node_next (ctx, cur);
+          __node_set_next (ctx, cur, run);
+          run = cur;
+          cur = next;
+        }
+    }
+  else
+    {
+      dptr tail = run;
+      while (cur && __node_cmp (ctx, cur, tail) >= 0)
+        {
+          tail = cur;
+          cur = __node_next (ctx, cur);
+        }
+      __node_set_next (ctx, tail, NULL);
+    }
+
+  *rest = cur;
+
+  return run;
+}
+
+dptr
+__node_sort (dptr front, size_t data_offset, size_t next_offset,
+             int (*cmp) (constdptr first, constdptr second))
+{
+  struct __node_sort_ctx ctx = { data_offset, next_offset, cmp };
+
+  // Level i holds merge of 2^i runs, 64 levels are enough for any size.
+  dptr levels[64];
+  size_t used = 0;
+
+  while (front)
+    {
+      dptr run = __node_take_run (&ctx, &front);
+      size_t i = 0;
+
+      for (; i < used && levels[i]; i++)
+        {
+          run = __node_merge (&ctx, levels[i], run);
+          levels[i] = NULL;
+        }
+
+      if (i == used)
+        used++;
+      levels[i] = run;
+    }
+
+  // Merging what is left, lower levels hold later nodes.
+  dptr res = NULL;
+  for (size_t i = 0; i < used; i++)
+    if (levels[i])
+      res = res ? __node_merge (&ctx, levels[i], res) : levels[i];
+
+  return res;
+}
+
 /**
  * @brief Implementation of pair functions.
  */
@@ -6,6 +6,8 @@
 #ifndef _EXTENDED_C_LIB_LIB_TYPES_H
 #define _EXTENDED_C_LIB_LIB_TYPES_H
 
+#include <stddef.h> // size_t
+
 /**
  * @brief Alias for void *.
  */
@@ -16,6 +18,18 @@ typedef void *dptr;
  */
 typedef const void *constdptr;
 
+/**
+ * @brief Pool allocator, that node based containers
+ * can take their nodes from (see pool_allocator.h).
+ */
+struct pool_allocator;
+
+/**
+ * @brief Interface of allocator, that containers
+ * take their memory from (see allocator.h).
+ */
+struct allocator;
+
 /**
  * @struct do_node
  * @brief Implements node for double ordered data structs (like list, queue).
@@ -72,6 +86,37 @@ struct do_node *__do_node_create (constdptr data, struct do_node *next,
  */
 void __do_node_destroy (struct do_node *node, void (*destr) (dptr data));
 
+/**
+ * @brief Function to initialize do_node, taken from <pool>.
+ * Falls back to <alloc>, if pool is NULL or has no free blocks.
+ *
+ * @param pool Pool allocator of the container. Could be NULL.
+ * @param alloc Allocator of the container.
+ * @param data Pointer to data.
+ * @param next Pointer to the next do_node.
+ * @param prev Pointer to the previous do_node.
+ * @return struct do_node* New created do_node.
+ */
+struct do_node *__do_node_create_from (struct pool_allocator *pool,
+                                       const struct allocator *alloc,
+                                       constdptr data, struct do_node *next,
+                                       struct do_node *prev);
+
+/**
+ * @brief Function to destroy do_node, created by
+ * __do_node_create_from(). Returns node to the pool,
+ * if it was taken from there, otherwise to <alloc>.
+ *
+ * @param pool Pool allocator of the container. Could be NULL.
+ * @param alloc Allocator of the container.
+ * @param node Node to destroy
+ * @param destr Funciton to destroy data correctly,
+ * Should be NULL, if do not should be freed.
+ */
+void __do_node_destroy_from (struct pool_allocator *pool,
+                             const struct allocator *alloc,
+                             struct do_node *node, void (*destr) (dptr data));
+
 /**
  * @struct o_node
  * @brief Implements node for only ordered data structs (like stack,
@@ -122,6 +167,53 @@ struct o_node *__o_node_create (constdptr data, struct o_node *next);
  */
 void __o_node_destroy (struct o_node *node, void (*destr) (dptr data));
 
+/**
+ * @brief Function to initialize o_node, taken from <pool>.
+ * Falls back to <alloc>, if pool is NULL or has no free blocks.
+ *
+ * @param pool Pool allocator of the container. Could be NULL.
+ * @param alloc Allocator of the container.
+ * @param data Pointer to data.
+ * @param next Pointer to the next node.
+ * @return struct o_node* New created o_node.
+ */
+struct o_node *__o_node_create_from (struct pool_allocator *pool,
+                                     const struct allocator *alloc,
+                                     constdptr data, struct o_node *next);
+
+/**
+ * @brief Function to destroy o_node, created by
+ * __o_node_create_from(). Returns node to the pool,
+ * if it was taken from there, otherwise to <alloc>.
+ *
+ * @param pool Pool allocator of the container. Could be NULL.
+ * @param alloc Allocator of the container.
+ * @param node Node to destroy
+ * @param destr Funciton to destroy data correctly,
+ * Should be NULL, if do not should be freed.
+ */
+void __o_node_destroy_from (struct pool_allocator *pool,
+                            const struct allocator *alloc, struct o_node *node,
+                            void (*destr) (dptr data));
+
+/**
+ * @brief Function to sort chain of nodes by natural
+ * bottom-up merge sort, relinking only <next>. Runs are
+ * merged like carries in binary counter, so every node
+ * takes part in O(log n) merges and sorted input takes
+ * one pass. Sorting is stable. Node fields are accessed
+ * by offsets, so it works for o_node and do_node alike.
+ * <prev> links of do_node are left stale.
+ *
+ * @param front Head of the chain, NULL terminated.
+ * @param data_offset Offset of <data> pointer in the node.
+ * @param next_offset Offset of <next> pointer in the node.
+ * @param cmp Function of comparing.
+ * @return dptr Head of sorted chain.
+ */
+dptr __node_sort (dptr front, size_t data_offset, size_t next_offset,
+                  int (*cmp) (constdptr first, constdptr second));
+
 /**
  * @struct pair
  * @brief Implements pair-node that contains to values.
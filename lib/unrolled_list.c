@@ -0,0 +1,462 @@
+#include "unrolled_list.h"
+
+////////////////////////////////////////////////////
+/*     Private functions of the unrolled_list     */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create empty node and link it
+ * between <prev> and <next>.
+ *
+ * @param l Pointer to the list.
+ * @param prev Node before new one, NULL if it is front.
+ * @param next Node after new one, NULL if it is back.
+ * @param begin Index, where elements will start.
+ * @return struct unrolled_list_node* New node.
+ */
+static struct unrolled_list_node *
+__unrolled_list_node_create (unrolled_list *l,
+                             struct unrolled_list_node *prev,
+                             struct unrolled_list_node *next, size_t begin)
+{
+  struct unrolled_list_node *node = (struct unrolled_list_node *)
+      allocator_allocate (&l->alloc, sizeof (struct unrolled_list_node));
+
+  node->begin = begin;
+  node->count = 0;
+  node->prev = prev;
+  node->next = next;
+
+  if (prev)
+    prev->next = node;
+  else
+    l->front = node;
+
+  if (next)
+    next->prev = node;
+  else
+    l->back = node;
+
+  return node;
+}
+
+/**
+ * @brief Function to unlink and free node.
+ *
+ * @param l Pointer to the list.
+ * @param node Node to destroy.
+ */
+static void
+__unrolled_list_node_destroy (unrolled_list *l,
+                              struct unrolled_list_node *node)
+{
+  if (node->prev)
+    node->prev->next = node->next;
+  else
+    l->front = node->next;
+
+  if (node->next)
+    node->next->prev = node->prev;
+  else
+    l->back = node->prev;
+
+  allocator_deallocate (&l->alloc, node, sizeof (struct unrolled_list_node));
+}
+
+/**
+ * @brief Function to move elements of the next node
+ * to the end of <node> and destroy the next node.
+ * Elements of <node> are moved to the start of <items>.
+ *
+ * @param l Pointer to the list.
+ * @param node Node, that has room for elements of the next.
+ */
+static void
+__unrolled_list_merge_next (unrolled_list *l, struct unrolled_list_node *node)
+{
+  struct unrolled_list_node *next = node->next;
+
+  memmove (node->items, node->items + node->begin,
+           sizeof (dptr) * node->count);
+  memcpy (node->items + node->count, next->items + next->begin,
+          sizeof (dptr) * next->count);
+
+  node->begin = 0;
+  node->count += next->count;
+
+  __unrolled_list_node_destroy (l, next);
+}
+
+/**
+ * @brief Function to make iterator to the first
+ * element of <node>.
+ *
+ * @param node Node, could be NULL.
+ * @return unrolled_list_iterator Iterator, end if
+ * <node> is NULL.
+ */
+inline static unrolled_list_iterator
+__unrolled_list_node_first (struct unrolled_list_node *node)
+{
+  unrolled_list_iterator it = { node, node ? node->begin : 0 };
+  return it;
+}
+
+/**
+ * @brief Function to make iterator to the last
+ * element of <node>.
+ *
+ * @param node Node, could be NULL.
+ * @return unrolled_list_iterator Iterator, end if
+ * <node> is NULL.
+ */
+inline static unrolled_list_iterator
+__unrolled_list_node_last (struct unrolled_list_node *node)
+{
+  unrolled_list_iterator it
+      = { node, node ? node->begin + node->count - 1 : 0 };
+  return it;
+}
+
+////////////////////////////////////////////////////
+/*    Public API functions of the unrolled_list   */
+////////////////////////////////////////////////////
+
+unrolled_list *
+unrolled_list_create ()
+{
+  return unrolled_list_create_with_allocator (NULL);
+}
+
+unrolled_list *
+unrolled_list_create_with_allocator (const allocator *alloc)
+{
+  allocator al = allocator_or_default (alloc);
+  unrolled_list *l
+      = (unrolled_list *)allocator_allocate (&al, sizeof (unrolled_list));
+
+  l->size = 0;
+  l->front = NULL;
+  l->back = NULL;
+  l->alloc = al;
+
+  return l;
+}
+
+dptr
+unrolled_list_at (const unrolled_list *l, size_t pos)
+{
+  if (!l || pos >= l->size)
+    return NULL;
+
+  // Skipping whole nodes.
+  struct unrolled_list_node *node = l->front;
+  while (pos >= node->count)
+    {
+      pos -= node->count;
+      node = node->next;
+    }
+
+  return node->items[node->begin + pos];
+}
+
+inline dptr
+unrolled_list_back (const unrolled_list *l)
+{
+  if (!l || !l->back)
+    return NULL;
+  return l->back->items[l->back->begin + l->back->count - 1];
+}
+
+inline unrolled_list_iterator
+unrolled_list_begin (const unrolled_list *l)
+{
+  return __unrolled_list_node_first (l ? l->front : NULL);
+}
+
+inline unrolled_list_iterator
+unrolled_list_rbegin (const unrolled_list *l)
+{
+  return __unrolled_list_node_last (l ? l->back : NULL);
+}
+
+void
+unrolled_list_clear (unrolled_list *l, void (*destr) (dptr data))
+{
+  if (!l)
+    return;
+
+  struct unrolled_list_node *node = l->front;
+
+  while (node)
+    {
+      struct unrolled_list_node *next = node->next;
+
+      if (destr)
+        for (size_t i = node->begin; i < node->begin + node->count; i++)
+          destr (node->items[i]);
+
+      allocator_deallocate (&l->alloc, node,
+                            sizeof (struct unrolled_list_node));
+      node = next;
+    }
+
+  l->front = NULL;
+  l->back = NULL;
+  l->size = 0;
+}
+
+void
+unrolled_list_destroy (unrolled_list *l, void (*destr) (dptr data))
+{
+  if (!l)
+    return;
+
+  unrolled_list_clear (l, destr);
+  allocator_deallocate (&l->alloc, l, sizeof (unrolled_list));
+}
+
+inline bool
+unrolled_list_empty (const unrolled_list *l)
+{
+  if (!l)
+    return true;
+  return l->size == 0;
+}
+
+inline unrolled_list_iterator
+unrolled_list_end ()
+{
+  return __unrolled_list_node_first (NULL);
+}
+
+unrolled_list_iterator
+unrolled_list_erase (unrolled_list *l, unrolled_list_iterator where,
+                     void (*destr) (dptr data))
+{
+  if (!l || !where.node)
+    return unrolled_list_end ();
+
+  struct unrolled_list_node *node = where.node;
+  size_t idx = where.pos - node->begin;
+
+  if (destr)
+    destr (node->items[where.pos]);
+
+  // Closing the gap inside the node.
+  memmove (node->items + where.pos, node->items + where.pos + 1,
+           sizeof (dptr) * (node->count - idx - 1));
+  node->count--;
+  l->size--;
+
+  if (node->count == 0)
+    {
+      struct unrolled_list_node *next = node->next;
+      __unrolled_list_node_destroy (l, node);
+      return __unrolled_list_node_first (next);
+    }
+
+  // Merging sparse neighbours, so nodes don't become almost empty.
+  if (node->next
+      && node->count + node->next->count <= UNROLLED_LIST_NODE_CAPACITY / 2)
+    __unrolled_list_merge_next (l, node);
+
+  if (idx < node->count)
+    {
+      unrolled_list_iterator it = { node, node->begin + idx };
+      return it;
+    }
+
+  return __unrolled_list_node_first (node->next);
+}
+
+unrolled_list_iterator
+unrolled_list_find (const unrolled_list *l, constdptr data,
+                    bool (*cmp) (constdptr first, constdptr second))
+{
+  if (!l)
+    return unrolled_list_end ();
+
+  for (struct unrolled_list_node *node = l->front; node; node = node->next)
+    for (size_t i = node->begin; i < node->begin + node->count; i++)
+      if (cmp (node->items[i], data))
+        {
+          unrolled_list_iterator it = { node, i };
+          return it;
+        }
+
+  return unrolled_list_end ();
+}
+
+inline dptr
+unrolled_list_front (const unrolled_list *l)
+{
+  if (!l || !l->front)
+    return NULL;
+  return l->front->items[l->front->begin];
+}
+
+inline dptr
+unrolled_list_get (unrolled_list_iterator it)
+{
+  return it.node->items[it.pos];
+}
+
+unrolled_list_iterator
+unrolled_list_insert (unrolled_list *l, unrolled_list_iterator where,
+                      constdptr data)
+{
+  if (!l)
+    return unrolled_list_end ();
+
+  if (!where.node)
+    {
+      unrolled_list_push_back (l, data);
+      return unrolled_list_rbegin (l);
+    }
+
+  struct unrolled_list_node *node = where.node;
+  size_t idx = where.pos - node->begin;
+
+  // Splitting full node, upper half goes to the new one.
+  if (node->count == UNROLLED_LIST_NODE_CAPACITY)
+    {
+      size_t half = UNROLLED_LIST_NODE_CAPACITY / 2;
+      struct unrolled_list_node *other
+          = __unrolled_list_node_create (l, node, node->next, 0);
+
+      memcpy (other->items, node->items + node->begin + half,
+              sizeof (dptr) * (node->count - half));
+      other->count = node->count - half;
+      node->count = half;
+
+      if (idx > half)
+        {
+          node = other;
+          idx -= half;
+        }
+    }
+
+  // Making room by moving tail right or, if there
+  // is no room at the right, head left.
+  if (node->begin + node->count < UNROLLED_LIST_NODE_CAPACITY)
+    memmove (node->items + node->begin + idx + 1,
+             node->items + node->begin + idx,
+             sizeof (dptr) * (node->count - idx));
+  else
+    {
+      memmove (node->items + node->begin - 1, node->items + node->begin,
+               sizeof (dptr) * idx);
+      node->begin--;
+    }
+
+  node->items[node->begin + idx] = (dptr)data;
+  node->count++;
+  l->size++;
+
+  unrolled_list_iterator it = { node, node->begin + idx };
+  return it;
+}
+
+inline unrolled_list_iterator
+unrolled_list_next (unrolled_list_iterator it)
+{
+  if (it.pos + 1 < it.node->begin + it.node->count)
+    {
+      it.pos++;
+      return it;
+    }
+  return __unrolled_list_node_first (it.node->next);
+}
+
+void
+unrolled_list_pop_back (unrolled_list *l, void (*destr) (dptr data))
+{
+  if (!l || !l->back)
+    return;
+
+  struct unrolled_list_node *node = l->back;
+
+  if (destr)
+    destr (node->items[node->begin + node->count - 1]);
+
+  node->count--;
+  l->size--;
+
+  if (node->count == 0)
+    __unrolled_list_node_destroy (l, node);
+}
+
+void
+unrolled_list_pop_front (unrolled_list *l, void (*destr) (dptr data))
+{
+  if (!l || !l->front)
+    return;
+
+  struct unrolled_list_node *node = l->front;
+
+  if (destr)
+    destr (node->items[node->begin]);
+
+  node->begin++;
+  node->count--;
+  l->size--;
+
+  if (node->count == 0)
+    __unrolled_list_node_destroy (l, node);
+}
+
+inline unrolled_list_iterator
+unrolled_list_prev (unrolled_list_iterator it)
+{
+  if (it.pos > it.node->begin)
+    {
+      it.pos--;
+      return it;
+    }
+  return __unrolled_list_node_last (it.node->prev);
+}
+
+void
+unrolled_list_push_back (unrolled_list *l, constdptr data)
+{
+  if (!l)
+    return;
+
+  struct unrolled_list_node *node = l->back;
+
+  // New node is filled from the start of <items>.
+  if (!node || node->begin + node->count == UNROLLED_LIST_NODE_CAPACITY)
+    node = __unrolled_list_node_create (l, l->back, NULL, 0);
+
+  node->items[node->begin + node->count] = (dptr)data;
+  node->count++;
+  l->size++;
+}
+
+void
+unrolled_list_push_front (unrolled_list *l, constdptr data)
+{
+  if (!l)
+    return;
+
+  struct unrolled_list_node *node = l->front;
+
+  // New node is filled from the end of <items>.
+  if (!node || node->begin == 0)
+    node = __unrolled_list_node_create (l, NULL, l->front,
+                                        UNROLLED_LIST_NODE_CAPACITY);
+
+  node->begin--;
+  node->items[node->begin] = (dptr)data;
+  node->count++;
+  l->size++;
+}
+
+inline size_t
+unrolled_list_size (const unrolled_list *l)
+{
+  if (!l)
+    return 0;
+  return l->size;
+}
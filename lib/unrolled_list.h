@@ -0,0 +1,307 @@
+/**
+ * @file unrolled_list.h Implementation of Unrolled
+ * linked list, that stores many elements in one node.
+ */
+
+#ifndef _EXTENDED_C_LIB_LIB_UNROLLED_LIST_H
+#define _EXTENDED_C_LIB_LIB_UNROLLED_LIST_H
+
+#include <stdbool.h> // bool
+#include <stddef.h>  // size_t
+#include <string.h>  // memmove, memcpy
+
+#include "allocator.h"
+#include "types.h"
+
+#define UNROLLED_LIST_NODE_CAPACITY 64
+
+/**
+ * @struct unrolled_list_node
+ * @brief Node of the unrolled list. Elements are
+ * stored contiguously in <items> from <begin>.
+ */
+struct unrolled_list_node
+{
+  /**
+   * @brief Pointer to the next node.
+   */
+  struct unrolled_list_node *next;
+
+  /**
+   * @brief Pointer to the previous node.
+   */
+  struct unrolled_list_node *prev;
+
+  /**
+   * @brief Index of the first element in <items>.
+   */
+  size_t begin;
+
+  /**
+   * @brief Number of elements in the node.
+   */
+  size_t count;
+
+  /**
+   * @brief Elements of the node.
+   */
+  dptr items[UNROLLED_LIST_NODE_CAPACITY];
+};
+
+/**
+ * @struct unrolled_list_iterator
+ * @brief Iterator of the unrolled list. End
+ * iterator has NULL <node>. Inserting and erasing
+ * invalidates iterators to the changed node.
+ */
+typedef struct unrolled_list_iterator
+{
+  /**
+   * @brief Node of the element.
+   */
+  struct unrolled_list_node *node;
+
+  /**
+   * @brief Index of the element in <items> of <node>.
+   */
+  size_t pos;
+} unrolled_list_iterator;
+
+/**
+ * @struct unrolled_list
+ * @brief Implementation of unrolled list. Every node
+ * keeps up to UNROLLED_LIST_NODE_CAPACITY elements,
+ * so there is one allocation and about one cache miss
+ * per node, instead of per element.
+ */
+typedef struct unrolled_list
+{
+  /**
+   * @brief Number of elements in the list.
+   */
+  size_t size;
+
+  /**
+   * @brief Pointer to the front node.
+   */
+  struct unrolled_list_node *front;
+
+  /**
+   * @brief Pointer to the back node.
+   */
+  struct unrolled_list_node *back;
+
+  /**
+   * @brief Allocator of the list instance and nodes.
+   */
+  allocator alloc;
+} unrolled_list;
+
+////////////////////////////////////////////////////
+/*    Public API functions of the unrolled_list   */
+////////////////////////////////////////////////////
+
+/**
+ * @brief Function to create new unrolled list.
+ * Allocates the memory. Should be destroyed at the end.
+ *
+ * @return unrolled_list* Pointer to new list.
+ */
+unrolled_list *unrolled_list_create ();
+
+/**
+ * @brief Function to create new unrolled list, that
+ * takes memory for itself and nodes from <alloc>.
+ * Should be destroyed at the end.
+ *
+ * @param alloc Allocator, NULL means allocator_default.
+ * @return unrolled_list* Pointer to new list.
+ */
+unrolled_list *unrolled_list_create_with_allocator (const allocator *alloc);
+
+/**
+ * @brief Function to get element by position.
+ * Skips whole nodes, so takes O(n / node capacity).
+ *
+ * @param l Pointer to the list.
+ * @param pos Position of element.
+ * @return dptr Element, NULL if <pos> is out of range.
+ */
+dptr unrolled_list_at (const unrolled_list *l, size_t pos);
+
+/**
+ * @brief Function to get last element.
+ *
+ * @param l Pointer to the list.
+ * @return dptr Element, NULL if list is empty.
+ */
+dptr unrolled_list_back (const unrolled_list *l);
+
+/**
+ * @brief Function to get iterator to the first element.
+ *
+ * @param l Pointer to the list.
+ * @return unrolled_list_iterator Iterator,
+ * end iterator if list is empty.
+ */
+unrolled_list_iterator unrolled_list_begin (const unrolled_list *l);
+
+/**
+ * @brief Function to get iterator to the last element.
+ *
+ * @param l Pointer to the list.
+ * @return unrolled_list_iterator Iterator,
+ * end iterator if list is empty.
+ */
+unrolled_list_iterator unrolled_list_rbegin (const unrolled_list *l);
+
+/**
+ * @brief Function to remove all elements.
+ *
+ * @param l Pointer to the list.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void unrolled_list_clear (unrolled_list *l, void (*destr) (dptr data));
+
+/**
+ * @brief Destructor of the unrolled list.
+ *
+ * @param l Pointer to the list.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void unrolled_list_destroy (unrolled_list *l, void (*destr) (dptr data));
+
+/**
+ * @brief Function to check if list is empty.
+ *
+ * @param l Pointer to the list.
+ * @return true If list is empty.
+ * @return false If list isn't empty.
+ */
+bool unrolled_list_empty (const unrolled_list *l);
+
+/**
+ * @brief Function to get end iterator, that is
+ * returned after the last and before the first element.
+ *
+ * @return unrolled_list_iterator Iterator with NULL node.
+ */
+unrolled_list_iterator unrolled_list_end ();
+
+/**
+ * @brief Function to erase element.
+ *
+ * @param l Pointer to the list.
+ * @param where Iterator to the element.
+ * @param destr Function to destroy data, could be NULL.
+ * @return unrolled_list_iterator Iterator to the
+ * element after erased one.
+ */
+unrolled_list_iterator unrolled_list_erase (unrolled_list *l,
+                                            unrolled_list_iterator where,
+                                            void (*destr) (dptr data));
+
+/**
+ * @brief Function to find first element, for which
+ * cmp (element, data) returns true.
+ *
+ * @param l Pointer to the list.
+ * @param data Data to find.
+ * @param cmp Function of comparing.
+ * @return unrolled_list_iterator Iterator to the
+ * element, end iterator if there is no such element.
+ */
+unrolled_list_iterator unrolled_list_find (const unrolled_list *l,
+                                           constdptr data,
+                                           bool (*cmp) (constdptr first,
+                                                        constdptr second));
+
+/**
+ * @brief Function to get first element.
+ *
+ * @param l Pointer to the list.
+ * @return dptr Element, NULL if list is empty.
+ */
+dptr unrolled_list_front (const unrolled_list *l);
+
+/**
+ * @brief Function to get element by iterator.
+ *
+ * @param it Iterator, not end.
+ * @return dptr Element.
+ */
+dptr unrolled_list_get (unrolled_list_iterator it);
+
+/**
+ * @brief Function to insert new element before <where>.
+ * Full node is split in two halves.
+ *
+ * @param l Pointer to the list.
+ * @param where Position of new element,
+ * end iterator means the end of the list.
+ * @param data New element.
+ * @return unrolled_list_iterator Iterator to the new element.
+ */
+unrolled_list_iterator unrolled_list_insert (unrolled_list *l,
+                                             unrolled_list_iterator where,
+                                             constdptr data);
+
+/**
+ * @brief Function to get iterator to the next element.
+ *
+ * @param it Iterator, not end.
+ * @return unrolled_list_iterator Next iterator,
+ * end iterator after the last element.
+ */
+unrolled_list_iterator unrolled_list_next (unrolled_list_iterator it);
+
+/**
+ * @brief Function to remove last element.
+ *
+ * @param l Pointer to the list.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void unrolled_list_pop_back (unrolled_list *l, void (*destr) (dptr data));
+
+/**
+ * @brief Function to remove first element.
+ *
+ * @param l Pointer to the list.
+ * @param destr Function to destroy data, could be NULL.
+ */
+void unrolled_list_pop_front (unrolled_list *l, void (*destr) (dptr data));
+
+/**
+ * @brief Function to get iterator to the previous element.
+ *
+ * @param it Iterator, not end.
+ * @return unrolled_list_iterator Previous iterator,
+ * end iterator before the first element.
+ */
+unrolled_list_iterator unrolled_list_prev (unrolled_list_iterator it);
+
+/**
+ * @brief Function to add element to the end. O(1).
+ *
+ * @param l Pointer to the list.
+ * @param data New element.
+ */
+void unrolled_list_push_back (unrolled_list *l, constdptr data);
+
+/**
+ * @brief Function to add element to the front. O(1).
+ *
+ * @param l Pointer to the list.
+ * @param data New element.
+ */
+void unrolled_list_push_front (unrolled_list *l, constdptr data);
+
+/**
+ * @brief Function to get size of the list.
+ *
+ * @param l Pointer to the list.
+ * @return size_t Number of elements.
+ */
+size_t unrolled_list_size (const unrolled_list *l);
+
+#endif
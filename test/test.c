@@ -26,6 +26,22 @@ run_tests ()
                     suite_linear_allocator (),
                     suite_pool_allocator (),
                     suite_std_allocator (),
+                    suite_flat_hashmap (),
+                    suite_flat_hashset (),
+                    suite_hash (),
+                    suite_concurrent_hashmap (),
+                    suite_chunked_pool_allocator (),
+                    suite_concurrent_pool_allocator (),
+                    suite_slab_allocator (),
+                    suite_stack_allocator (),
+                    suite_allocator (),
+                    suite_typed_array (),
+                    suite_template (),
+                    suite_unrolled_list (),
+                    suite_deque (),
+                    suite_spsc_queue (),
+                    suite_mpmc_queue (),
+                    suite_map (),
                     NULL };
 
   for (Suite **cur = list; *cur; cur++)
@@ -7,20 +7,39 @@
 
 #include "../lib/array.h"
 #include "../lib/bitset.h"
+#include "../lib/concurrent_hashmap.h"
+#include "../lib/deque.h"
+#include "../lib/flat_hashmap.h"
+#include "../lib/flat_hashset.h"
 #include "../lib/forward_list.h"
+#include "../lib/hash.h"
 #include "../lib/hashmap.h"
 #include "../lib/hashset.h"
 #include "../lib/list.h"
+#include "../lib/map.h"
+#include "../lib/mpmc_queue.h"
 #include "../lib/queue.h"
 #include "../lib/rbtree.h"
 #include "../lib/set.h"
+#include "../lib/spsc_queue.h"
 #include "../lib/stack.h"
+#include "../lib/template_array.h"
+#include "../lib/template_hashmap.h"
+#include "../lib/template_list.h"
+#include "../lib/template_rbtree.h"
+#include "../lib/unrolled_list.h"
 
 #include "../lib/string_array.h"
 
+#include "../lib/allocator.h"
+#include "../lib/chunked_pool_allocator.h"
+#include "../lib/concurrent_pool_allocator.h"
 #include "../lib/linear_allocator.h"
 #include "../lib/pool_allocator.h"
+#include "../lib/slab_allocator.h"
+#include "../lib/stack_allocator.h"
 #include "../lib/std_allocator.h"
+#include "../lib/typed_array.h"
 
 Suite *suite_queue ();
 Suite *suite_stack ();
@@ -39,4 +58,21 @@ Suite *suite_linear_allocator ();
 Suite *suite_pool_allocator ();
 Suite *suite_std_allocator ();
 
+Suite *suite_flat_hashmap ();
+Suite *suite_flat_hashset ();
+Suite *suite_hash ();
+Suite *suite_concurrent_hashmap ();
+Suite *suite_chunked_pool_allocator ();
+Suite *suite_concurrent_pool_allocator ();
+Suite *suite_slab_allocator ();
+Suite *suite_stack_allocator ();
+Suite *suite_allocator ();
+Suite *suite_typed_array ();
+Suite *suite_template ();
+Suite *suite_unrolled_list ();
+Suite *suite_deque ();
+Suite *suite_spsc_queue ();
+Suite *suite_mpmc_queue ();
+Suite *suite_map ();
+
 #endif
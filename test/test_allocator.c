@@ -0,0 +1,280 @@
+#include "test.h"
+
+/**
+ * @brief Context of the allocator, that counts
+ * bytes, which are not freed yet.
+ */
+struct counter
+{
+  size_t live;
+  size_t calls;
+};
+
+static dptr
+counter_allocate (dptr ctx, size_t size)
+{
+  ((struct counter *)ctx)->live += size;
+  ((struct counter *)ctx)->calls++;
+  return malloc (size);
+}
+
+static dptr
+counter_reallocate (dptr ctx, dptr ptr, size_t old_size, size_t new_size)
+{
+  ((struct counter *)ctx)->live += new_size - old_size;
+  ((struct counter *)ctx)->calls++;
+  return realloc (ptr, new_size);
+}
+
+static void
+counter_deallocate (dptr ctx, dptr ptr, size_t size)
+{
+  ((struct counter *)ctx)->live -= size;
+  free (ptr);
+}
+
+static size_t
+size_func (constdptr key)
+{
+  return sizeof (*(int *)key);
+}
+
+static bool
+cmp_pair (constdptr f, constdptr s)
+{
+  return (*(int *)((struct pair *)f)->key == *(int *)((struct pair *)s)->key);
+}
+
+static bool
+cmp_int (constdptr f, constdptr s)
+{
+  return *(int *)f == *(int *)s;
+}
+
+static dptr
+cpy (constdptr data)
+{
+  return (dptr)data;
+}
+
+static dptr
+copy_func (dptr data)
+{
+  return data;
+}
+
+static int
+cmp_tree (constdptr f, constdptr s)
+{
+  return *(int *)f - *(int *)s;
+}
+
+START_TEST (allocator_test_1)
+{
+  linear_allocator *arena = linear_allocator_create_with_flags (
+      4096, 0, LINEAR_ALLOCATOR_GROWABLE);
+  allocator alloc = linear_allocator_as_allocator (arena);
+  int keys[1000];
+
+  for (int k = 0; k < 2; k++)
+    {
+      hashmap *hm = hashmap_create_with_allocator (
+          cmp_pair, size_func, NULL, NULL, hash_jenkins, 0, &alloc);
+
+      for (int i = 0; i < 1000; i++)
+        {
+          keys[i] = i;
+          hashmap_insert (hm, keys + i, keys + 999 - i);
+        }
+
+      hashmap_erase (hm, keys + 10);
+      ck_assert_uint_eq (hashmap_size (hm), 999);
+      ck_assert (!hashmap_contains (hm, keys + 10));
+      for (int i = 11; i < 1000; i++)
+        ck_assert_ptr_eq (hashmap_at (hm, keys + i), keys + 999 - i);
+
+      // Arena has grown for buckets, nodes and entries.
+      ck_assert_ptr_nonnull (arena->prev);
+
+      // Whole hashmap is dropped at once, without destroy.
+      linear_allocator_free (arena);
+      ck_assert_uint_eq (arena->offset, 0);
+    }
+
+  // Last chunk is resized in place.
+  dptr ptr = allocator_allocate (&alloc, 100);
+  ck_assert_uint_eq ((uintptr_t)ptr % LINEAR_ALLOCATOR_INTERFACE_ALIGNMENT, 0);
+  ck_assert_ptr_eq (allocator_reallocate (&alloc, ptr, 100, 1000), ptr);
+  ck_assert_uint_eq (arena->offset, 1000);
+
+  linear_allocator_destroy (arena);
+}
+
+START_TEST (allocator_test_2)
+{
+  struct counter cnt = { 0, 0 };
+  allocator alloc = { counter_allocate, counter_reallocate,
+                      counter_deallocate, &cnt };
+  int data[100];
+
+  for (int i = 0; i < 100; i++)
+    data[i] = i;
+
+  array *arr = array_create_with_allocator (0, &alloc);
+  list *l = list_create_with_allocator (&alloc);
+  forward_list *fl = forward_list_create_with_allocator (&alloc);
+  queue *q = queue_create_with_allocator (NULL, &alloc);
+  stack *st = stack_create_with_allocator (NULL, &alloc);
+  string *str = string_create_with_allocator (1, &alloc);
+  bitset *b = bitset_create_with_allocator (128, &alloc);
+  hashmap *hm = hashmap_create_with_allocator (
+      cmp_pair, size_func, NULL, NULL, hash_jenkins, 0, &alloc);
+  hashset *hs = hashset_create_with_allocator (cmp_int, size_func, NULL,
+                                               hash_jenkins, 0, &alloc);
+  flat_hashmap *fhm = flat_hashmap_create_with_allocator (
+      cmp_int, size_func, NULL, NULL, hash_wy, 0, &alloc);
+  flat_hashset *fhs = flat_hashset_create_with_allocator (
+      cmp_int, size_func, NULL, hash_wy, 0, &alloc);
+  set *s = set_create_with_allocator (cmp_tree, NULL, &alloc);
+
+  for (int i = 0; i < 100; i++)
+    {
+      array_push_back (arr, data + i);
+      list_push_back (l, data + i);
+      forward_list_push_front (fl, data + i);
+      queue_push (q, data + i);
+      stack_push (st, data + i);
+      string_push_back (str, 'a');
+      bitset_set (b, i);
+      hashmap_insert (hm, data + i, data + i);
+      hashset_insert (hs, data + i);
+      flat_hashmap_insert (fhm, data + i, data + i);
+      flat_hashset_insert (fhs, data + i);
+      set_insert (s, data + i);
+    }
+
+  ck_assert_ptr_eq (array_at (arr, 50), data + 50);
+  ck_assert_uint_eq (string_size (str), 100);
+  ck_assert_uint_eq (bitset_count (b), 100);
+  ck_assert_ptr_eq (hashmap_at (hm, data + 7), data + 7);
+  ck_assert (hashset_contains (hs, data + 7));
+  ck_assert_ptr_eq (flat_hashmap_at (fhm, data + 7), data + 7);
+  ck_assert (set_contains (s, data + 7));
+  ck_assert (cnt.calls > 12);
+
+  // Copies take memory from the same allocator.
+  array *arr_copy = array_copy (arr, cpy);
+  list *l_copy = list_copy (l, copy_func);
+
+  for (int i = 0; i < 50; i++)
+    {
+      list_pop_front (l, NULL);
+      queue_pop (q);
+      stack_pop (st);
+      hashmap_erase (hm, data + i);
+      hashset_erase (hs, data + i);
+      set_erase (s, set_find (s, data + i));
+    }
+
+  array_destroy (arr, NULL);
+  array_destroy (arr_copy, NULL);
+  list_destroy (l, NULL);
+  list_destroy (l_copy, NULL);
+  forward_list_destroy (fl, NULL);
+  queue_destroy (q);
+  stack_destroy (st);
+  string_destroy (str);
+  bitset_destroy (b);
+  hashmap_destroy (hm);
+  hashset_destroy (hs);
+  flat_hashmap_destroy (fhm);
+  flat_hashset_destroy (fhs);
+  set_destroy (s);
+
+  // Every byte is returned with the same size.
+  ck_assert_uint_eq (cnt.live, 0);
+}
+
+START_TEST (allocator_test_3)
+{
+  slab_allocator *slab = slab_allocator_create ();
+  stack_allocator *sa = stack_allocator_create (1 << 16);
+  allocator slab_alloc = slab_allocator_as_allocator (slab);
+  allocator stack_alloc = stack_allocator_as_allocator (sa);
+  int data[1000];
+
+  rbtree *tree = rbtree_create_with_allocator (cmp_tree, NULL, true,
+                                               &slab_alloc);
+  for (int i = 0; i < 1000; i++)
+    {
+      data[i] = i % 100;
+      rbtree_insert (tree, data + i);
+    }
+  ck_assert_uint_eq (rbtree_count (tree, data + 5), 10);
+  rbtree_destroy (tree);
+
+  // Array, that is the last allocation, grows in place.
+  stack_allocator_marker marker = stack_allocator_mark (sa);
+  array *arr = array_create_with_allocator (1, &stack_alloc);
+  dptr *vec = arr->vec;
+
+  for (int i = 0; i < 1000; i++)
+    array_push_back (arr, data + i);
+  ck_assert_ptr_eq (arr->vec, vec);
+  ck_assert_ptr_eq (array_at (arr, 999), data + 999);
+
+  stack_allocator_rewind (sa, marker);
+  ck_assert_uint_eq (sa->offset, 0);
+
+  // NULL means default allocator.
+  string *str = string_create_with_allocator (4, NULL);
+  ck_assert_ptr_eq (str->alloc.allocate, allocator_default.allocate);
+  string_destroy (str);
+
+  stack_allocator_destroy (sa);
+  slab_allocator_destroy (slab);
+}
+
+START_TEST (allocator_test_4)
+{
+  struct counter cnt = { 0, 0 };
+  allocator alloc = { counter_allocate, counter_reallocate,
+                      counter_deallocate, &cnt };
+  int keys[100];
+
+  // Hashmap frees entries, destructor frees values only.
+  hashmap *hm = hashmap_create_with_allocator (
+      cmp_pair, size_func, NULL, free, hash_jenkins, 0, &alloc);
+
+  for (int i = 0; i < 100; i++)
+    {
+      keys[i] = i;
+      hashmap_insert (hm, keys + i, malloc (sizeof (int)));
+    }
+
+  hashmap_erase (hm, keys + 5);
+  hashmap_clear (hm);
+  hashmap_insert (hm, keys, malloc (sizeof (int)));
+  hashmap_destroy (hm);
+
+  ck_assert_uint_eq (cnt.live, 0);
+}
+
+Suite *
+suite_allocator ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Allocator test");
+  tc = tcase_create ("Allocator test");
+
+  tcase_add_test (tc, allocator_test_1);
+  tcase_add_test (tc, allocator_test_2);
+  tcase_add_test (tc, allocator_test_3);
+  tcase_add_test (tc, allocator_test_4);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -31,6 +31,70 @@ cpy (constdptr data)
   return (dptr)data;
 }
 
+int
+cmp_sort (constdptr f, constdptr s)
+{
+  return (*(int *)f > *(int *)s) - (*(int *)f < *(int *)s);
+}
+
+int
+cmp_sort_div (constdptr f, constdptr s)
+{
+  return (*(int *)f / 16 > *(int *)s / 16) - (*(int *)f / 16 < *(int *)s / 16);
+}
+
+/**
+ * @brief Function to fill <data> by pattern.
+ */
+void
+fill_pattern (int *data, int n, int pattern)
+{
+  for (int i = 0; i < n; i++)
+    {
+      switch (pattern)
+        {
+        case 0:
+          data[i] = rand ();
+          break;
+        case 1:
+          data[i] = i;
+          break;
+        case 2:
+          data[i] = n - i;
+          break;
+        case 3:
+          data[i] = 7;
+          break;
+        case 4:
+          data[i] = (i < n / 2) ? i : n - i;
+          break;
+        default:
+          data[i] = rand () % 4;
+          break;
+        }
+    }
+}
+
+/**
+ * @brief Function to check, that array is sorted
+ * and has the same elements, as <data>.
+ */
+void
+check_sorted (array *arr, int *data, int n)
+{
+  long long sum = 0;
+
+  ck_assert_uint_eq (array_size (arr), n);
+  for (int i = 0; i < n; i++)
+    {
+      sum += *(int *)arr->vec[i] - data[i];
+      ck_assert ((int *)arr->vec[i] >= data && (int *)arr->vec[i] < data + n);
+      if (i > 0)
+        ck_assert_int_le (*(int *)arr->vec[i - 1], *(int *)arr->vec[i]);
+    }
+  ck_assert (sum == 0);
+}
+
 START_TEST (array_test_1)
 {
   int a = 1, b = 2, c = 3;
@@ -368,6 +432,89 @@ START_TEST (array_test_9)
   array_destroy (arr, destr);
 }
 
+START_TEST (array_test_10)
+{
+  int sizes[] = { 0, 1, 2, 23, 24, 100, 129, 1000, 50000 };
+  int *data = malloc (sizeof (int) * 50000);
+
+  srand (time (NULL));
+  for (int s = 0; s < 9; s++)
+    for (int pattern = 0; pattern < 6; pattern++)
+      {
+        array *arr = array_create (0);
+        array *st = array_create (0);
+
+        fill_pattern (data, sizes[s], pattern);
+        for (int i = 0; i < sizes[s]; i++)
+          {
+            array_push_back (arr, data + i);
+            array_push_back (st, data + i);
+          }
+
+        array_sort (arr, cmp_sort);
+        check_sorted (arr, data, sizes[s]);
+        array_stable_sort (st, cmp_sort);
+        check_sorted (st, data, sizes[s]);
+
+        array_destroy (arr, NULL);
+        array_destroy (st, NULL);
+      }
+
+  free (data);
+}
+
+START_TEST (array_test_11)
+{
+  int n = 10000;
+  int *data = malloc (sizeof (int) * n);
+  array *arr = array_create (n);
+
+  srand (time (NULL));
+  for (int i = 0; i < n; i++)
+    {
+      data[i] = rand () % 1000;
+      array_push_back (arr, data + i);
+    }
+
+  // Equal keys keep order of their addresses.
+  array_stable_sort (arr, cmp_sort_div);
+  for (int i = 1; i < n; i++)
+    {
+      int res = cmp_sort_div (arr->vec[i - 1], arr->vec[i]);
+      ck_assert (res < 0 || (res == 0 && arr->vec[i - 1] < arr->vec[i]));
+    }
+
+  array_sort (NULL, cmp_sort);
+  array_stable_sort (NULL, cmp_sort);
+  array_sort_parallel (NULL, cmp_sort, 4);
+
+  array_destroy (arr, NULL);
+  free (data);
+}
+
+START_TEST (array_test_12)
+{
+  int n = 5 * ARRAY_SORT_PARALLEL_THRESHOLD + 3;
+  int *data = malloc (sizeof (int) * n);
+
+  srand (time (NULL));
+  for (size_t threads = 0; threads < 6; threads++)
+    {
+      array *arr = array_create (n);
+
+      fill_pattern (data, n, (threads == 4) ? 5 : 0);
+      for (int i = 0; i < n; i++)
+        array_push_back (arr, data + i);
+
+      array_sort_parallel (arr, cmp_sort, threads);
+      check_sorted (arr, data, n);
+
+      array_destroy (arr, NULL);
+    }
+
+  free (data);
+}
+
 Suite *
 suite_array ()
 {
@@ -386,6 +533,9 @@ suite_array ()
   tcase_add_test (tc, array_test_7);
   tcase_add_test (tc, array_test_8);
   tcase_add_test (tc, array_test_9);
+  tcase_add_test (tc, array_test_10);
+  tcase_add_test (tc, array_test_11);
+  tcase_add_test (tc, array_test_12);
 
   suite_add_tcase (s, tc);
 
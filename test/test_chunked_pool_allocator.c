@@ -0,0 +1,135 @@
+#include "test.h"
+
+START_TEST (chunked_pool_allocator_test_1)
+{
+  chunked_pool_allocator *al = chunked_pool_allocator_create (64, 16, false);
+  ck_assert_uint_eq (al->block_size, 64);
+  ck_assert_uint_ge (al->blocks_per_chunk, 16);
+  ck_assert_uint_eq (al->chunk_size & (al->chunk_size - 1), 0);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 0);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 0);
+
+  dptr one = chunked_pool_allocator_allocate (al);
+  ck_assert_ptr_nonnull (one);
+  ck_assert_uint_eq ((uintptr_t)one % CHUNKED_POOL_ALLOCATOR_ALIGNMENT, 0);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 1);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 1);
+
+  dptr two = chunked_pool_allocator_allocate (al);
+  ck_assert_uint_eq ((size_t)(one - two), 64);
+
+  // Last freed block is returned first.
+  chunked_pool_allocator_deallocate (al, one);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 1);
+  ck_assert_ptr_eq (chunked_pool_allocator_allocate (al), one);
+
+  // Wrong pointers are ignored.
+  chunked_pool_allocator_deallocate (al, two + 1);
+  chunked_pool_allocator_deallocate (al, al->chunks);
+  chunked_pool_allocator_deallocate (al, NULL);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 2);
+
+  chunked_pool_allocator_destroy (al);
+}
+
+START_TEST (chunked_pool_allocator_test_2)
+{
+  size_t count = 10000;
+  chunked_pool_allocator *al = chunked_pool_allocator_create (24, 100, false);
+  dptr *blocks = (dptr *)malloc (sizeof (dptr) * count);
+
+  // Allocator never runs out of blocks.
+  for (size_t i = 0; i < count; i++)
+    {
+      blocks[i] = chunked_pool_allocator_allocate (al);
+      ck_assert_ptr_nonnull (blocks[i]);
+      memset (blocks[i], (int)i, 24);
+    }
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), count);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al),
+                     (count + al->blocks_per_chunk - 1)
+                         / al->blocks_per_chunk);
+
+  // Blocks do not overlap.
+  for (size_t i = 0; i < count; i++)
+    ck_assert_int_eq (((unsigned char *)blocks[i])[23], (unsigned char)i);
+
+  size_t chunks = chunked_pool_allocator_chunks (al);
+  for (size_t i = 0; i < count; i++)
+    chunked_pool_allocator_deallocate (al, blocks[i]);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 0);
+
+  // Chunks are kept, so they are reused.
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), chunks);
+  for (size_t i = 0; i < count; i++)
+    blocks[i] = chunked_pool_allocator_allocate (al);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), chunks);
+
+  chunked_pool_allocator_reset (al);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 0);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), chunks);
+
+  free (blocks);
+  chunked_pool_allocator_destroy (al);
+}
+
+START_TEST (chunked_pool_allocator_test_3)
+{
+  size_t count = 5000;
+  chunked_pool_allocator *al = chunked_pool_allocator_create (32, 64, true);
+  dptr *blocks = (dptr *)malloc (sizeof (dptr) * count);
+
+  for (size_t i = 0; i < count; i++)
+    blocks[i] = chunked_pool_allocator_allocate (al);
+  ck_assert_uint_gt (chunked_pool_allocator_chunks (al), 2);
+
+  // Free chunks are returned to the system,
+  // only one is kept.
+  for (size_t i = 0; i < count; i++)
+    chunked_pool_allocator_deallocate (al, blocks[i]);
+  ck_assert_uint_eq (chunked_pool_allocator_used (al), 0);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 1);
+
+  // Allocation and deallocation on the border of
+  // the chunk do not map chunks again and again.
+  for (size_t i = 0; i < al->blocks_per_chunk; i++)
+    blocks[i] = chunked_pool_allocator_allocate (al);
+  for (size_t i = 0; i < 100; i++)
+    {
+      dptr ptr = chunked_pool_allocator_allocate (al);
+      ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 2);
+      chunked_pool_allocator_deallocate (al, ptr);
+    }
+  for (size_t i = 0; i < al->blocks_per_chunk; i++)
+    chunked_pool_allocator_deallocate (al, blocks[i]);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 1);
+
+  // Reset keeps only one chunk.
+  for (size_t i = 0; i < count; i++)
+    blocks[i] = chunked_pool_allocator_allocate (al);
+  chunked_pool_allocator_reset (al);
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 1);
+  ck_assert_ptr_nonnull (chunked_pool_allocator_allocate (al));
+  ck_assert_uint_eq (chunked_pool_allocator_chunks (al), 1);
+
+  free (blocks);
+  chunked_pool_allocator_destroy (al);
+}
+
+Suite *
+suite_chunked_pool_allocator ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Chunked Pool Allocator test");
+  tc = tcase_create ("Chunked Pool Allocator test");
+
+  tcase_add_test (tc, chunked_pool_allocator_test_1);
+  tcase_add_test (tc, chunked_pool_allocator_test_2);
+  tcase_add_test (tc, chunked_pool_allocator_test_3);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -0,0 +1,152 @@
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define THREADS 4
+#define KEYS_PER_THREAD 20000
+
+static size_t
+size_func (constdptr key)
+{
+  return sizeof (*(int *)key);
+}
+
+static bool
+cmp_int (constdptr f, constdptr s)
+{
+  return (*(int *)((struct pair *)f)->key == *(int *)((struct pair *)s)->key);
+}
+
+static int keys[THREADS * KEYS_PER_THREAD];
+static atomic_int computed;
+
+static dptr
+compute (constdptr key, dptr arg)
+{
+  (void)key;
+  atomic_fetch_add (&computed, 1);
+  return arg;
+}
+
+struct worker_arg
+{
+  concurrent_hashmap *chm;
+  int id;
+};
+
+static void *
+worker (void *p)
+{
+  struct worker_arg *arg = (struct worker_arg *)p;
+  int begin = arg->id * KEYS_PER_THREAD;
+
+  // Own keys.
+  for (int i = begin; i < begin + KEYS_PER_THREAD; i++)
+    concurrent_hashmap_insert (arg->chm, keys + i, keys + i);
+
+  // Keys shared with all threads (odd ones, that are not erased).
+  for (int i = 1; i < 2000; i += 2)
+    concurrent_hashmap_compute_if_absent (arg->chm, keys + i, compute,
+                                          keys + i);
+
+  for (int i = begin; i < begin + KEYS_PER_THREAD; i++)
+    if (concurrent_hashmap_at (arg->chm, keys + i) != keys + i)
+      return p;
+
+  for (int i = begin; i < begin + KEYS_PER_THREAD; i += 2)
+    concurrent_hashmap_erase (arg->chm, keys + i);
+
+  return NULL;
+}
+
+START_TEST (concurrent_hashmap_test_1)
+{
+  int arr[5] = { 1, 2, 3, 4, 5 };
+  concurrent_hashmap *chm = concurrent_hashmap_create_with_shards (
+      cmp_int, size_func, NULL, 3);
+
+  ck_assert_uint_eq (chm->nshards, 4);
+  ck_assert (concurrent_hashmap_empty (chm));
+
+  ck_assert (concurrent_hashmap_insert (chm, arr, arr + 1));
+  ck_assert (!concurrent_hashmap_insert (chm, arr, arr + 2));
+  ck_assert (concurrent_hashmap_at (chm, arr) == arr + 1);
+
+  ck_assert (!concurrent_hashmap_insert_or_assign (chm, arr, arr + 2));
+  ck_assert (concurrent_hashmap_at (chm, arr) == arr + 2);
+  ck_assert (concurrent_hashmap_insert_or_assign (chm, arr + 1, arr + 3));
+  ck_assert_uint_eq (concurrent_hashmap_size (chm), 2);
+
+  ck_assert (concurrent_hashmap_compute_if_absent (chm, arr, compute, arr)
+             == arr + 2);
+  ck_assert (concurrent_hashmap_compute_if_absent (chm, arr + 4, compute,
+                                                   arr + 3)
+             == arr + 3);
+  ck_assert_int_eq (atomic_load (&computed), 1);
+  ck_assert (concurrent_hashmap_contains (chm, arr + 4));
+
+  concurrent_hashmap_erase (chm, arr);
+  ck_assert (!concurrent_hashmap_contains (chm, arr));
+  ck_assert_uint_eq (concurrent_hashmap_size (chm), 2);
+
+  concurrent_hashmap_clear (chm);
+  ck_assert (concurrent_hashmap_empty (chm));
+
+  concurrent_hashmap_destroy (chm);
+}
+
+START_TEST (concurrent_hashmap_test_2)
+{
+  pthread_t threads[THREADS];
+  struct worker_arg args[THREADS];
+  concurrent_hashmap *chm
+      = concurrent_hashmap_create (cmp_int, size_func, NULL);
+
+  for (int i = 0; i < THREADS * KEYS_PER_THREAD; i++)
+    keys[i] = i;
+  atomic_store (&computed, 0);
+
+  for (int i = 0; i < THREADS; i++)
+    {
+      args[i].chm = chm;
+      args[i].id = i;
+      pthread_create (threads + i, NULL, worker, args + i);
+    }
+
+  for (int i = 0; i < THREADS; i++)
+    {
+      void *res;
+      pthread_join (threads[i], &res);
+      ck_assert_ptr_null (res);
+    }
+
+  ck_assert_uint_eq (concurrent_hashmap_size (chm),
+                     THREADS * KEYS_PER_THREAD / 2);
+
+  // Shared keys belong to the first thread, so computing
+  // could happen only before its insert and only once.
+  ck_assert_int_le (atomic_load (&computed), 1000);
+
+  for (int i = 0; i < THREADS * KEYS_PER_THREAD; i++)
+    ck_assert (concurrent_hashmap_contains (chm, keys + i) == (i % 2 != 0));
+
+  concurrent_hashmap_destroy (chm);
+}
+
+Suite *
+suite_concurrent_hashmap ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Concurrent Hashmap test");
+  tc = tcase_create ("Concurrent Hashmap test");
+
+  tcase_add_test (tc, concurrent_hashmap_test_1);
+  tcase_add_test (tc, concurrent_hashmap_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -0,0 +1,149 @@
+#include "test.h"
+
+#include <pthread.h>
+
+#define THREADS 4
+#define BLOCKS_PER_THREAD 20000
+
+static dptr blocks[THREADS * BLOCKS_PER_THREAD];
+
+struct worker_arg
+{
+  concurrent_pool_allocator *al;
+  int id;
+};
+
+static void *
+allocating_worker (void *p)
+{
+  struct worker_arg *arg = (struct worker_arg *)p;
+  int begin = arg->id * BLOCKS_PER_THREAD;
+
+  for (int i = begin; i < begin + BLOCKS_PER_THREAD; i++)
+    {
+      blocks[i] = concurrent_pool_allocator_allocate (arg->al);
+      *(int *)blocks[i] = i;
+    }
+
+  // Short living blocks.
+  for (int i = 0; i < BLOCKS_PER_THREAD; i++)
+    {
+      dptr ptr = concurrent_pool_allocator_allocate (arg->al);
+      *(int *)ptr = -1;
+      concurrent_pool_allocator_deallocate (arg->al, ptr);
+    }
+
+  for (int i = begin; i < begin + BLOCKS_PER_THREAD; i++)
+    if (*(int *)blocks[i] != i)
+      return p;
+
+  return NULL;
+}
+
+static void *
+freeing_worker (void *p)
+{
+  struct worker_arg *arg = (struct worker_arg *)p;
+
+  // Freeing blocks of the neighbour thread.
+  int begin = ((arg->id + 1) % THREADS) * BLOCKS_PER_THREAD;
+
+  for (int i = begin; i < begin + BLOCKS_PER_THREAD; i++)
+    concurrent_pool_allocator_deallocate (arg->al, blocks[i]);
+
+  return NULL;
+}
+
+static void
+run_workers (concurrent_pool_allocator *al, void *(*func) (void *))
+{
+  pthread_t threads[THREADS];
+  struct worker_arg args[THREADS];
+
+  for (int i = 0; i < THREADS; i++)
+    {
+      args[i].al = al;
+      args[i].id = i;
+      pthread_create (threads + i, NULL, func, args + i);
+    }
+
+  for (int i = 0; i < THREADS; i++)
+    {
+      void *res;
+      pthread_join (threads[i], &res);
+      ck_assert_ptr_null (res);
+    }
+}
+
+START_TEST (concurrent_pool_allocator_test_1)
+{
+  concurrent_pool_allocator *al = concurrent_pool_allocator_create (32, 128);
+  dptr local[1000];
+
+  dptr one = concurrent_pool_allocator_allocate (al);
+  ck_assert_ptr_nonnull (one);
+
+  // Last freed block is returned first.
+  concurrent_pool_allocator_deallocate (al, one);
+  ck_assert_ptr_eq (concurrent_pool_allocator_allocate (al), one);
+
+  // NULL is not cached, so it is never handed out.
+  concurrent_pool_allocator_deallocate (al, NULL);
+  ck_assert_ptr_nonnull (concurrent_pool_allocator_allocate (al));
+
+  // Magazines are refilled and flushed.
+  for (int i = 0; i < 1000; i++)
+    {
+      local[i] = concurrent_pool_allocator_allocate (al);
+      memset (local[i], i, 32);
+    }
+  for (int i = 0; i < 1000; i++)
+    ck_assert_int_eq (((unsigned char *)local[i])[31], (unsigned char)i);
+
+  size_t used = chunked_pool_allocator_used (al->pool);
+  for (int i = 0; i < 1000; i++)
+    concurrent_pool_allocator_deallocate (al, local[i]);
+  for (int i = 0; i < 1000; i++)
+    local[i] = concurrent_pool_allocator_allocate (al);
+
+  // Freed blocks are reused.
+  ck_assert_uint_eq (chunked_pool_allocator_used (al->pool), used);
+
+  concurrent_pool_allocator_destroy (al);
+}
+
+START_TEST (concurrent_pool_allocator_test_2)
+{
+  concurrent_pool_allocator *al = concurrent_pool_allocator_create (16, 1024);
+
+  run_workers (al, allocating_worker);
+  size_t used = chunked_pool_allocator_used (al->pool);
+  ck_assert_uint_ge (used, THREADS * BLOCKS_PER_THREAD);
+
+  // Blocks of finished threads are available to others.
+  run_workers (al, freeing_worker);
+  run_workers (al, allocating_worker);
+  ck_assert_uint_le (chunked_pool_allocator_used (al->pool),
+                     used
+                         + THREADS * 2
+                               * CONCURRENT_POOL_ALLOCATOR_MAGAZINE_SIZE);
+
+  concurrent_pool_allocator_destroy (al);
+}
+
+Suite *
+suite_concurrent_pool_allocator ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Concurrent Pool Allocator test");
+  tc = tcase_create ("Concurrent Pool Allocator test");
+
+  tcase_add_test (tc, concurrent_pool_allocator_test_1);
+  tcase_add_test (tc, concurrent_pool_allocator_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
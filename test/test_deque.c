@@ -0,0 +1,130 @@
+#include "test.h"
+
+static int destroyed = 0;
+
+static void
+destr (dptr data)
+{
+  data = data;
+  destroyed++;
+}
+
+START_TEST (deque_test_1)
+{
+  int data[100];
+  deque *d = deque_create (5);
+
+  ck_assert_uint_eq (deque_capacity (d), 8);
+  ck_assert (deque_empty (d));
+  ck_assert_ptr_null (deque_front (d));
+  ck_assert_ptr_null (deque_back (d));
+
+  // Wrapping around the end of buffer before growing.
+  for (int i = 0; i < 6; i++)
+    deque_push_back (d, data + i);
+  for (int i = 0; i < 4; i++)
+    deque_pop_front (d, NULL);
+  for (int i = 6; i < 12; i++)
+    deque_push_back (d, data + i);
+  ck_assert_uint_eq (deque_capacity (d), 8);
+  ck_assert_uint_eq (deque_size (d), 8);
+
+  // Growing, when elements are wrapped.
+  deque_push_back (d, data + 12);
+  ck_assert_uint_eq (deque_capacity (d), 16);
+  for (int i = 0; i < 9; i++)
+    ck_assert_ptr_eq (deque_at (d, i), data + 4 + i);
+  ck_assert_ptr_null (deque_at (d, 9));
+
+  deque_push_front (d, data + 3);
+  deque_push_front (d, data + 2);
+  ck_assert_ptr_eq (deque_front (d), data + 2);
+  ck_assert_ptr_eq (deque_back (d), data + 12);
+
+  deque_pop_back (d, destr);
+  deque_pop_front (d, destr);
+  ck_assert_int_eq (destroyed, 2);
+  ck_assert_ptr_eq (deque_front (d), data + 3);
+  ck_assert_ptr_eq (deque_back (d), data + 11);
+
+  deque_reserve (d, 100);
+  ck_assert_uint_eq (deque_capacity (d), 128);
+  for (int i = 0; i < 9; i++)
+    ck_assert_ptr_eq (deque_at (d, i), data + 3 + i);
+
+  deque_clear (d, destr);
+  ck_assert_int_eq (destroyed, 11);
+  ck_assert (deque_empty (d));
+
+  deque_destroy (d, NULL);
+  deque_destroy (NULL, NULL);
+}
+
+START_TEST (deque_test_2)
+{
+  int data[1000];
+  int *ref[2000];
+  size_t head = 1000, tail = 1000;
+  deque *d = deque_create (0);
+
+  srand (time (NULL));
+  for (int step = 0; step < 20000; step++)
+    {
+      int op = rand () % 4;
+      int *value = data + rand () % 1000;
+
+      if (op == 0 && head > 0)
+        {
+          deque_push_front (d, value);
+          ref[--head] = value;
+        }
+      else if (op == 1 && tail < 2000)
+        {
+          deque_push_back (d, value);
+          ref[tail++] = value;
+        }
+      else if (op == 2 && head < tail)
+        {
+          deque_pop_front (d, NULL);
+          head++;
+        }
+      else if (op == 3 && head < tail)
+        {
+          deque_pop_back (d, NULL);
+          tail--;
+        }
+
+      // Recentering reference, when it reaches the edge.
+      if (head == 0 || tail == 2000)
+        {
+          size_t size = tail - head;
+          memmove (ref + 1000 - size / 2, ref + head, sizeof (int *) * size);
+          head = 1000 - size / 2;
+          tail = head + size;
+        }
+
+      ck_assert_uint_eq (deque_size (d), tail - head);
+      if (step % 50 == 0)
+        for (size_t i = head; i < tail; i++)
+          ck_assert_ptr_eq (deque_at (d, i - head), ref[i]);
+    }
+
+  deque_destroy (d, NULL);
+}
+
+Suite *
+suite_deque ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Deque test");
+  tc = tcase_create ("Deque test");
+
+  tcase_add_test (tc, deque_test_1);
+  tcase_add_test (tc, deque_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
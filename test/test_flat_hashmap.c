@@ -0,0 +1,207 @@
+#include "test.h"
+
+static size_t
+size_func (constdptr key)
+{
+  return sizeof (*(int *)key);
+}
+
+static bool
+cmp_int (constdptr f, constdptr s)
+{
+  return *(int *)f == *(int *)s;
+}
+
+START_TEST (flat_hashmap_test_1)
+{
+  flat_hashmap *hm = flat_hashmap_create (cmp_int, size_func, NULL, NULL);
+  int arr[16]
+      = { 1, 8, 6, 4, 5, 3453, 235, 3, 564, 34, 53, 4, 53, 4545, 35, 3535 };
+  int vals[16];
+  int i;
+
+  ck_assert (flat_hashmap_empty (hm));
+  ck_assert_uint_eq (flat_hashmap_bucket_count (hm),
+                     FLAT_HASHMAP_STARTING_CAPACITY);
+
+  for (i = 0; i < 16; i++)
+    {
+      vals[i] = i;
+      flat_hashmap_insert (hm, arr + i, vals + i);
+      ck_assert (!flat_hashmap_empty (hm));
+    }
+
+  // 4 and 53 are duplicated, so values are updated.
+  ck_assert_uint_eq (flat_hashmap_size (hm), 14);
+  ck_assert (flat_hashmap_at (hm, arr + 3) == vals + 11);
+  ck_assert (flat_hashmap_at (hm, arr + 10) == vals + 12);
+
+  for (i = 0; i < 16; i++)
+    {
+      ck_assert (flat_hashmap_contains (hm, arr + i));
+      if (i != 3 && i != 10)
+        ck_assert (flat_hashmap_at (hm, arr + i) == vals + i);
+    }
+
+  ck_assert_float_eq_tol (flat_hashmap_load_factor (hm),
+                          14 / (float)flat_hashmap_bucket_count (hm), 1e-07);
+
+  for (i = 0; i < 16; i++)
+    {
+      flat_hashmap_erase (hm, arr + i);
+      ck_assert (flat_hashmap_at (hm, arr + i) == NULL);
+      ck_assert (!flat_hashmap_contains (hm, arr + i));
+    }
+
+  ck_assert (flat_hashmap_empty (hm));
+
+  flat_hashmap_destroy (hm);
+}
+
+START_TEST (flat_hashmap_test_2)
+{
+  int a = 24321, b = 78938, c = 18346, d = 1;
+  int val1 = 1, val2 = 2, val3 = 3;
+  flat_hashmap *hm = flat_hashmap_create (cmp_int, size_func, NULL, NULL);
+
+  ck_assert (hm != NULL);
+  ck_assert (flat_hashmap_size (hm) == 0);
+
+  flat_hashmap_insert (hm, &a, &val1);
+  flat_hashmap_insert (hm, &b, &val2);
+  flat_hashmap_insert (hm, &c, &val3);
+  ck_assert_uint_eq (flat_hashmap_size (hm), 3);
+  ck_assert (flat_hashmap_at (hm, &a) == &val1);
+  ck_assert (flat_hashmap_at (hm, &b) == &val2);
+  ck_assert (flat_hashmap_at (hm, &c) == &val3);
+  ck_assert (flat_hashmap_at (hm, &d) == NULL);
+
+  // Erasing of absent key changes nothing.
+  flat_hashmap_erase (hm, &d);
+  ck_assert_uint_eq (flat_hashmap_size (hm), 3);
+
+  flat_hashmap_clear (hm);
+  ck_assert (flat_hashmap_size (hm) == 0);
+  ck_assert (!flat_hashmap_contains (hm, &a));
+  ck_assert_uint_eq (flat_hashmap_bucket_count (hm),
+                     FLAT_HASHMAP_STARTING_CAPACITY);
+
+  flat_hashmap_insert (hm, &b, &val1);
+  ck_assert (flat_hashmap_at (hm, &b) == &val1);
+
+  flat_hashmap_destroy (hm);
+}
+
+START_TEST (flat_hashmap_test_3)
+{
+  flat_hashmap *hm = flat_hashmap_create (cmp_int, size_func, free, free);
+
+  for (int i = 0; i < 1000; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      int *val = (int *)malloc (sizeof (int));
+      *key = i;
+      *val = i * 2;
+      flat_hashmap_insert (hm, key, val);
+    }
+
+  // Updating value destroys the former one.
+  int key = 7;
+  int *val = (int *)malloc (sizeof (int));
+  *val = 0;
+  flat_hashmap_insert (hm, &key, val);
+  ck_assert (flat_hashmap_at (hm, &key) == val);
+
+  for (int i = 0; i < 1000; i += 2)
+    if (i != 7)
+      flat_hashmap_erase (hm, &i);
+
+  ck_assert_uint_eq (flat_hashmap_size (hm), 500);
+  for (int i = 1; i < 1000; i += 2)
+    if (i != 7)
+      ck_assert_int_eq (*(int *)flat_hashmap_at (hm, &i), i * 2);
+
+  flat_hashmap_destroy (hm);
+}
+
+START_TEST (flat_hashmap_test_4)
+{
+  static int arr[100000];
+  flat_hashmap *hm = flat_hashmap_create (cmp_int, size_func, NULL, NULL);
+
+  // Interleaving inserts and erases to produce many tombstones.
+  for (int round = 0; round < 4; round++)
+    {
+      for (int i = 0; i < 100000; i++)
+        {
+          arr[i] = i;
+          flat_hashmap_insert (hm, arr + i, arr + i);
+        }
+      ck_assert_uint_eq (flat_hashmap_size (hm), 100000);
+      ck_assert (flat_hashmap_load_factor (hm) <= 7 / 8.0f);
+
+      for (int i = 0; i < 100000; i++)
+        ck_assert (flat_hashmap_at (hm, arr + i) == arr + i);
+
+      for (int i = 0; i < 100000; i++)
+        flat_hashmap_erase (hm, arr + i);
+      ck_assert (flat_hashmap_empty (hm));
+    }
+
+  flat_hashmap_destroy (hm);
+}
+
+START_TEST (flat_hashmap_test_5)
+{
+  static int keys_data[10000];
+  static int vals_data[10000];
+  static constdptr keys[10000];
+  static constdptr vals[10000];
+  static dptr found[10000];
+  flat_hashmap *hm = flat_hashmap_create (cmp_int, size_func, NULL, NULL);
+
+  for (int i = 0; i < 10000; i++)
+    {
+      keys_data[i] = i;
+      vals_data[i] = -i;
+      keys[i] = keys_data + i;
+      vals[i] = vals_data + i;
+    }
+
+  // Table grows once for the whole batch.
+  flat_hashmap_insert_batch (hm, keys, vals, 5000);
+  ck_assert_uint_eq (flat_hashmap_size (hm), 5000);
+  ck_assert_uint_eq (flat_hashmap_bucket_count (hm), 8192);
+
+  flat_hashmap_insert_batch (hm, keys, vals, 10000);
+  ck_assert_uint_eq (flat_hashmap_size (hm), 10000);
+
+  for (int i = 0; i < 10000; i += 2)
+    flat_hashmap_erase (hm, keys[i]);
+
+  flat_hashmap_at_batch (hm, keys, found, 10000);
+  for (int i = 0; i < 10000; i++)
+    ck_assert (found[i] == (i % 2 ? vals_data + i : NULL));
+
+  flat_hashmap_destroy (hm);
+}
+
+Suite *
+suite_flat_hashmap ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Flat Hashmap test");
+  tc = tcase_create ("Flat Hashmap test");
+
+  tcase_add_test (tc, flat_hashmap_test_1);
+  tcase_add_test (tc, flat_hashmap_test_2);
+  tcase_add_test (tc, flat_hashmap_test_3);
+  tcase_add_test (tc, flat_hashmap_test_4);
+  tcase_add_test (tc, flat_hashmap_test_5);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -0,0 +1,143 @@
+#include "test.h"
+
+static size_t
+size_func (constdptr val)
+{
+  return sizeof (*(int *)val);
+}
+
+static bool
+cmp_int (constdptr f, constdptr s)
+{
+  return *(int *)f == *(int *)s;
+}
+
+START_TEST (flat_hashset_test_1)
+{
+  flat_hashset *hs = flat_hashset_create (cmp_int, size_func, NULL);
+  int arr[16]
+      = { 1, 8, 6, 4, 5, 3453, 235, 3, 564, 34, 53, 4, 53, 4545, 35, 3535 };
+  int absent[4] = { 2, 7, 100, 3536 };
+  int i;
+
+  ck_assert (flat_hashset_empty (hs));
+  for (i = 0; i < 16; i++)
+    {
+      flat_hashset_insert (hs, arr + i);
+      ck_assert (!flat_hashset_empty (hs));
+    }
+
+  ck_assert_uint_eq (flat_hashset_size (hs), 14);
+  ck_assert_float_eq_tol (flat_hashset_load_factor (hs),
+                          14 / (float)flat_hashset_bucket_count (hs), 1e-07);
+
+  for (i = 0; i < 16; i++)
+    ck_assert (flat_hashset_contains (hs, arr + i));
+  for (i = 0; i < 4; i++)
+    ck_assert (!flat_hashset_contains (hs, absent + i));
+
+  for (i = 0; i < 16; i++)
+    {
+      flat_hashset_erase (hs, arr + i);
+      ck_assert (!flat_hashset_contains (hs, arr + i));
+    }
+  ck_assert (flat_hashset_empty (hs));
+
+  flat_hashset_destroy (hs);
+}
+
+START_TEST (flat_hashset_test_2)
+{
+  flat_hashset *hs = flat_hashset_create (cmp_int, size_func, free);
+
+  for (int i = 0; i < 10000; i++)
+    {
+      int *val = (int *)malloc (sizeof (int));
+      *val = i;
+      flat_hashset_insert (hs, val);
+    }
+  ck_assert_uint_eq (flat_hashset_size (hs), 10000);
+
+  // Negative lookups.
+  for (int i = 10000; i < 20000; i++)
+    ck_assert (!flat_hashset_contains (hs, &i));
+
+  for (int i = 0; i < 10000; i += 3)
+    flat_hashset_erase (hs, &i);
+
+  for (int i = 0; i < 10000; i++)
+    ck_assert (flat_hashset_contains (hs, &i) == (i % 3 != 0));
+
+  flat_hashset_clear (hs);
+  ck_assert (flat_hashset_empty (hs));
+
+  flat_hashset_destroy (hs);
+}
+
+START_TEST (flat_hashset_test_3)
+{
+  static int arr[50000];
+  flat_hashset *hs = flat_hashset_create (cmp_int, size_func, NULL);
+
+  // Erasing and inserting in the same table many times
+  // to check, that tombstones do not break probing.
+  for (int i = 0; i < 50000; i++)
+    arr[i] = i;
+
+  for (int round = 0; round < 8; round++)
+    {
+      for (int i = round; i < 50000; i += 2)
+        flat_hashset_insert (hs, arr + i);
+      for (int i = round; i < 50000; i += 4)
+        flat_hashset_erase (hs, arr + i);
+      for (int i = round; i < 50000; i += 2)
+        ck_assert (flat_hashset_contains (hs, arr + i)
+                   == ((i - round) % 4 != 0));
+      flat_hashset_clear (hs);
+    }
+
+  flat_hashset_destroy (hs);
+}
+
+START_TEST (flat_hashset_test_4)
+{
+  static int arr[20000];
+  hash_func funcs[] = { hash_jenkins, hash_short, hash_crc32c };
+
+  for (int i = 0; i < 20000; i++)
+    arr[i] = i;
+
+  for (size_t f = 0; f < sizeof (funcs) / sizeof (funcs[0]); f++)
+    {
+      flat_hashset *hs = flat_hashset_create_with_hash (cmp_int, size_func,
+                                                        NULL, funcs[f], 7);
+
+      for (int i = 0; i < 20000; i += 2)
+        flat_hashset_insert (hs, arr + i);
+      ck_assert_uint_eq (flat_hashset_size (hs), 10000);
+
+      for (int i = 0; i < 20000; i++)
+        ck_assert (flat_hashset_contains (hs, arr + i) == (i % 2 == 0));
+
+      flat_hashset_destroy (hs);
+    }
+}
+
+Suite *
+suite_flat_hashset ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Flat Hashset test");
+  tc = tcase_create ("Flat Hashset test");
+
+  tcase_add_test (tc, flat_hashset_test_1);
+  tcase_add_test (tc, flat_hashset_test_2);
+  tcase_add_test (tc, flat_hashset_test_3);
+  tcase_add_test (tc, flat_hashset_test_4);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -43,6 +43,12 @@ predicate4 (constdptr d)
   return (*(int *)d > 41);
 }
 
+static int
+cmp_sort (constdptr f, constdptr s)
+{
+  return *(int *)f / 16 - *(int *)s / 16;
+}
+
 START_TEST (forward_list_test_1)
 {
   int a = 1, b = 2;
@@ -364,6 +370,81 @@ START_TEST (forward_list_test_9)
   forward_list_destroy (l, standart_destructor);
 }
 
+START_TEST (forward_list_test_10)
+{
+  int arr[100];
+  forward_list *l = forward_list_create_with_pool (50);
+
+  for (int i = 0; i < 100; i++)
+    {
+      arr[i] = i;
+      forward_list_push_front (l, arr + i);
+    }
+  ck_assert_uint_eq (pool_allocator_used (l->pool), 50);
+
+  // Removing heap and pool nodes.
+  for (int i = 0; i < 75; i++)
+    forward_list_pop_front (l, NULL);
+  ck_assert (forward_list_front (l) == arr + 24);
+  ck_assert_uint_eq (pool_allocator_used (l->pool), 25);
+
+  forward_list_clear (l, NULL);
+  ck_assert_uint_eq (pool_allocator_used (l->pool), 0);
+
+  for (int i = 0; i < 50; i++)
+    forward_list_push_front (l, arr + i);
+  forward_list_destroy (l, NULL);
+}
+
+START_TEST (forward_list_test_11)
+{
+  int n = 20000;
+  int *data = malloc (sizeof (int) * n);
+
+  srand (time (NULL));
+  for (int pattern = 0; pattern < 5; pattern++)
+    {
+      forward_list *l = forward_list_create ();
+      int size = (pattern == 4) ? 1 : n;
+
+      for (int i = 0; i < size; i++)
+        {
+          if (pattern == 0)
+            data[i] = rand () % 5000;
+          else if (pattern == 1)
+            data[i] = i;
+          else if (pattern == 2)
+            data[i] = n - i;
+          else
+            data[i] = 7;
+          forward_list_push_front (l, data + size - 1 - i);
+        }
+
+      forward_list_sort (l, cmp_sort);
+      ck_assert_uint_eq (forward_list_size (l), size);
+
+      // Sorted by key, equal keys keep order of their addresses.
+      int count = 0;
+      forward_list_iterator prev = NULL;
+      forward_list_iterator it = forward_list_begin (l);
+      for (; it; it = it->next, count++)
+        {
+          if (prev)
+            {
+              int res = cmp_sort (prev->data, it->data);
+              ck_assert (res < 0 || (res == 0 && prev->data < it->data));
+            }
+          prev = it;
+        }
+      ck_assert_int_eq (count, size);
+
+      forward_list_destroy (l, NULL);
+    }
+
+  forward_list_sort (NULL, cmp_sort);
+  free (data);
+}
+
 Suite *
 suite_forward_list ()
 {
@@ -382,6 +463,8 @@ suite_forward_list ()
   tcase_add_test (tc, forward_list_test_7);
   tcase_add_test (tc, forward_list_test_8);
   tcase_add_test (tc, forward_list_test_9);
+  tcase_add_test (tc, forward_list_test_10);
+  tcase_add_test (tc, forward_list_test_11);
 
   suite_add_tcase (s, tc);
 
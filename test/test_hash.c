@@ -0,0 +1,99 @@
+#include "test.h"
+
+START_TEST (hash_test_1)
+{
+  const char *str = "Hello, world!";
+  int val = 123456;
+
+  // Seed 0 gives the former hash.
+  ck_assert_uint_eq (hash_jenkins (str, strlen (str), 0),
+                     hash (str, strlen (str)));
+  ck_assert_uint_eq (hash_jenkins (&val, sizeof (int), 0),
+                     hash (&val, sizeof (int)));
+  ck_assert_uint_ne (hash_jenkins (str, strlen (str), 1),
+                     hash (str, strlen (str)));
+}
+
+START_TEST (hash_test_2)
+{
+  // Known CRC32C check value.
+  ck_assert_uint_eq (crc32c ("123456789", 9, 0), 0xe3069283);
+  ck_assert_uint_eq (crc32c ("", 0, 0), 0);
+
+  // Checksum can be computed by parts.
+  ck_assert_uint_eq (crc32c ("6789", 4, crc32c ("12345", 5, 0)),
+                     0xe3069283);
+}
+
+START_TEST (hash_test_3)
+{
+  unsigned char buf[256 + 8];
+  hash64 hashes[257];
+
+  for (size_t i = 0; i < sizeof (buf); i++)
+    buf[i] = (unsigned char)(i * 31 + 7);
+
+  // Every length gives its own hash and does not depend
+  // on alignment of the key.
+  for (size_t len = 0; len <= 256; len++)
+    {
+      hash64 crc = hash_crc32c (buf, len, 42);
+      hashes[len] = hash_wy (buf, len, 42);
+
+      memmove (buf + 3, buf, sizeof (buf) - 3);
+      ck_assert_uint_eq (hash_wy (buf + 3, len, 42), hashes[len]);
+      ck_assert_uint_eq (hash_crc32c (buf + 3, len, 42), crc);
+      memmove (buf, buf + 3, sizeof (buf) - 3);
+
+      if (len <= 16)
+        ck_assert_uint_eq (hash_short (buf, len, 42), hashes[len]);
+
+      for (size_t j = 0; j < len; j++)
+        ck_assert_uint_ne (hashes[j], hashes[len]);
+    }
+
+  // Seed changes the hash.
+  ck_assert_uint_ne (hash_wy (buf, 100, 1), hash_wy (buf, 100, 2));
+  ck_assert_uint_ne (hash_short (buf, 8, 1), hash_short (buf, 8, 2));
+  ck_assert_uint_ne (hash_crc32c (buf, 100, 1), hash_crc32c (buf, 100, 2));
+}
+
+START_TEST (hash_test_4)
+{
+  // Flipping one bit of the key changes
+  // about half of bits of the hash.
+  int total = 0;
+
+  for (uint64_t i = 0; i < 64; i++)
+    {
+      uint64_t key = 0x0123456789abcdefull;
+      uint64_t flipped = key ^ (1ull << i);
+
+      total += __builtin_popcountll (hash_wy (&key, sizeof (key), 0)
+                                     ^ hash_wy (&flipped, sizeof (key), 0));
+    }
+
+  ck_assert_int_gt (total, 64 * 24);
+  ck_assert_int_lt (total, 64 * 40);
+
+  ck_assert_uint_ne (hash_random_seed (), hash_random_seed ());
+}
+
+Suite *
+suite_hash ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Hash test");
+  tc = tcase_create ("Hash test");
+
+  tcase_add_test (tc, hash_test_1);
+  tcase_add_test (tc, hash_test_2);
+  tcase_add_test (tc, hash_test_3);
+  tcase_add_test (tc, hash_test_4);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -1,5 +1,7 @@
 #include "test.h"
 
+#include <math.h>
+
 static void
 destr (dptr pair)
 {
@@ -141,6 +143,306 @@ START_TEST (hashmap_test_4)
   hashmap_destroy (hm);
 }
 
+static void
+destr_with_key (dptr pair)
+{
+  free (((struct pair *)pair)->key);
+  free (pair);
+}
+
+START_TEST (hashmap_test_5)
+{
+  int vals[1000];
+  hashmap *hm = hashmap_create (cmp_int, size_func, destr_with_key);
+
+  // Entries are moved on resize, so keys stay alive.
+  for (int i = 0; i < 1000; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      *key = i;
+      vals[i] = i;
+      hashmap_insert (hm, key, vals + i);
+    }
+  ck_assert_uint_eq (hashmap_size (hm), 1000);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 1280);
+
+  for (int i = 0; i < 1000; i++)
+    {
+      ck_assert (hashmap_at (hm, &i) == vals + i);
+      ck_assert_uint_eq (hashmap_bucket (hm, &i),
+                         (size_t)hash (&i, sizeof (int))
+                             % hashmap_bucket_count (hm));
+    }
+
+  // Erasing of absent key changes nothing.
+  int absent = 1000;
+  hashmap_erase (hm, &absent);
+  ck_assert_uint_eq (hashmap_size (hm), 1000);
+
+  for (int i = 0; i < 1000; i += 2)
+    hashmap_erase (hm, &i);
+  ck_assert_uint_eq (hashmap_size (hm), 500);
+
+  hashmap_destroy (hm);
+}
+
+START_TEST (hashmap_test_6)
+{
+  int vals[5000];
+  hashmap *hm = hashmap_create (cmp_int, size_func, destr_with_key);
+  bool was_rehashing = false;
+
+  // Moving one bucket per operation.
+  hashmap_set_rehash_step (hm, 1);
+
+  for (int i = 0; i < 5000; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      *key = i;
+      vals[i] = i;
+      hashmap_insert (hm, key, vals + i);
+      was_rehashing |= hashmap_is_rehashing (hm);
+
+      // Every entry is visible during rehash.
+      ck_assert (hashmap_at (hm, &i) == vals + i);
+      ck_assert (hashmap_contains (hm, key));
+    }
+  ck_assert (was_rehashing);
+  ck_assert_uint_eq (hashmap_size (hm), 5000);
+
+  for (int i = 0; i < 5000; i++)
+    ck_assert (hashmap_at (hm, &i) == vals + i);
+
+  for (int i = 0; i < 5000; i += 2)
+    hashmap_erase (hm, &i);
+  ck_assert_uint_eq (hashmap_size (hm), 2500);
+
+  // Finishing rehash manually.
+  while (hashmap_rehash_step (hm, 1))
+    ;
+  ck_assert (!hashmap_is_rehashing (hm));
+
+  for (int i = 0; i < 5000; i++)
+    ck_assert (hashmap_contains (hm, &i) == (i % 2 != 0));
+
+  hashmap_destroy (hm);
+}
+
+START_TEST (hashmap_test_7)
+{
+  hashmap *hm = hashmap_create (cmp_int, size_func, destr_with_key);
+
+  // Clearing and destroying in the middle of rehash.
+  hashmap_set_rehash_step (hm, 1);
+
+  for (int i = 0; i < 641; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      *key = i;
+      hashmap_insert (hm, key, NULL);
+    }
+  ck_assert (hashmap_is_rehashing (hm));
+
+  hashmap_clear (hm);
+  ck_assert (hashmap_empty (hm));
+  ck_assert (!hashmap_is_rehashing (hm));
+
+  // Buckets are kept after clear, so next resize is at 1280.
+  for (int i = 0; i < 1281; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      *key = i;
+      hashmap_insert (hm, key, NULL);
+    }
+  ck_assert (hashmap_is_rehashing (hm));
+
+  // Disabling incremental mode finishes rehash.
+  hashmap_set_rehash_step (hm, 0);
+  ck_assert (!hashmap_is_rehashing (hm));
+  ck_assert_uint_eq (hashmap_size (hm), 1281);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 2560);
+
+  hashmap_set_rehash_step (hm, 1);
+  for (int i = 1281; i < 2561; i++)
+    {
+      int *key = (int *)malloc (sizeof (int));
+      *key = i;
+      hashmap_insert (hm, key, NULL);
+    }
+  ck_assert (hashmap_is_rehashing (hm));
+
+  hashmap_destroy (hm);
+}
+
+START_TEST (hashmap_test_8)
+{
+  hash_func funcs[] = { hash_jenkins, hash_wy, hash_crc32c };
+
+  for (size_t f = 0; f < sizeof (funcs) / sizeof (funcs[0]); f++)
+    {
+      int vals[1000];
+      hashmap *hm = hashmap_create_with_hash (cmp_int, size_func, NULL,
+                                              funcs[f], hash_random_seed ());
+
+      for (int i = 0; i < 1000; i++)
+        {
+          vals[i] = i;
+          hashmap_insert (hm, vals + i, vals + i);
+        }
+      ck_assert_uint_eq (hashmap_size (hm), 1000);
+
+      // Bucket depends on hash function and seed.
+      for (int i = 0; i < 1000; i++)
+        {
+          ck_assert (hashmap_at (hm, &i) == vals + i);
+          ck_assert_uint_eq (hashmap_bucket (hm, &i),
+                             funcs[f](&i, sizeof (int), hm->seed)
+                                 % hashmap_bucket_count (hm));
+        }
+
+      hashmap_destroy (hm);
+    }
+}
+
+START_TEST (hashmap_test_9)
+{
+  int vals[3000];
+  hashmap *hm = hashmap_create (cmp_int, size_func, NULL);
+
+  // Reserving gives enough buckets at once.
+  hashmap_reserve (hm, 3000);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 3000);
+
+  for (int i = 0; i < 3000; i++)
+    {
+      vals[i] = i;
+      hashmap_insert (hm, vals + i, vals + i);
+    }
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 3000);
+
+  // Reserve never shrinks.
+  hashmap_reserve (hm, 10);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 3000);
+
+  // Rehash does not go below size / max_load_factor.
+  hashmap_rehash (hm, 100);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 3000);
+  hashmap_rehash (hm, 7001);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 7001);
+
+  for (int i = 0; i < 3000; i++)
+    ck_assert (hashmap_at (hm, &i) == vals + i);
+
+  for (int i = 0; i < 3000; i += 3)
+    hashmap_erase (hm, &i);
+  hashmap_shrink_to_fit (hm);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 2000);
+
+  // Lower max load factor gives more buckets.
+  ck_assert_float_eq_tol (hashmap_max_load_factor (hm), 1.0, 1e-07);
+  hashmap_set_max_load_factor (hm, 0.5);
+  ck_assert_uint_eq (hashmap_bucket_count (hm), 4000);
+
+  // Invalid maximums are ignored.
+  hashmap_set_max_load_factor (hm, 0);
+  hashmap_set_max_load_factor (hm, -1);
+  hashmap_set_max_load_factor (hm, NAN);
+  ck_assert_float_eq_tol (hashmap_max_load_factor (hm), 0.5, 1e-07);
+  ck_assert (hashmap_load_factor (hm) <= 0.5);
+
+  for (int i = 0; i < 3000; i += 3)
+    hashmap_insert (hm, vals + i, vals + i);
+  ck_assert (hashmap_load_factor (hm) <= 0.5);
+
+  for (int i = 0; i < 3000; i++)
+    ck_assert (hashmap_at (hm, &i) == vals + i);
+
+  hashmap_destroy (hm);
+}
+
+START_TEST (hashmap_test_10)
+{
+  static int keys_data[10000];
+  static int vals_data[10000];
+  constdptr keys[10003];
+  constdptr vals[10003];
+  dptr found[10003];
+  hashmap *hm = hashmap_create (cmp_int, size_func, NULL);
+
+  for (int i = 0; i < 10000; i++)
+    {
+      keys_data[i] = i;
+      vals_data[i] = -i;
+      keys[i] = keys_data + i;
+      vals[i] = vals_data + i;
+    }
+
+  // Duplicates in the same batch update value.
+  keys[10000] = keys_data + 5;
+  vals[10000] = vals_data + 6;
+  hashmap_insert_batch (hm, keys, vals, 10001);
+  ck_assert_uint_eq (hashmap_size (hm), 10000);
+  ck_assert (hashmap_at (hm, keys_data + 5) == vals_data + 6);
+  hashmap_insert (hm, keys_data + 5, vals_data + 5);
+
+  // Absent keys give NULL.
+  int absent[3] = { -1, 10000, 20000 };
+  for (int i = 0; i < 3; i++)
+    keys[10000 + i] = absent + i;
+
+  hashmap_at_batch (hm, keys, found, 10003);
+  for (int i = 0; i < 10000; i++)
+    ck_assert (found[i] == vals_data + i);
+  for (int i = 10000; i < 10003; i++)
+    ck_assert_ptr_null (found[i]);
+
+  // Batch without values.
+  hashmap_clear (hm);
+  hashmap_insert_batch (hm, keys, NULL, 3);
+  ck_assert_uint_eq (hashmap_size (hm), 3);
+  ck_assert (hashmap_contains (hm, keys[2]));
+  ck_assert_ptr_null (hashmap_at (hm, keys[2]));
+
+  hashmap_destroy (hm);
+}
+
+START_TEST (hashmap_test_11)
+{
+  int keys[100];
+  bool inserted;
+  hashmap *hm = hashmap_create (cmp_int, size_func, NULL);
+
+  for (int i = 0; i < 100; i++)
+    {
+      keys[i] = i;
+      hash64 h = hashmap_hash (hm, keys + i);
+      struct pair *pair = hashmap_emplace_hashed (hm, keys + i, h, &inserted);
+
+      ck_assert (inserted);
+      ck_assert_ptr_null (pair->value);
+      if (i % 2)
+        pair->value = keys + i;
+    }
+
+  // Present key with NULL value differs from absent key.
+  int absent = 100;
+  ck_assert_ptr_nonnull (
+      hashmap_find_hashed (hm, keys + 10, hashmap_hash (hm, keys + 10)));
+  ck_assert_ptr_null (
+      hashmap_find_hashed (hm, &absent, hashmap_hash (hm, &absent)));
+
+  struct pair *pair = hashmap_emplace_hashed (
+      hm, keys + 11, hashmap_hash (hm, keys + 11), &inserted);
+  ck_assert (!inserted);
+  ck_assert_ptr_eq (pair->value, keys + 11);
+
+  hashmap_erase_hashed (hm, keys + 11, hashmap_hash (hm, keys + 11));
+  ck_assert (!hashmap_contains (hm, keys + 11));
+  ck_assert_uint_eq (hashmap_size (hm), 99);
+
+  hashmap_destroy (hm);
+}
+
 Suite *
 suite_hashmap ()
 {
@@ -154,6 +456,13 @@ suite_hashmap ()
   tcase_add_test (tc, hashmap_test_2);
   tcase_add_test (tc, hashmap_test_3);
   tcase_add_test (tc, hashmap_test_4);
+  tcase_add_test (tc, hashmap_test_5);
+  tcase_add_test (tc, hashmap_test_6);
+  tcase_add_test (tc, hashmap_test_7);
+  tcase_add_test (tc, hashmap_test_8);
+  tcase_add_test (tc, hashmap_test_9);
+  tcase_add_test (tc, hashmap_test_10);
+  tcase_add_test (tc, hashmap_test_11);
 
   suite_add_tcase (s, tc);
 
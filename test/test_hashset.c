@@ -1,5 +1,7 @@
 #include "test.h"
 
+#include <math.h>
+
 static void
 destr (dptr data)
 {
@@ -129,6 +131,81 @@ START_TEST (hashset_test_4)
   hashset_destroy (hs);
 }
 
+START_TEST (hashset_test_5)
+{
+  static int arr[20000];
+  hashset *hs = hashset_create (cmp_int, size_func, NULL);
+  bool was_rehashing = false;
+
+  // Moving one bucket per operation.
+  hashset_set_rehash_step (hs, 1);
+
+  for (int i = 0; i < 20000; i++)
+    {
+      arr[i] = i;
+      hashset_insert (hs, arr + i);
+      was_rehashing |= hashset_is_rehashing (hs);
+    }
+  ck_assert (was_rehashing);
+  ck_assert_uint_eq (hashset_size (hs), 20000);
+
+  for (int i = 0; i < 20000; i += 3)
+    hashset_erase (hs, arr + i);
+
+  for (int i = 0; i < 20000; i++)
+    ck_assert (hashset_contains (hs, arr + i) == (i % 3 != 0));
+
+  while (hashset_rehash_step (hs, 1))
+    ;
+  ck_assert (!hashset_is_rehashing (hs));
+
+  for (int i = 0; i < 20000; i++)
+    ck_assert (hashset_contains (hs, arr + i) == (i % 3 != 0));
+
+  hashset_destroy (hs);
+}
+
+START_TEST (hashset_test_6)
+{
+  static int arr[5000];
+  hashset *hs = hashset_create (cmp_int, size_func, NULL);
+
+  hashset_set_max_load_factor (hs, 2.0);
+  hashset_set_max_load_factor (hs, 0);
+  hashset_set_max_load_factor (hs, NAN);
+  ck_assert_float_eq_tol (hashset_max_load_factor (hs), 2.0, 1e-07);
+  hashset_reserve (hs, 5000);
+  ck_assert_uint_eq (hashset_bucket_count (hs), 2500);
+
+  for (int i = 0; i < 5000; i++)
+    {
+      arr[i] = i;
+      hashset_insert (hs, arr + i);
+    }
+  ck_assert_uint_eq (hashset_bucket_count (hs), 2500);
+
+  // Growing with factor 2 after reaching max load.
+  hashset_insert (hs, arr);
+  ck_assert_uint_eq (hashset_bucket_count (hs), 2500);
+  int extra = 5000;
+  hashset_insert (hs, &extra);
+  ck_assert_uint_eq (hashset_bucket_count (hs), 5000);
+  hashset_erase (hs, &extra);
+
+  for (int i = 0; i < 5000; i += 2)
+    hashset_erase (hs, arr + i);
+  hashset_shrink_to_fit (hs);
+  ck_assert_uint_eq (hashset_bucket_count (hs), 1250);
+
+  hashset_rehash (hs, 0);
+  ck_assert_uint_eq (hashset_bucket_count (hs), 1250);
+
+  for (int i = 0; i < 5000; i++)
+    ck_assert (hashset_contains (hs, arr + i) == (i % 2 != 0));
+
+  hashset_destroy (hs);
+}
+
 Suite *
 suite_hashset ()
 {
@@ -142,6 +219,8 @@ suite_hashset ()
   tcase_add_test (tc, hashset_test_2);
   tcase_add_test (tc, hashset_test_3);
   tcase_add_test (tc, hashset_test_4);
+  tcase_add_test (tc, hashset_test_5);
+  tcase_add_test (tc, hashset_test_6);
 
   suite_add_tcase (s, tc);
 
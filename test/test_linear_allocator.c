@@ -13,13 +13,19 @@ START_TEST (linear_allocator_test_1)
   ck_assert (al->offset == 16);
 
   dptr two = linear_allocator_allocate (al, 1);
-  ck_assert_uint_eq (((uint64_t)two - (uint64_t)al->ptr), 23);
+  ck_assert_uint_eq (((uint64_t)two - (uint64_t)al->ptr), 16);
   ck_assert (al->capacity == 256);
-  ck_assert (al->offset == 24);
+  ck_assert (al->offset == 17);
 
+  // Address is aligned, not size.
   dptr three = linear_allocator_allocate (al, 300);
   ck_assert (three == NULL);
-  ck_assert (al->offset == 24);
+  ck_assert (al->offset == 17);
+
+  dptr four = linear_allocator_allocate (al, 1);
+  ck_assert_uint_eq (((uint64_t)four - (uint64_t)al->ptr), 24);
+  ck_assert_uint_eq ((uint64_t)four % align, 0);
+  ck_assert (al->offset == 25);
 
   linear_allocator_free (al);
   ck_assert (al->capacity == 256);
@@ -34,20 +40,23 @@ START_TEST (linear_allocator_test_2)
   size_t capacity = 256;
 
   linear_allocator *al = linear_allocator_create (capacity, align);
+  size_t junk = (5 - (uint64_t)al->ptr % 5) % 5;
 
   dptr one = linear_allocator_allocate (al, 16);
-  ck_assert_uint_eq (((uint64_t)one - (uint64_t)al->ptr), 4);
+  ck_assert_uint_eq ((uint64_t)one % align, 0);
+  ck_assert_uint_eq (((uint64_t)one - (uint64_t)al->ptr), junk);
   ck_assert (al->capacity == 256);
-  ck_assert (al->offset == 20);
+  ck_assert (al->offset == junk + 16);
 
   dptr two = linear_allocator_allocate (al, 3);
-  ck_assert_uint_eq (((uint64_t)two - (uint64_t)al->ptr), 22);
+  ck_assert_uint_eq ((uint64_t)two % align, 0);
+  ck_assert_uint_eq (((uint64_t)two - (uint64_t)one), 20);
   ck_assert (al->capacity == 256);
-  ck_assert (al->offset == 25);
+  ck_assert (al->offset == junk + 23);
 
   dptr three = linear_allocator_allocate (al, 300);
   ck_assert (three == NULL);
-  ck_assert (al->offset == 25);
+  ck_assert (al->offset == junk + 23);
 
   linear_allocator_free (al);
   ck_assert (al->capacity == 256);
@@ -84,6 +93,60 @@ START_TEST (linear_allocator_test_3)
   linear_allocator_destroy (al);
 }
 
+START_TEST (linear_allocator_test_4)
+{
+  linear_allocator *al
+      = linear_allocator_create_with_flags (256, 8, LINEAR_ALLOCATOR_GROWABLE);
+  dptr first = al->ptr;
+
+  // Alignment override for SIMD data.
+  dptr one = linear_allocator_allocate (al, 1);
+  dptr two = linear_allocator_allocate_aligned (al, 64, 64);
+  ck_assert_uint_eq ((uint64_t)two % 64, 0);
+  ck_assert (two > one);
+
+  linear_allocator_checkpoint cp = linear_allocator_checkpoint_save (al);
+
+  // Growable allocator chains new blocks.
+  for (int i = 0; i < 100; i++)
+    {
+      char *ptr = linear_allocator_allocate (al, 100);
+      ck_assert_ptr_nonnull (ptr);
+      ck_assert_uint_eq ((uint64_t)ptr % 8, 0);
+      memset (ptr, i, 100);
+    }
+  ck_assert_ptr_ne (al->ptr, first);
+  ck_assert_ptr_nonnull (al->prev);
+
+  // Request greater than the block.
+  char *big = linear_allocator_allocate (al, 100000);
+  ck_assert_ptr_nonnull (big);
+  memset (big, 0, 100000);
+
+  // Restoring unmaps chained blocks.
+  linear_allocator_checkpoint_restore (al, cp);
+  ck_assert_ptr_eq (al->ptr, first);
+  ck_assert_ptr_null (al->prev);
+  ck_assert_uint_eq (al->offset, cp.offset);
+  ck_assert_ptr_eq (linear_allocator_allocate (al, 8), (char *)two + 64);
+
+  // Restored checkpoint is ignored.
+  linear_allocator_checkpoint inner = linear_allocator_checkpoint_save (al);
+  linear_allocator_checkpoint_restore (al, cp);
+  linear_allocator_checkpoint_restore (al, inner);
+  ck_assert_uint_eq (al->offset, cp.offset);
+
+  linear_allocator_destroy (al);
+
+  // Huge pages fall back to normal ones, if there are no reserved.
+  al = linear_allocator_create_with_flags (100, 0,
+                                           LINEAR_ALLOCATOR_HUGE_PAGES);
+  ck_assert_ptr_nonnull (al->ptr);
+  ck_assert_uint_eq (al->capacity, LINEAR_ALLOCATOR_HUGE_PAGE_SIZE);
+  memset (linear_allocator_allocate (al, 4096), 1, 4096);
+  linear_allocator_destroy (al);
+}
+
 Suite *
 suite_linear_allocator ()
 {
@@ -96,6 +159,7 @@ suite_linear_allocator ()
   tcase_add_test (tc, linear_allocator_test_1);
   tcase_add_test (tc, linear_allocator_test_2);
   tcase_add_test (tc, linear_allocator_test_3);
+  tcase_add_test (tc, linear_allocator_test_4);
 
   suite_add_tcase (s, tc);
 
@@ -43,6 +43,12 @@ copy_func (dptr val)
   return val;
 }
 
+static int
+cmp_sort (constdptr f, constdptr s)
+{
+  return *(int *)f / 16 - *(int *)s / 16;
+}
+
 START_TEST (list_test_1)
 {
   int a = 1, b = 2;
@@ -790,6 +796,94 @@ START_TEST (list_test_12)
   list_destroy (l, standart_destructor);
 }
 
+START_TEST (list_test_13)
+{
+  int arr[100];
+  list *l = list_create_with_pool (100);
+
+  for (int round = 0; round < 3; round++)
+    {
+      for (int i = 0; i < 100; i++)
+        {
+          arr[i] = i;
+          list_push_back (l, arr + i);
+        }
+      ck_assert_uint_eq (list_size (l), 100);
+      ck_assert_uint_eq (pool_allocator_used (l->pool), 100);
+
+      list_pop_front (l, NULL);
+      list_erase (l, list_begin (l)->next, NULL);
+      ck_assert_uint_eq (pool_allocator_used (l->pool), 98);
+      ck_assert (list_front (l) == arr + 1);
+
+      // All nodes are released at once.
+      list_clear (l, NULL);
+      ck_assert (list_empty (l));
+      ck_assert_uint_eq (pool_allocator_used (l->pool), 0);
+    }
+
+  // Mixed pool and heap nodes.
+  for (int i = 0; i < 150; i++)
+    list_push_front (l, arr + i % 100);
+  ck_assert (list_back (l) == arr);
+  list_clear (l, NULL);
+  ck_assert_uint_eq (pool_allocator_used (l->pool), 0);
+
+  for (int i = 0; i < 150; i++)
+    list_push_front (l, malloc (sizeof (int)));
+  list_destroy (l, free);
+}
+
+START_TEST (list_test_14)
+{
+  int n = 20000;
+  int *data = malloc (sizeof (int) * n);
+
+  srand (time (NULL));
+  for (int pattern = 0; pattern < 5; pattern++)
+    {
+      list *l = list_create ();
+      int size = (pattern == 4) ? 1 : n;
+
+      for (int i = 0; i < size; i++)
+        {
+          if (pattern == 0)
+            data[i] = rand () % 5000;
+          else if (pattern == 1)
+            data[i] = i;
+          else if (pattern == 2)
+            data[i] = n - i;
+          else
+            data[i] = 7;
+          list_push_back (l, data + i);
+        }
+
+      list_sort (l, cmp_sort);
+      ck_assert_uint_eq (list_size (l), size);
+
+      // Sorted by key, equal keys keep order of their addresses.
+      int count = 0;
+      list_iterator prev = NULL;
+      for (list_iterator it = list_begin (l); it; it = it->next, count++)
+        {
+          ck_assert_ptr_eq (it->prev, prev);
+          if (prev)
+            {
+              int res = cmp_sort (prev->data, it->data);
+              ck_assert (res < 0 || (res == 0 && prev->data < it->data));
+            }
+          prev = it;
+        }
+      ck_assert_int_eq (count, size);
+      ck_assert_ptr_eq (l->back, prev);
+
+      list_destroy (l, NULL);
+    }
+
+  list_sort (NULL, cmp_sort);
+  free (data);
+}
+
 Suite *
 suite_list ()
 {
@@ -811,6 +905,8 @@ suite_list ()
   tcase_add_test (tc, list_test_10);
   tcase_add_test (tc, list_test_11);
   tcase_add_test (tc, list_test_12);
+  tcase_add_test (tc, list_test_13);
+  tcase_add_test (tc, list_test_14);
 
   suite_add_tcase (s, tc);
 
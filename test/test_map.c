@@ -0,0 +1,151 @@
+#include "test.h"
+
+struct counter
+{
+  size_t live;
+  size_t calls;
+};
+
+static size_t destroyed = 0;
+
+static dptr
+counter_allocate (dptr ctx, size_t size)
+{
+  ((struct counter *)ctx)->live += size;
+  ((struct counter *)ctx)->calls++;
+  return malloc (size);
+}
+
+static dptr
+counter_reallocate (dptr ctx, dptr ptr, size_t old_size, size_t new_size)
+{
+  ((struct counter *)ctx)->live += new_size - old_size;
+  ((struct counter *)ctx)->calls++;
+  return realloc (ptr, new_size);
+}
+
+static void
+counter_deallocate (dptr ctx, dptr ptr, size_t size)
+{
+  ((struct counter *)ctx)->live -= size;
+  free (ptr);
+}
+
+static int
+cmp (constdptr first, constdptr second)
+{
+  int f = *(int *)((struct pair *)first)->key;
+  int s = *(int *)((struct pair *)second)->key;
+
+  return (f > s) - (f < s);
+}
+
+static void
+value_destr (dptr value)
+{
+  value = value;
+  destroyed++;
+}
+
+START_TEST (map_test_1)
+{
+  map *mp = map_create (cmp, NULL);
+  int keys[100], values[100];
+
+  for (int i = 0; i < 100; i++)
+    {
+      keys[i] = (i * 37) % 100;
+      values[i] = keys[i] * 2;
+      ck_assert_ptr_nonnull (map_insert (mp, keys + i, values + i));
+    }
+  ck_assert_uint_eq (map_size (mp), 100);
+
+  // Key is not inserted twice.
+  ck_assert_ptr_null (map_insert (mp, keys, values + 1));
+  ck_assert_uint_eq (map_size (mp), 100);
+
+  for (int i = 0; i < 100; i++)
+    {
+      ck_assert (map_contains (mp, keys + i));
+      ck_assert_uint_eq (map_count (mp, keys + i), 1);
+      ck_assert_int_eq (*(int *)map_at (mp, keys + i), keys[i] * 2);
+    }
+
+  int absent = 100;
+  ck_assert (!map_contains (mp, &absent));
+  ck_assert_ptr_null (map_at (mp, &absent));
+
+  // Pairs go in order of keys.
+  int expected = 0;
+  for (map_iterator iter = map_begin (mp); iter != map_end ();
+       iter = map_next (iter))
+    ck_assert_int_eq (*(int *)((struct pair *)iter->data)->key, expected++);
+
+  map_remove (mp, keys);
+  map_erase (mp, map_find (mp, keys + 1));
+  ck_assert (!map_contains (mp, keys));
+  ck_assert (!map_contains (mp, keys + 1));
+  ck_assert_uint_eq (map_size (mp), 98);
+
+  map_clear (mp);
+  ck_assert (map_empty (mp));
+
+  map_destroy (mp);
+}
+
+START_TEST (map_test_2)
+{
+  struct counter cnt = { 0, 0 };
+  allocator alloc = { counter_allocate, counter_reallocate,
+                      counter_deallocate, &cnt };
+  int keys[100], values[100];
+
+  // Map owns pairs, destructor is called for values only.
+  destroyed = 0;
+  map *mp = map_create_with_allocator (cmp, NULL, value_destr, &alloc);
+
+  for (int i = 0; i < 100; i++)
+    {
+      keys[i] = i;
+      values[i] = i;
+      map_insert (mp, keys + i, values + i);
+    }
+
+  // Rejected pair is freed, its value stays with caller.
+  ck_assert_ptr_null (map_insert (mp, keys, values));
+  ck_assert_uint_eq (destroyed, 0);
+
+  map_erase (mp, map_find (mp, keys + 50));
+  map_remove (mp, keys + 10);
+  map_remove (mp, keys + 10);
+  ck_assert_uint_eq (destroyed, 2);
+  ck_assert_uint_eq (map_size (mp), 98);
+  ck_assert_ptr_eq (map_at (mp, keys + 11), values + 11);
+
+  map_clear (mp);
+  ck_assert_uint_eq (destroyed, 100);
+
+  map_insert (mp, keys, values);
+  map_destroy (mp);
+  ck_assert_uint_eq (destroyed, 101);
+
+  // Map instance, tree, nodes and pairs are returned.
+  ck_assert_uint_eq (cnt.live, 0);
+}
+
+Suite *
+suite_map ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Map test");
+  tc = tcase_create ("Map test");
+
+  tcase_add_test (tc, map_test_1);
+  tcase_add_test (tc, map_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
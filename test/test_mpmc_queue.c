@@ -0,0 +1,175 @@
+#include "test.h"
+
+#include <pthread.h>
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 50000
+#define BATCH 16
+
+static _Atomic int seen[PRODUCERS * ITEMS_PER_PRODUCER];
+
+struct worker_arg
+{
+  mpmc_queue *q;
+  int id;
+};
+
+static void *
+producer (void *p)
+{
+  struct worker_arg *arg = (struct worker_arg *)p;
+  uintptr_t begin = (uintptr_t)arg->id * ITEMS_PER_PRODUCER;
+  dptr batch[BATCH];
+
+  // Even producers push one by one, odd ones by batches.
+  for (uintptr_t i = begin; i < begin + ITEMS_PER_PRODUCER; i += BATCH)
+    {
+      for (size_t n = 0; n < BATCH; n++)
+        batch[n] = (dptr)(i + n + 1);
+
+      if (arg->id % 2)
+        mpmc_queue_push_many (arg->q, batch, BATCH);
+      else
+        for (size_t n = 0; n < BATCH; n++)
+          mpmc_queue_push (arg->q, batch[n]);
+    }
+
+  return NULL;
+}
+
+static void *
+consumer (void *p)
+{
+  struct worker_arg *arg = (struct worker_arg *)p;
+  size_t items = PRODUCERS * ITEMS_PER_PRODUCER / CONSUMERS;
+  dptr batch[BATCH];
+
+  for (size_t i = 0; i < items; i += BATCH)
+    {
+      if (arg->id % 2)
+        mpmc_queue_pop_many (arg->q, batch, BATCH);
+      else
+        for (size_t n = 0; n < BATCH; n++)
+          batch[n] = mpmc_queue_pop (arg->q);
+
+      for (size_t n = 0; n < BATCH; n++)
+        atomic_fetch_add (seen + (uintptr_t)batch[n] - 1, 1);
+    }
+
+  return NULL;
+}
+
+START_TEST (mpmc_queue_test_1)
+{
+  int data[8];
+  dptr out[8];
+  mpmc_queue *q = mpmc_queue_create (1);
+
+  ck_assert_uint_eq (mpmc_queue_capacity (q), 2);
+  mpmc_queue_destroy (q);
+
+  q = mpmc_queue_create (8);
+  ck_assert (mpmc_queue_empty (q));
+  ck_assert (!mpmc_queue_try_pop (q, out));
+
+  for (int i = 0; i < 8; i++)
+    ck_assert (mpmc_queue_try_push (q, data + i));
+  ck_assert (!mpmc_queue_try_push (q, data));
+  ck_assert_uint_eq (mpmc_queue_size (q), 8);
+  ck_assert_uint_eq (mpmc_queue_try_push_many (q, out, 8), 0);
+
+  for (int i = 0; i < 5; i++)
+    {
+      ck_assert (mpmc_queue_try_pop (q, out));
+      ck_assert_ptr_eq (out[0], data + i);
+    }
+
+  // Batch is cut by free space, single and batch calls mix.
+  dptr in[8] = { data, data + 1, data + 2, data + 3,
+                 data + 4, data + 5, data + 6, data + 7 };
+  ck_assert_uint_eq (mpmc_queue_try_push_many (q, in, 8), 5);
+  ck_assert_uint_eq (mpmc_queue_try_pop_many (q, out, 2), 2);
+  ck_assert_ptr_eq (out[0], data + 5);
+  ck_assert (mpmc_queue_try_push (q, data + 3));
+  ck_assert_uint_eq (mpmc_queue_try_pop_many (q, out, 8), 7);
+  ck_assert_ptr_eq (out[0], data + 7);
+  ck_assert_ptr_eq (out[5], data + 4);
+  ck_assert_ptr_eq (out[6], data + 3);
+  ck_assert (mpmc_queue_empty (q));
+
+  mpmc_queue_destroy (q);
+}
+
+START_TEST (mpmc_queue_test_2)
+{
+  pthread_t threads[PRODUCERS + CONSUMERS];
+  struct worker_arg args[PRODUCERS + CONSUMERS];
+  mpmc_queue *q = mpmc_queue_create (256);
+
+  for (int i = 0; i < PRODUCERS + CONSUMERS; i++)
+    {
+      args[i].q = q;
+      args[i].id = (i < PRODUCERS) ? i : i - PRODUCERS;
+      pthread_create (threads + i, NULL, (i < PRODUCERS) ? producer : consumer,
+                      args + i);
+    }
+
+  for (int i = 0; i < PRODUCERS + CONSUMERS; i++)
+    pthread_join (threads[i], NULL);
+
+  // Every item is popped exactly once.
+  for (int i = 0; i < PRODUCERS * ITEMS_PER_PRODUCER; i++)
+    ck_assert_int_eq (seen[i], 1);
+  ck_assert (mpmc_queue_empty (q));
+
+  mpmc_queue_destroy (q);
+}
+
+START_TEST (mpmc_queue_test_3)
+{
+  int data[8];
+  dptr out[8];
+  dptr in[8] = { data, data + 1, data + 2, data + 3,
+                 data + 4, data + 5, data + 6, data + 7 };
+  mpmc_queue *q = mpmc_queue_create (8);
+
+  // Producer has claimed position, but hasn't written it yet.
+  atomic_fetch_add (&q->enqueue_pos, 1);
+  ck_assert_uint_eq (mpmc_queue_try_pop_many (q, out, 8), 0);
+  ck_assert (!mpmc_queue_try_pop (q, out));
+
+  // Batch stops before the cell of that producer.
+  ck_assert_uint_eq (mpmc_queue_try_push_many (q, in, 3), 3);
+  q->cells[0].data = NULL;
+  atomic_store (&q->cells[0].sequence, 1);
+  ck_assert_uint_eq (mpmc_queue_try_pop_many (q, out, 8), 4);
+  ck_assert_ptr_eq (out[1], data);
+
+  ck_assert_uint_eq (mpmc_queue_try_push_many (q, in, 8), 8);
+
+  // Consumer has claimed position, but hasn't read it yet.
+  atomic_fetch_add (&q->dequeue_pos, 1);
+  ck_assert_uint_eq (mpmc_queue_try_push_many (q, in, 8), 0);
+  ck_assert (!mpmc_queue_try_push (q, data));
+
+  mpmc_queue_destroy (q);
+}
+
+Suite *
+suite_mpmc_queue ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Mpmc queue test");
+  tc = tcase_create ("Mpmc queue test");
+
+  tcase_add_test (tc, mpmc_queue_test_1);
+  tcase_add_test (tc, mpmc_queue_test_2);
+  tcase_add_test (tc, mpmc_queue_test_3);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
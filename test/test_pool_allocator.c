@@ -6,60 +6,60 @@ START_TEST (pool_allocator_test_1)
   pool_allocator *al = pool_allocator_create (block_size, blocks_number);
   ck_assert (al->block_size == block_size);
   ck_assert (al->blocks_number == blocks_number);
-  ck_assert (forward_list_size (al->free_blocks) == 4);
+  ck_assert (pool_allocator_used (al) == 0);
   ck_assert ((size_t)(al->ptr_end - al->ptr_begin)
              == block_size * blocks_number);
 
   dptr one = pool_allocator_allocate (al);
   ck_assert (one == (al->ptr_begin + block_size * (blocks_number - 1)));
-  ck_assert (forward_list_size (al->free_blocks) == 3);
+  ck_assert (pool_allocator_used (al) == blocks_number - 3);
 
   dptr two = pool_allocator_allocate (al);
   ck_assert (two == (al->ptr_begin + block_size * (blocks_number - 2)));
-  ck_assert (forward_list_size (al->free_blocks) == 2);
+  ck_assert (pool_allocator_used (al) == blocks_number - 2);
   ck_assert ((size_t)(one - two) == block_size);
 
   dptr three = pool_allocator_allocate (al);
   ck_assert (three == (al->ptr_begin + block_size * (blocks_number - 3)));
-  ck_assert (forward_list_size (al->free_blocks) == 1);
+  ck_assert (pool_allocator_used (al) == blocks_number - 1);
   ck_assert ((size_t)(two - three) == block_size);
 
   dptr four = pool_allocator_allocate (al);
   ck_assert (four == (al->ptr_begin + block_size * (blocks_number - 4)));
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
   ck_assert ((size_t)(three - four) == block_size);
 
   dptr five = pool_allocator_allocate (al);
   ck_assert (five == NULL);
 
   pool_allocator_deallocate (al, four);
-  ck_assert (forward_list_size (al->free_blocks) == 1);
-  ck_assert (forward_list_front (al->free_blocks) == four);
+  ck_assert (pool_allocator_used (al) == blocks_number - 1);
+  ck_assert (al->free_list == four);
 
   four = pool_allocator_allocate (al);
   ck_assert (four == (al->ptr_begin + block_size * (blocks_number - 4)));
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
   ck_assert ((size_t)(three - four) == block_size);
 
   five = pool_allocator_allocate (al);
   ck_assert (five == NULL);
 
   pool_allocator_deallocate (al, one);
-  ck_assert (forward_list_size (al->free_blocks) == 1);
-  ck_assert (forward_list_front (al->free_blocks) == one);
+  ck_assert (pool_allocator_used (al) == blocks_number - 1);
+  ck_assert (al->free_list == one);
 
   one = pool_allocator_allocate (al);
   ck_assert (one == (al->ptr_begin + block_size * (blocks_number - 1)));
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
   ck_assert ((size_t)(one - two) == block_size);
 
   pool_allocator_deallocate (al, two);
-  ck_assert (forward_list_size (al->free_blocks) == 1);
-  ck_assert (forward_list_front (al->free_blocks) == two);
+  ck_assert (pool_allocator_used (al) == blocks_number - 1);
+  ck_assert (al->free_list == two);
 
   two = pool_allocator_allocate (al);
   ck_assert (two == (al->ptr_begin + block_size * (blocks_number - 2)));
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
   ck_assert ((size_t)(two - three) == block_size);
 
   pool_allocator_destroy (al);
@@ -71,37 +71,37 @@ START_TEST (pool_allocator_test_2)
   pool_allocator *al = pool_allocator_create (block_size, blocks_number);
   ck_assert (al->block_size == block_size);
   ck_assert (al->blocks_number == blocks_number);
-  ck_assert (forward_list_size (al->free_blocks) == 4);
+  ck_assert (pool_allocator_used (al) == 0);
   ck_assert ((size_t)(al->ptr_end - al->ptr_begin)
              == block_size * blocks_number);
 
   dptr one = pool_allocator_allocate (al);
   ck_assert (one == (al->ptr_begin + block_size * (blocks_number - 1)));
-  ck_assert (forward_list_size (al->free_blocks) == 3);
+  ck_assert (pool_allocator_used (al) == blocks_number - 3);
 
   dptr two = pool_allocator_allocate (al);
   ck_assert (two == (al->ptr_begin + block_size * (blocks_number - 2)));
-  ck_assert (forward_list_size (al->free_blocks) == 2);
+  ck_assert (pool_allocator_used (al) == blocks_number - 2);
   ck_assert ((size_t)(one - two) == block_size);
 
   dptr three = pool_allocator_allocate (al);
   ck_assert (three == (al->ptr_begin + block_size * (blocks_number - 3)));
-  ck_assert (forward_list_size (al->free_blocks) == 1);
+  ck_assert (pool_allocator_used (al) == blocks_number - 1);
   ck_assert ((size_t)(two - three) == block_size);
 
   dptr four = pool_allocator_allocate (al);
   ck_assert (four == (al->ptr_begin + block_size * (blocks_number - 4)));
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
   ck_assert ((size_t)(three - four) == block_size);
 
   dptr five = pool_allocator_allocate (al);
   ck_assert (five == NULL);
 
   pool_allocator_deallocate (al, four + 1);
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
 
   pool_allocator_deallocate (al, four - 200);
-  ck_assert (forward_list_size (al->free_blocks) == 0);
+  ck_assert (pool_allocator_used (al) == blocks_number);
 
   pool_allocator_destroy (al);
 }
@@ -112,23 +112,93 @@ START_TEST (pool_allocator_test_3)
   pool_allocator *al = pool_allocator_create (block_size, blocks_number);
   ck_assert (al->block_size == block_size);
   ck_assert (al->blocks_number == blocks_number);
-  ck_assert (forward_list_size (al->free_blocks) == 4);
+  ck_assert (pool_allocator_used (al) == 0);
   ck_assert ((size_t)(al->ptr_end - al->ptr_begin)
              == block_size * blocks_number);
 
   dptr one = pool_allocator_allocate (al);
   ck_assert (one == (al->ptr_begin + block_size * (blocks_number - 1)));
-  ck_assert (forward_list_size (al->free_blocks) == 3);
+  ck_assert (pool_allocator_used (al) == blocks_number - 3);
 
   pool_allocator_deallocate (al, one);
-  ck_assert (forward_list_size (al->free_blocks) == 4);
+  ck_assert (pool_allocator_used (al) == 0);
 
   pool_allocator_deallocate (al, one);
-  ck_assert (forward_list_size (al->free_blocks) == 4);
+  ck_assert (pool_allocator_used (al) == 0);
 
   pool_allocator_destroy (al);
 }
 
+START_TEST (pool_allocator_test_4)
+{
+  pool_allocator *al = pool_allocator_create (32, 8);
+  dptr blocks[8];
+  int outside;
+
+  for (int i = 0; i < 8; i++)
+    {
+      blocks[i] = pool_allocator_allocate (al);
+      ck_assert (pool_allocator_owns (al, blocks[i]));
+    }
+  ck_assert (!pool_allocator_owns (al, &outside));
+  ck_assert_uint_eq (pool_allocator_used (al), 8);
+
+  pool_allocator_deallocate (al, blocks[3]);
+  ck_assert_uint_eq (pool_allocator_used (al), 7);
+
+  // Reset makes every block free again.
+  pool_allocator_reset (al);
+  ck_assert_uint_eq (pool_allocator_used (al), 0);
+  for (int i = 0; i < 8; i++)
+    ck_assert_ptr_nonnull (pool_allocator_allocate (al));
+  ck_assert_ptr_null (pool_allocator_allocate (al));
+
+  pool_allocator_destroy (al);
+}
+
+START_TEST (pool_allocator_test_5)
+{
+  // Block should fit link to the next free block.
+  pool_allocator *al = pool_allocator_create (1, 16);
+  ck_assert_uint_eq (al->block_size, sizeof (dptr));
+  pool_allocator_destroy (al);
+
+  // Blocks not aligned for pointer.
+  size_t block_size = 12, blocks_number = 1000;
+  al = pool_allocator_create (block_size, blocks_number);
+  dptr blocks[1000];
+
+  for (size_t round = 0; round < 3; round++)
+    {
+      for (size_t i = 0; i < blocks_number; i++)
+        {
+          blocks[i] = pool_allocator_allocate (al);
+          memset (blocks[i], (int)i, block_size);
+        }
+      ck_assert_ptr_null (pool_allocator_allocate (al));
+
+      for (size_t i = 0; i < blocks_number; i += 2)
+        pool_allocator_deallocate (al, blocks[i]);
+      ck_assert_uint_eq (pool_allocator_used (al), blocks_number / 2);
+
+      // Other blocks are not damaged by free list.
+      for (size_t i = 1; i < blocks_number; i += 2)
+        ck_assert_int_eq (((unsigned char *)blocks[i])[block_size - 1],
+                          (unsigned char)i);
+
+      for (size_t i = 1; i < blocks_number; i += 2)
+        pool_allocator_deallocate (al, blocks[i]);
+      ck_assert_uint_eq (pool_allocator_used (al), 0);
+    }
+
+  pool_allocator_destroy (al);
+
+  // Creation does not depend on number of blocks.
+  al = pool_allocator_create (64, 1 << 24);
+  ck_assert_ptr_nonnull (pool_allocator_allocate (al));
+  pool_allocator_destroy (al);
+}
+
 Suite *
 suite_pool_allocator ()
 {
@@ -141,6 +211,8 @@ suite_pool_allocator ()
   tcase_add_test (tc, pool_allocator_test_1);
   tcase_add_test (tc, pool_allocator_test_2);
   tcase_add_test (tc, pool_allocator_test_3);
+  tcase_add_test (tc, pool_allocator_test_4);
+  tcase_add_test (tc, pool_allocator_test_5);
 
   suite_add_tcase (s, tc);
 
@@ -174,6 +174,81 @@ START_TEST (queue_test_3)
   queue_destroy (q1);
 }
 
+START_TEST (queue_test_4)
+{
+  int arr[100];
+  queue *q = queue_create_with_pool (NULL, 64);
+
+  // First 64 nodes are taken from the pool, the rest from heap.
+  for (int i = 0; i < 100; i++)
+    {
+      arr[i] = i;
+      queue_push (q, arr + i);
+    }
+  ck_assert_uint_eq (pool_allocator_used (q->pool), 64);
+
+  for (int i = 0; i < 50; i++)
+    {
+      ck_assert (queue_back (q) == arr + i);
+      queue_pop (q);
+    }
+  ck_assert_uint_eq (queue_size (q), 50);
+  ck_assert_uint_eq (pool_allocator_used (q->pool), 14);
+
+  // Freed blocks are reused.
+  for (int i = 0; i < 50; i++)
+    queue_push (q, arr + i);
+  ck_assert_uint_eq (pool_allocator_used (q->pool), 64);
+  ck_assert (queue_front (q) == arr + 49);
+
+  queue_destroy (q);
+
+  // Destructor is called for every node.
+  q = queue_create_with_pool (free, 8);
+  for (int i = 0; i < 16; i++)
+    queue_push (q, malloc (sizeof (int)));
+  queue_destroy (q);
+}
+
+START_TEST (queue_test_5)
+{
+  int arr[1000];
+  queue *q = queue_create_ring (NULL, 4);
+  queue *ref = queue_create (NULL);
+
+  // Ring queue behaves the same as queue on nodes.
+  srand (time (NULL));
+  for (int i = 0; i < 10000; i++)
+    {
+      if (rand () % 3 == 0)
+        {
+          queue_pop (q);
+          queue_pop (ref);
+        }
+      else
+        {
+          queue_push (q, arr + i % 1000);
+          queue_push (ref, arr + i % 1000);
+        }
+
+      ck_assert_uint_eq (queue_size (q), queue_size (ref));
+      ck_assert_ptr_eq (queue_front (q), queue_front (ref));
+      ck_assert_ptr_eq (queue_back (q), queue_back (ref));
+    }
+  ck_assert_ptr_null (q->front);
+
+  queue_destroy (q);
+  queue_destroy (ref);
+
+  // Destructor is called for every element.
+  q = queue_create_ring (free, 0);
+  for (int i = 0; i < 40; i++)
+    queue_push (q, malloc (sizeof (int)));
+  queue_pop (q);
+  ck_assert_uint_eq (queue_size (q), 39);
+  queue_destroy (q);
+}
+
 Suite *
 suite_queue ()
 {
@@ -186,6 +261,8 @@ suite_queue ()
   tcase_add_test (tc, queue_test_1);
   tcase_add_test (tc, queue_test_2);
   tcase_add_test (tc, queue_test_3);
+  tcase_add_test (tc, queue_test_4);
+  tcase_add_test (tc, queue_test_5);
 
   suite_add_tcase (s, tc);
 
@@ -1,6 +1,9 @@
 #include "test.h"
 #include <stdbool.h>
 
+// In DEBUG mode checks are taken from the library.
+#ifndef DEBUG
+
 bool
 __rbtree_is_bst (rbtree *tree, struct __rbt_node *root)
 {
@@ -70,6 +73,8 @@ __rbtree_is_correct (rbtree *tree)
          && __rbtree_is_bst (tree, tree->root);
 }
 
+#endif // DEBUG
+
 static int
 cmp (constdptr first, constdptr second)
 {
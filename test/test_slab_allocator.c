@@ -0,0 +1,128 @@
+#include "test.h"
+
+START_TEST (slab_allocator_test_1)
+{
+  slab_allocator *al = slab_allocator_create ();
+
+  // Size is rounded up to the class.
+  dptr a = slab_allocator_allocate (al, 1);
+  ck_assert_uint_eq (slab_allocator_usable_size (al, a), 8);
+
+  dptr b = slab_allocator_allocate (al, 100);
+  ck_assert_uint_eq (slab_allocator_usable_size (al, b), 112);
+  ck_assert_uint_eq ((uintptr_t)b % 16, 0);
+
+  dptr c = slab_allocator_allocate (al, 4096);
+  ck_assert_uint_eq (slab_allocator_usable_size (al, c), 4096);
+
+  // Waste is less than 16 bytes for small sizes
+  // and at most 25% for others.
+  for (size_t size = 1; size <= SLAB_ALLOCATOR_MAX_SMALL; size++)
+    {
+      dptr ptr = slab_allocator_allocate (al, size);
+      size_t usable = slab_allocator_usable_size (al, ptr);
+
+      ck_assert_uint_ge (usable, size);
+      if (size <= 128)
+        ck_assert_uint_lt (usable - size, 16);
+      else
+        ck_assert_uint_le (usable - size, usable / 4);
+      memset (ptr, 0xAB, size);
+      slab_allocator_deallocate (al, ptr);
+    }
+
+  // Large request.
+  dptr d = slab_allocator_allocate (al, 100000);
+  ck_assert_uint_ge (slab_allocator_usable_size (al, d), 100000);
+  ck_assert_uint_eq ((uintptr_t)d % SLAB_ALLOCATOR_ALIGNMENT, 0);
+  memset (d, 1, 100000);
+
+  slab_allocator_deallocate (al, a);
+  slab_allocator_deallocate (al, b);
+  slab_allocator_deallocate (al, c);
+  slab_allocator_deallocate (al, d);
+  slab_allocator_deallocate (al, NULL);
+  ck_assert_ptr_null (al->large);
+
+  slab_allocator_destroy (al);
+}
+
+START_TEST (slab_allocator_test_2)
+{
+  slab_allocator *al = slab_allocator_create ();
+  size_t count = 10000;
+  dptr *ptrs = (dptr *)malloc (sizeof (dptr) * count);
+
+  // Mixed sizes, every pointer keeps its content.
+  for (size_t i = 0; i < count; i++)
+    {
+      size_t size = 1 + (i * 37) % 6000;
+      ptrs[i] = slab_allocator_allocate (al, size);
+      memset (ptrs[i], (int)i, size);
+    }
+
+  for (size_t i = 0; i < count; i++)
+    {
+      size_t size = 1 + (i * 37) % 6000;
+      ck_assert_int_eq (((unsigned char *)ptrs[i])[size - 1],
+                        (unsigned char)i);
+    }
+
+  // Free slabs are returned to the system.
+  for (size_t i = 0; i < count; i++)
+    slab_allocator_deallocate (al, ptrs[i]);
+  for (size_t i = 0; i < SLAB_ALLOCATOR_CLASSES; i++)
+    {
+      ck_assert_uint_eq (chunked_pool_allocator_used (al->classes[i]), 0);
+      ck_assert_uint_le (chunked_pool_allocator_chunks (al->classes[i]), 1);
+    }
+
+  free (ptrs);
+  slab_allocator_destroy (al);
+}
+
+START_TEST (slab_allocator_test_3)
+{
+  slab_allocator *al = slab_allocator_create ();
+
+  char *str = slab_allocator_reallocate (al, NULL, 10);
+  strcpy (str, "slab");
+
+  // Fits the same block.
+  ck_assert_ptr_eq (slab_allocator_reallocate (al, str, 12), str);
+
+  // Growing moves content.
+  str = slab_allocator_reallocate (al, str, 1000);
+  ck_assert_str_eq (str, "slab");
+  ck_assert_uint_eq (slab_allocator_usable_size (al, str), 1024);
+
+  str = slab_allocator_reallocate (al, str, 50000);
+  ck_assert_str_eq (str, "slab");
+
+  // Shrinking moves too, so memory is not wasted.
+  str = slab_allocator_reallocate (al, str, 5);
+  ck_assert_str_eq (str, "slab");
+  ck_assert_uint_eq (slab_allocator_usable_size (al, str), 8);
+  ck_assert_ptr_null (al->large);
+
+  slab_allocator_deallocate (al, str);
+  slab_allocator_destroy (al);
+}
+
+Suite *
+suite_slab_allocator ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Slab Allocator test");
+  tc = tcase_create ("Slab Allocator test");
+
+  tcase_add_test (tc, slab_allocator_test_1);
+  tcase_add_test (tc, slab_allocator_test_2);
+  tcase_add_test (tc, slab_allocator_test_3);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -0,0 +1,107 @@
+#include "test.h"
+
+#include <pthread.h>
+
+#define ITEMS 200000
+#define BATCH 37
+
+static void *
+producer (void *p)
+{
+  spsc_queue *q = (spsc_queue *)p;
+  dptr batch[BATCH];
+
+  // Half of items one by one, half by batches.
+  for (uintptr_t i = 1; i <= ITEMS / 2; i++)
+    spsc_queue_push (q, (dptr)i);
+
+  for (uintptr_t i = ITEMS / 2 + 1; i <= ITEMS; i += BATCH)
+    {
+      size_t n = 0;
+      for (; n < BATCH && i + n <= ITEMS; n++)
+        batch[n] = (dptr)(i + n);
+      spsc_queue_push_many (q, batch, n);
+    }
+
+  return NULL;
+}
+
+START_TEST (spsc_queue_test_1)
+{
+  int data[8];
+  dptr out[8];
+  spsc_queue *q = spsc_queue_create (5);
+
+  ck_assert_uint_eq (spsc_queue_capacity (q), 8);
+  ck_assert (spsc_queue_empty (q));
+  ck_assert (!spsc_queue_try_pop (q, out));
+
+  for (int i = 0; i < 8; i++)
+    ck_assert (spsc_queue_try_push (q, data + i));
+  ck_assert (!spsc_queue_try_push (q, data));
+  ck_assert_uint_eq (spsc_queue_size (q), 8);
+
+  for (int i = 0; i < 5; i++)
+    {
+      ck_assert (spsc_queue_try_pop (q, out));
+      ck_assert_ptr_eq (out[0], data + i);
+    }
+
+  // Batch wraps around the end of buffer and is cut by free space.
+  dptr in[8] = { data, data + 1, data + 2, data + 3,
+                 data + 4, data + 5, data + 6, data + 7 };
+  ck_assert_uint_eq (spsc_queue_try_push_many (q, in, 8), 5);
+  ck_assert_uint_eq (spsc_queue_try_pop_many (q, out, 8), 8);
+  ck_assert_ptr_eq (out[0], data + 5);
+  ck_assert_ptr_eq (out[2], data + 7);
+  for (int i = 3; i < 8; i++)
+    ck_assert_ptr_eq (out[i], data + i - 3);
+  ck_assert_uint_eq (spsc_queue_try_pop_many (q, out, 8), 0);
+
+  spsc_queue_destroy (q);
+}
+
+START_TEST (spsc_queue_test_2)
+{
+  pthread_t thread;
+  dptr batch[BATCH];
+  uintptr_t expected = 1;
+  spsc_queue *q = spsc_queue_create (64);
+
+  pthread_create (&thread, NULL, producer, q);
+
+  // Items come in order of pushing.
+  while (expected <= ITEMS / 3)
+    ck_assert_uint_eq ((uintptr_t)spsc_queue_pop (q), expected++);
+
+  // Blocking pop backs off, so producer is not starved on one CPU.
+  while (expected <= ITEMS)
+    {
+      size_t n = ITEMS - expected + 1 < BATCH ? ITEMS - expected + 1 : BATCH;
+      spsc_queue_pop_many (q, batch, n);
+      for (size_t i = 0; i < n; i++)
+        ck_assert_uint_eq ((uintptr_t)batch[i], expected++);
+    }
+
+  pthread_join (thread, NULL);
+  ck_assert (spsc_queue_empty (q));
+
+  spsc_queue_destroy (q);
+}
+
+Suite *
+suite_spsc_queue ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Spsc queue test");
+  tc = tcase_create ("Spsc queue test");
+
+  tcase_add_test (tc, spsc_queue_test_1);
+  tcase_add_test (tc, spsc_queue_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
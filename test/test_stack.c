@@ -152,6 +152,87 @@ START_TEST (stack_test_3)
   stack_destroy (s1);
 }
 
+START_TEST (stack_test_4)
+{
+  int arr[100];
+  stack *s = stack_create_with_pool (NULL, 100);
+
+  for (int i = 0; i < 100; i++)
+    {
+      arr[i] = i;
+      stack_push (s, arr + i);
+    }
+  ck_assert_uint_eq (pool_allocator_used (s->pool), 100);
+
+  for (int i = 99; i >= 0; i--)
+    {
+      ck_assert (stack_top (s) == arr + i);
+      stack_pop (s);
+    }
+  ck_assert (stack_empty (s));
+  ck_assert_uint_eq (pool_allocator_used (s->pool), 0);
+
+  // Nodes over the pool come from heap.
+  for (int i = 0; i < 100; i++)
+    stack_push (s, arr + i);
+  stack_push (s, arr);
+  ck_assert_uint_eq (stack_size (s), 101);
+
+  stack_destroy (s);
+}
+
+START_TEST (stack_test_5)
+{
+  int arr[1000];
+  stack *s = stack_create_chunked (NULL, 4);
+  stack *ref = stack_create (NULL);
+
+  // Chunked stack behaves the same as stack on nodes.
+  srand (time (NULL));
+  for (int i = 0; i < 10000; i++)
+    {
+      if (rand () % 3 == 0)
+        {
+          stack_pop (s);
+          stack_pop (ref);
+        }
+      else
+        {
+          stack_push (s, arr + i % 1000);
+          stack_push (ref, arr + i % 1000);
+        }
+
+      ck_assert_uint_eq (stack_size (s), stack_size (ref));
+      ck_assert_ptr_eq (stack_top (s), stack_top (ref));
+    }
+  ck_assert_ptr_null (s->top);
+
+  stack_destroy (s);
+  stack_destroy (ref);
+
+  // Elements are not moved, when stack grows.
+  s = stack_create_chunked (NULL, 4);
+  stack_push (s, arr);
+  dptr *bottom = s->chunk->items;
+  for (int i = 1; i < 1000; i++)
+    stack_push (s, arr + i);
+  for (int i = 1; i < 1000; i++)
+    stack_pop (s);
+  ck_assert_ptr_eq (s->chunk->items, bottom);
+  ck_assert_ptr_eq (stack_top (s), arr);
+  stack_pop (s);
+  ck_assert_ptr_null (stack_top (s));
+  stack_destroy (s);
+
+  // Destructor is called for every element.
+  s = stack_create_chunked (free, 0);
+  for (int i = 0; i < 200; i++)
+    stack_push (s, malloc (sizeof (int)));
+  stack_pop (s);
+  ck_assert_uint_eq (stack_size (s), 199);
+  stack_destroy (s);
+}
+
 Suite *
 suite_stack ()
 {
@@ -164,6 +245,8 @@ suite_stack ()
   tcase_add_test (tc, stack_test_1);
   tcase_add_test (tc, stack_test_2);
   tcase_add_test (tc, stack_test_3);
+  tcase_add_test (tc, stack_test_4);
+  tcase_add_test (tc, stack_test_5);
 
   suite_add_tcase (s, tc);
 
@@ -0,0 +1,149 @@
+#include "test.h"
+
+#include <signal.h>
+
+START_TEST (stack_allocator_test_1)
+{
+  stack_allocator *al = stack_allocator_create (4096);
+
+  dptr one = stack_allocator_allocate (al, 10);
+  ck_assert_ptr_nonnull (one);
+  ck_assert_uint_eq ((uintptr_t)one % STACK_ALLOCATOR_DEFAULT_ALIGNMENT, 0);
+  ck_assert_ptr_eq (al->top, one);
+
+  dptr two = stack_allocator_allocate_aligned (al, 3, 256);
+  ck_assert_uint_eq ((uintptr_t)two % 256, 0);
+  ck_assert (two > one);
+
+  dptr three = stack_allocator_allocate_aligned (al, 1, 1);
+  ck_assert_uint_eq ((uintptr_t)three % sizeof (size_t), 0);
+
+  // Only last allocation is freed.
+  size_t offset = al->offset;
+  stack_allocator_deallocate (al, two);
+  ck_assert_uint_eq (al->offset, offset);
+
+  stack_allocator_deallocate (al, three);
+  ck_assert_ptr_eq (al->top, two);
+  stack_allocator_deallocate (al, two);
+  ck_assert_ptr_eq (al->top, one);
+
+  // Freed place is reused.
+  ck_assert_ptr_eq (stack_allocator_allocate_aligned (al, 3, 256), two);
+
+  stack_allocator_deallocate (al, two);
+  stack_allocator_deallocate (al, one);
+  ck_assert_uint_eq (al->offset, 0);
+  ck_assert_ptr_null (al->top);
+
+  // Not enough space.
+  ck_assert_ptr_null (stack_allocator_allocate (al, 4096));
+  ck_assert_ptr_null (stack_allocator_allocate (al, (size_t)-1));
+  ck_assert_uint_eq (al->offset, 0);
+
+  stack_allocator_destroy (al);
+}
+
+START_TEST (stack_allocator_test_2)
+{
+  stack_allocator *al = stack_allocator_create (1 << 16);
+
+  char *outer = stack_allocator_allocate (al, 100);
+  strcpy (outer, "outer");
+
+  // Nested scopes.
+  stack_allocator_marker scope1 = stack_allocator_mark (al);
+  for (int i = 0; i < 10; i++)
+    memset (stack_allocator_allocate (al, 200), i, 200);
+
+  stack_allocator_marker scope2 = stack_allocator_mark (al);
+  dptr inner = stack_allocator_allocate (al, 1000);
+  memset (inner, 0, 1000);
+
+  stack_allocator_rewind (al, scope2);
+  ck_assert_uint_eq (al->offset, scope2.offset);
+  ck_assert_ptr_eq (stack_allocator_allocate (al, 1000), inner);
+
+  stack_allocator_rewind (al, scope1);
+  ck_assert_ptr_eq (al->top, outer);
+  ck_assert_str_eq (outer, "outer");
+
+  // Marker, that is already rewound, is ignored.
+  stack_allocator_rewind (al, scope2);
+  ck_assert_uint_eq (al->offset, scope1.offset);
+
+  // Allocation after rewind can be freed one by one.
+  dptr ptr = stack_allocator_allocate (al, 8);
+  stack_allocator_deallocate (al, ptr);
+  ck_assert_uint_eq (al->offset, scope1.offset);
+  stack_allocator_deallocate (al, outer);
+  ck_assert_uint_eq (al->offset, 0);
+
+  stack_allocator_allocate (al, 8);
+  stack_allocator_free (al);
+  ck_assert_uint_eq (al->offset, 0);
+  ck_assert_ptr_null (al->top);
+
+  stack_allocator_destroy (al);
+}
+
+START_TEST (stack_allocator_test_3)
+{
+  stack_allocator *al = stack_allocator_create (4096);
+  allocator alloc = stack_allocator_as_allocator (al);
+
+  // Sizes near SIZE_MAX don't wrap around.
+  ck_assert_ptr_null (stack_allocator_allocate (al, SIZE_MAX));
+  ck_assert_ptr_null (stack_allocator_allocate (al, SIZE_MAX - 4));
+
+  dptr ptr = allocator_allocate (&alloc, 16);
+  ck_assert_ptr_null (allocator_reallocate (&alloc, ptr, 16, SIZE_MAX));
+  ck_assert_ptr_eq (al->top, ptr);
+
+#ifdef DEBUG
+  ck_assert (__stack_allocator_is_correct (al));
+#endif // DEBUG
+
+  stack_allocator_deallocate (al, ptr);
+  ck_assert_uint_eq (al->offset, 0);
+
+  stack_allocator_destroy (al);
+}
+
+#ifdef DEBUG
+
+START_TEST (stack_allocator_test_4)
+{
+  stack_allocator *al = stack_allocator_create (4096);
+  stack_allocator_marker marker = stack_allocator_mark (al);
+
+  // Overflow of allocation is noticed, when it is freed.
+  char *ptr = stack_allocator_allocate (al, 10);
+  stack_allocator_allocate (al, 10);
+  memset (ptr, 0, 11);
+
+  stack_allocator_rewind (al, marker);
+}
+
+#endif // DEBUG
+
+Suite *
+suite_stack_allocator ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Stack Allocator test");
+  tc = tcase_create ("Stack Allocator test");
+
+  tcase_add_test (tc, stack_allocator_test_1);
+  tcase_add_test (tc, stack_allocator_test_2);
+  tcase_add_test (tc, stack_allocator_test_3);
+#ifdef DEBUG
+  tcase_add_test_raise_signal (tc, stack_allocator_test_4, SIGABRT);
+#endif // DEBUG
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -33,7 +33,7 @@ START_TEST (std_allocator_test_1)
   std_allocator_deallocate (al, b, 1);
   ck_assert (al->n == 6);
 
-  std_allocator_reallocate (al, a, 1, 18);
+  a = std_allocator_reallocate (al, a, 1, 18);
   ck_assert (al->n == 23);
 
   std_allocator_deallocate (al, arr, 5);
@@ -71,7 +71,7 @@ START_TEST (std_allocator_test_2)
   std_allocator_deallocate (al, b, 1);
   ck_assert (al->n == 6);
 
-  std_allocator_reallocate (al, a, 1, 18);
+  a = std_allocator_reallocate (al, a, 1, 18);
   ck_assert (al->n == 23);
 
   std_allocator_deallocate (al, arr, 5);
@@ -109,7 +109,7 @@ START_TEST (std_allocator_test_3)
   std_allocator_deallocate (al, b, 1);
   ck_assert (al->n == 6);
 
-  std_allocator_reallocate (al, a, 1, 18);
+  a = std_allocator_reallocate (al, a, 1, 18);
   ck_assert (al->n == 23);
 
   std_allocator_deallocate (al, arr, 5);
@@ -122,6 +122,41 @@ START_TEST (std_allocator_test_3)
   std_allocator_destroy (al);
 }
 
+START_TEST (std_allocator_test_4)
+{
+  std_allocator *al = std_allocator_create (sizeof (int), 0, 0);
+
+  // Small requests share slabs.
+  int *a = std_allocator_allocate (al, 1);
+  int *b = std_allocator_allocate (al, 1);
+  ck_assert_uint_eq ((uintptr_t)a / SLAB_ALLOCATOR_SLAB_SIZE,
+                     (uintptr_t)b / SLAB_ALLOCATOR_SLAB_SIZE);
+  std_allocator_deallocate (al, b, 1);
+
+  a[0] = 0;
+
+  // Growing over threshold keeps content.
+  a = std_allocator_reallocate (al, a, 1, 10000);
+  ck_assert_int_eq (a[0], 0);
+  for (int i = 0; i < 10000; i++)
+    a[i] = i;
+
+  // Huge mapping is resized.
+  a = std_allocator_reallocate (al, a, 10000, 100000);
+  ck_assert_int_eq (a[9999], 9999);
+  ck_assert_uint_eq (al->n, 100000);
+
+  // Shrinking under threshold keeps content.
+  a = std_allocator_reallocate (al, a, 100000, 100);
+  for (int i = 0; i < 100; i++)
+    ck_assert_int_eq (a[i], i);
+
+  std_allocator_deallocate (al, a, 100);
+  ck_assert_uint_eq (al->n, 0);
+
+  std_allocator_destroy (al);
+}
+
 Suite *
 suite_std_allocator ()
 {
@@ -134,6 +169,7 @@ suite_std_allocator ()
   tcase_add_test (tc, std_allocator_test_1);
   tcase_add_test (tc, std_allocator_test_2);
   tcase_add_test (tc, std_allocator_test_3);
+  tcase_add_test (tc, std_allocator_test_4);
 
   suite_add_tcase (s, tc);
 
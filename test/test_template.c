@@ -0,0 +1,242 @@
+#include "test.h"
+
+static inline hash64
+int_hash (int key)
+{
+  uint64_t x = (uint64_t)(unsigned)key * 0x9E3779B97F4A7C15ULL;
+  return x ^ (x >> 32);
+}
+
+static inline bool
+int_eq (int first, int second)
+{
+  return first == second;
+}
+
+static inline int
+int_cmp (int first, int second)
+{
+  return (first > second) - (first < second);
+}
+
+DEFINE_ARRAY (int_array, int)
+DEFINE_LIST (int_list, int)
+DEFINE_HASHMAP (int_map, int, double, int_hash, int_eq)
+DEFINE_RBTREE (int_tree, int, int_cmp)
+DEFINE_SET (int_set, int, int_cmp)
+
+/**
+ * @brief Function to check Red-Black tree properties.
+ *
+ * @return int Black height of subtree, -1 if broken.
+ */
+static int
+check_rb (const struct int_tree_node *node)
+{
+  if (!node)
+    return 1;
+
+  if (node->is_red && ((node->left && node->left->is_red)
+                       || (node->right && node->right->is_red)))
+    return -1;
+  if ((node->left && node->left->parent != node)
+      || (node->right && node->right->parent != node))
+    return -1;
+
+  int left = check_rb (node->left);
+  int right = check_rb (node->right);
+
+  if (left < 0 || left != right)
+    return -1;
+  return left + !node->is_red;
+}
+
+START_TEST (template_test_1)
+{
+  int_array *arr = int_array_create (0);
+
+  for (int i = 0; i < 100; i++)
+    int_array_push_back (arr, i);
+  ck_assert_uint_eq (int_array_size (arr), 100);
+  ck_assert_int_eq (*int_array_at (arr, 42), 42);
+  ck_assert_ptr_null (int_array_at (arr, 100));
+
+  int_array_insert (arr, 0, -1);
+  int_array_erase (arr, 50);
+  ck_assert_int_eq (*int_array_at (arr, 0), -1);
+  ck_assert_int_eq (*int_array_at (arr, 50), 50);
+  ck_assert_int_eq (*int_array_back (arr), 99);
+
+  int_array_pop_back (arr);
+  ck_assert_uint_eq (int_array_size (arr), 99);
+  int_array_clear (arr);
+  ck_assert (int_array_empty (arr));
+  int_array_destroy (arr);
+
+  int_list *l = int_list_create ();
+  for (int i = 0; i < 10; i++)
+    {
+      int_list_push_back (l, i);
+      int_list_push_front (l, -i - 1);
+    }
+  ck_assert_uint_eq (int_list_size (l), 20);
+  ck_assert_int_eq (*int_list_front (l), -10);
+  ck_assert_int_eq (*int_list_back (l), 9);
+
+  // Erasing negative numbers.
+  struct int_list_node *node = int_list_begin (l);
+  while (node)
+    node = (node->data < 0) ? int_list_erase (l, node) : node->next;
+
+  int expected = 0;
+  for (node = int_list_begin (l); node; node = int_list_next (node))
+    ck_assert_int_eq (node->data, expected++);
+  ck_assert_int_eq (expected, 10);
+
+  int_list_pop_front (l);
+  int_list_pop_back (l);
+  ck_assert_int_eq (*int_list_front (l), 1);
+  ck_assert_int_eq (*int_list_back (l), 8);
+  int_list_destroy (l);
+}
+
+START_TEST (template_test_2)
+{
+  int_map *hm = int_map_create ();
+  bool ref[5000] = { false };
+
+  for (int i = 0; i < 5000; i++)
+    {
+      int_map_insert (hm, i, i * 0.5);
+      ref[i] = true;
+    }
+  ck_assert_uint_eq (int_map_size (hm), 5000);
+
+  // Updating value of existing key.
+  int_map_insert (hm, 7, 100.0);
+  ck_assert_uint_eq (int_map_size (hm), 5000);
+  ck_assert (*int_map_at (hm, 7) == 100.0);
+  // Restoring value, random pass may leave key 7 untouched.
+  int_map_insert (hm, 7, 7 * 0.5);
+
+  srand (time (NULL));
+  for (int i = 0; i < 20000; i++)
+    {
+      int key = rand () % 5000;
+
+      if (rand () % 2)
+        {
+          ck_assert (int_map_erase (hm, key) == ref[key]);
+          ref[key] = false;
+        }
+      else
+        {
+          int_map_insert (hm, key, key * 0.5);
+          ref[key] = true;
+        }
+    }
+
+  size_t count = 0;
+  for (int i = 0; i < 5000; i++)
+    {
+      ck_assert (int_map_contains (hm, i) == ref[i]);
+      if (ref[i])
+        {
+          ck_assert (*int_map_at (hm, i) == i * 0.5);
+          count++;
+        }
+    }
+  ck_assert_uint_eq (int_map_size (hm), count);
+  ck_assert_ptr_null (int_map_at (hm, 5000));
+
+  int_map_clear (hm);
+  ck_assert (int_map_empty (hm));
+  int_map_reserve (hm, 100000);
+  ck_assert (hm->capacity >= 100000);
+  int_map_destroy (hm);
+}
+
+START_TEST (template_test_3)
+{
+  int_tree *tree = int_tree_create (true);
+  int count[100] = { 0 };
+
+  srand (time (NULL));
+  for (int i = 0; i < 3000; i++)
+    {
+      int value = rand () % 100;
+      struct int_tree_node *node = int_tree_find (tree, value);
+
+      if (node && rand () % 2)
+        {
+          int_tree_erase (tree, node);
+          count[value]--;
+        }
+      else
+        {
+          int_tree_insert (tree, value);
+          count[value]++;
+        }
+      ck_assert_int_ge (check_rb (tree->root), 0);
+    }
+
+  // In-order walk gives sorted values with right counts.
+  size_t size = 0;
+  int prev = -1;
+  struct int_tree_node *node = int_tree_begin (tree);
+  for (; node; node = int_tree_next (node), size++)
+    {
+      ck_assert_int_ge (node->data, prev);
+      prev = node->data;
+    }
+  ck_assert_uint_eq (size, int_tree_size (tree));
+
+  for (int i = 0; i < 100; i++)
+    {
+      int n = 0;
+      node = int_tree_find (tree, i);
+      for (; node && node->data == i; node = int_tree_next (node))
+        n++;
+      ck_assert_int_eq (n, count[i]);
+    }
+
+  node = int_tree_rbegin (tree);
+  ck_assert_int_eq (node->data, prev);
+  ck_assert (!int_tree_prev (node) || int_tree_prev (node)->data <= prev);
+  int_tree_destroy (tree);
+
+  int_set *s = int_set_create ();
+  for (int i = 0; i < 1000; i++)
+    ck_assert (int_set_insert (s, i % 500) == (i < 500));
+  ck_assert_uint_eq (int_set_size (s), 500);
+
+  for (int i = 0; i < 500; i += 2)
+    ck_assert (int_set_erase (s, i));
+  ck_assert (!int_set_erase (s, 0));
+  ck_assert (!int_set_contains (s, 10));
+  ck_assert (int_set_contains (s, 11));
+
+  int expected = 1;
+  struct int_set_rbtree_node *snode = int_set_begin (s);
+  for (; snode; snode = int_set_next (snode), expected += 2)
+    ck_assert_int_eq (snode->data, expected);
+  int_set_destroy (s);
+}
+
+Suite *
+suite_template ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Template test");
+  tc = tcase_create ("Template test");
+
+  tcase_add_test (tc, template_test_1);
+  tcase_add_test (tc, template_test_2);
+  tcase_add_test (tc, template_test_3);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
@@ -0,0 +1,179 @@
+#include "test.h"
+
+struct point
+{
+  double x;
+  double y;
+  int id;
+};
+
+static bool
+cmp_point_id (constdptr first, constdptr second)
+{
+  return ((const struct point *)first)->id
+         == ((const struct point *)second)->id;
+}
+
+START_TEST (typed_array_test_1)
+{
+  typed_array *arr = typed_array_create (sizeof (int), 0);
+
+  ck_assert (typed_array_empty (arr));
+  ck_assert_uint_eq (typed_array_capacity (arr), TYPED_ARRAY_CAPACITY_DEFAULT);
+  ck_assert_ptr_null (typed_array_at (arr, 0));
+  ck_assert_ptr_null (typed_array_back (arr));
+
+  for (int i = 0; i < 1000; i++)
+    typed_array_push_back (arr, &i);
+
+  ck_assert_uint_eq (typed_array_size (arr), 1000);
+  ck_assert_int_eq (*(int *)typed_array_front (arr), 0);
+  ck_assert_int_eq (*(int *)typed_array_back (arr), 999);
+
+  // Elements are contiguous.
+  int *data = typed_array_data (arr);
+  long sum = 0;
+  for (size_t i = 0; i < typed_array_size (arr); i++)
+    {
+      ck_assert_int_eq (data[i], (int)i);
+      sum += TYPED_ARRAY_AT (arr, int, i);
+    }
+  ck_assert_int_eq (sum, 999 * 1000 / 2);
+
+  typed_array_pop_back (arr);
+  ck_assert_uint_eq (typed_array_size (arr), 999);
+
+  typed_array_shrink_to_fit (arr);
+  ck_assert_uint_eq (typed_array_capacity (arr), 999);
+
+  *(int *)typed_array_emplace_back (arr) = -1;
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 999), -1);
+
+  typed_array_clear (arr);
+  ck_assert (typed_array_empty (arr));
+
+  typed_array_destroy (arr);
+}
+
+START_TEST (typed_array_test_2)
+{
+  typed_array *arr = typed_array_create (sizeof (int), 4);
+  int values[] = { 10, 20, 30 };
+  int x = 5;
+
+  typed_array_insert_many (arr, 0, values, 3);
+  ck_assert_ptr_null (typed_array_insert (arr, 4, &x));
+
+  // 5 10 20 30
+  ck_assert_ptr_eq (typed_array_insert (arr, 0, &x), typed_array_data (arr));
+  // 5 10 15 20 30
+  x = 15;
+  typed_array_insert (arr, 2, &x);
+  // 5 10 15 20 30 35
+  x = 35;
+  typed_array_insert (arr, typed_array_size (arr), &x);
+
+  int expected1[] = { 5, 10, 15, 20, 30, 35 };
+  ck_assert_uint_eq (typed_array_size (arr), 6);
+  ck_assert_mem_eq (typed_array_data (arr), expected1, sizeof (expected1));
+
+  ck_assert_uint_eq (typed_array_find (arr, &x, NULL), 5);
+  x = 100;
+  ck_assert_uint_eq (typed_array_find (arr, &x, NULL), 6);
+
+  // 5 30 35
+  typed_array_erase_many (arr, 1, 3);
+  // 5 35
+  typed_array_erase (arr, 1);
+  // 5
+  typed_array_erase_many (arr, 1, 100);
+  ck_assert_uint_eq (typed_array_size (arr), 1);
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 0), 5);
+
+  typed_array_resize (arr, 4);
+  int expected2[] = { 5, 0, 0, 0 };
+  ck_assert_mem_eq (typed_array_data (arr), expected2, sizeof (expected2));
+
+  typed_array *copy = typed_array_copy (arr);
+  ck_assert_uint_eq (typed_array_size (copy), 4);
+  ck_assert_mem_eq (typed_array_data (copy), expected2, sizeof (expected2));
+  ck_assert_ptr_ne (typed_array_data (copy), typed_array_data (arr));
+
+  typed_array_destroy (copy);
+  typed_array_destroy (arr);
+}
+
+START_TEST (typed_array_test_3)
+{
+  linear_allocator *arena = linear_allocator_create_with_flags (
+      4096, 0, LINEAR_ALLOCATOR_GROWABLE);
+  allocator alloc = linear_allocator_as_allocator (arena);
+  typed_array *arr
+      = typed_array_create_with_allocator (sizeof (struct point), 1, &alloc);
+
+  for (int i = 0; i < 100; i++)
+    {
+      struct point p = { i * 0.5, -i * 0.5, i };
+      typed_array_push_back (arr, &p);
+    }
+
+  struct point key = { 0, 0, 42 };
+  size_t pos = typed_array_find (arr, &key, cmp_point_id);
+  ck_assert_uint_eq (pos, 42);
+  ck_assert (((struct point *)typed_array_at (arr, pos))->x == 21.0);
+  ck_assert (TYPED_ARRAY_AT (arr, struct point, 99).y == -49.5);
+
+  linear_allocator_destroy (arena);
+}
+
+START_TEST (typed_array_test_4)
+{
+  int first = 1;
+  typed_array *arr = typed_array_create (sizeof (int), 1);
+
+  // Pushing own element, while array is reallocated.
+  typed_array_push_back (arr, &first);
+  for (int i = 0; i < 10; i++)
+    typed_array_push_back (arr, typed_array_back (arr));
+  ck_assert_uint_eq (typed_array_size (arr), 11);
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 10), 1);
+
+  for (int i = 0; i < 11; i++)
+    TYPED_ARRAY_AT (arr, int, i) = i;
+  typed_array_shrink_to_fit (arr);
+
+  // Source range is split by the insert position:
+  // 2 3 4 are inserted before 4.
+  typed_array_insert_many (arr, 4, typed_array_at (arr, 2), 3);
+  int expected[] = { 0, 1, 2, 3, 2, 3, 4, 4, 5, 6, 7, 8, 9, 10 };
+  ck_assert_uint_eq (typed_array_size (arr), 14);
+  for (int i = 0; i < 14; i++)
+    ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, i), expected[i]);
+
+  // Source range is completely after the insert position.
+  typed_array_insert_many (arr, 0, typed_array_at (arr, 12), 2);
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 0), 9);
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 1), 10);
+  ck_assert_int_eq (TYPED_ARRAY_AT (arr, int, 2), 0);
+
+  typed_array_destroy (arr);
+}
+
+Suite *
+suite_typed_array ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Typed Array test");
+  tc = tcase_create ("Typed Array test");
+
+  tcase_add_test (tc, typed_array_test_1);
+  tcase_add_test (tc, typed_array_test_2);
+  tcase_add_test (tc, typed_array_test_3);
+  tcase_add_test (tc, typed_array_test_4);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
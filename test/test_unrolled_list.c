@@ -0,0 +1,180 @@
+#include "test.h"
+
+static bool
+cmp (constdptr f, constdptr s)
+{
+  return (*(int *)f == *(int *)s);
+}
+
+static int destroyed = 0;
+
+static void
+destr (dptr data)
+{
+  data = data;
+  destroyed++;
+}
+
+/**
+ * @brief Function to check list against <ref> by
+ * iterating forward and backward.
+ */
+static void
+check_equal (unrolled_list *l, int **ref, int n)
+{
+  int i = 0;
+
+  ck_assert_uint_eq (unrolled_list_size (l), n);
+
+  unrolled_list_iterator it = unrolled_list_begin (l);
+  for (; it.node; it = unrolled_list_next (it), i++)
+    {
+      ck_assert_int_lt (i, n);
+      ck_assert_ptr_eq (unrolled_list_get (it), ref[i]);
+    }
+  ck_assert_int_eq (i, n);
+
+  it = unrolled_list_rbegin (l);
+  for (; it.node; it = unrolled_list_prev (it))
+    ck_assert_ptr_eq (unrolled_list_get (it), ref[--i]);
+  ck_assert_int_eq (i, 0);
+}
+
+START_TEST (unrolled_list_test_1)
+{
+  int data[1000];
+  int *ref[1000];
+  unrolled_list *l = unrolled_list_create ();
+
+  ck_assert (unrolled_list_empty (l));
+  ck_assert_ptr_null (unrolled_list_front (l));
+  ck_assert_ptr_null (unrolled_list_back (l));
+  ck_assert_ptr_null (unrolled_list_begin (l).node);
+
+  // Front half is pushed to the front, back half to the back.
+  for (int i = 0; i < 500; i++)
+    {
+      data[499 - i] = 499 - i;
+      data[500 + i] = 500 + i;
+      unrolled_list_push_front (l, data + 499 - i);
+      unrolled_list_push_back (l, data + 500 + i);
+    }
+  for (int i = 0; i < 1000; i++)
+    ref[i] = data + i;
+
+  check_equal (l, ref, 1000);
+  ck_assert_ptr_eq (unrolled_list_front (l), data);
+  ck_assert_ptr_eq (unrolled_list_back (l), data + 999);
+  ck_assert_ptr_eq (unrolled_list_at (l, 321), data + 321);
+  ck_assert_ptr_null (unrolled_list_at (l, 1000));
+
+  // Nodes are full except the two in the middle.
+  size_t nodes = 0;
+  for (struct unrolled_list_node *n = l->front; n; n = n->next)
+    nodes++;
+  ck_assert_uint_eq (nodes, 2 * (500 / UNROLLED_LIST_NODE_CAPACITY + 1));
+
+  int pattern = 777;
+  unrolled_list_iterator it = unrolled_list_find (l, &pattern, cmp);
+  ck_assert_ptr_eq (unrolled_list_get (it), data + 777);
+  pattern = 1000;
+  ck_assert_ptr_null (unrolled_list_find (l, &pattern, cmp).node);
+
+  for (int i = 0; i < 400; i++)
+    {
+      unrolled_list_pop_front (l, destr);
+      unrolled_list_pop_back (l, destr);
+    }
+  ck_assert_int_eq (destroyed, 800);
+  check_equal (l, ref + 400, 200);
+
+  unrolled_list_destroy (l, destr);
+  ck_assert_int_eq (destroyed, 1000);
+}
+
+START_TEST (unrolled_list_test_2)
+{
+  int n = 0;
+  int data[3000];
+  int *ref[3000];
+  unrolled_list *l = unrolled_list_create ();
+
+  for (int i = 0; i < 3000; i++)
+    data[i] = i;
+
+  srand (time (NULL));
+  for (int step = 0; step < 6000; step++)
+    {
+      int pos = n ? rand () % (n + 1) : 0;
+
+      // Inserting more at first, erasing more later.
+      if (n < 3000 && (n == 0 || rand () % 6000 > step))
+        {
+          unrolled_list_iterator where = unrolled_list_begin (l);
+          for (int i = 0; i < pos; i++)
+            where = unrolled_list_next (where);
+
+          unrolled_list_iterator it
+              = unrolled_list_insert (l, where, data + step % 3000);
+          ck_assert_ptr_eq (unrolled_list_get (it), data + step % 3000);
+
+          memmove (ref + pos + 1, ref + pos, sizeof (int *) * (n - pos));
+          ref[pos] = data + step % 3000;
+          n++;
+        }
+      else
+        {
+          pos %= n;
+          unrolled_list_iterator it = unrolled_list_begin (l);
+          for (int i = 0; i < pos; i++)
+            it = unrolled_list_next (it);
+
+          it = unrolled_list_erase (l, it, NULL);
+          memmove (ref + pos, ref + pos + 1, sizeof (int *) * (n - pos - 1));
+          n--;
+
+          // Returned iterator points to the next element.
+          if (pos < n)
+            ck_assert_ptr_eq (unrolled_list_get (it), ref[pos]);
+          else
+            ck_assert_ptr_null (it.node);
+        }
+
+      if (step % 100 == 0)
+        check_equal (l, ref, n);
+    }
+
+  check_equal (l, ref, n);
+
+  // No node is empty, nodes stay dense enough.
+  size_t nodes = 0;
+  for (struct unrolled_list_node *node = l->front; node; node = node->next)
+    {
+      ck_assert_uint_gt (node->count, 0);
+      nodes++;
+    }
+  ck_assert (nodes <= 4 * (size_t)n / UNROLLED_LIST_NODE_CAPACITY + 2);
+
+  unrolled_list_clear (l, NULL);
+  ck_assert (unrolled_list_empty (l));
+  ck_assert_ptr_null (l->front);
+  ck_assert_ptr_null (l->back);
+  unrolled_list_destroy (l, NULL);
+}
+
+Suite *
+suite_unrolled_list ()
+{
+  Suite *s;
+  TCase *tc;
+
+  s = suite_create ("Unrolled list test");
+  tc = tcase_create ("Unrolled list test");
+
+  tcase_add_test (tc, unrolled_list_test_1);
+  tcase_add_test (tc, unrolled_list_test_2);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}